@@ -0,0 +1,135 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "benchmarks/benchmark_graphs.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/log/absl_check.h"
+#include "absl/log/absl_log.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/generation/barabasi_albert.h"
+#include "in_memory/generation/erdos_renyi.h"
+#include "in_memory/generation/generator_utils.h"
+#include "in_memory/generation/lfr.h"
+#include "in_memory/generation/rmat.h"
+#include "in_memory/status_macros.h"
+#include "parlay/parallel.h"
+#include "utils/status/thread_safe_status.h"
+
+ABSL_FLAG(std::string, graph_model, "rmat",
+          "Model of the benchmark graph: rmat, gnm, barabasi_albert or lfr.");
+ABSL_FLAG(int, graph_scale, 16,
+          "The benchmark graph has 2^graph_scale nodes.");
+ABSL_FLAG(int, graph_edges_per_node, 16,
+          "Approximate number of edges per node of the benchmark graph.");
+ABSL_FLAG(uint64_t, graph_seed, 0, "Seed of the benchmark graph.");
+
+namespace graph_mining::in_memory {
+namespace {
+
+absl::Status GenerateBenchmarkGraph(GbbsGraph& graph) {
+  const std::string model = absl::GetFlag(FLAGS_graph_model);
+  const int scale = absl::GetFlag(FLAGS_graph_scale);
+  const NodeId num_nodes = NodeId{1} << scale;
+  const int edges_per_node = absl::GetFlag(FLAGS_graph_edges_per_node);
+  GeneratorOptions options;
+  options.seed = absl::GetFlag(FLAGS_graph_seed);
+  options.min_weight = 0.01;
+  options.max_weight = 1.0;
+  if (model == "rmat") {
+    return Rmat(scale, static_cast<int64_t>(num_nodes) * edges_per_node,
+                RmatParameters(), options, graph);
+  } else if (model == "gnm") {
+    return ErdosRenyiGnm(num_nodes,
+                         static_cast<int64_t>(num_nodes) * edges_per_node,
+                         options, graph);
+  } else if (model == "barabasi_albert") {
+    return ParallelBarabasiAlbert(num_nodes, edges_per_node, options, graph);
+  } else if (model == "lfr") {
+    LfrConfig config;
+    config.num_nodes = num_nodes;
+    config.min_degree = edges_per_node;
+    config.max_degree = 16 * edges_per_node;
+    config.inter_community_weight_factor = 0.5;
+    return LfrGraph(config, options, graph).status();
+  }
+  return absl::InvalidArgumentError(
+      absl::StrCat("Unknown graph model: ", model));
+}
+
+std::vector<InMemoryClusterer::AdjacencyList> MakeBenchmarkAdjacencyLists() {
+  GbbsGraph graph;
+  ABSL_CHECK_OK(GenerateBenchmarkGraph(graph));
+  auto* gbbs_graph = graph.Graph();
+  std::vector<InMemoryClusterer::AdjacencyList> adjacency_lists(gbbs_graph->n);
+  parlay::parallel_for(0, gbbs_graph->n, [&](std::size_t i) {
+    auto neighbors = gbbs_graph->get_vertex(i).out_neighbors();
+    adjacency_lists[i].id = i;
+    adjacency_lists[i].outgoing_edges.reserve(neighbors.get_degree());
+    for (std::size_t j = 0; j < neighbors.get_degree(); ++j) {
+      adjacency_lists[i].outgoing_edges.emplace_back(neighbors.get_neighbor(j),
+                                                     neighbors.get_weight(j));
+    }
+  });
+  ABSL_LOG(INFO) << "Generated " << absl::GetFlag(FLAGS_graph_model)
+                 << " benchmark graph with " << gbbs_graph->n << " nodes and "
+                 << gbbs_graph->m / 2 << " edges";
+  return adjacency_lists;
+}
+
+}  // namespace
+
+const std::vector<InMemoryClusterer::AdjacencyList>&
+BenchmarkAdjacencyLists() {
+  static const auto* const adjacency_lists =
+      new std::vector<InMemoryClusterer::AdjacencyList>(
+          MakeBenchmarkAdjacencyLists());
+  return *adjacency_lists;
+}
+
+absl::Status ImportBenchmarkGraph(InMemoryClusterer::Graph& graph) {
+  const auto& adjacency_lists = BenchmarkAdjacencyLists();
+  RETURN_IF_ERROR(graph.PrepareImport(adjacency_lists.size()));
+  ThreadSafeStatus import_status;
+  parlay::parallel_for(0, adjacency_lists.size(), [&](std::size_t i) {
+    import_status.Update(graph.Import(adjacency_lists[i]));
+  });
+  RETURN_IF_ERROR(import_status.status());
+  return graph.FinishImport();
+}
+
+void SetBenchmarkGraphCounters(benchmark::State& state) {
+  const auto& adjacency_lists = BenchmarkAdjacencyLists();
+  std::size_t num_edges = 0;
+  for (const auto& adjacency_list : adjacency_lists) {
+    num_edges += adjacency_list.outgoing_edges.size();
+  }
+  num_edges /= 2;
+  state.counters["num_nodes"] = adjacency_lists.size();
+  state.counters["num_edges"] = num_edges;
+  state.counters["num_workers"] = parlay::num_workers();
+  state.SetItemsProcessed(state.iterations() * num_edges);
+}
+
+}  // namespace graph_mining::in_memory
@@ -0,0 +1,56 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Generated graphs shared by the benchmarks. The graph is configured with the
+// flags below and generated once per process.
+
+#ifndef THIRD_PARTY_GRAPH_MINING_BENCHMARKS_BENCHMARK_GRAPHS_H_
+#define THIRD_PARTY_GRAPH_MINING_BENCHMARKS_BENCHMARK_GRAPHS_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/flags/declare.h"
+#include "absl/status/status.h"
+#include "benchmark/benchmark.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+
+ABSL_DECLARE_FLAG(std::string, graph_model);
+ABSL_DECLARE_FLAG(int, graph_scale);
+ABSL_DECLARE_FLAG(int, graph_edges_per_node);
+ABSL_DECLARE_FLAG(uint64_t, graph_seed);
+
+namespace graph_mining::in_memory {
+
+// Returns the adjacency lists of the benchmark graph, which has
+// 2^--graph_scale nodes, about --graph_edges_per_node edges per node and edge
+// weights in [0.01, 1). --graph_model is one of "rmat", "gnm",
+// "barabasi_albert" and "lfr". The graph is generated on the first call, so
+// benchmarks should call this (or ImportBenchmarkGraph) before their timed
+// loop.
+const std::vector<InMemoryClusterer::AdjacencyList>& BenchmarkAdjacencyLists();
+
+// Imports the benchmark graph into graph (in parallel) and calls
+// FinishImport().
+absl::Status ImportBenchmarkGraph(InMemoryClusterer::Graph& graph);
+
+// Reports the size of the benchmark graph and the number of parlay workers as
+// counters of state, and the number of processed edges (one per undirected
+// edge and iteration) as its items.
+void SetBenchmarkGraphCounters(benchmark::State& state);
+
+}  // namespace graph_mining::in_memory
+
+#endif  // THIRD_PARTY_GRAPH_MINING_BENCHMARKS_BENCHMARK_GRAPHS_H_
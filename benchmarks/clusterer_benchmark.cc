@@ -0,0 +1,163 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Benchmarks of Cluster() of every clusterer and of dendrogram flattening on
+// the benchmark graph (see benchmark_graphs.h). The graph is imported once per
+// benchmark, outside of the timed loop, except for the connected components
+// clusterers, which do most of their work during the import.
+
+#include "absl/log/absl_check.h"
+#include "benchmark/benchmark.h"
+#include "benchmarks/benchmark_graphs.h"
+#include "in_memory/clustering/affinity/affinity.h"
+#include "in_memory/clustering/affinity/parallel_affinity.h"
+#include "in_memory/clustering/coconductance/coconductance.h"
+#include "in_memory/clustering/config.pb.h"
+#include "in_memory/clustering/connected_components/afforest.h"
+#include "in_memory/clustering/connected_components/connected_components.h"
+#include "in_memory/clustering/correlation/parallel_correlation.h"
+#include "in_memory/clustering/correlation/parallel_modularity.h"
+#include "in_memory/clustering/dendrogram.h"
+#include "in_memory/clustering/hac/parhac.h"
+#include "in_memory/clustering/hac/single_linkage.h"
+#include "in_memory/clustering/parline/parallel_line.h"
+
+namespace graph_mining::in_memory {
+namespace {
+
+template <typename Clusterer>
+void BM_Cluster(benchmark::State& state, const ClustererConfig& config) {
+  Clusterer clusterer;
+  ABSL_CHECK_OK(ImportBenchmarkGraph(*clusterer.MutableGraph()));
+  for (auto _ : state) {
+    auto clustering = clusterer.Cluster(config);
+    ABSL_CHECK_OK(clustering.status());
+    state.counters["num_clusters"] = clustering->size();
+    benchmark::DoNotOptimize(clustering);
+  }
+  SetBenchmarkGraphCounters(state);
+}
+
+// Same as BM_Cluster, but imports the graph into a new clusterer inside of the
+// timed loop. Used for clusterers that do (part of) their work during the
+// import, such as ParallelConnectedComponentsClusterer, whose union-find runs
+// in Import.
+template <typename Clusterer>
+void BM_ImportAndCluster(benchmark::State& state,
+                         const ClustererConfig& config) {
+  for (auto _ : state) {
+    Clusterer clusterer;
+    ABSL_CHECK_OK(ImportBenchmarkGraph(*clusterer.MutableGraph()));
+    auto clustering = clusterer.Cluster(config);
+    ABSL_CHECK_OK(clustering.status());
+    state.counters["num_clusters"] = clustering->size();
+    benchmark::DoNotOptimize(clustering);
+  }
+  SetBenchmarkGraphCounters(state);
+}
+
+ClustererConfig MakeParHacConfig() {
+  ClustererConfig config;
+  config.mutable_parhac_clusterer_config()->set_epsilon(0.1);
+  config.mutable_parhac_clusterer_config()->set_weight_threshold(0.3);
+  return config;
+}
+
+ClustererConfig MakeSingleLinkageConfig() {
+  ClustererConfig config;
+  config.mutable_single_linkage_clusterer_config()->set_weight_threshold(0.5);
+  return config;
+}
+
+ClustererConfig MakeCorrelationConfig() {
+  ClustererConfig config;
+  config.mutable_correlation_clusterer_config()->set_resolution(0.5);
+  return config;
+}
+
+ClustererConfig MakeModularityConfig() {
+  ClustererConfig config;
+  config.mutable_modularity_clusterer_config()->set_resolution(1.0);
+  return config;
+}
+
+ClustererConfig MakeAffinityConfig() {
+  ClustererConfig config;
+  config.mutable_affinity_clusterer_config()->set_num_iterations(5);
+  config.mutable_affinity_clusterer_config()->set_weight_threshold(0.3);
+  return config;
+}
+
+ClustererConfig MakeLinePartitionerConfig() {
+  ClustererConfig config;
+  config.mutable_line_partitioner_config()->set_num_clusters(64);
+  return config;
+}
+
+// Defines and registers BM_<clusterer>, which runs BM_Cluster with the given
+// config.
+#define GRAPH_MINING_CLUSTERER_BENCHMARK(clusterer, config) \
+  void BM_##clusterer(benchmark::State& state) {            \
+    BM_Cluster<clusterer>(state, config);                   \
+  }                                                         \
+  BENCHMARK(BM_##clusterer)->UseRealTime()->Unit(benchmark::kMillisecond)
+
+// Same as GRAPH_MINING_CLUSTERER_BENCHMARK, but with BM_ImportAndCluster.
+#define GRAPH_MINING_IMPORT_AND_CLUSTER_BENCHMARK(clusterer, config) \
+  void BM_##clusterer(benchmark::State& state) {                     \
+    BM_ImportAndCluster<clusterer>(state, config);                   \
+  }                                                                  \
+  BENCHMARK(BM_##clusterer)->UseRealTime()->Unit(benchmark::kMillisecond)
+
+GRAPH_MINING_CLUSTERER_BENCHMARK(ParHacClusterer, MakeParHacConfig());
+GRAPH_MINING_CLUSTERER_BENCHMARK(SingleLinkageClusterer,
+                                 MakeSingleLinkageConfig());
+GRAPH_MINING_CLUSTERER_BENCHMARK(ParallelCorrelationClusterer,
+                                 MakeCorrelationConfig());
+GRAPH_MINING_CLUSTERER_BENCHMARK(ParallelModularityClusterer,
+                                 MakeModularityConfig());
+GRAPH_MINING_CLUSTERER_BENCHMARK(ParallelAffinityClusterer,
+                                 MakeAffinityConfig());
+GRAPH_MINING_CLUSTERER_BENCHMARK(AffinityClusterer, MakeAffinityConfig());
+GRAPH_MINING_CLUSTERER_BENCHMARK(CoconductanceClusterer, ClustererConfig());
+GRAPH_MINING_IMPORT_AND_CLUSTER_BENCHMARK(ParallelConnectedComponentsClusterer,
+                                          ClustererConfig());
+GRAPH_MINING_IMPORT_AND_CLUSTER_BENCHMARK(AfforestConnectedComponentsClusterer,
+                                          ClustererConfig());
+GRAPH_MINING_CLUSTERER_BENCHMARK(ParallelLinePartitioner,
+                                 MakeLinePartitionerConfig());
+
+// Flattens the (monotone) single-linkage dendrogram of the benchmark graph at
+// the threshold given by the benchmark argument (in percent).
+void BM_FlattenClustering(benchmark::State& state) {
+  SingleLinkageClusterer clusterer;
+  ABSL_CHECK_OK(ImportBenchmarkGraph(*clusterer.MutableGraph()));
+  auto dendrogram = clusterer.HierarchicalCluster(ClustererConfig());
+  ABSL_CHECK_OK(dendrogram.status());
+  for (auto _ : state) {
+    auto clustering = dendrogram->FlattenClustering(state.range(0) / 100.0);
+    ABSL_CHECK_OK(clustering.status());
+    benchmark::DoNotOptimize(clustering);
+  }
+  SetBenchmarkGraphCounters(state);
+}
+BENCHMARK(BM_FlattenClustering)
+    ->Arg(10)
+    ->Arg(50)
+    ->Arg(90)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace graph_mining::in_memory
@@ -0,0 +1,61 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Benchmarks of importing the benchmark graph (see benchmark_graphs.h) into the
+// graph representations used by the clusterers. Each iteration imports all
+// adjacency lists in parallel and calls FinishImport().
+
+#include "absl/log/absl_check.h"
+#include "benchmark/benchmark.h"
+#include "benchmarks/benchmark_graphs.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/graph.h"
+#include "in_memory/clustering/undirected_converter_graph.h"
+#include "in_memory/clustering/undirected_converter_graph.pb.h"
+
+namespace graph_mining::in_memory {
+namespace {
+
+template <typename Graph>
+void BM_Import(benchmark::State& state) {
+  BenchmarkAdjacencyLists();
+  for (auto _ : state) {
+    Graph graph;
+    ABSL_CHECK_OK(ImportBenchmarkGraph(graph));
+    benchmark::DoNotOptimize(graph);
+  }
+  SetBenchmarkGraphCounters(state);
+}
+BENCHMARK(BM_Import<GbbsGraph>)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Import<SimpleUndirectedGraph>)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+void BM_UndirectedConverterGraphImport(benchmark::State& state) {
+  BenchmarkAdjacencyLists();
+  for (auto _ : state) {
+    GbbsGraph out_graph;
+    UndirectedConverterGraph graph(::graph_mining::ConvertToUndirectedConfig(),
+                                   &out_graph);
+    ABSL_CHECK_OK(ImportBenchmarkGraph(graph));
+    benchmark::DoNotOptimize(out_graph);
+  }
+  SetBenchmarkGraphCounters(state);
+}
+BENCHMARK(BM_UndirectedConverterGraphImport)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace graph_mining::in_memory
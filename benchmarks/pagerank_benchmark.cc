@@ -0,0 +1,81 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Benchmarks of PageRank on the benchmark graph (see benchmark_graphs.h): the
+// cache-blocked power iterations of ComputePageRank against the GBBS
+// implementation, both running a fixed number of iterations on the unweighted
+// graph.
+
+#include "absl/log/absl_check.h"
+#include "benchmark/benchmark.h"
+#include "benchmarks/PageRank/PageRank.h"
+#include "benchmarks/benchmark_graphs.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/pagerank/pagerank.pb.h"
+#include "in_memory/pagerank/pagerank_engine.h"
+
+namespace graph_mining::in_memory {
+namespace {
+
+constexpr int kNumIterations = 20;
+
+// Builds the PageRankGraph (including its cache blocks) of the benchmark
+// graph.
+void BM_CreatePageRankGraph(benchmark::State& state) {
+  UnweightedGbbsGraph graph;
+  ABSL_CHECK_OK(ImportBenchmarkGraph(graph));
+  for (auto _ : state) {
+    auto pagerank_graph = PageRankGraph::Create(*graph.Graph());
+    ABSL_CHECK_OK(pagerank_graph.status());
+    benchmark::DoNotOptimize(pagerank_graph);
+  }
+  SetBenchmarkGraphCounters(state);
+}
+BENCHMARK(BM_CreatePageRankGraph)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+void BM_ComputePageRank(benchmark::State& state) {
+  UnweightedGbbsGraph graph;
+  ABSL_CHECK_OK(ImportBenchmarkGraph(graph));
+  auto pagerank_graph = PageRankGraph::Create(*graph.Graph());
+  ABSL_CHECK_OK(pagerank_graph.status());
+  PageRankConfig config;
+  config.set_num_iterations(kNumIterations);
+  config.set_approx_precision(0);
+  for (auto _ : state) {
+    auto result = ComputePageRank(*pagerank_graph, config);
+    ABSL_CHECK_OK(result.status());
+    benchmark::DoNotOptimize(result);
+  }
+  SetBenchmarkGraphCounters(state);
+  state.counters["pagerank_iterations"] = kNumIterations;
+}
+BENCHMARK(BM_ComputePageRank)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// The GBBS PageRank benchmark, which ParallelPageRank used before the native
+// engine. With eps = 0 it runs exactly kNumIterations iterations.
+void BM_GbbsPageRank(benchmark::State& state) {
+  UnweightedGbbsGraph graph;
+  ABSL_CHECK_OK(ImportBenchmarkGraph(graph));
+  for (auto _ : state) {
+    auto scores = ::gbbs::PageRank(*graph.Graph(), /*eps=*/0.0,
+                                   /*max_iters=*/kNumIterations);
+    benchmark::DoNotOptimize(scores);
+  }
+  SetBenchmarkGraphCounters(state);
+  state.counters["pagerank_iterations"] = kNumIterations;
+}
+BENCHMARK(BM_GbbsPageRank)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace graph_mining::in_memory
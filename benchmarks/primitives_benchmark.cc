@@ -0,0 +1,138 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Benchmarks of core parallel primitives on the benchmark graph (see
+// benchmark_graphs.h).
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <tuple>
+#include <vector>
+
+#include "absl/log/absl_check.h"
+#include "benchmark/benchmark.h"
+#include "benchmarks/benchmark_graphs.h"
+#include "gbbs/macros.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/connected_components/asynchronous_union_find.h"
+#include "in_memory/parallel/parallel_graph_utils.h"
+#include "in_memory/parallel/streaming_writer.h"
+#include "parlay/parallel.h"
+#include "parlay/utilities.h"
+#include "utils/container/fixed_size_priority_queue.h"
+
+namespace graph_mining::in_memory {
+namespace {
+
+// Contracts the benchmark graph with respect to a clustering with clusters of
+// (on average) state.range(0) nodes.
+void BM_ComputeInterClusterEdgesSort(benchmark::State& state) {
+  GbbsGraph graph;
+  ABSL_CHECK_OK(ImportBenchmarkGraph(graph));
+  const std::size_t num_nodes = graph.Graph()->n;
+  const std::size_t num_clusters =
+      std::max<std::size_t>(1, num_nodes / state.range(0));
+  std::vector<gbbs::uintE> cluster_ids(num_nodes);
+  parlay::parallel_for(0, num_nodes, [&](std::size_t i) {
+    cluster_ids[i] = parlay::hash64(i) % num_clusters;
+  });
+  for (auto _ : state) {
+    auto result = ComputeInterClusterEdgesSort(
+        *graph.Graph(), cluster_ids, num_clusters, std::plus<float>(),
+        [](gbbs::uintE, gbbs::uintE) { return true; },
+        [](std::tuple<gbbs::uintE, gbbs::uintE, float> edge) {
+          return std::get<2>(edge);
+        });
+    benchmark::DoNotOptimize(result);
+  }
+  SetBenchmarkGraphCounters(state);
+}
+BENCHMARK(BM_ComputeInterClusterEdgesSort)
+    ->Arg(4)
+    ->Arg(64)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Writes one element per directed edge of the benchmark graph with the block
+// size given by the benchmark argument.
+void BM_StreamingWriter(benchmark::State& state) {
+  const auto& adjacency_lists = BenchmarkAdjacencyLists();
+  for (auto _ : state) {
+    StreamingWriter<std::tuple<gbbs::uintE, gbbs::uintE>> writer(
+        state.range(0));
+    parlay::parallel_for(0, adjacency_lists.size(), [&](std::size_t i) {
+      for (const auto& [neighbor, weight] :
+           adjacency_lists[i].outgoing_edges) {
+        writer.Add({i, neighbor});
+      }
+    });
+    auto blocks = writer.Build();
+    benchmark::DoNotOptimize(blocks);
+  }
+  SetBenchmarkGraphCounters(state);
+}
+BENCHMARK(BM_StreamingWriter)
+    ->Arg(0)
+    ->Arg(1 << 12)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Unites the endpoints of all edges of the benchmark graph in parallel and
+// computes the component ids.
+void BM_AsynchronousUnionFind(benchmark::State& state) {
+  const auto& adjacency_lists = BenchmarkAdjacencyLists();
+  for (auto _ : state) {
+    AsynchronousUnionFind<gbbs::uintE> union_find(adjacency_lists.size());
+    parlay::parallel_for(0, adjacency_lists.size(), [&](std::size_t i) {
+      for (const auto& [neighbor, weight] :
+           adjacency_lists[i].outgoing_edges) {
+        if (i < neighbor) union_find.Unite(i, neighbor);
+      }
+    });
+    auto component_ids = union_find.ComponentIds();
+    benchmark::DoNotOptimize(component_ids);
+  }
+  SetBenchmarkGraphCounters(state);
+}
+BENCHMARK(BM_AsynchronousUnionFind)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Inserts every node of the benchmark graph with its weighted degree as the
+// priority and then removes the nodes in the order of decreasing priority.
+// The queue is sequential.
+void BM_FixedSizePriorityQueue(benchmark::State& state) {
+  const auto& adjacency_lists = BenchmarkAdjacencyLists();
+  std::vector<double> priorities(adjacency_lists.size());
+  parlay::parallel_for(0, adjacency_lists.size(), [&](std::size_t i) {
+    for (const auto& [neighbor, weight] : adjacency_lists[i].outgoing_edges) {
+      priorities[i] += weight;
+    }
+  });
+  for (auto _ : state) {
+    FixedSizePriorityQueue<double> queue(priorities.size());
+    for (std::size_t i = 0; i < priorities.size(); ++i) {
+      queue.InsertOrUpdate(i, priorities[i]);
+    }
+    while (!queue.Empty()) queue.Remove(queue.Top());
+  }
+  state.counters["num_nodes"] = priorities.size();
+  state.SetItemsProcessed(state.iterations() * priorities.size());
+}
+BENCHMARK(BM_FixedSizePriorityQueue)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace graph_mining::in_memory
@@ -0,0 +1,61 @@
+#!/bin/bash
+# Copyright 2023 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Runs all benchmark suites for a range of thread counts and writes the results
+# as JSON files (one per suite and thread count) to the output directory.
+#
+# Usage: run_benchmarks.sh OUTPUT_DIR [THREAD_COUNTS] [FLAGS...]
+#
+# THREAD_COUNTS is a comma-separated list (default: 1 and the number of
+# available cores). FLAGS are passed to every benchmark binary, e.g.
+# --graph_scale=18 or --benchmark_filter=ParHac.
+#
+# The parlay scheduler cannot be resized within a process, so each thread count
+# is run as a separate process with PARLAY_NUM_THREADS set.
+
+set -euo pipefail
+
+if [[ $# -lt 1 ]]; then
+  echo "Usage: $0 OUTPUT_DIR [THREAD_COUNTS] [FLAGS...]" >&2
+  exit 1
+fi
+output_dir="$1"
+shift
+thread_counts="1,$(nproc)"
+if [[ $# -gt 0 && "$1" != -* ]]; then
+  thread_counts="$1"
+  shift
+fi
+
+readonly benchmarks=(graph_import_benchmark clusterer_benchmark
+  primitives_benchmark pagerank_benchmark)
+
+# BUILD_WORKING_DIRECTORY and BUILD_WORKSPACE_DIRECTORY are set when run with
+# `bazel run`.
+output_dir="$(cd "${BUILD_WORKING_DIRECTORY:-.}" && mkdir -p "${output_dir}" &&
+  cd "${output_dir}" && pwd)"
+cd "${BUILD_WORKSPACE_DIRECTORY:-$(dirname "$0")/..}"
+bazel build -c opt $(printf "//benchmarks:%s " "${benchmarks[@]}")
+bin_dir="$(bazel info -c opt bazel-bin)/benchmarks"
+
+for threads in ${thread_counts//,/ }; do
+  for benchmark in "${benchmarks[@]}"; do
+    PARLAY_NUM_THREADS="${threads}" "${bin_dir}/${benchmark}" \
+      --benchmark_out="${output_dir}/${benchmark}_t${threads}.json" \
+      --benchmark_out_format=json \
+      --benchmark_context=num_threads="${threads}" \
+      "$@"
+  done
+done
@@ -25,6 +25,7 @@
 #include "absl/status/statusor.h"
 #include "in_memory/clustering/affinity/parallel_affinity_internal.h"
 #include "in_memory/clustering/affinity/weight_threshold.h"
+#include "in_memory/clustering/clustering_run_stats.h"
 #include "in_memory/clustering/config.pb.h"
 #include "in_memory/clustering/gbbs_graph.h"
 #include "in_memory/clustering/in_memory_clusterer.h"
@@ -47,7 +48,13 @@ void AddNewClusters(ParallelAffinityClusterer::Clustering new_clusters,
 absl::StatusOr<std::vector<ParallelAffinityClusterer::Clustering>>
 ParallelAffinityClusterer::HierarchicalFlatCluster(
     const ClustererConfig& config) const {
-  
+  return HierarchicalFlatClusterImpl(config, /*stats=*/nullptr);
+}
+
+absl::StatusOr<std::vector<ParallelAffinityClusterer::Clustering>>
+ParallelAffinityClusterer::HierarchicalFlatClusterImpl(
+    const ClustererConfig& config, RunStatsCollector* stats) const {
+  RunStatsScope hierarchy_scope(stats, "Affinity/HierarchicalFlatCluster");
   ABSL_CHECK(graph_.Graph() != nullptr);
   const AffinityClustererConfig& affinity_config =
       config.affinity_clusterer_config();
@@ -83,12 +90,15 @@ ParallelAffinityClusterer::HierarchicalFlatCluster(
         (i == 0) ? graph_.Graph() : compressed_graph.get();
 
     std::vector<gbbs::uintE> compressed_cluster_ids;
-    ASSIGN_OR_RETURN(
-        compressed_cluster_ids,
-        NearestNeighborLinkage(*current_graph, weight_threshold,
-                               affinity_config.has_size_constraint()
-                                   ? std::make_optional(size_constraint_config)
-                                   : std::nullopt));
+    {
+      RunStatsScope linkage_scope(stats, "Affinity/NearestNeighborLinkage");
+      ASSIGN_OR_RETURN(compressed_cluster_ids,
+                       NearestNeighborLinkage(
+                           *current_graph, weight_threshold,
+                           affinity_config.has_size_constraint()
+                               ? std::make_optional(size_constraint_config)
+                               : std::nullopt));
+    }
 
     cluster_ids = FlattenClustering(cluster_ids, compressed_cluster_ids);
 
@@ -118,6 +128,7 @@ ParallelAffinityClusterer::HierarchicalFlatCluster(
     if (to_exit || i == affinity_config.num_iterations() - 1) break;
 
     // Compress graph
+    RunStatsScope compress_scope(stats, "Affinity/Compress");
     GraphWithWeights new_compressed_graph;
     ASSIGN_OR_RETURN(new_compressed_graph,
                      CompressGraph(*current_graph, node_weights,
@@ -139,9 +150,23 @@ ParallelAffinityClusterer::HierarchicalFlatCluster(
 
 absl::StatusOr<ParallelAffinityClusterer::Clustering>
 ParallelAffinityClusterer::Cluster(const ClustererConfig& config) const {
-  
+  return ClusterImpl(config, /*stats=*/nullptr);
+}
+
+absl::StatusOr<ClusteringWithStats> ParallelAffinityClusterer::ClusterWithStats(
+    const ClustererConfig& config) const {
+  RunStatsCollector stats;
+  ASSIGN_OR_RETURN(Clustering clustering, ClusterImpl(config, &stats));
+  return ClusteringWithStats{std::move(clustering), std::move(stats).Finish()};
+}
+
+absl::StatusOr<ParallelAffinityClusterer::Clustering>
+ParallelAffinityClusterer::ClusterImpl(const ClustererConfig& config,
+                                       RunStatsCollector* stats) const {
+  RunStatsScope cluster_scope(stats, "Affinity/Cluster");
   std::vector<ParallelAffinityClusterer::Clustering> clustering_hierarchy;
-  ASSIGN_OR_RETURN(clustering_hierarchy, HierarchicalFlatCluster(config));
+  ASSIGN_OR_RETURN(clustering_hierarchy,
+                   HierarchicalFlatClusterImpl(config, stats));
 
   if (clustering_hierarchy.empty()) {
     ParallelAffinityClusterer::Clustering trivial_clustering(graph_.Graph()->n);
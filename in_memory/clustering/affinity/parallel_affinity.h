@@ -24,6 +24,7 @@
 #include "absl/status/statusor.h"
 #include "in_memory/clustering/affinity/parallel_affinity_internal.h"
 #include "in_memory/clustering/affinity/weight_threshold.h"
+#include "in_memory/clustering/clustering_run_stats.h"
 #include "in_memory/clustering/config.pb.h"
 #include "in_memory/clustering/gbbs_graph.h"
 #include "in_memory/clustering/in_memory_clusterer.h"
@@ -55,12 +56,28 @@ class ParallelAffinityClusterer : public InMemoryClusterer {
       const ::graph_mining::in_memory::ClustererConfig& config)
       const override;
 
+  // Same as Cluster(), but also returns the resource usage of the phases of the
+  // run (see clustering_run_stats.h).
+  absl::StatusOr<ClusteringWithStats> ClusterWithStats(
+      const ::graph_mining::in_memory::ClustererConfig& config) const;
+
   absl::StatusOr<std::vector<Clustering>> HierarchicalFlatCluster(
       const ::graph_mining::in_memory::ClustererConfig& config)
       const override;
 
  private:
   GbbsGraph graph_;
+
+  // Implements Cluster() and ClusterWithStats(). stats may be nullptr.
+  absl::StatusOr<Clustering> ClusterImpl(
+      const ::graph_mining::in_memory::ClustererConfig& config,
+      RunStatsCollector* stats) const;
+
+  // Implements HierarchicalFlatCluster(). The phases of the run are recorded in
+  // stats, unless it is nullptr.
+  absl::StatusOr<std::vector<Clustering>> HierarchicalFlatClusterImpl(
+      const ::graph_mining::in_memory::ClustererConfig& config,
+      RunStatsCollector* stats) const;
 };
 
 }  // namespace graph_mining::in_memory
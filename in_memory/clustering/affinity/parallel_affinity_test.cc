@@ -21,6 +21,7 @@
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "in_memory/clustering/clustering_run_stats.h"
 #include "in_memory/clustering/clustering_utils.h"
 #include "in_memory/clustering/config.pb.h"
 #include "in_memory/clustering/graph.h"
@@ -469,5 +470,39 @@ TEST(ParallelAffinityTest, AverageEdgeAggregation) {
               ElementsAreArray<Cluster>({{0, 1, 2, 3, 4}}));
 }
 
+TEST(ParallelAffinityTest, ClusterWithStats) {
+  SimpleUndirectedGraph graph;
+  ASSERT_OK(graph.AddEdge(0, 1, 2.0));  // contracted in the first round
+  ASSERT_OK(graph.AddEdge(1, 2, 2.0));  // contracted in the first round
+  ASSERT_OK(graph.AddEdge(3, 4, 2.0));  // contracted in the first round
+  ASSERT_OK(graph.AddEdge(3, 0, 1));
+  ASSERT_OK(graph.AddEdge(4, 2, 0.5));
+  auto clusterer = std::make_unique<ParallelAffinityClusterer>();
+  ASSERT_OK(CopyGraph(graph, clusterer->MutableGraph()));
+  ASSERT_OK(clusterer->MutableGraph()->FinishImport());
+
+  ASSERT_OK_AND_ASSIGN(ClusteringWithStats result,
+                       clusterer->ClusterWithStats(PARSE_TEXT_PROTO(
+                           "affinity_clusterer_config { "
+                           "edge_aggregation_function: DEFAULT_AVERAGE "
+                           "weight_threshold: 0.26 num_iterations: 2 }")));
+  EXPECT_THAT(CanonicalizeClustering(result.clustering),
+              ElementsAreArray<Cluster>({{0, 1, 2}, {3, 4}}));
+
+  // Hardware counters and memory usage may be unavailable, but the phases are
+  // always recorded.
+  const auto& phases = result.stats.phases;
+  ASSERT_GE(phases.size(), 3);
+  EXPECT_EQ(phases[0].name, "Affinity/Cluster");
+  EXPECT_EQ(phases[0].parent, -1);
+  EXPECT_EQ(phases[0].num_calls, 1);
+  EXPECT_EQ(phases[1].name, "Affinity/HierarchicalFlatCluster");
+  EXPECT_EQ(phases[1].parent, 0);
+  EXPECT_EQ(phases[2].name, "Affinity/NearestNeighborLinkage");
+  EXPECT_EQ(phases[2].parent, 1);
+  EXPECT_EQ(phases[2].num_calls, 2);
+  for (const PhaseStats& phase : phases) EXPECT_GE(phase.wall_seconds, 0);
+}
+
 }  // namespace
 }  // namespace graph_mining::in_memory
@@ -0,0 +1,154 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/clustering/clustering_run_stats.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "absl/log/absl_check.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "in_memory/parallel/perf_counters.h"
+#include "in_memory/parallel/tracing.h"
+
+namespace graph_mining::in_memory {
+namespace {
+
+int64_t Difference(int64_t end, int64_t start) {
+  return end < 0 || start < 0 ? -1 : end - start;
+}
+
+// Adds value to total; the total becomes -1 (unavailable) once any value is.
+void Accumulate(int64_t value, int64_t& total) {
+  total = value < 0 || total < 0 ? -1 : total + value;
+}
+
+std::string FormatCount(int64_t value) {
+  return value < 0 ? "-" : absl::StrFormat("%.3g", static_cast<double>(value));
+}
+
+std::string FormatMegabytes(int64_t bytes) {
+  return bytes < 0 ? "-" : absl::StrFormat("%.1f", bytes / (1024.0 * 1024.0));
+}
+
+}  // namespace
+
+std::string ClusteringRunStats::DebugString() const {
+  std::string result = absl::StrFormat(
+      "%-40s %8s %10s %10s %10s %10s %10s %10s %10s %10s %10s\n", "phase",
+      "calls", "wall_s", "cpu_s", "cycles", "instrs", "llc_miss", "dtlb_miss",
+      "rss_mb", "peak_mb", "peak_up_mb");
+  for (const PhaseStats& phase : phases) {
+    int depth = 0;
+    for (int parent = phase.parent; parent >= 0;
+         parent = phases[parent].parent) {
+      ++depth;
+    }
+    absl::StrAppendFormat(
+        &result, "%-40s %8d %10.3f %10s %10s %10s %10s %10s %10s %10s %10s\n",
+        absl::StrCat(std::string(2 * depth, ' '), phase.name), phase.num_calls,
+        phase.wall_seconds,
+        phase.cpu_seconds < 0 ? "-"
+                              : absl::StrFormat("%.3f", phase.cpu_seconds),
+        FormatCount(phase.counters.cycles),
+        FormatCount(phase.counters.instructions),
+        FormatCount(phase.counters.llc_misses),
+        FormatCount(phase.counters.dtlb_misses),
+        FormatMegabytes(phase.rss_bytes_end),
+        FormatMegabytes(phase.peak_rss_bytes),
+        FormatMegabytes(phase.peak_rss_growth_bytes));
+  }
+  return result;
+}
+
+RunStatsCollector::RunStatsCollector() {
+  stats_.perf_counters_available = perf_counters_.Available();
+}
+
+ClusteringRunStats RunStatsCollector::Finish() && {
+  ABSL_CHECK_EQ(current_phase_, -1);
+  return std::move(stats_);
+}
+
+RunStatsCollector::Sample RunStatsCollector::TakeSample() const {
+  return {absl::Now(), Tracer::ProcessCpuNanos(), perf_counters_.Read(),
+          CurrentMemoryUsage()};
+}
+
+int RunStatsCollector::EnterPhase(const char* name) {
+  auto& phases = stats_.phases;
+  auto it = std::find_if(phases.begin(), phases.end(), [&](const auto& phase) {
+    return phase.parent == current_phase_ && phase.name == name;
+  });
+  if (it == phases.end()) {
+    PhaseStats phase;
+    phase.name = name;
+    phase.parent = current_phase_;
+    phase.counters = {0, 0, 0, 0};
+    phases.push_back(std::move(phase));
+    it = phases.end() - 1;
+  }
+  current_phase_ = it - phases.begin();
+  return current_phase_;
+}
+
+void RunStatsCollector::ExitPhase(int phase_index, const Sample& start) {
+  ABSL_CHECK_EQ(phase_index, current_phase_);
+  PhaseStats& phase = stats_.phases[phase_index];
+  current_phase_ = phase.parent;
+  const Sample end = TakeSample();
+  ++phase.num_calls;
+  phase.wall_seconds += absl::ToDoubleSeconds(end.time - start.time);
+  if (phase.cpu_seconds >= 0) {
+    phase.cpu_seconds = start.cpu_ns < 0 || end.cpu_ns < 0
+                            ? -1
+                            : phase.cpu_seconds +
+                                  (end.cpu_ns - start.cpu_ns) / 1e9;
+  }
+  const PerfCounterValues counters =
+      PerfCounterDifference(end.counters, start.counters);
+  Accumulate(counters.cycles, phase.counters.cycles);
+  Accumulate(counters.instructions, phase.counters.instructions);
+  Accumulate(counters.llc_misses, phase.counters.llc_misses);
+  Accumulate(counters.dtlb_misses, phase.counters.dtlb_misses);
+  if (phase.num_calls == 1) phase.rss_bytes_begin = start.memory.rss_bytes;
+  phase.rss_bytes_end = end.memory.rss_bytes;
+  phase.peak_rss_bytes = end.memory.peak_rss_bytes;
+  Accumulate(
+      Difference(end.memory.peak_rss_bytes, start.memory.peak_rss_bytes),
+      phase.peak_rss_growth_bytes);
+}
+
+RunStatsScope::RunStatsScope(RunStatsCollector* collector, const char* name)
+    : collector_(collector) {
+#ifdef GRAPH_MINING_ENABLE_TRACING
+  trace_scope_.emplace(name);
+#endif
+  if (collector_ == nullptr) return;
+  phase_ = collector_->EnterPhase(name);
+  // Sample last, so that the bookkeeping is not part of the phase.
+  start_ = collector_->TakeSample();
+}
+
+RunStatsScope::~RunStatsScope() {
+  if (collector_ == nullptr) return;
+  collector_->ExitPhase(phase_, *start_);
+}
+
+}  // namespace graph_mining::in_memory
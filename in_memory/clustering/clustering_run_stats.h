@@ -0,0 +1,146 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Per-phase resource usage of a clustering run: wall and CPU time, hardware
+// counters and memory. Clusterers that support it expose a ClusterWithStats()
+// method, which marks its phases with RunStatsScope.
+
+#ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_CLUSTERING_RUN_STATS_H_
+#define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_CLUSTERING_RUN_STATS_H_
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/time/time.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/parallel/perf_counters.h"
+#include "in_memory/parallel/tracing.h"
+
+namespace graph_mining::in_memory {
+
+// Resource usage of a phase, summed over all times the phase was entered.
+//
+// Every phase is sampled when it is entered and exited. A sample reads the
+// hardware counters with one read(2) per thread (see ProcessPerfCounters) and
+// the memory usage from /proc, so phases should not be entered more than once
+// per round of an algorithm.
+struct PhaseStats {
+  std::string name;
+  // Index of the enclosing phase in ClusteringRunStats::phases, or -1 for
+  // top-level phases.
+  int parent = -1;
+  // Number of times the phase was entered.
+  int64_t num_calls = 0;
+  double wall_seconds = 0;
+  // CPU time of all threads of the process, or -1 if unavailable. Divided by
+  // wall_seconds, this shows how parallel the phase was.
+  double cpu_seconds = 0;
+  // Counters of all threads of the process. See PerfCounterValues.
+  PerfCounterValues counters;
+  // Resident set size when the phase was first entered and last exited, or -1
+  // if unavailable.
+  int64_t rss_bytes_begin = -1;
+  int64_t rss_bytes_end = -1;
+  // High-water mark of the resident set size of the process when the phase
+  // was last exited, or -1 if unavailable.
+  int64_t peak_rss_bytes = -1;
+  // Growth of the high-water mark during the phase, summed over all calls, or
+  // -1 if unavailable. The high-water mark is never reset, so this is 0 for a
+  // phase that stays below the peak of an earlier phase.
+  int64_t peak_rss_growth_bytes = 0;
+};
+
+struct ClusteringRunStats {
+  // Whether any hardware counter could be opened. Counters that could not be
+  // opened are -1 in all phases.
+  bool perf_counters_available = false;
+  // Phases in the order in which they were first entered. A phase entered
+  // again under the same parent is accumulated in the same entry.
+  std::vector<PhaseStats> phases;
+
+  // Returns a human-readable table of the phases.
+  std::string DebugString() const;
+};
+
+// A clustering together with the statistics of the run that computed it.
+struct ClusteringWithStats {
+  InMemoryClusterer::Clustering clustering;
+  ClusteringRunStats stats;
+};
+
+// Collects ClusteringRunStats for the phases marked with RunStatsScope.
+// Opening the hardware counters takes a few system calls per thread, so a
+// collector should be created once per run.
+//
+// This class is thread-compatible; phases must be entered and exited from
+// serial code.
+class RunStatsCollector {
+ public:
+  RunStatsCollector();
+
+  RunStatsCollector(const RunStatsCollector&) = delete;
+  RunStatsCollector& operator=(const RunStatsCollector&) = delete;
+
+  // Returns the collected statistics. All phases must have been exited.
+  ClusteringRunStats Finish() &&;
+
+ private:
+  friend class RunStatsScope;
+
+  // Resource usage at a point in time.
+  struct Sample {
+    absl::Time time;
+    int64_t cpu_ns;
+    PerfCounterValues counters;
+    MemoryUsage memory;
+  };
+
+  Sample TakeSample() const;
+
+  // Returns the index of the entered phase in stats_.phases.
+  int EnterPhase(const char* name);
+  void ExitPhase(int phase, const Sample& start);
+
+  ProcessPerfCounters perf_counters_;
+  ClusteringRunStats stats_;
+  // The currently entered phase, or -1.
+  int current_phase_ = -1;
+};
+
+// Marks the lifetime of the object as a phase with the given name (which must
+// have static storage duration). If this library is compiled with
+// GRAPH_MINING_ENABLE_TRACING, the phase is also traced while the tracer is
+// recording (see tracing.h). The trace scope is an optional member that is
+// only engaged by the (out-of-line) constructor, so the layout of this class
+// does not depend on the flag. If collector is nullptr, only tracing is done.
+class RunStatsScope {
+ public:
+  RunStatsScope(RunStatsCollector* collector, const char* name);
+  ~RunStatsScope();
+
+  RunStatsScope(const RunStatsScope&) = delete;
+  RunStatsScope& operator=(const RunStatsScope&) = delete;
+
+ private:
+  std::optional<TraceScope> trace_scope_;
+  RunStatsCollector* collector_;
+  int phase_ = -1;
+  std::optional<RunStatsCollector::Sample> start_;
+};
+
+}  // namespace graph_mining::in_memory
+
+#endif  // THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_CLUSTERING_RUN_STATS_H_
@@ -0,0 +1,163 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/clustering/clustering_run_stats.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "in_memory/parallel/perf_counters.h"
+#include "in_memory/parallel/tracing.h"
+
+namespace graph_mining::in_memory {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::Field;
+using ::testing::HasSubstr;
+
+// Returns a matcher of a PhaseStats with the given name and parent.
+testing::Matcher<PhaseStats> Phase(const char* name, int parent) {
+  return testing::AllOf(Field(&PhaseStats::name, name),
+                        Field(&PhaseStats::parent, parent));
+}
+
+// Checks the counters of phase against the availability of the counters.
+void ExpectCounters(const PhaseStats& phase, bool perf_counters_available) {
+  if (perf_counters_available) {
+    EXPECT_GE(phase.counters.cycles, 0) << phase.name;
+  } else {
+    EXPECT_EQ(phase.counters.cycles, -1) << phase.name;
+    EXPECT_EQ(phase.counters.instructions, -1) << phase.name;
+    EXPECT_EQ(phase.counters.llc_misses, -1) << phase.name;
+    EXPECT_EQ(phase.counters.dtlb_misses, -1) << phase.name;
+  }
+}
+
+TEST(RunStatsCollectorTest, AccumulatesNestedPhases) {
+  RunStatsCollector collector;
+  for (int i = 0; i < 2; ++i) {
+    RunStatsScope outer(&collector, "outer");
+    for (int j = 0; j < 3; ++j) {
+      RunStatsScope inner(&collector, "inner");
+    }
+    RunStatsScope other(&collector, "other");
+  }
+  const ClusteringRunStats stats = std::move(collector).Finish();
+
+  ASSERT_THAT(stats.phases, ElementsAre(Phase("outer", -1), Phase("inner", 0),
+                                        Phase("other", 0)));
+  EXPECT_EQ(stats.phases[0].num_calls, 2);
+  EXPECT_EQ(stats.phases[1].num_calls, 6);
+  EXPECT_EQ(stats.phases[2].num_calls, 2);
+  EXPECT_GE(stats.phases[0].wall_seconds,
+            stats.phases[1].wall_seconds + stats.phases[2].wall_seconds);
+  // Nested phases are sampled like top-level ones.
+  for (const PhaseStats& phase : stats.phases) {
+    EXPECT_GE(phase.cpu_seconds, 0) << phase.name;
+    EXPECT_GT(phase.rss_bytes_begin, 0) << phase.name;
+    EXPECT_GT(phase.rss_bytes_end, 0) << phase.name;
+    EXPECT_GE(phase.peak_rss_bytes, phase.rss_bytes_end) << phase.name;
+    EXPECT_GE(phase.peak_rss_growth_bytes, 0) << phase.name;
+    ExpectCounters(phase, stats.perf_counters_available);
+  }
+}
+
+TEST(RunStatsCollectorTest, SeparatesRepeatedNamesByParent) {
+  RunStatsCollector collector;
+  {
+    RunStatsScope first(&collector, "first");
+    { RunStatsScope shared(&collector, "shared"); }
+    { RunStatsScope shared(&collector, "shared"); }
+  }
+  {
+    RunStatsScope second(&collector, "second");
+    { RunStatsScope shared(&collector, "shared"); }
+  }
+  { RunStatsScope shared(&collector, "shared"); }
+  const ClusteringRunStats stats = std::move(collector).Finish();
+
+  ASSERT_THAT(stats.phases,
+              ElementsAre(Phase("first", -1), Phase("shared", 0),
+                          Phase("second", -1), Phase("shared", 2),
+                          Phase("shared", -1)));
+  EXPECT_EQ(stats.phases[1].num_calls, 2);
+  EXPECT_EQ(stats.phases[3].num_calls, 1);
+  EXPECT_EQ(stats.phases[4].num_calls, 1);
+  EXPECT_THAT(stats.DebugString(), HasSubstr("\n  shared"));
+}
+
+TEST(RunStatsCollectorTest, ReportsPeakRssGrowth) {
+  constexpr std::size_t kNumBytes = 64 << 20;
+  RunStatsCollector collector;
+  {
+    RunStatsScope allocate(&collector, "allocate");
+    auto buffer = std::make_unique<char[]>(kNumBytes);
+    // Touch every page so that it becomes resident.
+    for (std::size_t i = 0; i < kNumBytes; i += 1024) buffer[i] = 1;
+    EXPECT_EQ(buffer[kNumBytes - 1024], 1);
+  }
+  const ClusteringRunStats stats = std::move(collector).Finish();
+  ASSERT_EQ(stats.phases.size(), 1);
+  EXPECT_GE(stats.phases[0].peak_rss_growth_bytes, kNumBytes / 2);
+}
+
+int FailingPerfEventOpen(void*, int, int, int, unsigned long) {
+  errno = EACCES;
+  return -1;
+}
+
+TEST(RunStatsCollectorTest, DegradesGracefullyWithoutPerfEvents) {
+  internal::SetPerfEventOpenFunctionForTesting(FailingPerfEventOpen);
+  RunStatsCollector collector;
+  internal::SetPerfEventOpenFunctionForTesting(nullptr);
+  {
+    RunStatsScope outer(&collector, "outer");
+    RunStatsScope inner(&collector, "inner");
+  }
+  const ClusteringRunStats stats = std::move(collector).Finish();
+
+  EXPECT_FALSE(stats.perf_counters_available);
+  ASSERT_THAT(stats.phases,
+              ElementsAre(Phase("outer", -1), Phase("inner", 0)));
+  for (const PhaseStats& phase : stats.phases) {
+    EXPECT_EQ(phase.num_calls, 1) << phase.name;
+    EXPECT_GE(phase.wall_seconds, 0) << phase.name;
+    EXPECT_GE(phase.cpu_seconds, 0) << phase.name;
+    ExpectCounters(phase, /*perf_counters_available=*/false);
+  }
+  EXPECT_THAT(stats.DebugString(), HasSubstr("outer"));
+}
+
+TEST(RunStatsScopeTest, TracesOnlyWithTracingEnabled) {
+  Tracer& tracer = Tracer::Get();
+  tracer.Start();
+  { RunStatsScope scope(nullptr, "traced"); }
+  tracer.Stop();
+  std::size_t num_events = 0;
+  for (const auto& events : tracer.Events()) num_events += events.size();
+#ifdef GRAPH_MINING_ENABLE_TRACING
+  EXPECT_EQ(num_events, 1);
+#else
+  EXPECT_EQ(num_events, 0);
+#endif
+}
+
+}  // namespace
+}  // namespace graph_mining::in_memory
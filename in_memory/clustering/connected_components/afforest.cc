@@ -0,0 +1,142 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/clustering/connected_components/afforest.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "absl/log/absl_log.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
+#include "gbbs/macros.h"
+#include "in_memory/clustering/config.pb.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/connected_components/asynchronous_union_find.h"
+#include "in_memory/parallel/parallel_sequence_ops.h"
+#include "parlay/monoid.h"
+#include "parlay/parallel.h"
+#include "parlay/primitives.h"
+#include "parlay/sequence.h"
+#include "parlay/utilities.h"
+
+namespace graph_mining::in_memory {
+namespace {
+
+using ::gbbs::uintE;
+
+// Returns the most frequent component id among sampled nodes.
+uintE SampleLargestComponent(AsynchronousUnionFind<uintE>& union_find,
+                             const AfforestOptions& options) {
+  const std::size_t num_nodes = union_find.NumberOfNodes();
+  std::vector<uintE> sample(std::max(1, options.num_component_samples));
+  for (std::size_t i = 0; i < sample.size(); ++i) {
+    sample[i] = union_find.Find(
+        parlay::hash64(parlay::hash64(options.seed) + i) % num_nodes);
+  }
+  std::sort(sample.begin(), sample.end());
+  uintE largest_component = sample[0];
+  std::size_t largest_count = 0;
+  for (std::size_t begin = 0, end = 0; begin < sample.size(); begin = end) {
+    while (end < sample.size() && sample[end] == sample[begin]) ++end;
+    if (end - begin > largest_count) {
+      largest_count = end - begin;
+      largest_component = sample[begin];
+    }
+  }
+  return largest_component;
+}
+
+}  // namespace
+
+AfforestResult AfforestConnectedComponents(const GbbsGraph& graph,
+                                           const AfforestOptions& options) {
+  auto& gbbs_graph = *graph.Graph();
+  const std::size_t num_nodes = gbbs_graph.n;
+  AfforestResult result;
+  if (num_nodes == 0) return result;
+  AsynchronousUnionFind<uintE> union_find(num_nodes);
+  const std::size_t num_neighbor_rounds =
+      std::max(0, options.num_neighbor_rounds);
+
+  // Links the first neighbors round by round, so that the trees stay shallow.
+  for (std::size_t round = 0; round < num_neighbor_rounds; ++round) {
+    parlay::parallel_for(0, num_nodes, [&](std::size_t i) {
+      auto neighbors = gbbs_graph.get_vertex(i).out_neighbors();
+      if (round < neighbors.get_degree()) {
+        union_find.Unite(i, neighbors.get_neighbor(round));
+      }
+    });
+  }
+  // Compresses the trees, so that the Find calls below are cheap.
+  union_find.ComponentIds();
+
+  const uintE largest_component = SampleLargestComponent(union_find, options);
+  auto num_processed_edges = parlay::sequence<std::size_t>::from_function(
+      num_nodes, [&](std::size_t i) -> std::size_t {
+        auto neighbors = gbbs_graph.get_vertex(i).out_neighbors();
+        const std::size_t degree = neighbors.get_degree();
+        if (union_find.Find(i) == largest_component) {
+          return std::min(degree, num_neighbor_rounds);
+        }
+        for (std::size_t j = num_neighbor_rounds; j < degree; ++j) {
+          union_find.Unite(i, neighbors.get_neighbor(j));
+        }
+        return degree;
+      });
+  result.num_edges_processed =
+      parlay::reduce(num_processed_edges, parlay::addm<std::size_t>());
+  result.num_edges_skipped = gbbs_graph.m - result.num_edges_processed;
+  auto component_ids = union_find.ComponentIds();
+  result.component_ids =
+      parlay::sequence<uintE>(component_ids.begin(), component_ids.end());
+  return result;
+}
+
+absl::StatusOr<InMemoryClusterer::Clustering>
+AfforestConnectedComponentsClusterer::Cluster(
+    const ClustererConfig& config) const {
+  if (graph_.Graph() == nullptr) {
+    return absl::FailedPreconditionError(
+        "graph_ must be initialized before clustering.");
+  }
+  const AfforestConfig& afforest_config = config.afforest_clusterer_config();
+  if (afforest_config.num_neighbor_rounds() < 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("num_neighbor_rounds must be non-negative, got ",
+                     afforest_config.num_neighbor_rounds()));
+  }
+  if (afforest_config.num_component_samples() < 1) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("num_component_samples must be positive, got ",
+                     afforest_config.num_component_samples()));
+  }
+  AfforestOptions options;
+  options.num_neighbor_rounds = afforest_config.num_neighbor_rounds();
+  options.num_component_samples = afforest_config.num_component_samples();
+  options.seed = afforest_config.seed();
+  AfforestResult result = AfforestConnectedComponents(graph_, options);
+  ABSL_VLOG(1) << "Afforest processed " << result.num_edges_processed
+               << " edges and skipped " << result.num_edges_skipped;
+  return OutputIndicesById<uintE, NodeId>(
+      absl::MakeConstSpan(result.component_ids),
+      [](NodeId i) { return i; }, result.component_ids.size());
+}
+
+}  // namespace graph_mining::in_memory
@@ -0,0 +1,81 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_CONNECTED_COMPONENTS_AFFOREST_H_
+#define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_CONNECTED_COMPONENTS_AFFOREST_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "absl/status/statusor.h"
+#include "gbbs/macros.h"
+#include "in_memory/clustering/config.pb.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "parlay/sequence.h"
+
+namespace graph_mining::in_memory {
+
+struct AfforestOptions {
+  // Number of neighbors of each node that are linked before the largest
+  // component is identified.
+  int num_neighbor_rounds = 2;
+  // Number of nodes sampled to identify the largest component.
+  int num_component_samples = 1024;
+  // Seed of the node sample.
+  uint64_t seed = 0;
+};
+
+struct AfforestResult {
+  // Component id of each node, which is the minimum node id in its component.
+  parlay::sequence<gbbs::uintE> component_ids;
+  // Number of adjacency list entries (i.e., each undirected edge is counted
+  // twice) that were passed to the union-find structure and that were skipped
+  // because both endpoints were already known to be in the same component.
+  std::size_t num_edges_processed = 0;
+  std::size_t num_edges_skipped = 0;
+};
+
+// Computes the connected components of a pre-built undirected graph with the
+// Afforest algorithm (Sutton et al., IPDPS'18): first, only the first
+// options.num_neighbor_rounds neighbors of each node are linked, which usually
+// connects most of the largest component. The most frequent component in a
+// sample of nodes is then taken as the largest component, and the remaining
+// edges are linked only from nodes outside of it. Because the graph is
+// symmetric, every edge that may connect two different components has an
+// endpoint outside of the largest component, so the skipped edges never
+// change the result.
+AfforestResult AfforestConnectedComponents(
+    const GbbsGraph& graph, const AfforestOptions& options = AfforestOptions());
+
+// Clusterer returning the connected components of a symmetric GbbsGraph, see
+// AfforestConnectedComponents. Unlike ParallelConnectedComponentsClusterer,
+// which links every edge during Import, the graph is loaded first, so most
+// edges of the largest component are never passed to the union-find structure.
+//
+// Uses config.afforest_clusterer_config() to set the AfforestOptions.
+class AfforestConnectedComponentsClusterer : public InMemoryClusterer {
+ public:
+  Graph* MutableGraph() override { return &graph_; }
+
+  absl::StatusOr<Clustering> Cluster(
+      const ClustererConfig& config) const override;
+
+ private:
+  GbbsGraph graph_;
+};
+
+}  // namespace graph_mining::in_memory
+
+#endif  // THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_CONNECTED_COMPONENTS_AFFOREST_H_
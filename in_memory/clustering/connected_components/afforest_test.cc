@@ -0,0 +1,109 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/clustering/connected_components/afforest.h"
+
+#include "absl/status/status.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "in_memory/clustering/config.pb.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/graph.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/status_macros.h"  // IWYU pragma: keep
+
+namespace graph_mining::in_memory {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::UnorderedElementsAre;
+
+// Returns a graph with the components {0, 2, 4, 6, 8} (a star centered at 8
+// plus the edge {0, 2}), {1, 3, 5} (a path) and {7} (an isolated node).
+absl::Status MakeThreeComponents(InMemoryClusterer::Graph* graph) {
+  SimpleUndirectedGraph components;
+  for (int i : {0, 2, 4, 6}) RETURN_IF_ERROR(components.AddEdge(i, 8, 1.0));
+  RETURN_IF_ERROR(components.AddEdge(0, 2, 1.0));
+  RETURN_IF_ERROR(components.AddEdge(5, 3, 1.0));
+  RETURN_IF_ERROR(components.AddEdge(3, 1, 1.0));
+  components.SetNodeWeight(7, 1.0);
+  return CopyGraph(components, graph);
+}
+
+TEST(AfforestTest, ComponentIdsAreMinimumNodeIds) {
+  GbbsGraph graph;
+  ASSERT_OK(MakeThreeComponents(&graph));
+  for (int num_neighbor_rounds : {0, 1, 2, 10}) {
+    AfforestOptions options;
+    options.num_neighbor_rounds = num_neighbor_rounds;
+    options.num_component_samples = 4;
+    const AfforestResult result = AfforestConnectedComponents(graph, options);
+    EXPECT_THAT(result.component_ids, ElementsAre(0, 1, 0, 1, 0, 1, 0, 7, 0))
+        << "num_neighbor_rounds = " << num_neighbor_rounds;
+    // Each of the 7 undirected edges is counted twice.
+    EXPECT_EQ(result.num_edges_processed + result.num_edges_skipped, 14);
+  }
+}
+
+TEST(AfforestTest, ClustererReturnsComponents) {
+  AfforestConnectedComponentsClusterer clusterer;
+  ASSERT_OK(MakeThreeComponents(clusterer.MutableGraph()));
+  ASSERT_OK_AND_ASSIGN(InMemoryClusterer::Clustering clustering,
+                       clusterer.Cluster(ClustererConfig()));
+  EXPECT_THAT(clustering, UnorderedElementsAre(
+                              UnorderedElementsAre(0, 2, 4, 6, 8),
+                              UnorderedElementsAre(1, 3, 5),
+                              UnorderedElementsAre(7)));
+}
+
+TEST(AfforestTest, ClustererUsesConfig) {
+  AfforestConnectedComponentsClusterer clusterer;
+  ASSERT_OK(MakeThreeComponents(clusterer.MutableGraph()));
+  ClustererConfig config;
+  AfforestConfig* afforest_config = config.mutable_afforest_clusterer_config();
+  for (int num_neighbor_rounds : {0, 1, 10}) {
+    afforest_config->set_num_neighbor_rounds(num_neighbor_rounds);
+    afforest_config->set_num_component_samples(1);
+    afforest_config->set_seed(num_neighbor_rounds);
+    ASSERT_OK_AND_ASSIGN(InMemoryClusterer::Clustering clustering,
+                         clusterer.Cluster(config));
+    EXPECT_THAT(clustering, UnorderedElementsAre(
+                                UnorderedElementsAre(0, 2, 4, 6, 8),
+                                UnorderedElementsAre(1, 3, 5),
+                                UnorderedElementsAre(7)))
+        << "num_neighbor_rounds = " << num_neighbor_rounds;
+  }
+}
+
+TEST(AfforestTest, InvalidConfigIsAnError) {
+  AfforestConnectedComponentsClusterer clusterer;
+  ASSERT_OK(MakeThreeComponents(clusterer.MutableGraph()));
+  ClustererConfig config;
+  config.mutable_afforest_clusterer_config()->set_num_neighbor_rounds(-1);
+  EXPECT_EQ(clusterer.Cluster(config).status().code(),
+            absl::StatusCode::kInvalidArgument);
+  config.mutable_afforest_clusterer_config()->set_num_neighbor_rounds(2);
+  config.mutable_afforest_clusterer_config()->set_num_component_samples(0);
+  EXPECT_EQ(clusterer.Cluster(config).status().code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+TEST(AfforestTest, UninitializedGraphIsAnError) {
+  AfforestConnectedComponentsClusterer clusterer;
+  EXPECT_EQ(clusterer.Cluster(ClustererConfig()).status().code(),
+            absl::StatusCode::kFailedPrecondition);
+}
+
+}  // namespace
+}  // namespace graph_mining::in_memory
@@ -25,6 +25,7 @@
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "in_memory/clustering/clustering_run_stats.h"
 #include "in_memory/clustering/config.pb.h"
 #include "in_memory/clustering/correlation/parallel_correlation_util.h"
 #include "in_memory/clustering/in_memory_clusterer.h"
@@ -229,12 +230,13 @@ std::unique_ptr<gbbs::vertexSubset> BestMovesForVertexSubset(
 // until a stable state is achieved, i.e. no vertices desire to change
 // clusters). Stores the cluster that gives the maximum objective, as compared
 // to max_objective, in local_cluster_ids, and returns the maximum objective
-// achieved.
+// achieved. The iterations are recorded in stats, unless it is nullptr.
 double IterateBestMoves(
     gbbs::symmetric_ptr_graph<gbbs::symmetric_vertex, float>* current_graph,
     ClusteringHelper* helper, std::vector<gbbs::uintE>& local_cluster_ids,
     double max_objective, int num_inner_iterations,
-    const ClustererConfig& clusterer_config) {
+    const ClustererConfig& clusterer_config, RunStatsCollector* stats) {
+  RunStatsScope best_moves_scope(stats, "Correlation/BestMoves");
   const auto num_nodes = current_graph->n;
   bool local_moved = true;
   auto seq = gbbs::sequence<bool>(num_nodes, true);
@@ -269,8 +271,7 @@ double IterateBestMoves(
 absl::Status ParallelCorrelationClusterer::RefineClusters(
     const ClustererConfig& clusterer_config,
     InMemoryClusterer::Clustering* initial_clustering,
-    ClusteringHelper* initial_helper) const {
-  
+    ClusteringHelper* initial_helper, RunStatsCollector* stats) const {
   using symmetric_ptr_graph =
       gbbs::symmetric_ptr_graph<gbbs::symmetric_vertex, float>;
 
@@ -370,6 +371,7 @@ absl::Status ParallelCorrelationClusterer::RefineClusters(
   int iter;
   for (iter = 0; iter < num_iterations; ++iter) {
     ABSL_LOG(INFO) << "Clustering iteration " << iter;
+    RunStatsScope iteration_scope(stats, "Correlation/Iteration");
     symmetric_ptr_graph* current_graph =
         (iter == 0) ? graph_.Graph() : compressed_graph.get();
     auto helper = (iter == 0) ? initial_helper : current_helper.get();
@@ -379,7 +381,8 @@ absl::Status ParallelCorrelationClusterer::RefineClusters(
     // IterateBestMoves.
     auto new_objective =
         IterateBestMoves(current_graph, helper, local_cluster_ids,
-                         max_objective, num_inner_iterations, clusterer_config);
+                         max_objective, num_inner_iterations, clusterer_config,
+                         stats);
 
     // If no moves can be made at all, exit.
     // Note that the objective is comparable across different levels, as the
@@ -437,13 +440,16 @@ absl::Status ParallelCorrelationClusterer::RefineClusters(
     }
 
     graph_mining::in_memory::GraphWithWeights new_compressed_graph;
-    ASSIGN_OR_RETURN(
-        new_compressed_graph,
-        CompressGraph(*current_graph,
-                      config.use_bipartite_objective()
-                          ? bipartite_metadata.node_id_to_new_node_ids
-                          : local_cluster_ids,
-                      *helper));
+    {
+      RunStatsScope compress_scope(stats, "Correlation/Compress");
+      ASSIGN_OR_RETURN(
+          new_compressed_graph,
+          CompressGraph(*current_graph,
+                        config.use_bipartite_objective()
+                            ? bipartite_metadata.node_id_to_new_node_ids
+                            : local_cluster_ids,
+                        *helper));
+    }
     compressed_graph.swap(new_compressed_graph.graph);
     if (use_refinement) {
       recursive_cluster_ids[iter] = local_cluster_ids;
@@ -479,6 +485,7 @@ absl::Status ParallelCorrelationClusterer::RefineClusters(
 
   // Perform multi-level refinement
   if (use_refinement && iter > 0) {
+    RunStatsScope refinement_scope(stats, "Correlation/Refinement");
     cluster_ids = recursive_cluster_ids[iter];
     for (int i = iter - 1; i >= 0; --i) {
       symmetric_ptr_graph* current_graph =
@@ -502,9 +509,9 @@ absl::Status ParallelCorrelationClusterer::RefineClusters(
                                       recursive_node_weights[i],
                                       recursive_node_parts[i]);
 
-      max_objective = IterateBestMoves(current_graph, initial_helper,
-                                       flattened_cluster_ids, max_objective,
-                                       num_inner_iterations, clusterer_config);
+      max_objective = IterateBestMoves(
+          current_graph, initial_helper, flattened_cluster_ids, max_objective,
+          num_inner_iterations, clusterer_config, stats);
 
       cluster_ids = std::move(flattened_cluster_ids);
 
@@ -528,18 +535,40 @@ absl::Status ParallelCorrelationClusterer::RefineClusters(
 absl::Status ParallelCorrelationClusterer::RefineClusters(
     const ClustererConfig& clusterer_config,
     InMemoryClusterer::Clustering* initial_clustering) const {
-  
+  return RefineClustersImpl(clusterer_config, initial_clustering,
+                            /*stats=*/nullptr);
+}
+
+absl::Status ParallelCorrelationClusterer::RefineClustersImpl(
+    const ClustererConfig& clusterer_config,
+    InMemoryClusterer::Clustering* initial_clustering,
+    RunStatsCollector* stats) const {
   // Initialize clustering helper
   ClusteringHelper helper{static_cast<NodeId>(graph_.Graph()->n),
                           clusterer_config, *initial_clustering,
                           graph_.GetNodeParts()};
-  return RefineClusters(clusterer_config, initial_clustering, &helper);
+  return RefineClusters(clusterer_config, initial_clustering, &helper, stats);
 }
 
 absl::StatusOr<InMemoryClusterer::Clustering>
 ParallelCorrelationClusterer::Cluster(
     const ClustererConfig& clusterer_config) const {
-  
+  return ClusterImpl(clusterer_config, /*stats=*/nullptr);
+}
+
+absl::StatusOr<ClusteringWithStats>
+ParallelCorrelationClusterer::ClusterWithStats(
+    const ClustererConfig& clusterer_config) const {
+  RunStatsCollector stats;
+  ASSIGN_OR_RETURN(Clustering clustering,
+                   ClusterImpl(clusterer_config, &stats));
+  return ClusteringWithStats{std::move(clustering), std::move(stats).Finish()};
+}
+
+absl::StatusOr<InMemoryClusterer::Clustering>
+ParallelCorrelationClusterer::ClusterImpl(
+    const ClustererConfig& clusterer_config, RunStatsCollector* stats) const {
+  RunStatsScope cluster_scope(stats, "Correlation/Cluster");
   InMemoryClusterer::Clustering clustering(graph_.Graph()->n);
 
   // Create all-singletons initial clustering
@@ -547,7 +576,7 @@ ParallelCorrelationClusterer::Cluster(
     clustering[i] = {static_cast<int32_t>(i)};
   });
 
-  RETURN_IF_ERROR(RefineClusters(clusterer_config, &clustering));
+  RETURN_IF_ERROR(RefineClustersImpl(clusterer_config, &clustering, stats));
 
   return clustering;
 }
@@ -16,6 +16,7 @@
 #define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_CORRELATION_PARALLEL_CORRELATION_H_
 
 #include "absl/status/statusor.h"
+#include "in_memory/clustering/clustering_run_stats.h"
 #include "in_memory/clustering/correlation/parallel_correlation_util.h"
 #include "in_memory/clustering/gbbs_graph.h"
 #include "in_memory/clustering/in_memory_clusterer.h"
@@ -37,6 +38,11 @@ class ParallelCorrelationClusterer : public InMemoryClusterer {
   absl::StatusOr<Clustering> Cluster(
       const graph_mining::in_memory::ClustererConfig& config) const override;
 
+  // Same as Cluster(), but also returns the resource usage of the phases of the
+  // run (see clustering_run_stats.h).
+  absl::StatusOr<ClusteringWithStats> ClusterWithStats(
+      const graph_mining::in_memory::ClustererConfig& config) const;
+
   // initial_clustering must include every node in the range
   // [0, MutableGraph().NumNodes()) exactly once.
   absl::Status RefineClusters(
@@ -46,10 +52,24 @@ class ParallelCorrelationClusterer : public InMemoryClusterer {
  protected:
   graph_mining::in_memory::GbbsGraph graph_;
 
+  // Implements RefineClusters() and is called by Cluster() and
+  // ClusterWithStats(). The phases of the run are recorded in stats, unless it
+  // is nullptr.
+  virtual absl::Status RefineClustersImpl(
+      const graph_mining::in_memory::ClustererConfig& clusterer_config,
+      Clustering* initial_clustering, RunStatsCollector* stats) const;
+
   absl::Status RefineClusters(
       const graph_mining::in_memory::ClustererConfig& clusterer_config,
       InMemoryClusterer::Clustering* initial_clustering,
-      ClusteringHelper* initial_helper) const;
+      ClusteringHelper* initial_helper,
+      RunStatsCollector* stats = nullptr) const;
+
+ private:
+  // Refines the all-singletons clustering. stats may be nullptr.
+  absl::StatusOr<Clustering> ClusterImpl(
+      const graph_mining::in_memory::ClustererConfig& config,
+      RunStatsCollector* stats) const;
 };
 
 }  // namespace graph_mining::in_memory
@@ -67,9 +67,16 @@ ParallelModularityClusterer::Cluster(const ClustererConfig& config) const {
 absl::Status ParallelModularityClusterer::RefineClusters(
     const ClustererConfig& clusterer_config,
     Clustering* initial_clustering) const {
+  return RefineClustersImpl(clusterer_config, initial_clustering,
+                            /*stats=*/nullptr);
+}
+
+absl::Status ParallelModularityClusterer::RefineClustersImpl(
+    const ClustererConfig& clusterer_config, Clustering* initial_clustering,
+    RunStatsCollector* stats) const {
   if (clusterer_config.has_correlation_clusterer_config()) {
-    return ParallelCorrelationClusterer::RefineClusters(clusterer_config,
-                                                        initial_clustering);
+    return ParallelCorrelationClusterer::RefineClustersImpl(
+        clusterer_config, initial_clustering, stats);
   }
 
   // Set modularity clustering config
@@ -88,7 +95,7 @@ absl::Status ParallelModularityClusterer::RefineClusters(
                           std::move(node_weights_total_weight.node_weights),
                           *initial_clustering, graph_.GetNodeParts()};
   return ParallelCorrelationClusterer::RefineClusters(
-      modularity_config, initial_clustering, &helper);
+      modularity_config, initial_clustering, &helper, stats);
 }
 
 }  // namespace graph_mining::in_memory
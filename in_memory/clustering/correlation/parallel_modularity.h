@@ -15,6 +15,7 @@
 #ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_CORRELATION_PARALLEL_MODULARITY_INTERNAL_H_
 #define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_CORRELATION_PARALLEL_MODULARITY_INTERNAL_H_
 
+#include "in_memory/clustering/clustering_run_stats.h"
 #include "in_memory/clustering/config.pb.h"
 #include "in_memory/clustering/in_memory_clusterer.h"
 #include "absl/status/status.h"
@@ -45,6 +46,11 @@ class ParallelModularityClusterer : public ParallelCorrelationClusterer {
   absl::Status RefineClusters(
       const graph_mining::in_memory::ClustererConfig& clusterer_config,
       Clustering* initial_clustering) const override;
+
+ protected:
+  absl::Status RefineClustersImpl(
+      const graph_mining::in_memory::ClustererConfig& clusterer_config,
+      Clustering* initial_clustering, RunStatsCollector* stats) const override;
 };
 
 }  // namespace graph_mining::in_memory
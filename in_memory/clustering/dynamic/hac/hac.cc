@@ -41,6 +41,7 @@
 #include "in_memory/clustering/hac/subgraph/approximate_subgraph_hac.h"
 #include "in_memory/clustering/in_memory_clusterer.h"
 #include "in_memory/clustering/types.h"
+#include "in_memory/parallel/tracing.h"
 #include "in_memory/status_macros.h"
 #include "utils/timer.h"
 
@@ -232,6 +233,7 @@ absl::StatusOr<UpdateStats> DynamicHacClusterer::Modify(
   std::size_t total_num_dirty_edge = 0;
   std::size_t total_num_nodes_ignored = 0;
 
+  GRAPH_MINING_TRACE_SCOPE("DynamicHac/Modify");
   WallTimer total_timer;
   total_timer.Restart();
   WallTimer timer;
@@ -259,12 +261,16 @@ absl::StatusOr<UpdateStats> DynamicHacClusterer::Modify(
 
   int empty_rounds = 0;
   int consecutive_empty_rounds = 0;
-  auto log_time = [&](std::string msg) {
-    ABSL_VLOG(0) << msg << " Time: " << timer.GetSeconds() << " seconds";
+  // `msg` is also the name of the traced phase, so it must be a string literal.
+  auto log_time = [&](const char* msg) {
+    const double seconds = timer.GetSeconds();
+    ABSL_VLOG(0) << msg << " Time: " << seconds << " seconds";
+    GRAPH_MINING_TRACE_ELAPSED(msg, seconds);
     timer.Restart();
   };
 
   while (true) {
+    GRAPH_MINING_TRACE_SCOPE("DynamicHac/Round");
     WallTimer round_timer;
     round_timer.Restart();
     if (round + 1 >= RoundNumber()) {
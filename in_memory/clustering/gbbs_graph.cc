@@ -15,18 +15,23 @@
 #include "in_memory/clustering/gbbs_graph.h"
 
 #include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <functional>
 #include <utility>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
 #include "gbbs/bridge.h"
 #include "gbbs/graph.h"
 #include "gbbs/macros.h"
 #include "gbbs/vertex.h"
+#include "in_memory/clustering/sorted_intersection.h"
 #include "utils/status/thread_safe_status.h"
 #include "parlay/parallel.h"
+#include "parlay/primitives.h"
+#include "parlay/sequence.h"
 
 namespace graph_mining::in_memory {
 
@@ -54,6 +59,88 @@ absl::Status GbbsGraph::ReweightGraph(
   return status.status();
 }
 
+absl::Status GbbsGraph::ReweightByNeighborhoodSimilarity(
+    NeighborhoodSimilarity similarity) {
+  const std::size_t num_nodes = nodes_.size();
+  // The neighborhood of node i without self-loops and parallel edges is
+  // neighbor_ids[offsets[i]], ..., neighbor_ids[offsets[i] + degrees[i] - 1],
+  // sorted by id.
+  auto offsets = parlay::sequence<std::size_t>::from_function(
+      num_nodes, [&](std::size_t i) -> std::size_t {
+        return nodes_[i].out_degree();
+      });
+  const std::size_t num_edges = parlay::scan_inplace(offsets);
+  auto neighbor_ids = parlay::sequence<gbbs::uintE>::uninitialized(num_edges);
+  auto degrees = parlay::sequence<gbbs::uintE>::uninitialized(num_nodes);
+  parlay::parallel_for(0, num_nodes, [&](std::size_t i) {
+    gbbs::uintE* begin = neighbor_ids.data() + offsets[i];
+    gbbs::uintE* end = begin;
+    for (std::size_t j = 0; j < nodes_[i].out_degree(); ++j) {
+      const gbbs::uintE neighbor_id = std::get<0>(edges_[i][j]);
+      if (neighbor_id != i) *end++ = neighbor_id;
+    }
+    std::sort(begin, end);
+    degrees[i] = std::unique(begin, end) - begin;
+  });
+  auto num_common_neighbors = [&](gbbs::uintE u, gbbs::uintE v) {
+    return SortedIntersectionSize(
+        absl::MakeConstSpan(neighbor_ids.data() + offsets[u], degrees[u]),
+        absl::MakeConstSpan(neighbor_ids.data() + offsets[v], degrees[v]));
+  };
+
+  // Index of the edge {u, v} in neighbor_ids.
+  auto edge_index = [&](gbbs::uintE u, gbbs::uintE v) -> std::size_t {
+    const gbbs::uintE* begin = neighbor_ids.data() + offsets[u];
+    return std::lower_bound(begin, begin + degrees[u], v) -
+           neighbor_ids.data();
+  };
+
+  // Takes the similarity as a template argument so that it is inlined. As the
+  // graph is symmetric, the similarity of every edge {u, v} is computed once
+  // for u < v and looked up for both directions, which also covers parallel
+  // edges.
+  auto reweight = [&](auto edge_similarity) {
+    auto similarities = parlay::sequence<float>::uninitialized(num_edges);
+    parlay::parallel_for(0, num_nodes, [&](std::size_t i) {
+      for (std::size_t k = offsets[i]; k < offsets[i] + degrees[i]; ++k) {
+        if (neighbor_ids[k] > i) {
+          similarities[k] = edge_similarity(i, neighbor_ids[k]);
+        }
+      }
+    });
+    parlay::parallel_for(0, num_nodes, [&](std::size_t i) {
+      for (std::size_t j = 0; j < nodes_[i].out_degree(); ++j) {
+        auto& [neighbor_id, weight] = edges_[i][j];
+        if (neighbor_id == i) continue;
+        weight = similarities[neighbor_id > i ? edge_index(i, neighbor_id)
+                                              : edge_index(neighbor_id, i)];
+      }
+    });
+  };
+  switch (similarity) {
+    case NeighborhoodSimilarity::kJaccard:
+      // Both endpoints are in the intersection of the closed neighborhoods.
+      reweight([&](gbbs::uintE u, gbbs::uintE v) -> float {
+        const double num_common = num_common_neighbors(u, v) + 2.0;
+        return num_common /
+               (degrees[u] + 1.0 + degrees[v] + 1.0 - num_common);
+      });
+      return absl::OkStatus();
+    case NeighborhoodSimilarity::kCosine:
+      reweight([&](gbbs::uintE u, gbbs::uintE v) -> float {
+        return (num_common_neighbors(u, v) + 2.0) /
+               std::sqrt((degrees[u] + 1.0) * (degrees[v] + 1.0));
+      });
+      return absl::OkStatus();
+    case NeighborhoodSimilarity::kTriangleCount:
+      reweight([&](gbbs::uintE u, gbbs::uintE v) -> float {
+        return num_common_neighbors(u, v);
+      });
+      return absl::OkStatus();
+  }
+  return absl::InvalidArgumentError("Unknown neighborhood similarity");
+}
+
 absl::Status UnweightedSortedNeighborGbbsGraph::Import(
     AdjacencyList adjacency_list) {
   std::sort(adjacency_list.outgoing_edges.begin(),
@@ -29,6 +29,7 @@
 #include "in_memory/clustering/in_memory_clusterer.h"
 #include "in_memory/clustering/types.h"
 #include "in_memory/parallel/scheduler.h"
+#include "in_memory/parallel/tracing.h"
 
 namespace graph_mining::in_memory {
 
@@ -132,6 +133,33 @@ class GbbsGraph
           gbbs::uintE node_id, gbbs::uintE neighbor_id, std::size_t node_degree,
           std::size_t neighbor_degree, float current_edge_weight)>&
           edge_reweighter);
+
+  // Similarities of the neighborhoods of the endpoints of an edge {u, v}, see
+  // ReweightByNeighborhoodSimilarity. N(u) is the set of neighbors of u and
+  // N[u] = N(u) + {u} is its closed neighborhood.
+  enum class NeighborhoodSimilarity {
+    // |N[u] & N[v]| / |N[u] | N[v]|.
+    kJaccard,
+    // |N[u] & N[v]| / sqrt(|N[u]| * |N[v]|).
+    kCosine,
+    // |N(u) & N(v)|, i.e., the number of triangles containing the edge.
+    kTriangleCount,
+  };
+
+  // Sets the weight of every edge {u, v} with u != v to the given similarity
+  // of the neighborhoods of u and v. The closed neighborhoods make the Jaccard
+  // and cosine similarities of adjacent nodes positive. Edge weights,
+  // self-loops and parallel edges are ignored when computing the
+  // neighborhoods, and self-loops keep their weights. The graph must be
+  // symmetric.
+  //
+  // Every neighbor list is first copied once, without self-loops and parallel
+  // edges, and sorted. The similarity of every undirected edge {u, v} is then
+  // computed once by merging the copies of N(u) and N(v) (see
+  // SortedIntersectionSize). Must be called after FinishImport, and has the
+  // same synchronization requirements as ReweightGraph.
+  absl::Status ReweightByNeighborhoodSimilarity(
+      NeighborhoodSimilarity similarity);
 };
 
 // Directed unweighted graph. The resulting graph has only its out-neighbors
@@ -303,7 +331,7 @@ absl::Status GbbsGraphBase<GraphType>::Import(AdjacencyList adjacency_list) {
 
 template <typename GraphType>
 absl::Status GbbsGraphBase<GraphType>::FinishImport() {
-  
+  GRAPH_MINING_TRACE_SCOPE("GbbsGraph/FinishImport");
   auto degrees = parlay::delayed_seq<std::size_t>(
       nodes_.size(), [this](size_t i) { return nodes_[i].out_degree(); });
   auto num_edges = parlay::reduce(parlay::make_slice(degrees));
@@ -0,0 +1,108 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/clustering/gbbs_graph.h"
+
+#include <cmath>
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "gbbs/macros.h"
+#include "in_memory/clustering/gbbs_graph_test_utils.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/status_macros.h"  // IWYU pragma: keep
+
+namespace graph_mining::in_memory {
+namespace {
+
+using Neighbors = std::vector<std::vector<std::tuple<gbbs::uintE, float>>>;
+using NeighborhoodSimilarity = GbbsGraph::NeighborhoodSimilarity;
+
+// Builds the graph with the triangle 0, 1, 2 and the path 2 - 3 - 4. The edge
+// {0, 1} is imported twice, and node 3 has a self-loop of weight 5.
+absl::Status ImportTriangleWithPath(GbbsGraph& graph) {
+  const Neighbors neighbors = {{{1, 1}, {1, 1}, {2, 1}},
+                               {{0, 1}, {0, 1}, {2, 1}},
+                               {{0, 1}, {1, 1}, {3, 1}},
+                               {{2, 1}, {3, 5}, {4, 1}},
+                               {{3, 1}}};
+  RETURN_IF_ERROR(graph.PrepareImport(neighbors.size()));
+  for (std::size_t i = 0; i < neighbors.size(); ++i) {
+    InMemoryClusterer::AdjacencyList adjacency_list;
+    adjacency_list.id = i;
+    for (const auto& [neighbor_id, weight] : neighbors[i]) {
+      adjacency_list.outgoing_edges.emplace_back(neighbor_id, weight);
+    }
+    RETURN_IF_ERROR(graph.Import(std::move(adjacency_list)));
+  }
+  return graph.FinishImport();
+}
+
+// Returns the neighbors of ImportTriangleWithPath with the given weights of
+// the edges {0, 1}, {0, 2}, {1, 2}, {2, 3} and {3, 4}.
+Neighbors TriangleWithPathNeighbors(float w01, float w02, float w12, float w23,
+                                    float w34) {
+  return {{{1, w01}, {1, w01}, {2, w02}},
+          {{0, w01}, {0, w01}, {2, w12}},
+          {{0, w02}, {1, w12}, {3, w23}},
+          {{2, w23}, {3, 5}, {4, w34}},
+          {{3, w34}}};
+}
+
+// The closed neighborhoods, without the self-loop and the parallel edge, are
+// N[0] = {0, 1, 2}, N[1] = {0, 1, 2}, N[2] = {0, 1, 2, 3}, N[3] = {2, 3, 4} and
+// N[4] = {3, 4}.
+
+TEST(GbbsGraphTest, ReweightByJaccardSimilarity) {
+  GbbsGraph graph;
+  ASSERT_OK(ImportTriangleWithPath(graph));
+  ASSERT_OK(
+      graph.ReweightByNeighborhoodSimilarity(NeighborhoodSimilarity::kJaccard));
+  CheckGbbsGraph(graph.Graph(), 5,
+                 TriangleWithPathNeighbors(
+                     /*w01=*/3.0 / 3, /*w02=*/3.0 / 4, /*w12=*/3.0 / 4,
+                     /*w23=*/2.0 / 5, /*w34=*/2.0 / 3));
+}
+
+TEST(GbbsGraphTest, ReweightByCosineSimilarity) {
+  GbbsGraph graph;
+  ASSERT_OK(ImportTriangleWithPath(graph));
+  ASSERT_OK(
+      graph.ReweightByNeighborhoodSimilarity(NeighborhoodSimilarity::kCosine));
+  CheckGbbsGraph(graph.Graph(), 5,
+                 TriangleWithPathNeighbors(
+                     /*w01=*/3.0 / std::sqrt(3.0 * 3.0),
+                     /*w02=*/3.0 / std::sqrt(3.0 * 4.0),
+                     /*w12=*/3.0 / std::sqrt(3.0 * 4.0),
+                     /*w23=*/2.0 / std::sqrt(4.0 * 3.0),
+                     /*w34=*/2.0 / std::sqrt(3.0 * 2.0)));
+}
+
+TEST(GbbsGraphTest, ReweightByTriangleCount) {
+  GbbsGraph graph;
+  ASSERT_OK(ImportTriangleWithPath(graph));
+  ASSERT_OK(graph.ReweightByNeighborhoodSimilarity(
+      NeighborhoodSimilarity::kTriangleCount));
+  CheckGbbsGraph(graph.Graph(), 5,
+                 TriangleWithPathNeighbors(/*w01=*/1, /*w02=*/1, /*w12=*/1,
+                                           /*w23=*/0, /*w34=*/0));
+}
+
+}  // namespace
+}  // namespace graph_mining::in_memory
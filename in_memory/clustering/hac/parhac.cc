@@ -23,6 +23,7 @@
 #include "absl/status/statusor.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "in_memory/clustering/clustering_run_stats.h"
 #include "in_memory/clustering/clustering_utils.h"
 #include "in_memory/clustering/config.pb.h"
 #include "in_memory/clustering/dendrogram.h"
@@ -34,6 +35,8 @@
 #include "in_memory/clustering/parallel_clustered_graph_internal.h"
 #include "in_memory/parallel/parallel_graph_utils.h"
 #include "in_memory/parallel/scheduler.h"
+#include "in_memory/parallel/tracing.h"
+#include "in_memory/status_macros.h"
 
 using ::graph_mining::in_memory::ClustererConfig;
 
@@ -42,7 +45,9 @@ namespace graph_mining::in_memory {
 template <typename ClusteredGraph>
 void ParHacClusterer::ParHacImplementation(ClusteredGraph& clustered_graph,
                                            double epsilon,
-                                           double linkage_threshold) const {
+                                           double linkage_threshold,
+                                           RunStatsCollector* stats) const {
+  RunStatsScope merge_scope(stats, "ParHac/Merge");
   size_t num_active = clustered_graph.NumNodes();
 
   size_t num_inner_rounds = 0;
@@ -62,20 +67,24 @@ void ParHacClusterer::ParHacImplementation(ClusteredGraph& clustered_graph,
     // whenever we compute it, and only recompute whenever edges incident to
     // this node are modified.
     auto lower_threshold_start = absl::Now();
-    parlay::parallel_for(0, clustered_graph.NumNodes(), [&](size_t i) {
-      if (clustered_graph.MutableNode(i)->IsActive()) {
-        auto [id, similarity] = clustered_graph.MutableNode(i)->BestEdge();
-        if (id != UINT_E_MAX && similarity > max_weight) {
-          gbbs::write_max(&max_weight, similarity);
+    {
+      RunStatsScope max_weight_scope(stats, "ParHac/MaxWeight");
+      parlay::parallel_for(0, clustered_graph.NumNodes(), [&](size_t i) {
+        if (clustered_graph.MutableNode(i)->IsActive()) {
+          auto [id, similarity] = clustered_graph.MutableNode(i)->BestEdge();
+          if (id != UINT_E_MAX && similarity > max_weight) {
+            gbbs::write_max(&max_weight, similarity);
+          }
         }
-      }
-    });
+      });
+    }
     double lower_threshold_time =
         absl::ToDoubleSeconds(absl::Now() - lower_threshold_start);
     ABSL_LOG(INFO) << "Compute lower_threshold time " << lower_threshold_time;
     total_lower_threshold_time += lower_threshold_time;
     if (max_weight == 0 || max_weight < linkage_threshold) break;
 
+    RunStatsScope process_bucket_scope(stats, "ParHac/ProcessBucket");
     auto [num_merged, inner_rounds] = ProcessHacBucketRandomized(
         clustered_graph, max_weight / (1 + epsilon), epsilon);
     num_inner_rounds += inner_rounds;
@@ -95,7 +104,19 @@ void ParHacClusterer::ParHacImplementation(ClusteredGraph& clustered_graph,
 
 absl::StatusOr<ParHacClusterer::Clustering> ParHacClusterer::Cluster(
     const ClustererConfig& config) const {
-  
+  return ClusterImpl(config, /*stats=*/nullptr);
+}
+
+absl::StatusOr<ClusteringWithStats> ParHacClusterer::ClusterWithStats(
+    const ClustererConfig& config) const {
+  RunStatsCollector stats;
+  ASSIGN_OR_RETURN(Clustering clustering, ClusterImpl(config, &stats));
+  return ClusteringWithStats{std::move(clustering), std::move(stats).Finish()};
+}
+
+absl::StatusOr<ParHacClusterer::Clustering> ParHacClusterer::ClusterImpl(
+    const ClustererConfig& config, RunStatsCollector* stats) const {
+  RunStatsScope cluster_scope(stats, "ParHac/Cluster");
   using Graph = gbbs::symmetric_ptr_graph<gbbs::symmetric_vertex, float>;
   Graph* input_graph = graph_.Graph();
 
@@ -106,14 +127,15 @@ absl::StatusOr<ParHacClusterer::Clustering> ParHacClusterer::Cluster(
     epsilon = config.parhac_clusterer_config().epsilon();
   }
 
-  ParHacImplementation(clustered_graph, epsilon, weight_threshold);
+  ParHacImplementation(clustered_graph, epsilon, weight_threshold, stats);
+  RunStatsScope flatten_scope(stats, "ParHac/Flatten");
   return graph_mining::in_memory::ClusterIdsToClustering(
       clustered_graph.GetDendrogram()->GetSubtreeClustering(weight_threshold));
 }
 
 absl::StatusOr<Dendrogram> ParHacClusterer::HierarchicalCluster(
     const ClustererConfig& config) const {
-  
+  GRAPH_MINING_TRACE_SCOPE("ParHac/HierarchicalCluster");
   using Graph = gbbs::symmetric_ptr_graph<gbbs::symmetric_vertex, float>;
   Graph* input_graph = graph_.Graph();
   size_t num_nodes = input_graph->num_vertices();
@@ -125,8 +147,10 @@ absl::StatusOr<Dendrogram> ParHacClusterer::HierarchicalCluster(
     epsilon = config.parhac_clusterer_config().epsilon();
   }
 
-  ParHacImplementation(clustered_graph, epsilon, weight_threshold);
+  ParHacImplementation(clustered_graph, epsilon, weight_threshold,
+                       /*stats=*/nullptr);
 
+  GRAPH_MINING_TRACE_SCOPE("ParHac/ConvertDendrogram");
   // Convert from a parallel_dendrogram to a dendrogram. This is a stop-gap
   // measure until we unify parallel-dendrogram in //r/g/ and dendrogram in
   // //third_party/graph_mining.
@@ -23,6 +23,7 @@
 #include "absl/status/statusor.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "in_memory/clustering/clustering_run_stats.h"
 #include "in_memory/clustering/clustering_utils.h"
 #include "in_memory/clustering/config.pb.h"
 #include "in_memory/clustering/dendrogram.h"
@@ -45,6 +46,11 @@ class ParHacClusterer : public InMemoryClusterer {
       const ::graph_mining::in_memory::ClustererConfig& config)
       const override;
 
+  // Same as Cluster(), but also returns the resource usage of the phases of the
+  // run (see clustering_run_stats.h).
+  absl::StatusOr<ClusteringWithStats> ClusterWithStats(
+      const ::graph_mining::in_memory::ClustererConfig& config) const;
+
   absl::StatusOr<Dendrogram> HierarchicalCluster(
       const ::graph_mining::in_memory::ClustererConfig& config)
       const override;
@@ -52,6 +58,11 @@ class ParHacClusterer : public InMemoryClusterer {
  private:
   GbbsGraph graph_;
 
+  // Implements Cluster() and ClusterWithStats(). stats may be nullptr.
+  absl::StatusOr<Clustering> ClusterImpl(
+      const ::graph_mining::in_memory::ClustererConfig& config,
+      RunStatsCollector* stats) const;
+
   // Runs the ParHac algorithm described in go/parhac-paper. The algorithm
   // computes a (1+epsilon)^2 approximate clustering, which means that when a
   // node v is merged to a node w, the similarity of this (v, w) edge is within
@@ -69,9 +80,12 @@ class ParHacClusterer : public InMemoryClusterer {
   // Within each bucket, the algorithm runs a randomized sub-routine,
   // ProcessHacBucketRandomized, which is described in detail in
   // parhac-internal.h.
+  //
+  // The phases of the algorithm are recorded in stats, unless it is nullptr.
   template <typename ClusteredGraph>
   void ParHacImplementation(ClusteredGraph& clustered_graph, double epsilon,
-                            double linkage_threshold) const;
+                            double linkage_threshold,
+                            RunStatsCollector* stats) const;
 };
 
 }  // namespace graph_mining::in_memory
@@ -0,0 +1,221 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/clustering/hac/single_linkage.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "absl/log/absl_log.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "gbbs/bridge.h"
+#include "gbbs/macros.h"
+#include "in_memory/clustering/config.pb.h"
+#include "in_memory/clustering/dendrogram.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/connected_components/asynchronous_union_find.h"
+#include "in_memory/parallel/parallel_sequence_ops.h"
+#include "in_memory/status_macros.h"
+#include "parlay/parallel.h"
+#include "parlay/primitives.h"
+#include "parlay/sequence.h"
+
+namespace graph_mining::in_memory {
+namespace {
+
+constexpr std::size_t kNoEdge = std::numeric_limits<std::size_t>::max();
+
+// Returns the entries (u, v, w) with u < v and w > 0 of all adjacency lists,
+// ordered by u and then by the position of v in the adjacency list of u.
+parlay::sequence<SpanningForestEdge> PositiveEdges(const GbbsGraph& graph) {
+  auto& gbbs_graph = *graph.Graph();
+  const std::size_t num_nodes = gbbs_graph.n;
+  auto offsets = parlay::sequence<std::size_t>::from_function(
+      num_nodes + 1, [&](std::size_t u) -> std::size_t {
+        if (u == num_nodes) return 0;
+        auto neighbors = gbbs_graph.get_vertex(u).out_neighbors();
+        std::size_t count = 0;
+        for (std::size_t j = 0; j < neighbors.get_degree(); ++j) {
+          count += neighbors.get_neighbor(j) > u && neighbors.get_weight(j) > 0;
+        }
+        return count;
+      });
+  const std::size_t num_edges = parlay::scan_inplace(offsets);
+  auto edges = parlay::sequence<SpanningForestEdge>::uninitialized(num_edges);
+  parlay::parallel_for(0, num_nodes, [&](std::size_t u) {
+    auto neighbors = gbbs_graph.get_vertex(u).out_neighbors();
+    std::size_t position = offsets[u];
+    for (std::size_t j = 0; j < neighbors.get_degree(); ++j) {
+      const gbbs::uintE v = neighbors.get_neighbor(j);
+      const float weight = neighbors.get_weight(j);
+      if (v > u && weight > 0) {
+        edges[position++] = {static_cast<gbbs::uintE>(u), v, weight};
+      }
+    }
+  });
+  return edges;
+}
+
+// Returns the clustering given by the connected components of the forest edges
+// with weight at least weight_threshold.
+InMemoryClusterer::Clustering CutSpanningForest(
+    const parlay::sequence<SpanningForestEdge>& forest, std::size_t num_nodes,
+    double weight_threshold) {
+  AsynchronousUnionFind<gbbs::uintE> components(num_nodes);
+  parlay::parallel_for(0, forest.size(), [&](std::size_t i) {
+    const auto& [node_a, node_b, weight] = forest[i];
+    if (weight >= weight_threshold) components.Unite(node_a, node_b);
+  });
+  return OutputIndicesById<gbbs::uintE, InMemoryClusterer::NodeId>(
+      components.ComponentIds(),
+      [](InMemoryClusterer::NodeId i) { return i; },
+      static_cast<InMemoryClusterer::NodeId>(num_nodes));
+}
+
+}  // namespace
+
+parlay::sequence<SpanningForestEdge> MaximumSpanningForest(
+    const GbbsGraph& graph) {
+  const std::size_t num_nodes = graph.Graph()->n;
+  const parlay::sequence<SpanningForestEdge> edges = PositiveEdges(graph);
+
+  // Strict total order on the edges, so that the edges selected in a round
+  // never form a cycle.
+  auto heavier = [&](std::size_t e, std::size_t f) {
+    const float weight_e = std::get<2>(edges[e]);
+    const float weight_f = std::get<2>(edges[f]);
+    return weight_e > weight_f || (weight_e == weight_f && e < f);
+  };
+  // Atomically replaces *best with edge if edge is heavier.
+  auto write_heavier = [&](std::size_t* best, std::size_t edge) {
+    std::size_t current = *best;
+    while (current == kNoEdge || heavier(edge, current)) {
+      if (gbbs::atomic_compare_and_swap(best, current, edge)) return;
+      current = *best;
+    }
+  };
+
+  AsynchronousUnionFind<gbbs::uintE> components(num_nodes);
+  parlay::sequence<std::size_t> best_edge(num_nodes, kNoEdge);
+  parlay::sequence<std::size_t> active =
+      parlay::iota<std::size_t>(edges.size());
+  parlay::sequence<SpanningForestEdge> forest;
+  int num_rounds = 0;
+  while (true) {
+    auto roots = parlay::map(active, [&](std::size_t e) {
+      return std::make_pair(components.Find(std::get<0>(edges[e])),
+                            components.Find(std::get<1>(edges[e])));
+    });
+    auto keep = parlay::delayed_seq<bool>(active.size(), [&](std::size_t i) {
+      return roots[i].first != roots[i].second;
+    });
+    active = parlay::pack(active, keep);
+    roots = parlay::pack(roots, keep);
+    if (active.empty()) break;
+    ++num_rounds;
+
+    parlay::parallel_for(0, active.size(), [&](std::size_t i) {
+      write_heavier(&best_edge[roots[i].first], active[i]);
+      write_heavier(&best_edge[roots[i].second], active[i]);
+    });
+    // Bit 0 (resp. 1) is set if the edge is the best edge of the component of
+    // its first (resp. second) endpoint. Each entry of best_edge is owned by
+    // exactly one edge, which resets it for the next round.
+    auto selected = parlay::sequence<uint8_t>::from_function(
+        active.size(), [&](std::size_t i) -> uint8_t {
+          return (best_edge[roots[i].first] == active[i] ? 1 : 0) |
+                 (best_edge[roots[i].second] == active[i] ? 2 : 0);
+        });
+    parlay::parallel_for(0, active.size(), [&](std::size_t i) {
+      if (selected[i] & 1) best_edge[roots[i].first] = kNoEdge;
+      if (selected[i] & 2) best_edge[roots[i].second] = kNoEdge;
+    });
+    auto new_forest_edges = parlay::pack(
+        parlay::delayed_seq<SpanningForestEdge>(
+            active.size(), [&](std::size_t i) { return edges[active[i]]; }),
+        parlay::delayed_seq<bool>(active.size(), [&](std::size_t i) {
+          return selected[i] != 0;
+        }));
+    parlay::parallel_for(0, new_forest_edges.size(), [&](std::size_t i) {
+      components.Unite(std::get<0>(new_forest_edges[i]),
+                       std::get<1>(new_forest_edges[i]));
+    });
+    forest.append(new_forest_edges);
+  }
+  ABSL_VLOG(1) << "Spanning forest of " << forest.size()
+               << " edges computed in " << num_rounds << " Boruvka rounds";
+  return forest;
+}
+
+absl::StatusOr<InMemoryClusterer::Clustering> SingleLinkageClusterer::Cluster(
+    const ClustererConfig& config) const {
+  if (graph_.Graph() == nullptr) {
+    return absl::FailedPreconditionError(
+        "graph_ must be initialized before clustering.");
+  }
+  return CutSpanningForest(
+      MaximumSpanningForest(graph_), graph_.Graph()->n,
+      config.single_linkage_clusterer_config().weight_threshold());
+}
+
+absl::StatusOr<Dendrogram> SingleLinkageClusterer::HierarchicalCluster(
+    const ClustererConfig& config) const {
+  if (graph_.Graph() == nullptr) {
+    return absl::FailedPreconditionError(
+        "graph_ must be initialized before clustering.");
+  }
+  const std::size_t num_nodes = graph_.Graph()->n;
+  parlay::sequence<SpanningForestEdge> forest = MaximumSpanningForest(graph_);
+  parlay::sort_inplace(forest, [](const SpanningForestEdge& a,
+                                  const SpanningForestEdge& b) {
+    return std::get<2>(a) > std::get<2>(b) ||
+           (std::get<2>(a) == std::get<2>(b) && a < b);
+  });
+
+  // Replaying the merges is a single pass over the forest edges with a
+  // sequential union-find structure. The forest has at most num_nodes - 1
+  // edges and each merge takes amortized near-constant time, so the pass is
+  // linear in the number of nodes and cheaper than the parallel spanning forest
+  // and sort above, which process every edge of the graph. The merge order is
+  // inherently sequential (the parent of a cluster depends on all heavier
+  // merges), and a single pass keeps the dendrogram deterministic.
+  // cluster_node[r] is the dendrogram node of the cluster whose union-find root
+  // is r.
+  std::vector<DendrogramNode> nodes(num_nodes + forest.size());
+  std::vector<DendrogramNode::ParentId> cluster_node(num_nodes);
+  std::iota(cluster_node.begin(), cluster_node.end(), 0);
+  SequentialUnionFind<gbbs::uintE> clusters(num_nodes);
+  for (std::size_t i = 0; i < forest.size(); ++i) {
+    const auto& [node_a, node_b, weight] = forest[i];
+    const DendrogramNode::ParentId parent_id = num_nodes + i;
+    nodes[cluster_node[clusters.Find(node_a)]] = {parent_id, weight};
+    nodes[cluster_node[clusters.Find(node_b)]] = {parent_id, weight};
+    clusters.Unite(node_a, node_b);
+    cluster_node[clusters.Find(node_a)] = parent_id;
+  }
+
+  Dendrogram dendrogram(0);
+  RETURN_IF_ERROR(dendrogram.Init(std::move(nodes), num_nodes));
+  return dendrogram;
+}
+
+}  // namespace graph_mining::in_memory
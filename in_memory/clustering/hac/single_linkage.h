@@ -0,0 +1,72 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_HAC_SINGLE_LINKAGE_H_
+#define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_HAC_SINGLE_LINKAGE_H_
+
+#include <tuple>
+
+#include "absl/status/statusor.h"
+#include "gbbs/macros.h"
+#include "in_memory/clustering/config.pb.h"
+#include "in_memory/clustering/dendrogram.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "parlay/sequence.h"
+
+namespace graph_mining::in_memory {
+
+// An edge (node_a, node_b, weight) of a spanning forest, with node_a < node_b.
+using SpanningForestEdge = std::tuple<gbbs::uintE, gbbs::uintE, float>;
+
+// Computes a maximum-weight spanning forest of the (symmetric) graph using a
+// parallel Boruvka algorithm: in each round, every component selects its
+// heaviest incident edge, the selected edges are linked in a concurrent
+// union-find structure and edges inside a single component are dropped. Ties
+// are broken by edge position, so the result is deterministic. Only the entries
+// (u, v) with u < v of each adjacency list and with positive weight are
+// considered. The edges are returned in an unspecified order.
+parlay::sequence<SpanningForestEdge> MaximumSpanningForest(
+    const GbbsGraph& graph);
+
+// Exact single-linkage hierarchical agglomerative clustering. The similarity of
+// two clusters is the maximum weight of an edge between them. The merges of
+// single-linkage HAC are exactly the edges of a maximum-weight spanning forest
+// processed in the order of decreasing weight, so the dendrogram is obtained
+// without maintaining any cluster-level graph.
+//
+// Uses config.single_linkage_clusterer_config().
+class SingleLinkageClusterer : public InMemoryClusterer {
+ public:
+  Graph* MutableGraph() override { return &graph_; }
+
+  // Returns the clustering obtained by cutting the dendrogram at
+  // weight_threshold, i.e., the connected components of the spanning forest
+  // edges with weight at least weight_threshold.
+  absl::StatusOr<Clustering> Cluster(
+      const ClustererConfig& config) const override;
+
+  // Returns the single-linkage dendrogram. The dendrogram is monotone and
+  // contains one internal node per spanning forest edge (nodes that are only
+  // connected through edges with non-positive weight are not merged).
+  absl::StatusOr<Dendrogram> HierarchicalCluster(
+      const ClustererConfig& config) const override;
+
+ private:
+  GbbsGraph graph_;
+};
+
+}  // namespace graph_mining::in_memory
+
+#endif  // THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_HAC_SINGLE_LINKAGE_H_
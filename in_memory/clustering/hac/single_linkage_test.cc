@@ -0,0 +1,87 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/clustering/hac/single_linkage.h"
+
+#include <vector>
+
+#include "absl/status/status.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "in_memory/clustering/config.pb.h"
+#include "in_memory/clustering/dendrogram.h"
+#include "in_memory/clustering/graph.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/status_macros.h"  // IWYU pragma: keep
+
+namespace graph_mining::in_memory {
+namespace {
+
+using ::testing::UnorderedElementsAre;
+
+// Two chains 0 - 1 - 2 and 3 - 4 joined by the light edge {2, 3}. The edge
+// {0, 2} closes a cycle and is not in the maximum spanning forest.
+absl::Status MakeGraph(InMemoryClusterer::Graph* graph) {
+  SimpleUndirectedGraph two_chains;
+  RETURN_IF_ERROR(two_chains.AddEdge(0, 1, 0.9));
+  RETURN_IF_ERROR(two_chains.AddEdge(1, 2, 0.5));
+  RETURN_IF_ERROR(two_chains.AddEdge(0, 2, 0.2));
+  RETURN_IF_ERROR(two_chains.AddEdge(3, 4, 0.8));
+  RETURN_IF_ERROR(two_chains.AddEdge(2, 3, 0.1));
+  return CopyGraph(two_chains, graph);
+}
+
+TEST(SingleLinkageClustererTest, ClusterCutsAtThreshold) {
+  SingleLinkageClusterer clusterer;
+  ASSERT_OK(MakeGraph(clusterer.MutableGraph()));
+  ClustererConfig config;
+  config.mutable_single_linkage_clusterer_config()->set_weight_threshold(0.4);
+  ASSERT_OK_AND_ASSIGN(InMemoryClusterer::Clustering clustering,
+                       clusterer.Cluster(config));
+  EXPECT_THAT(clustering, UnorderedElementsAre(UnorderedElementsAre(0, 1, 2),
+                                               UnorderedElementsAre(3, 4)));
+}
+
+TEST(SingleLinkageClustererTest, DendrogramReplaysForestEdgesByWeight) {
+  SingleLinkageClusterer clusterer;
+  ASSERT_OK(MakeGraph(clusterer.MutableGraph()));
+  ASSERT_OK_AND_ASSIGN(Dendrogram dendrogram,
+                       clusterer.HierarchicalCluster(ClustererConfig()));
+  // The merges are {0, 1} (node 5), {3, 4} (node 6), {5, 2} (node 7) and
+  // {7, 6} (node 8).
+  const std::vector<DendrogramNode>& nodes = dendrogram.Nodes();
+  ASSERT_EQ(nodes.size(), 9);
+  const std::vector<DendrogramNode::ParentId> expected_parents = {
+      5, 5, 7, 6, 6, 7, 8, 8, Dendrogram::kNoParentId};
+  const std::vector<double> expected_similarities = {0.9, 0.9, 0.5, 0.8, 0.8,
+                                                     0.5, 0.1, 0.1};
+  for (int i = 0; i < 9; ++i) {
+    EXPECT_EQ(nodes[i].parent_id, expected_parents[i]) << "node " << i;
+    if (i < 8) {
+      EXPECT_FLOAT_EQ(nodes[i].merge_similarity, expected_similarities[i])
+          << "node " << i;
+    }
+  }
+}
+
+TEST(SingleLinkageClustererTest, UninitializedGraphIsAnError) {
+  SingleLinkageClusterer clusterer;
+  EXPECT_EQ(clusterer.Cluster(ClustererConfig()).status().code(),
+            absl::StatusCode::kFailedPrecondition);
+  EXPECT_EQ(clusterer.HierarchicalCluster(ClustererConfig()).status().code(),
+            absl::StatusCode::kFailedPrecondition);
+}
+
+}  // namespace
+}  // namespace graph_mining::in_memory
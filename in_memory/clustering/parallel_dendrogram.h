@@ -70,6 +70,12 @@ class ParallelDendrogram {
     return parent_pointers_[node_id].parent_id != kInvalidClusterId;
   }
 
+  NodeId NumNodes() const { return num_nodes_; }
+
+  // All cluster ids, including the ids of the base nodes, are in the range
+  // [0, MaxClusterId()).
+  size_t MaxClusterId() const { return 2 * num_nodes_ - 1; }
+
   // Returns a clustering where the dendrogram is cut with the given similarity
   // threshold, linkage (similarity) threshold. Let's view the dendrogram as an
   // edge-weighted tree, where edges go from child clusters to their parent
@@ -223,8 +229,6 @@ class ParallelDendrogram {
   static constexpr size_t kInvalidClusterId =
       std::numeric_limits<NodeId>::max();
 
-  size_t MaxClusterId() const { return 2 * num_nodes_ - 1; }
-
   parlay::sequence<ParentEdge> parent_pointers_;
   NodeId num_nodes_;
 };
@@ -185,26 +185,13 @@ AffinityHierarchyEmbedder::EmbedGraph(const GbbsGraph& graph) {
 
 absl::StatusOr<std::vector<std::pair<gbbs::uintE, double>>>
 AffinityHierarchyEmbedder::EmbedGraphWeighted(const GbbsGraph& graph) {
-  
-  const auto& g = graph.Graph();
-  std::size_t num_nodes = g->num_vertices();
-  if (g->vertex_weights == nullptr) {
+  if (graph.Graph()->vertex_weights == nullptr) {
     return absl::InvalidArgumentError(
         absl::StrFormat("Input graph does not have any node weights."));
   }
-  const auto* node_weights = g->vertex_weights;
   std::vector<gbbs::uintE> embedding;
   ASSIGN_OR_RETURN(embedding, EmbedGraph(graph));
-  std::vector<double> weight_prefix_sums(num_nodes);
-  parlay::parallel_for(0, num_nodes, [&](std::size_t i) {
-    weight_prefix_sums[i] = node_weights[embedding[i]];
-  });
-  parlay::scan_inplace(weight_prefix_sums);
-  std::vector<std::pair<gbbs::uintE, double>> weighted_embedding(num_nodes);
-  parlay::parallel_for(0, num_nodes, [&](std::size_t i) {
-    weighted_embedding[i] = std::make_pair(embedding[i], weight_prefix_sums[i]);
-  });
-  return weighted_embedding;
+  return ComputeWeightedEmbedding(graph, embedding);
 }
 
 }  // namespace graph_mining::in_memory
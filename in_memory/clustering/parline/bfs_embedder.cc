@@ -0,0 +1,160 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/clustering/parline/bfs_embedder.h"
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "gbbs/graph.h"
+#include "gbbs/macros.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/parline/linear_embedder.h"
+#include "in_memory/clustering/parline/parline.pb.h"
+#include "in_memory/status_macros.h"
+#include "parlay/delayed_sequence.h"
+#include "parlay/parallel.h"
+#include "parlay/primitives.h"
+#include "parlay/sequence.h"
+
+namespace graph_mining::in_memory {
+namespace {
+
+using WeightedUndirectedGraph =
+    gbbs::symmetric_ptr_graph<gbbs::symmetric_vertex, float>;
+
+// A node reached from the current frontier along with the index (in the
+// frontier) of the node it is reached from.
+using ReachedNode = std::pair<gbbs::uintE, gbbs::uintE>;
+
+// Computes the next BFS frontier. The returned nodes are ordered by the index
+// of their earliest parent in the input frontier and then (if sort_by_degree
+// is true) by their degree. Marks the returned nodes as visited.
+parlay::sequence<gbbs::uintE> NextFrontier(
+    WeightedUndirectedGraph& graph,
+    const parlay::sequence<gbbs::uintE>& frontier,
+    const parlay::sequence<gbbs::uintE>& degrees, bool sort_by_degree,
+    parlay::sequence<bool>& visited) {
+  auto offsets = parlay::sequence<std::size_t>::from_function(
+      frontier.size(), [&](std::size_t i) { return degrees[frontier[i]]; });
+  const std::size_t num_edges = parlay::scan_inplace(offsets);
+  parlay::sequence<ReachedNode> reached(num_edges,
+                                        ReachedNode{UINT_E_MAX, UINT_E_MAX});
+  parlay::parallel_for(
+      0, frontier.size(),
+      [&](std::size_t i) {
+        auto neighbors = graph.get_vertex(frontier[i]).out_neighbors();
+        for (std::size_t j = 0; j < neighbors.get_degree(); ++j) {
+          const gbbs::uintE neighbor = neighbors.get_neighbor(j);
+          if (!visited[neighbor]) {
+            reached[offsets[i] + j] = {neighbor, static_cast<gbbs::uintE>(i)};
+          }
+        }
+      },
+      /*granularity=*/1);
+  reached = parlay::filter(reached, [](const ReachedNode& node) {
+    return node.first != UINT_E_MAX;
+  });
+
+  // Keep only the earliest parent of each reached node.
+  parlay::sort_inplace(reached);
+  auto first_occurrence =
+      parlay::delayed_seq<bool>(reached.size(), [&](std::size_t i) {
+        return i == 0 || reached[i - 1].first != reached[i].first;
+      });
+  reached = parlay::pack(reached, first_occurrence);
+
+  parlay::sort_inplace(reached, [&](const ReachedNode& a,
+                                    const ReachedNode& b) {
+    const gbbs::uintE degree_a = sort_by_degree ? degrees[a.first] : 0;
+    const gbbs::uintE degree_b = sort_by_degree ? degrees[b.first] : 0;
+    return std::tie(a.second, degree_a, a.first) <
+           std::tie(b.second, degree_b, b.first);
+  });
+  auto next_frontier = parlay::sequence<gbbs::uintE>::from_function(
+      reached.size(), [&](std::size_t i) { return reached[i].first; });
+  parlay::parallel_for(0, next_frontier.size(),
+                       [&](std::size_t i) { visited[next_frontier[i]] = true; });
+  return next_frontier;
+}
+
+std::vector<gbbs::uintE> CuthillMcKeeOrder(WeightedUndirectedGraph& graph,
+                                           bool sort_by_degree) {
+  const std::size_t num_nodes = graph.n;
+  auto degrees = parlay::sequence<gbbs::uintE>::from_function(
+      num_nodes, [&](std::size_t i) -> gbbs::uintE {
+        return graph.get_vertex(i).out_degree();
+      });
+  auto node_ids = parlay::iota<gbbs::uintE>(num_nodes);
+  // Nodes with at least one edge in the order of increasing degree. Each BFS
+  // starts from the first unvisited node in this order.
+  auto start_nodes = parlay::filter(
+      node_ids, [&](gbbs::uintE i) { return degrees[i] > 0; });
+  parlay::sort_inplace(start_nodes, [&](gbbs::uintE a, gbbs::uintE b) {
+    return std::tie(degrees[a], a) < std::tie(degrees[b], b);
+  });
+
+  std::vector<gbbs::uintE> order;
+  order.reserve(num_nodes);
+  parlay::sequence<bool> visited(num_nodes, false);
+  for (const gbbs::uintE start_node : start_nodes) {
+    if (visited[start_node]) continue;
+    visited[start_node] = true;
+    parlay::sequence<gbbs::uintE> frontier(1, start_node);
+    while (!frontier.empty()) {
+      order.insert(order.end(), frontier.begin(), frontier.end());
+      frontier =
+          NextFrontier(graph, frontier, degrees, sort_by_degree, visited);
+    }
+  }
+  auto isolated_nodes = parlay::filter(
+      node_ids, [&](gbbs::uintE i) { return degrees[i] == 0; });
+  order.insert(order.end(), isolated_nodes.begin(), isolated_nodes.end());
+  return order;
+}
+
+}  // namespace
+
+BfsEmbedder::BfsEmbedder(const BfsEmbedderConfig& config) : config_(config) {}
+
+absl::StatusOr<std::vector<gbbs::uintE>> BfsEmbedder::EmbedGraph(
+    const GbbsGraph& graph) {
+  std::vector<gbbs::uintE> order =
+      CuthillMcKeeOrder(*graph.Graph(), config_.sort_by_degree());
+  if (!config_.reverse()) return order;
+  const std::size_t num_nodes = order.size();
+  std::vector<gbbs::uintE> reversed_order(num_nodes);
+  parlay::parallel_for(0, num_nodes, [&](std::size_t i) {
+    reversed_order[i] = order[num_nodes - 1 - i];
+  });
+  return reversed_order;
+}
+
+absl::StatusOr<std::vector<std::pair<gbbs::uintE, double>>>
+BfsEmbedder::EmbedGraphWeighted(const GbbsGraph& graph) {
+  if (graph.Graph()->vertex_weights == nullptr) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Input graph does not have any node weights."));
+  }
+  std::vector<gbbs::uintE> embedding;
+  ASSIGN_OR_RETURN(embedding, EmbedGraph(graph));
+  return ComputeWeightedEmbedding(graph, embedding);
+}
+
+}  // namespace graph_mining::in_memory
@@ -0,0 +1,58 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_PARLINE_BFS_EMBEDDER_H_
+#define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_PARLINE_BFS_EMBEDDER_H_
+
+#include <utility>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "gbbs/macros.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/parline/linear_embedder.h"
+#include "in_memory/clustering/parline/parline.pb.h"
+
+namespace graph_mining::in_memory {
+
+// Embeds the nodes of an input graph into a line using a breadth-first search
+// ordering, by default the (reverse) Cuthill-McKee ordering. Each connected
+// component is traversed from a node of minimum degree and the nodes reached
+// at the same BFS level are ordered by the position of their (earliest)
+// parent, followed by their degree. Each BFS level is processed in parallel,
+// and the ordering is deterministic. Isolated nodes are placed after all the
+// other nodes (or before them if the ordering is reversed).
+//
+// This is much cheaper than AffinityHierarchyEmbedder (roughly a single pass
+// over the edges plus sorting the frontiers) but typically gives embeddings
+// with larger cuts. Note that graphs with many small connected components
+// need at least one round per component.
+class BfsEmbedder : public LinearEmbedder {
+ public:
+  explicit BfsEmbedder(const BfsEmbedderConfig& config);
+  ~BfsEmbedder() override {}
+
+  absl::StatusOr<std::vector<gbbs::uintE>> EmbedGraph(
+      const GbbsGraph& graph) override;
+
+  absl::StatusOr<std::vector<std::pair<gbbs::uintE, double>>>
+  EmbedGraphWeighted(const GbbsGraph& graph) override;
+
+ private:
+  BfsEmbedderConfig config_;
+};
+
+}  // namespace graph_mining::in_memory
+
+#endif  // THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_PARLINE_BFS_EMBEDDER_H_
@@ -0,0 +1,107 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/clustering/parline/bfs_embedder.h"
+
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/graph.h"
+#include "in_memory/clustering/parline/parline.pb.h"
+#include "in_memory/status_macros.h"  // IWYU pragma: keep
+
+namespace graph_mining::in_memory {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::Pair;
+
+// Returns a graph with the components {0, 1, 2, 3, 4, 8} (the cycle
+// 0 - 1 - 3 - 2 - 0 with the pendant nodes 4 at node 3 and 8 at node 1),
+// {5, 6} (an edge) and {7} (an isolated node of weight 2). The degrees are
+// 1 for nodes 4, 5, 6 and 8, 2 for nodes 0 and 2, 3 for nodes 1 and 3 and 0
+// for node 7.
+absl::Status MakeGraph(GbbsGraph& graph) {
+  SimpleUndirectedGraph simple_graph;
+  for (const auto& [node_a, node_b] : std::vector<std::pair<int, int>>{
+           {0, 1}, {0, 2}, {1, 3}, {2, 3}, {3, 4}, {1, 8}, {5, 6}}) {
+    RETURN_IF_ERROR(simple_graph.AddEdge(node_a, node_b, 1.0));
+  }
+  simple_graph.SetNodeWeight(7, 2.0);
+  return CopyGraph(simple_graph, &graph);
+}
+
+BfsEmbedderConfig Config(bool sort_by_degree, bool reverse) {
+  BfsEmbedderConfig config;
+  config.set_sort_by_degree(sort_by_degree);
+  config.set_reverse(reverse);
+  return config;
+}
+
+// Each component is traversed from its first node in the order of increasing
+// degree: node 4 for the first component and node 5 for the second one.
+TEST(BfsEmbedderTest, CuthillMcKeeOrder) {
+  GbbsGraph graph;
+  ASSERT_OK(MakeGraph(graph));
+  // The BFS levels from node 4 are {4}, {3}, {1, 2} and {0, 8}. Node 2 has a
+  // lower degree than node 1, and node 0 is reached from the earlier node of
+  // the previous level.
+  BfsEmbedder embedder(Config(/*sort_by_degree=*/true, /*reverse=*/false));
+  EXPECT_THAT(embedder.EmbedGraph(graph),
+              IsOkAndHolds(ElementsAre(4, 3, 2, 1, 0, 8, 5, 6, 7)));
+}
+
+TEST(BfsEmbedderTest, OrdersByNodeIdWithoutDegreeSorting) {
+  GbbsGraph graph;
+  ASSERT_OK(MakeGraph(graph));
+  BfsEmbedder embedder(Config(/*sort_by_degree=*/false, /*reverse=*/false));
+  EXPECT_THAT(embedder.EmbedGraph(graph),
+              IsOkAndHolds(ElementsAre(4, 3, 1, 2, 0, 8, 5, 6, 7)));
+}
+
+TEST(BfsEmbedderTest, ReverseCuthillMcKeeByDefault) {
+  GbbsGraph graph;
+  ASSERT_OK(MakeGraph(graph));
+  BfsEmbedder embedder{BfsEmbedderConfig()};
+  EXPECT_THAT(embedder.EmbedGraph(graph),
+              IsOkAndHolds(ElementsAre(7, 6, 5, 8, 0, 1, 2, 3, 4)));
+}
+
+TEST(BfsEmbedderTest, WeightedEmbedding) {
+  GbbsGraph graph;
+  ASSERT_OK(MakeGraph(graph));
+  BfsEmbedder embedder{BfsEmbedderConfig()};
+  // Each node is paired with the total weight of the nodes before it.
+  EXPECT_THAT(embedder.EmbedGraphWeighted(graph),
+              IsOkAndHolds(ElementsAre(Pair(7, 0), Pair(6, 2), Pair(5, 3),
+                                       Pair(8, 4), Pair(0, 5), Pair(1, 6),
+                                       Pair(2, 7), Pair(3, 8), Pair(4, 9))));
+}
+
+TEST(BfsEmbedderTest, WeightedEmbeddingWithoutNodeWeightsIsAnError) {
+  SimpleUndirectedGraph simple_graph;
+  ASSERT_OK(simple_graph.AddEdge(0, 1, 1.0));
+  GbbsGraph graph;
+  ASSERT_OK(CopyGraph(simple_graph, &graph));
+  BfsEmbedder embedder{BfsEmbedderConfig()};
+  EXPECT_THAT(embedder.EmbedGraphWeighted(graph),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace graph_mining::in_memory
@@ -0,0 +1,375 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/clustering/parline/bucket_fm.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/log/absl_check.h"
+#include "gbbs/macros.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/parline/cluster_pair_improver.h"
+#include "in_memory/clustering/types.h"
+
+namespace graph_mining::in_memory {
+namespace {
+
+using LocalId = uint32_t;
+
+constexpr LocalId kNoNode = static_cast<LocalId>(-1);
+
+// The two clusters copied into a CSR graph over dense local indices. Nodes of
+// cluster1 occupy local indices [0, cluster1_size) and nodes of cluster2
+// occupy [cluster1_size, num_nodes). Only edges between nodes of the pair are
+// kept.
+struct LocalGraph {
+  LocalId cluster1_size = 0;
+  // Entry i is the global node id of local node i.
+  std::vector<NodeId> node_ids;
+  std::vector<double> node_weights;
+  // Edges of local node i are in [offsets[i], offsets[i+1]).
+  std::vector<std::size_t> offsets;
+  std::vector<LocalId> neighbors;
+  std::vector<float> weights;
+
+  LocalId NumNodes() const { return node_ids.size(); }
+  bool InCluster1(LocalId id) const { return id < cluster1_size; }
+};
+
+double GetNodeWeight(const GbbsGraph& gbbs_graph, gbbs::uintE node_id) {
+  auto graph = gbbs_graph.Graph();
+  return graph->vertex_weights == nullptr ? 1.0
+                                          : graph->vertex_weights[node_id];
+}
+
+// Builds the local graph of a cluster pair. local_index_fn maps a global node
+// id to its local index, or to a negative value if the node is not in the
+// pair.
+template <typename ClusterRange, typename LocalIndexFn>
+LocalGraph BuildLocalGraph(const GbbsGraph& gbbs_graph,
+                           const ClusterRange& cluster1,
+                           const ClusterRange& cluster2,
+                           LocalIndexFn local_index_fn) {
+  auto graph = gbbs_graph.Graph();
+  LocalGraph local_graph;
+  local_graph.cluster1_size = cluster1.size();
+  const std::size_t num_nodes = cluster1.size() + cluster2.size();
+  local_graph.node_ids.reserve(num_nodes);
+  local_graph.node_ids.insert(local_graph.node_ids.end(), cluster1.begin(),
+                              cluster1.end());
+  local_graph.node_ids.insert(local_graph.node_ids.end(), cluster2.begin(),
+                              cluster2.end());
+  local_graph.node_weights.resize(num_nodes);
+  local_graph.offsets.resize(num_nodes + 1);
+  local_graph.offsets[0] = 0;
+  for (LocalId i = 0; i < num_nodes; ++i) {
+    const NodeId node_id = local_graph.node_ids[i];
+    local_graph.node_weights[i] = GetNodeWeight(gbbs_graph, node_id);
+    auto neighbors = graph->get_vertex(node_id).out_neighbors();
+    for (int j = 0; j < neighbors.get_degree(); ++j) {
+      const auto local_neighbor = local_index_fn(neighbors.get_neighbor(j));
+      // Neighbors outside of the pair and self edges do not affect gains.
+      if (local_neighbor < 0 || local_neighbor == i) continue;
+      local_graph.neighbors.push_back(local_neighbor);
+      local_graph.weights.push_back(neighbors.get_weight(j));
+    }
+    local_graph.offsets[i + 1] = local_graph.neighbors.size();
+  }
+  return local_graph;
+}
+
+// An array of gain buckets over the contiguous range of local indices
+// [begin, end). Each bucket is a doubly linked list threaded through the
+// next_/prev_ arrays. Gains are mapped to buckets by rounding gain / width to
+// the nearest integer and clamping it to [-num_buckets, num_buckets].
+// The queue also keeps track of the total weight of the cluster it represents.
+class GainBucketQueue {
+ public:
+  GainBucketQueue(LocalId begin, LocalId end, int num_buckets, double width)
+      : begin_(begin),
+        num_buckets_(num_buckets),
+        inverse_width_(1.0 / width),
+        heads_(2 * num_buckets + 1, kNoNode),
+        next_(end - begin, kNoNode),
+        prev_(end - begin, kNoNode),
+        buckets_(end - begin, -1) {}
+
+  bool Empty() const { return size_ == 0; }
+
+  bool Contains(LocalId id) const {
+    return id >= begin_ && id - begin_ < buckets_.size() &&
+           buckets_[id - begin_] >= 0;
+  }
+
+  void Insert(LocalId id, double gain) {
+    const int bucket = Bucket(gain);
+    const LocalId offset = id - begin_;
+    buckets_[offset] = bucket;
+    prev_[offset] = kNoNode;
+    next_[offset] = heads_[bucket];
+    if (heads_[bucket] != kNoNode) prev_[heads_[bucket] - begin_] = id;
+    heads_[bucket] = id;
+    max_bucket_ = std::max(max_bucket_, bucket);
+    ++size_;
+  }
+
+  void Remove(LocalId id) {
+    const LocalId offset = id - begin_;
+    const int bucket = buckets_[offset];
+    if (prev_[offset] == kNoNode) {
+      heads_[bucket] = next_[offset];
+    } else {
+      next_[prev_[offset] - begin_] = next_[offset];
+    }
+    if (next_[offset] != kNoNode) prev_[next_[offset] - begin_] = prev_[offset];
+    buckets_[offset] = -1;
+    --size_;
+  }
+
+  // Moves a node to the bucket of its new gain. This is a no-op if the
+  // bucket does not change.
+  void Adjust(LocalId id, double gain) {
+    if (Bucket(gain) == buckets_[id - begin_]) return;
+    Remove(id);
+    Insert(id, gain);
+  }
+
+  // Returns a node from the highest non-empty bucket. Must not be called on an
+  // empty queue.
+  LocalId Top() {
+    ABSL_DCHECK(!Empty());
+    while (heads_[max_bucket_] == kNoNode) --max_bucket_;
+    return heads_[max_bucket_];
+  }
+
+  double weight() const { return weight_; }
+  void set_weight(double weight) { weight_ = weight; }
+
+ private:
+  int Bucket(double gain) const {
+    const double scaled = std::round(gain * inverse_width_);
+    return static_cast<int>(std::clamp(scaled, -1.0 * num_buckets_,
+                                       1.0 * num_buckets_)) +
+           num_buckets_;
+  }
+
+  const LocalId begin_;
+  const int num_buckets_;
+  const double inverse_width_;
+  std::vector<LocalId> heads_;
+  std::vector<LocalId> next_;
+  std::vector<LocalId> prev_;
+  // Bucket index of each node or -1 if the node is not in the queue.
+  std::vector<int> buckets_;
+  std::size_t size_ = 0;
+  // Upper bound on the index of the highest non-empty bucket.
+  int max_bucket_ = 0;
+  double weight_ = 0;
+};
+
+// See MoveStats and ChooseMove in fm_base.cc.
+bool MoveFits(const LocalGraph& graph, LocalId id,
+              const GainBucketQueue& from_queue,
+              const GainBucketQueue& to_queue, double max_cluster_weight) {
+  const double node_weight = graph.node_weights[id];
+  return max_cluster_weight - std::max(to_queue.weight() + node_weight,
+                                       from_queue.weight() - node_weight) >=
+         0.0;
+}
+
+// Runs the FM move sequence on a local graph and returns the improvement of
+// the best prefix of moves. The local ids of the nodes in that prefix are
+// stored in best_moves.
+double RunFM(const LocalGraph& graph, int num_buckets,
+             double max_cluster_weight, std::vector<LocalId>& best_moves) {
+  const LocalId num_nodes = graph.NumNodes();
+  // Initial gains and the largest possible absolute gain.
+  std::vector<double> gains(num_nodes, 0.0);
+  double max_abs_gain = 0.0;
+  for (LocalId i = 0; i < num_nodes; ++i) {
+    double weighted_degree = 0.0;
+    for (std::size_t e = graph.offsets[i]; e < graph.offsets[i + 1]; ++e) {
+      const double weight = graph.weights[e];
+      gains[i] += graph.InCluster1(graph.neighbors[e]) == graph.InCluster1(i)
+                      ? -weight
+                      : weight;
+      weighted_degree += std::abs(weight);
+    }
+    max_abs_gain = std::max(max_abs_gain, weighted_degree);
+  }
+  const double bucket_width =
+      max_abs_gain > 0.0 ? max_abs_gain / num_buckets : 1.0;
+
+  GainBucketQueue left_queue(0, graph.cluster1_size, num_buckets,
+                             bucket_width);
+  GainBucketQueue right_queue(graph.cluster1_size, num_nodes, num_buckets,
+                              bucket_width);
+  double left_weight = 0.0;
+  double right_weight = 0.0;
+  for (LocalId i = 0; i < num_nodes; ++i) {
+    if (graph.InCluster1(i)) {
+      left_queue.Insert(i, gains[i]);
+      left_weight += graph.node_weights[i];
+    } else {
+      right_queue.Insert(i, gains[i]);
+      right_weight += graph.node_weights[i];
+    }
+  }
+  left_queue.set_weight(left_weight);
+  right_queue.set_weight(right_weight);
+
+  // The move log: moved local ids and their gains at the time of the move.
+  std::vector<LocalId> moved_nodes;
+  std::vector<double> move_gains;
+  moved_nodes.reserve(num_nodes);
+  move_gains.reserve(num_nodes);
+
+  auto make_move = [&](LocalId id, GainBucketQueue& from_queue,
+                       GainBucketQueue& to_queue) {
+    from_queue.Remove(id);
+    moved_nodes.push_back(id);
+    move_gains.push_back(gains[id]);
+    const double node_weight = graph.node_weights[id];
+    from_queue.set_weight(from_queue.weight() - node_weight);
+    to_queue.set_weight(to_queue.weight() + node_weight);
+    for (std::size_t e = graph.offsets[id]; e < graph.offsets[id + 1]; ++e) {
+      const LocalId neighbor = graph.neighbors[e];
+      const double weight = graph.weights[e];
+      if (from_queue.Contains(neighbor)) {
+        gains[neighbor] += 2 * weight;
+        from_queue.Adjust(neighbor, gains[neighbor]);
+      } else if (to_queue.Contains(neighbor)) {
+        gains[neighbor] -= 2 * weight;
+        to_queue.Adjust(neighbor, gains[neighbor]);
+      }
+    }
+  };
+
+  while (!left_queue.Empty() && !right_queue.Empty()) {
+    const LocalId left_node = left_queue.Top();
+    const LocalId right_node = right_queue.Top();
+    const bool left_move_allowed = MoveFits(graph, left_node, left_queue,
+                                            right_queue, max_cluster_weight);
+    const bool right_move_allowed = MoveFits(graph, right_node, right_queue,
+                                             left_queue, max_cluster_weight);
+    if (left_move_allowed &&
+        (!right_move_allowed || gains[left_node] > gains[right_node])) {
+      make_move(left_node, left_queue, right_queue);
+    } else if (right_move_allowed) {
+      make_move(right_node, right_queue, left_queue);
+    } else if (graph.node_weights[left_node] >
+               graph.node_weights[right_node]) {
+      // Both moves would violate the balance constraint; lock the larger node.
+      left_queue.Remove(left_node);
+    } else {
+      right_queue.Remove(right_node);
+    }
+  }
+  GainBucketQueue& remaining_queue =
+      left_queue.Empty() ? right_queue : left_queue;
+  GainBucketQueue& empty_queue = left_queue.Empty() ? left_queue : right_queue;
+  while (!remaining_queue.Empty()) {
+    const LocalId top_node = remaining_queue.Top();
+    if (MoveFits(graph, top_node, remaining_queue, empty_queue,
+                 max_cluster_weight)) {
+      make_move(top_node, remaining_queue, empty_queue);
+    } else {
+      remaining_queue.Remove(top_node);
+    }
+  }
+
+  // Find the best prefix of the move log, preferring later moves on ties.
+  double improvement = 0.0;
+  double current_improvement = 0.0;
+  std::size_t best_prefix_size = 0;
+  for (std::size_t i = 0; i < move_gains.size(); ++i) {
+    current_improvement += move_gains[i];
+    if (current_improvement >= improvement) {
+      improvement = current_improvement;
+      best_prefix_size = i + 1;
+    }
+  }
+  best_moves.assign(moved_nodes.begin(),
+                    moved_nodes.begin() + best_prefix_size);
+  return improvement;
+}
+
+}  // namespace
+
+BucketFM::BucketFM(int num_gain_buckets) : num_gain_buckets_(num_gain_buckets) {
+  ABSL_CHECK_GT(num_gain_buckets_, 0);
+}
+
+double BucketFM::Improve(const GbbsGraph& graph,
+                         const absl::flat_hash_set<NodeId>& cluster1,
+                         const absl::flat_hash_set<NodeId>& cluster2,
+                         double max_cluster_weight,
+                         absl::flat_hash_set<NodeId>& cluster1_to_cluster2,
+                         absl::flat_hash_set<NodeId>& cluster2_to_cluster1) {
+  absl::flat_hash_map<NodeId, LocalId> local_index;
+  local_index.reserve(cluster1.size() + cluster2.size());
+  LocalId next_index = 0;
+  for (const auto& node_id : cluster1) local_index[node_id] = next_index++;
+  for (const auto& node_id : cluster2) local_index[node_id] = next_index++;
+  const LocalGraph local_graph = BuildLocalGraph(
+      graph, cluster1, cluster2, [&](gbbs::uintE node_id) -> int64_t {
+        auto it = local_index.find(node_id);
+        // Both branches are int64_t, so that -1 does not wrap around LocalId.
+        return it == local_index.end() ? int64_t{-1}
+                                       : static_cast<int64_t>(it->second);
+      });
+
+  std::vector<LocalId> best_moves;
+  const double improvement =
+      RunFM(local_graph, num_gain_buckets_, max_cluster_weight, best_moves);
+  for (const LocalId id : best_moves) {
+    if (local_graph.InCluster1(id)) {
+      cluster1_to_cluster2.insert(local_graph.node_ids[id]);
+    } else {
+      cluster2_to_cluster1.insert(local_graph.node_ids[id]);
+    }
+  }
+  return improvement;
+}
+
+double BucketFM::Improve(const GbbsGraph& graph, const ClusterPairView& pair,
+                         double max_cluster_weight,
+                         std::vector<NodeId>& cluster1_to_cluster2,
+                         std::vector<NodeId>& cluster2_to_cluster1) {
+  const LocalGraph local_graph =
+      BuildLocalGraph(graph, pair.cluster1, pair.cluster2,
+                      [&](gbbs::uintE node_id) -> int64_t {
+                        return pair.LocalIndex(node_id);
+                      });
+
+  std::vector<LocalId> best_moves;
+  const double improvement =
+      RunFM(local_graph, num_gain_buckets_, max_cluster_weight, best_moves);
+  for (const LocalId id : best_moves) {
+    if (local_graph.InCluster1(id)) {
+      cluster1_to_cluster2.push_back(local_graph.node_ids[id]);
+    } else {
+      cluster2_to_cluster1.push_back(local_graph.node_ids[id]);
+    }
+  }
+  return improvement;
+}
+
+}  // namespace graph_mining::in_memory
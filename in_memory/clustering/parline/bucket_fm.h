@@ -0,0 +1,73 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_PARLINE_BUCKET_FM_H_
+#define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_PARLINE_BUCKET_FM_H_
+
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/parline/cluster_pair_improver.h"
+#include "in_memory/clustering/types.h"
+
+namespace graph_mining::in_memory {
+
+// A Fiduccia-Mattheyses implementation with the same move selection and
+// balance handling as FMBase (see fm_base.h) but built on dense data
+// structures:
+//   - The two clusters are first copied into a pair-local CSR graph where
+//     nodes are addressed by their dense local index and edges leaving the
+//     pair are dropped.
+//   - Gains are kept in the classic gain-bucket array of doubly linked lists,
+//     which supports O(1) insert, remove and adjust. Since edge weights are
+//     floats the gains are quantized into buckets, so the node popped from a
+//     bucket array is a max-gain node up to the bucket width. Exact gains are
+//     still used for move selection and the reported improvement.
+//   - The move log is a contiguous array of local indices and gains.
+// Self-loops never cross the cut and are ignored. FMBase instead subtracts
+// their weight from the initial gain of a node, so on graphs with self-loops
+// the two can choose different moves. Otherwise the results may differ from
+// FMBase only in how ties (within a bucket) are broken.
+class BucketFM : public ClusterPairImprover {
+ public:
+  // Default number of gain buckets on each side of zero.
+  static constexpr int kDefaultNumGainBuckets = 1024;
+
+  // num_gain_buckets is the number of buckets used on each side of zero gain.
+  // The bucket width is max_gain / num_gain_buckets where max_gain is the
+  // maximum weighted degree of a node within the cluster pair. Larger values
+  // give a more precise ordering of moves at the expense of more memory and
+  // longer scans over empty buckets. Must be positive.
+  explicit BucketFM(int num_gain_buckets = kDefaultNumGainBuckets);
+
+  double Improve(const GbbsGraph& graph,
+                 const absl::flat_hash_set<NodeId>& cluster1,
+                 const absl::flat_hash_set<NodeId>& cluster2,
+                 double max_cluster_weight,
+                 absl::flat_hash_set<NodeId>& cluster1_to_cluster2,
+                 absl::flat_hash_set<NodeId>& cluster2_to_cluster1) override;
+
+  double Improve(const GbbsGraph& graph, const ClusterPairView& pair,
+                 double max_cluster_weight,
+                 std::vector<NodeId>& cluster1_to_cluster2,
+                 std::vector<NodeId>& cluster2_to_cluster1) override;
+
+ private:
+  const int num_gain_buckets_;
+};
+
+}  // namespace graph_mining::in_memory
+
+#endif  // THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_PARLINE_BUCKET_FM_H_
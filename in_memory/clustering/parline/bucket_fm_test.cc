@@ -0,0 +1,156 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/clustering/parline/bucket_fm.h"
+
+#include <tuple>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/graph.h"
+#include "in_memory/clustering/parline/cluster_pair_improver.h"
+#include "in_memory/clustering/types.h"
+#include "in_memory/status_macros.h"  // IWYU pragma: keep
+
+namespace graph_mining::in_memory {
+namespace {
+
+using ::testing::IsEmpty;
+
+using Edge = std::tuple<NodeId, NodeId, double>;
+
+// The triangles {0, 1, 2} and {3, 4, 5} joined by the edge {2, 3}.
+const std::vector<Edge>& TwoTriangles() {
+  static const auto* const kEdges = new std::vector<Edge>{
+      {0, 1, 1}, {0, 2, 1}, {1, 2, 1}, {3, 4, 1},
+      {3, 5, 1}, {4, 5, 1}, {2, 3, 1}};
+  return *kEdges;
+}
+
+absl::Status ImportEdges(const std::vector<Edge>& edges, GbbsGraph& graph) {
+  SimpleUndirectedGraph simple_graph;
+  for (const auto& [node_a, node_b, weight] : edges) {
+    RETURN_IF_ERROR(simple_graph.AddEdge(node_a, node_b, weight));
+  }
+  return CopyGraph(simple_graph, &graph);
+}
+
+// Returns the total weight of the edges with exactly one endpoint in cluster1.
+double CutWeight(const std::vector<Edge>& edges,
+                 const absl::flat_hash_set<NodeId>& cluster1) {
+  double cut_weight = 0;
+  for (const auto& [node_a, node_b, weight] : edges) {
+    if (cluster1.contains(node_a) != cluster1.contains(node_b)) {
+      cut_weight += weight;
+    }
+  }
+  return cut_weight;
+}
+
+// Returns cluster1 after applying the given moves.
+absl::flat_hash_set<NodeId> MoveNodes(
+    absl::flat_hash_set<NodeId> cluster1,
+    const absl::flat_hash_set<NodeId>& cluster1_to_cluster2,
+    const absl::flat_hash_set<NodeId>& cluster2_to_cluster1) {
+  for (const NodeId node_id : cluster1_to_cluster2) cluster1.erase(node_id);
+  cluster1.insert(cluster2_to_cluster1.begin(), cluster2_to_cluster1.end());
+  return cluster1;
+}
+
+TEST(BucketFMTest, SeparatesTriangles) {
+  GbbsGraph graph;
+  ASSERT_OK(ImportEdges(TwoTriangles(), graph));
+  // Nodes 2 and 3 are on the wrong sides, which cuts 5 edges.
+  const absl::flat_hash_set<NodeId> cluster1 = {0, 1, 3};
+  const absl::flat_hash_set<NodeId> cluster2 = {2, 4, 5};
+  absl::flat_hash_set<NodeId> cluster1_to_cluster2;
+  absl::flat_hash_set<NodeId> cluster2_to_cluster1;
+  const double improvement =
+      BucketFM().Improve(graph, cluster1, cluster2, /*max_cluster_weight=*/4,
+                         cluster1_to_cluster2, cluster2_to_cluster1);
+  EXPECT_EQ(improvement, 4);
+  const absl::flat_hash_set<NodeId> new_cluster1 =
+      MoveNodes(cluster1, cluster1_to_cluster2, cluster2_to_cluster1);
+  EXPECT_EQ(CutWeight(TwoTriangles(), new_cluster1), 1);
+  EXPECT_EQ(new_cluster1.size(), 3);
+}
+
+TEST(BucketFMTest, DenseViewMatchesHashSets) {
+  GbbsGraph graph;
+  ASSERT_OK(ImportEdges(TwoTriangles(), graph));
+  const std::vector<NodeId> cluster1 = {0, 1, 3};
+  const std::vector<NodeId> cluster2 = {2, 4, 5};
+  // Node 2 is at position 0 of cluster 7 and node 3 at position 2 of cluster 5.
+  const std::vector<int> node_cluster_ids = {5, 5, 7, 5, 7, 7};
+  const std::vector<NodeId> node_positions = {0, 1, 0, 2, 1, 2};
+  ClusterPairView pair;
+  pair.cluster1 = cluster1;
+  pair.cluster2 = cluster2;
+  pair.cluster1_id = 5;
+  pair.cluster2_id = 7;
+  pair.node_cluster_ids = node_cluster_ids;
+  pair.node_positions = node_positions;
+  std::vector<NodeId> cluster1_to_cluster2;
+  std::vector<NodeId> cluster2_to_cluster1;
+  const double improvement =
+      BucketFM().Improve(graph, pair, /*max_cluster_weight=*/4,
+                         cluster1_to_cluster2, cluster2_to_cluster1);
+  EXPECT_EQ(improvement, 4);
+  const absl::flat_hash_set<NodeId> new_cluster1 = MoveNodes(
+      {cluster1.begin(), cluster1.end()},
+      {cluster1_to_cluster2.begin(), cluster1_to_cluster2.end()},
+      {cluster2_to_cluster1.begin(), cluster2_to_cluster1.end()});
+  EXPECT_EQ(CutWeight(TwoTriangles(), new_cluster1), 1);
+}
+
+TEST(BucketFMTest, RespectsMaxClusterWeight) {
+  GbbsGraph graph;
+  ASSERT_OK(ImportEdges(TwoTriangles(), graph));
+  absl::flat_hash_set<NodeId> cluster1_to_cluster2;
+  absl::flat_hash_set<NodeId> cluster2_to_cluster1;
+  // Without slack, no single move keeps both clusters at weight 3.
+  EXPECT_EQ(BucketFM().Improve(graph, {0, 1, 3}, {2, 4, 5},
+                               /*max_cluster_weight=*/3, cluster1_to_cluster2,
+                               cluster2_to_cluster1),
+            0);
+  EXPECT_THAT(cluster1_to_cluster2, IsEmpty());
+  EXPECT_THAT(cluster2_to_cluster1, IsEmpty());
+}
+
+TEST(BucketFMTest, IgnoresSelfLoopsAndOutsideEdges) {
+  // Adds a heavy self-loop on node 2 and a heavy edge from node 3 to node 6,
+  // which is in neither cluster.
+  std::vector<Edge> edges = TwoTriangles();
+  edges.emplace_back(2, 2, 10);
+  edges.emplace_back(3, 6, 10);
+  GbbsGraph graph;
+  ASSERT_OK(ImportEdges(edges, graph));
+  const absl::flat_hash_set<NodeId> cluster1 = {0, 1, 3};
+  absl::flat_hash_set<NodeId> cluster1_to_cluster2;
+  absl::flat_hash_set<NodeId> cluster2_to_cluster1;
+  EXPECT_EQ(BucketFM(/*num_gain_buckets=*/4)
+                .Improve(graph, cluster1, {2, 4, 5}, /*max_cluster_weight=*/4,
+                         cluster1_to_cluster2, cluster2_to_cluster1),
+            4);
+  EXPECT_EQ(CutWeight(TwoTriangles(), MoveNodes(cluster1, cluster1_to_cluster2,
+                                                cluster2_to_cluster1)),
+            1);
+}
+
+}  // namespace
+}  // namespace graph_mining::in_memory
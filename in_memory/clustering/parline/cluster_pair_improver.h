@@ -18,12 +18,43 @@
 #ifndef RESEARCH_GRAPH_IN_MEMORY_BALANCED_PARTITIONER_CLUSTER_PAIR_IMPROVER_H_
 #define RESEARCH_GRAPH_IN_MEMORY_BALANCED_PARTITIONER_CLUSTER_PAIR_IMPROVER_H_
 
+#include <vector>
+
 #include "absl/container/flat_hash_set.h"
+#include "absl/types/span.h"
 #include "in_memory/clustering/gbbs_graph.h"
 #include "in_memory/clustering/types.h"
 
 namespace graph_mining::in_memory {
 
+// A dense view of two clusters of a partition of the whole graph. In addition
+// to the node ids of the two clusters it references node-indexed arrays giving
+// the cluster index of every node in the graph and its position within that
+// cluster, i.e. for every node v of the graph
+//     clusters[node_cluster_ids[v]][node_positions[v]] == v.
+// This allows constant time membership and local index lookups without any
+// hashing. None of the referenced arrays may be modified while the view is in
+// use.
+struct ClusterPairView {
+  absl::Span<const NodeId> cluster1;
+  absl::Span<const NodeId> cluster2;
+  int cluster1_id = -1;
+  int cluster2_id = -1;
+  absl::Span<const int> node_cluster_ids;
+  absl::Span<const NodeId> node_positions;
+
+  // Returns the index of a node in the concatenation of cluster1 and cluster2
+  // or -1 if the node belongs to neither of them.
+  NodeId LocalIndex(gbbs::uintE node_id) const {
+    const int cluster_id = node_cluster_ids[node_id];
+    if (cluster_id == cluster1_id) return node_positions[node_id];
+    if (cluster_id == cluster2_id) {
+      return cluster1.size() + node_positions[node_id];
+    }
+    return -1;
+  }
+};
+
 class ClusterPairImprover {
  public:
   virtual ~ClusterPairImprover() = default;
@@ -45,6 +76,29 @@ class ClusterPairImprover {
                          double max_cluster_weight,
                          absl::flat_hash_set<NodeId>& cluster1_to_cluster2,
                          absl::flat_hash_set<NodeId>& cluster2_to_cluster1) = 0;
+
+  // Same as above but the two clusters are given as a ClusterPairView and the
+  // nodes to move are appended to the output vectors. Implementations that
+  // work on dense node arrays should override this; the default implementation
+  // converts the input to hash sets and calls the function above.
+  virtual double Improve(const GbbsGraph& graph, const ClusterPairView& pair,
+                         double max_cluster_weight,
+                         std::vector<NodeId>& cluster1_to_cluster2,
+                         std::vector<NodeId>& cluster2_to_cluster1) {
+    const absl::flat_hash_set<NodeId> cluster1(pair.cluster1.begin(),
+                                               pair.cluster1.end());
+    const absl::flat_hash_set<NodeId> cluster2(pair.cluster2.begin(),
+                                               pair.cluster2.end());
+    absl::flat_hash_set<NodeId> moved1;
+    absl::flat_hash_set<NodeId> moved2;
+    const double improvement = Improve(graph, cluster1, cluster2,
+                                       max_cluster_weight, moved1, moved2);
+    cluster1_to_cluster2.insert(cluster1_to_cluster2.end(), moved1.begin(),
+                                moved1.end());
+    cluster2_to_cluster1.insert(cluster2_to_cluster1.end(), moved2.begin(),
+                                moved2.end());
+    return improvement;
+  }
 };
 
 }  // namespace graph_mining::in_memory
@@ -18,15 +18,18 @@
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/log/absl_check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
 #include "gbbs/macros.h"
 #include "in_memory/clustering/gbbs_graph.h"
 #include "in_memory/clustering/in_memory_clusterer.h"
 #include "in_memory/parallel/scheduler.h"
 #include "parlay/monoid.h"
 #include "parlay/parallel.h"
+#include "parlay/primitives.h"
 
 namespace graph_mining::in_memory {
 namespace {
@@ -88,4 +91,105 @@ absl::StatusOr<double> ComputeCutRatio(
       ConvertToCompactClustering(clustering, graph.Graph()->n), graph);
 }
 
+ClusterEdgeWeights::ClusterEdgeWeights(
+    const GbbsGraph& graph, const InMemoryClusterer::Clustering& clustering,
+    absl::Span<const int> node_cluster_ids)
+    : internal_weights_(clustering.size()),
+      external_weights_(clustering.size()) {
+  parlay::parallel_for(
+      0, clustering.size(),
+      [&](std::size_t i) {
+        const int cluster_id = i;
+        double internal_weight = 0;
+        double external_weight = 0;
+        auto add_edge_weight = [&](uintE, uintE neighbor_id, float weight) {
+          if (node_cluster_ids[neighbor_id] == cluster_id) {
+            internal_weight += weight;
+          } else {
+            external_weight += weight;
+          }
+        };
+        for (const NodeId node_id : clustering[cluster_id]) {
+          graph.Graph()->get_vertex(node_id).out_neighbors().map(
+              add_edge_weight, /*parallel=*/false);
+        }
+        internal_weights_[cluster_id] = internal_weight;
+        external_weights_[cluster_id] = external_weight;
+      },
+      /*granularity=*/1);
+  cut_weight_ = parlay::reduce(external_weights_, parlay::addm<double>());
+  total_weight_ =
+      cut_weight_ + parlay::reduce(internal_weights_, parlay::addm<double>());
+}
+
+void ClusterEdgeWeights::MoveNodes(
+    const GbbsGraph& graph,
+    const std::vector<std::pair<int, int>>& cluster_id_pairs,
+    const std::vector<std::vector<NodeId>>& cluster1_to_cluster2,
+    const std::vector<std::vector<NodeId>>& cluster2_to_cluster1,
+    absl::Span<const int> node_cluster_ids) {
+  std::vector<double> cut_weight_changes(cluster_id_pairs.size());
+  parlay::parallel_for(
+      0, cluster_id_pairs.size(),
+      [&](std::size_t i) {
+        if (cluster1_to_cluster2[i].empty() &&
+            cluster2_to_cluster1[i].empty()) {
+          return;
+        }
+        const auto [cluster1_id, cluster2_id] = cluster_id_pairs[i];
+        absl::flat_hash_set<NodeId> moved_nodes(
+            cluster1_to_cluster2[i].begin(), cluster1_to_cluster2[i].end());
+        moved_nodes.insert(cluster2_to_cluster1[i].begin(),
+                           cluster2_to_cluster1[i].end());
+        auto other_cluster = [&](int cluster_id) {
+          return cluster_id == cluster1_id ? cluster2_id : cluster1_id;
+        };
+        // Weights are changed only for the two clusters of the pair: an edge
+        // from a moved node to a node outside of the pair is external to the
+        // cluster of that node both before and after the move, even if that
+        // node is moved within its own pair at the same time.
+        double internal1 = 0, external1 = 0, internal2 = 0, external2 = 0;
+        auto add = [&](int cluster_id, bool internal, double weight) {
+          if (cluster_id == cluster1_id) {
+            (internal ? internal1 : external1) += weight;
+          } else {
+            (internal ? internal2 : external2) += weight;
+          }
+        };
+        for (const NodeId node_id : moved_nodes) {
+          const int new_cluster = node_cluster_ids[node_id];
+          const int old_cluster = other_cluster(new_cluster);
+          auto update_edge_weight = [&](uintE, uintE neighbor_id,
+                                        float weight) {
+            const int new_neighbor_cluster = node_cluster_ids[neighbor_id];
+            const bool neighbor_moved = moved_nodes.contains(neighbor_id);
+            const int old_neighbor_cluster =
+                neighbor_moved ? other_cluster(new_neighbor_cluster)
+                               : new_neighbor_cluster;
+            // The endpoint at the moved node.
+            add(old_cluster, old_neighbor_cluster == old_cluster, -weight);
+            add(new_cluster, new_neighbor_cluster == new_cluster, weight);
+            // The endpoint at a non-moved neighbor in the pair. (Moved
+            // neighbors are handled from their own side.)
+            if (!neighbor_moved && (new_neighbor_cluster == cluster1_id ||
+                                    new_neighbor_cluster == cluster2_id)) {
+              add(new_neighbor_cluster,
+                  old_cluster == new_neighbor_cluster, -weight);
+              add(new_neighbor_cluster,
+                  new_cluster == new_neighbor_cluster, weight);
+            }
+          };
+          graph.Graph()->get_vertex(node_id).out_neighbors().map(
+              update_edge_weight, /*parallel=*/false);
+        }
+        internal_weights_[cluster1_id] += internal1;
+        external_weights_[cluster1_id] += external1;
+        internal_weights_[cluster2_id] += internal2;
+        external_weights_[cluster2_id] += external2;
+        cut_weight_changes[i] = external1 + external2;
+      },
+      /*granularity=*/1);
+  cut_weight_ += parlay::reduce(cut_weight_changes, parlay::addm<double>());
+}
+
 }  // namespace graph_mining::in_memory
@@ -15,9 +15,11 @@
 #ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_PARLINE_CUT_SIZE_H_
 #define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_PARLINE_CUT_SIZE_H_
 
+#include <utility>
 #include <vector>
 
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
 #include "gbbs/macros.h"
 #include "in_memory/clustering/gbbs_graph.h"
 #include "in_memory/clustering/in_memory_clusterer.h"
@@ -38,6 +40,59 @@ absl::StatusOr<double> ComputeCutRatio(
 absl::StatusOr<double> ComputeCutRatio(
     const InMemoryClusterer::Clustering& clustering, const GbbsGraph& graph);
 
+// Maintains the internal and external edge weights of each cluster of a
+// clustering so that the cut ratio (see ComputeCutRatio) is available in O(1)
+// time while nodes are moved between clusters. The internal (external) weight
+// of a cluster is the total weight of the edges from its nodes to nodes in
+// the same (a different) cluster. As in ComputeCutRatio, both directions of
+// each edge are counted.
+class ClusterEdgeWeights {
+ public:
+  using NodeId = InMemoryClusterer::NodeId;
+
+  // Computes the weights in a single pass over the edges of the graph.
+  // node_cluster_ids[i] must be the index of the cluster containing node i.
+  ClusterEdgeWeights(const GbbsGraph& graph,
+                     const InMemoryClusterer::Clustering& clustering,
+                     absl::Span<const int> node_cluster_ids);
+
+  // Updates the weights after nodes are moved between pairs of clusters in
+  // parallel: cluster1_to_cluster2[i] (cluster2_to_cluster1[i]) are the nodes
+  // moved from cluster_id_pairs[i].first to cluster_id_pairs[i].second (and
+  // vice versa). The pairs must be disjoint and node_cluster_ids must already
+  // reflect the moves. Takes time proportional to the total degree of the
+  // moved nodes.
+  void MoveNodes(const GbbsGraph& graph,
+                 const std::vector<std::pair<int, int>>& cluster_id_pairs,
+                 const std::vector<std::vector<NodeId>>& cluster1_to_cluster2,
+                 const std::vector<std::vector<NodeId>>& cluster2_to_cluster1,
+                 absl::Span<const int> node_cluster_ids);
+
+  double InternalWeight(int cluster_id) const {
+    return internal_weights_[cluster_id];
+  }
+  double ExternalWeight(int cluster_id) const {
+    return external_weights_[cluster_id];
+  }
+
+  // Sum of the external weights of all the clusters.
+  double CutWeight() const { return cut_weight_; }
+
+  // Total edge weight of the graph.
+  double TotalWeight() const { return total_weight_; }
+
+  // Returns CutWeight() / TotalWeight(), or 0 if the graph has no edges.
+  double CutRatio() const {
+    return total_weight_ == 0 ? 0 : cut_weight_ / total_weight_;
+  }
+
+ private:
+  std::vector<double> internal_weights_;
+  std::vector<double> external_weights_;
+  double cut_weight_ = 0;
+  double total_weight_ = 0;
+};
+
 }  // namespace graph_mining::in_memory
 
 #endif  // THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_PARLINE_CUT_SIZE_H_
@@ -24,6 +24,8 @@ namespace graph_mining::in_memory {
 
 class FMBase : public ClusterPairImprover {
  public:
+  using ClusterPairImprover::Improve;
+
   // Runs one pass of the Fiduccia-Mattheyses post-processing algorithm on
   // cluster1 and cluster2. The original paper for FM is located at:
   // http://web.eecs.umich.edu/~mazum/fmcut1.pdf
@@ -0,0 +1,437 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/clustering/parline/kway_refiner.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "absl/log/absl_log.h"
+#include "gbbs/bridge.h"
+#include "gbbs/graph.h"
+#include "gbbs/macros.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/clustering/parline/parline.pb.h"
+#include "in_memory/clustering/parline/parline_util.h"
+#include "in_memory/parallel/per_worker.h"
+#include "parlay/delayed_sequence.h"
+#include "parlay/monoid.h"
+#include "parlay/parallel.h"
+#include "parlay/primitives.h"
+#include "parlay/sequence.h"
+
+namespace graph_mining::in_memory {
+namespace {
+
+using WeightedUndirectedGraph =
+    gbbs::symmetric_ptr_graph<gbbs::symmetric_vertex, float>;
+
+// Maximum number of rebalancing rounds in each iteration. A round may overfill
+// some destination clusters, which are then rebalanced in the next round.
+constexpr int kMaxRebalancingRounds = 4;
+
+// No move for a node.
+constexpr int kNoMove = -1;
+
+double NodeWeight(const WeightedUndirectedGraph& graph, std::size_t node_id) {
+  return graph.vertex_weights == nullptr ? 1.0 : graph.vertex_weights[node_id];
+}
+
+// Total weight of the edges from a node to each cluster. Meant to be reused
+// for all the nodes processed by a worker: clearing takes time proportional to
+// the number of clusters the last node was connected to.
+class Connectivity {
+ public:
+  // Sets the connectivity to that of node_id, where cluster_of(u) is the
+  // cluster of neighbor u. Self-loops are ignored. Must be cleared before
+  // being computed again.
+  template <typename ClusterOf>
+  void Compute(WeightedUndirectedGraph& graph, int num_clusters,
+               gbbs::uintE node_id, const ClusterOf& cluster_of) {
+    if (entry_indices_.size() < static_cast<std::size_t>(num_clusters)) {
+      entry_indices_.resize(num_clusters, -1);
+    }
+    auto add_edge = [&](gbbs::uintE, gbbs::uintE neighbor_id, float weight) {
+      if (neighbor_id == node_id) return;
+      const int cluster_id = cluster_of(neighbor_id);
+      if (entry_indices_[cluster_id] < 0) {
+        entry_indices_[cluster_id] = entries_.size();
+        entries_.emplace_back(cluster_id, 0.0);
+      }
+      entries_[entry_indices_[cluster_id]].second += weight;
+    };
+    graph.get_vertex(node_id).out_neighbors().map(add_edge,
+                                                  /*parallel=*/false);
+  }
+
+  void Clear() {
+    for (const auto& [cluster_id, weight] : entries_) {
+      entry_indices_[cluster_id] = -1;
+    }
+    entries_.clear();
+  }
+
+  double To(int cluster_id) const {
+    const int index = entry_indices_[cluster_id];
+    return index < 0 ? 0 : entries_[index].second;
+  }
+
+  // (cluster id, weight) for each cluster with an edge from the node.
+  const std::vector<std::pair<int, double>>& Entries() const {
+    return entries_;
+  }
+
+ private:
+  // Index in entries_ of each cluster, or -1.
+  std::vector<int> entry_indices_;
+  std::vector<std::pair<int, double>> entries_;
+};
+
+// Current assignment of the nodes to the clusters.
+struct Partition {
+  std::vector<int> cluster_ids;
+  std::vector<double> cluster_weights;
+  // Total weight of the edges between different clusters, counting both
+  // directions of each edge. Maintained by ApplyMoves.
+  double cut_weight = 0;
+
+  void Move(gbbs::uintE node_id, int cluster_id, double node_weight) {
+    gbbs::write_add(&cluster_weights[cluster_ids[node_id]], -node_weight);
+    gbbs::write_add(&cluster_weights[cluster_id], node_weight);
+    cluster_ids[node_id] = cluster_id;
+  }
+
+  // Total weight exceeding max_cluster_weight over all the clusters.
+  double ExcessWeight(double max_cluster_weight) const {
+    return parlay::reduce(
+        parlay::delayed_seq<double>(
+            cluster_weights.size(),
+            [&](std::size_t i) {
+              return std::max(0.0, cluster_weights[i] - max_cluster_weight);
+            }),
+        parlay::addm<double>());
+  }
+
+  // Computes cut_weight from scratch.
+  double CutWeight(WeightedUndirectedGraph& graph) const {
+    auto cut_weight = [&](gbbs::uintE u, gbbs::uintE v, float weight) {
+      return cluster_ids[u] != cluster_ids[v] ? static_cast<double>(weight)
+                                              : 0.0;
+    };
+    return graph.reduceEdges(cut_weight, parlay::addm<double>());
+  }
+};
+
+Partition CreatePartition(WeightedUndirectedGraph& graph,
+                          const InMemoryClusterer::Clustering& clustering) {
+  Partition partition{std::vector<int>(graph.n, 0),
+                      std::vector<double>(clustering.size(), 0), 0};
+  parlay::parallel_for(
+      0, clustering.size(),
+      [&](std::size_t i) {
+        double cluster_weight = 0;
+        for (const auto node_id : clustering[i]) {
+          partition.cluster_ids[node_id] = i;
+          cluster_weight += NodeWeight(graph, node_id);
+        }
+        partition.cluster_weights[i] = cluster_weight;
+      },
+      /*granularity=*/1);
+  partition.cut_weight = partition.CutWeight(graph);
+  return partition;
+}
+
+// Moves each of the moved_nodes to its cluster in destinations (which is
+// kNoMove for all the other nodes) and updates the cut weight. Takes time
+// proportional to the total degree of the moved nodes.
+void ApplyMoves(WeightedUndirectedGraph& graph,
+                const parlay::sequence<gbbs::uintE>& moved_nodes,
+                const std::vector<int>& destinations, Partition& partition) {
+  const auto& cluster_ids = partition.cluster_ids;
+  auto new_cluster = [&](gbbs::uintE u) {
+    return destinations[u] == kNoMove ? cluster_ids[u] : destinations[u];
+  };
+  const double cut_weight_change = parlay::reduce(
+      parlay::delayed_seq<double>(
+          moved_nodes.size(),
+          [&](std::size_t i) {
+            const gbbs::uintE u = moved_nodes[i];
+            double change = 0;
+            auto add_edge = [&](gbbs::uintE, gbbs::uintE v, float weight) {
+              const int cut_change =
+                  static_cast<int>(new_cluster(u) != new_cluster(v)) -
+                  static_cast<int>(cluster_ids[u] != cluster_ids[v]);
+              // Both directions of an edge to a non-moved node are counted
+              // here; an edge between moved nodes is counted from both sides.
+              change += cut_change * static_cast<double>(weight) *
+                        (destinations[v] == kNoMove ? 2 : 1);
+            };
+            graph.get_vertex(u).out_neighbors().map(add_edge,
+                                                    /*parallel=*/false);
+            return change;
+          }),
+      parlay::addm<double>());
+  parlay::parallel_for(0, moved_nodes.size(), [&](std::size_t i) {
+    const gbbs::uintE node_id = moved_nodes[i];
+    partition.Move(node_id, destinations[node_id], NodeWeight(graph, node_id));
+  });
+  partition.cut_weight += cut_weight_change;
+}
+
+// Performs the label propagation step: computes candidate moves, filters them
+// and applies the remaining ones. Returns the number of moved nodes.
+std::size_t PropagateLabels(WeightedUndirectedGraph& graph,
+                            double max_cluster_weight,
+                            double negative_gain_factor,
+                            PerWorker<Connectivity>& scratch,
+                            Partition& partition) {
+  const std::size_t num_nodes = graph.n;
+  const int num_clusters = partition.cluster_weights.size();
+  const auto& cluster_ids = partition.cluster_ids;
+  const auto& cluster_weights = partition.cluster_weights;
+  // 1) Each node picks the neighboring cluster with the largest connectivity
+  // among those with room for it.
+  std::vector<int> targets(num_nodes, kNoMove);
+  std::vector<double> gains(num_nodes, 0);
+  parlay::parallel_for(0, num_nodes, [&](std::size_t i) {
+    const int cluster_id = cluster_ids[i];
+    const double node_weight = NodeWeight(graph, i);
+    Connectivity& connectivity = scratch.Get();
+    connectivity.Compute(graph, num_clusters, i,
+                         [&](gbbs::uintE u) { return cluster_ids[u]; });
+    const double own_connectivity = connectivity.To(cluster_id);
+    int best_cluster = kNoMove;
+    double best_connectivity = 0;
+    for (const auto& [other_cluster, other_connectivity] :
+         connectivity.Entries()) {
+      if (other_cluster == cluster_id ||
+          cluster_weights[other_cluster] + node_weight > max_cluster_weight) {
+        continue;
+      }
+      if (best_cluster == kNoMove ||
+          std::make_tuple(other_connectivity, -cluster_weights[other_cluster],
+                          -other_cluster) >
+              std::make_tuple(best_connectivity, -cluster_weights[best_cluster],
+                              -best_cluster)) {
+        best_cluster = other_cluster;
+        best_connectivity = other_connectivity;
+      }
+    }
+    connectivity.Clear();
+    if (best_cluster == kNoMove) return;
+    const double gain = best_connectivity - own_connectivity;
+    if (gain > 0 || -gain <= negative_gain_factor * own_connectivity) {
+      targets[i] = best_cluster;
+      gains[i] = gain;
+    }
+  });
+
+  // 2) Recompute the gain of each candidate assuming that the neighboring
+  // candidates with higher priority (larger gain, then smaller id) have
+  // already moved, and keep the candidates whose recomputed gain is positive.
+  auto has_priority = [&](gbbs::uintE u, gbbs::uintE v) {
+    return gains[u] > gains[v] || (gains[u] == gains[v] && u < v);
+  };
+  auto moves = parlay::filter(
+      parlay::iota<gbbs::uintE>(num_nodes), [&](gbbs::uintE i) {
+        if (targets[i] == kNoMove) return false;
+        Connectivity& connectivity = scratch.Get();
+        connectivity.Compute(graph, num_clusters, i, [&](gbbs::uintE u) {
+          return targets[u] != kNoMove && has_priority(u, i) ? targets[u]
+                                                             : cluster_ids[u];
+        });
+        const double gain = connectivity.To(targets[i]) -
+                            connectivity.To(cluster_ids[i]);
+        connectivity.Clear();
+        return gain > 0;
+      });
+
+  // 3) Apply the moves.
+  std::vector<int> destinations(num_nodes, kNoMove);
+  parlay::parallel_for(0, moves.size(), [&](std::size_t i) {
+    destinations[moves[i]] = targets[moves[i]];
+  });
+  ApplyMoves(graph, moves, destinations, partition);
+  return moves.size();
+}
+
+// Moves nodes out of the clusters heavier than max_cluster_weight, choosing
+// the nodes with the smallest loss (per unit of weight) first.
+void Rebalance(WeightedUndirectedGraph& graph, double max_cluster_weight,
+               PerWorker<Connectivity>& scratch, Partition& partition) {
+  const std::size_t num_nodes = graph.n;
+  const int num_clusters = partition.cluster_weights.size();
+  for (int round = 0; round < kMaxRebalancingRounds; ++round) {
+    const auto& cluster_ids = partition.cluster_ids;
+    const std::vector<double> cluster_weights = partition.cluster_weights;
+    auto overweight = [&](int cluster_id) {
+      return cluster_weights[cluster_id] > max_cluster_weight;
+    };
+    if (std::none_of(cluster_weights.begin(), cluster_weights.end(),
+                     [&](double weight) {
+                       return weight > max_cluster_weight;
+                     })) {
+      return;
+    }
+    const int lightest_cluster =
+        parlay::min_element(cluster_weights) - cluster_weights.begin();
+
+    // (source cluster, loss per unit weight, node id, destination cluster) for
+    // each node of an overweight cluster.
+    using Candidate = std::tuple<int, double, gbbs::uintE, int>;
+    auto overweight_nodes = parlay::filter(
+        parlay::iota<gbbs::uintE>(num_nodes),
+        [&](gbbs::uintE i) { return overweight(cluster_ids[i]); });
+    auto candidates = parlay::sequence<Candidate>::from_function(
+        overweight_nodes.size(), [&](std::size_t j) {
+          const gbbs::uintE i = overweight_nodes[j];
+          const double node_weight = NodeWeight(graph, i);
+          Connectivity& connectivity = scratch.Get();
+          connectivity.Compute(graph, num_clusters, i, [&](gbbs::uintE u) {
+            return cluster_ids[u];
+          });
+          // The lightest cluster is the best destination without any edges
+          // to the node.
+          int best_cluster = lightest_cluster;
+          double best_connectivity = connectivity.To(lightest_cluster);
+          for (const auto& [other_cluster, other_connectivity] :
+               connectivity.Entries()) {
+            if (overweight(other_cluster) ||
+                cluster_weights[other_cluster] + node_weight >
+                    max_cluster_weight) {
+              continue;
+            }
+            if (std::make_tuple(other_connectivity,
+                                -cluster_weights[other_cluster],
+                                -other_cluster) >
+                std::make_tuple(best_connectivity,
+                                -cluster_weights[best_cluster],
+                                -best_cluster)) {
+              best_cluster = other_cluster;
+              best_connectivity = other_connectivity;
+            }
+          }
+          const double loss =
+              connectivity.To(cluster_ids[i]) - best_connectivity;
+          connectivity.Clear();
+          return Candidate{cluster_ids[i], loss / node_weight, i,
+                           best_cluster};
+        });
+    parlay::sort_inplace(candidates);
+
+    // Each overweight cluster moves out its prefix of candidates until it is
+    // within max_cluster_weight.
+    std::vector<int> destinations(num_nodes, kNoMove);
+    auto group_starts = parlay::pack_index<std::size_t>(
+        parlay::delayed_seq<bool>(candidates.size(), [&](std::size_t j) {
+          return j == 0 || std::get<0>(candidates[j - 1]) !=
+                               std::get<0>(candidates[j]);
+        }));
+    parlay::parallel_for(
+        0, group_starts.size(),
+        [&](std::size_t g) {
+          const std::size_t end = g + 1 < group_starts.size()
+                                      ? group_starts[g + 1]
+                                      : candidates.size();
+          double excess_weight =
+              cluster_weights[std::get<0>(candidates[group_starts[g]])] -
+              max_cluster_weight;
+          for (std::size_t j = group_starts[g]; j < end && excess_weight > 0;
+               ++j) {
+            const auto& [source, loss, node_id, destination] = candidates[j];
+            if (destination == source) continue;
+            destinations[node_id] = destination;
+            excess_weight -= NodeWeight(graph, node_id);
+          }
+        },
+        /*granularity=*/1);
+    ApplyMoves(graph,
+               parlay::filter(overweight_nodes,
+                              [&](gbbs::uintE i) {
+                                return destinations[i] != kNoMove;
+                              }),
+               destinations, partition);
+  }
+}
+
+}  // namespace
+
+InMemoryClusterer::Clustering ImproveClustersKWay(
+    const GbbsGraph& graph,
+    const InMemoryClusterer::Clustering& initial_clustering,
+    const LinePartitionerConfig& line_config) {
+  if (initial_clustering.size() < 2 ||
+      !line_config.local_search_config().has_kway_refiner_config()) {
+    return initial_clustering;
+  }
+  const KWayRefinerConfig& config =
+      line_config.local_search_config().kway_refiner_config();
+  WeightedUndirectedGraph& gbbs_graph = *graph.Graph();
+  const int num_clusters = initial_clustering.size();
+  const double max_cluster_weight = (1 + line_config.imbalance()) *
+                                    ComputeTotalNodeWeight(graph) /
+                                    num_clusters;
+
+  Partition partition = CreatePartition(gbbs_graph, initial_clustering);
+  PerWorker<Connectivity> scratch;
+  std::vector<int> best_cluster_ids = partition.cluster_ids;
+  double best_excess_weight = partition.ExcessWeight(max_cluster_weight);
+  double best_cut_weight = partition.cut_weight;
+  int iterations_without_improvement = 0;
+  for (int iteration = 0; iteration < config.num_iterations() &&
+                          iterations_without_improvement <
+                              config.max_iterations_without_improvement();
+       ++iteration) {
+    const std::size_t num_moves =
+        PropagateLabels(gbbs_graph, max_cluster_weight,
+                        config.negative_gain_factor(), scratch, partition);
+    Rebalance(gbbs_graph, max_cluster_weight, scratch, partition);
+    const double excess_weight = partition.ExcessWeight(max_cluster_weight);
+    const double cut_weight = partition.cut_weight;
+    ABSL_VLOG(1) << "K-way refinement iteration " << iteration + 1 << ": "
+                 << num_moves << " moves, cut weight " << cut_weight
+                 << ", excess weight " << excess_weight;
+    if (std::tie(excess_weight, cut_weight) <
+        std::tie(best_excess_weight, best_cut_weight)) {
+      best_cluster_ids = partition.cluster_ids;
+      best_excess_weight = excess_weight;
+      best_cut_weight = cut_weight;
+      iterations_without_improvement = 0;
+    } else {
+      ++iterations_without_improvement;
+    }
+    if (num_moves == 0 && excess_weight == 0) break;
+  }
+
+  // Convert back to clusters keeping the cluster indices.
+  auto cluster_nodes = parlay::group_by_index(
+      parlay::delayed_seq<std::pair<int, InMemoryClusterer::NodeId>>(
+          best_cluster_ids.size(),
+          [&](std::size_t i) {
+            return std::make_pair(best_cluster_ids[i],
+                                  static_cast<InMemoryClusterer::NodeId>(i));
+          }),
+      num_clusters);
+  InMemoryClusterer::Clustering clustering(num_clusters);
+  parlay::parallel_for(0, num_clusters, [&](std::size_t i) {
+    clustering[i].assign(cluster_nodes[i].begin(), cluster_nodes[i].end());
+  });
+  return clustering;
+}
+
+}  // namespace graph_mining::in_memory
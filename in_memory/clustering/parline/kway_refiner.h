@@ -0,0 +1,47 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_PARLINE_KWAY_REFINER_H_
+#define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_PARLINE_KWAY_REFINER_H_
+
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/clustering/parline/parline.pb.h"
+
+namespace graph_mining::in_memory {
+
+// Improves an input clustering with a parallel size-constrained k-way label
+// propagation in the spirit of the Jet refinement algorithm
+// (https://arxiv.org/abs/2304.13194), configured by
+// line_config.local_search_config().kway_refiner_config(). Each iteration
+//   1) computes for every node the best cluster to move to among the clusters
+//      of its neighbors which have room for it,
+//   2) filters the candidate moves by recomputing their gains assuming that
+//      the neighboring candidates with higher priority (larger gain) have
+//      already moved, which prevents neighbors from swapping back and forth,
+//   3) applies the remaining moves in parallel, and
+//   4) moves the nodes with the smallest loss out of the clusters that exceed
+//      the maximum cluster weight
+//          avg_cluster_weight * (1 + line_config.imbalance()).
+// The best clustering found (fewest excess weight, then smallest cut) is
+// returned. Cluster indices of the input clustering are kept (empty clusters
+// included).
+InMemoryClusterer::Clustering ImproveClustersKWay(
+    const GbbsGraph& graph,
+    const InMemoryClusterer::Clustering& initial_clustering,
+    const LinePartitionerConfig& line_config);
+
+}  // namespace graph_mining::in_memory
+
+#endif  // THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_PARLINE_KWAY_REFINER_H_
@@ -0,0 +1,58 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/clustering/parline/linear_embedder.h"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "gbbs/macros.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "parlay/parallel.h"
+#include "parlay/primitives.h"
+
+namespace graph_mining::in_memory {
+
+absl::StatusOr<std::vector<std::pair<gbbs::uintE, double>>>
+ComputeWeightedEmbedding(const GbbsGraph& graph,
+                         const std::vector<gbbs::uintE>& embedding) {
+  const auto& g = graph.Graph();
+  std::size_t num_nodes = g->num_vertices();
+  if (g->vertex_weights == nullptr) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Input graph does not have any node weights."));
+  }
+  if (embedding.size() != num_nodes) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Embedding size %d does not match the number of nodes %d.",
+        embedding.size(), num_nodes));
+  }
+  const auto* node_weights = g->vertex_weights;
+  std::vector<double> weight_prefix_sums(num_nodes);
+  parlay::parallel_for(0, num_nodes, [&](std::size_t i) {
+    weight_prefix_sums[i] = node_weights[embedding[i]];
+  });
+  parlay::scan_inplace(weight_prefix_sums);
+  std::vector<std::pair<gbbs::uintE, double>> weighted_embedding(num_nodes);
+  parlay::parallel_for(0, num_nodes, [&](std::size_t i) {
+    weighted_embedding[i] = std::make_pair(embedding[i], weight_prefix_sums[i]);
+  });
+  return weighted_embedding;
+}
+
+}  // namespace graph_mining::in_memory
@@ -15,7 +15,11 @@
 #ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_PARLINE_LINEAR_EMBEDDER_H_
 #define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_PARLINE_LINEAR_EMBEDDER_H_
 
+#include <utility>
+#include <vector>
+
 #include "absl/status/statusor.h"
+#include "gbbs/macros.h"
 #include "in_memory/clustering/gbbs_graph.h"
 
 namespace graph_mining::in_memory {
@@ -41,6 +45,14 @@ class LinearEmbedder {
   EmbedGraphWeighted(const GbbsGraph& graph) = 0;
 };
 
+// Converts an embedding (as returned by LinearEmbedder::EmbedGraph) into a
+// weighted embedding (as returned by LinearEmbedder::EmbedGraphWeighted) using
+// the node weights of the graph. Returns an error if the graph does not have
+// node weights.
+absl::StatusOr<std::vector<std::pair<gbbs::uintE, double>>>
+ComputeWeightedEmbedding(const GbbsGraph& graph,
+                         const std::vector<gbbs::uintE>& embedding);
+
 }  // namespace graph_mining::in_memory
 
 #endif  // THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_PARLINE_LINEAR_EMBEDDER_H_
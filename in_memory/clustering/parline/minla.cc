@@ -21,10 +21,16 @@
 #include <vector>
 
 #include "absl/log/absl_check.h"
+#include "absl/log/absl_log.h"
+#include "absl/status/statusor.h"
+#include "gbbs/bridge.h"
 #include "parlay/primitives.h"
+#include "parlay/sequence.h"
 #include "in_memory/clustering/gbbs_graph.h"
 #include "in_memory/clustering/parline/minla_cost_metric.h"
 #include "in_memory/clustering/parline/minla.pb.h"
+#include "in_memory/clustering/parline/multilevel.h"
+#include "in_memory/clustering/parline/parline.pb.h"
 #include "in_memory/parallel/scheduler.h"
 #include "in_memory/status_macros.h"
 
@@ -34,6 +40,7 @@ namespace {
 using uintE = ::gbbs::uintE;
 
 const int kDefaultMaxIterations = 20;
+const int kDefaultCoarsestNumNodes = 1024;
 
 MinimumLinearArrangementConfig MinimumLinearArrangementConfigWithDefaults(
     MinimumLinearArrangementConfig minla_config) {
@@ -41,9 +48,113 @@ MinimumLinearArrangementConfig MinimumLinearArrangementConfigWithDefaults(
   if (!minla_config.has_max_iterations()) {
     minla_config.set_max_iterations(kDefaultMaxIterations);
   }
+  if (!minla_config.has_coarsest_num_nodes()) {
+    minla_config.set_coarsest_num_nodes(kDefaultCoarsestNumNodes);
+  }
   return minla_config;
 }
 
+// Returns the arrangement of a fine graph where each node takes the location of
+// its coarse node in coarse_minla (ties are broken by node id).
+std::vector<uintE> ProjectArrangement(
+    const std::vector<uintE>& coarse_minla,
+    const std::vector<uintE>& fine_to_coarse) {
+  std::vector<uintE> coarse_locations(coarse_minla.size());
+  parlay::parallel_for(0, coarse_minla.size(), [&](std::size_t i) {
+    coarse_locations[coarse_minla[i]] = i;
+  });
+  std::vector<uintE> fine_minla(fine_to_coarse.size());
+  parlay::copy(parlay::iota<uintE>(fine_to_coarse.size()), fine_minla);
+  parlay::sort_inplace(fine_minla, [&](uintE i, uintE j) {
+    const uintE location_i = coarse_locations[fine_to_coarse[i]];
+    const uintE location_j = coarse_locations[fine_to_coarse[j]];
+    return location_i < location_j || (location_i == location_j && i < j);
+  });
+  return fine_minla;
+}
+
+// Rescales the node locations to [0,n-1] range to prevent them from
+// collapsing.
+void RescaleLocations(std::vector<double>& node_locations, int iteration) {
+  auto min_max = parlay::minmax_element(node_locations);
+  double min_value = *min_max.first;
+  double max_value = *min_max.second;
+  ABSL_CHECK_GT(max_value, min_value)
+      << "All new locations collapsed to a single point at iteration "
+      << iteration;
+  const double scaling_factor =
+      (node_locations.size() - 1) / (max_value - min_value);
+  parlay::parallel_for(0, node_locations.size(), [&](std::size_t j) {
+    node_locations[j] = (node_locations[j] - min_value) * scaling_factor;
+  });
+}
+
+// Runs the iterations of MinimumLinearArrangement::Improve on the active nodes
+// only (see MinimumLinearArrangementConfig.active_set_threshold). The work of
+// an iteration is proportional to the degrees of the active nodes. Rescaling
+// touches all the nodes, so it is done only once the number of nodes
+// recomputed since the previous rescaling reaches the number of nodes.
+void ImproveActiveNodes(const GbbsGraph& graph,
+                        const MinlaCostMetric& minla_cost_metric,
+                        const MinimumLinearArrangementConfig& config,
+                        std::vector<double>& node_locations) {
+  const std::size_t num_nodes = node_locations.size();
+  parlay::sequence<uintE> active_nodes = parlay::iota<uintE>(num_nodes);
+  // Marks the nodes added to the next active set. All false between
+  // iterations.
+  parlay::sequence<bool> next_active(num_nodes, false);
+  std::size_t num_recomputed = 0;
+  for (int i = 0; i < config.max_iterations() && !active_nodes.empty(); ++i) {
+    // 1) Compute the new locations of the active nodes. They are written back
+    // only after all of them are computed, so that all the nodes see the
+    // locations of the previous iteration.
+    auto new_locations = parlay::map(active_nodes, [&](uintE node_id) {
+      return minla_cost_metric.ImproveNodeLocation(node_id, node_locations,
+                                                   graph);
+    });
+    auto moved_nodes = parlay::pack(
+        active_nodes,
+        parlay::delayed_seq<bool>(active_nodes.size(), [&](std::size_t j) {
+          return std::abs(new_locations[j] - node_locations[active_nodes[j]]) >
+                 config.active_set_threshold();
+        }));
+    parlay::parallel_for(0, active_nodes.size(), [&](std::size_t j) {
+      node_locations[active_nodes[j]] = new_locations[j];
+    });
+
+    // 2) The next active set consists of the moved nodes and their neighbors.
+    auto activate = [&](uintE node_id) {
+      return gbbs::atomic_compare_and_swap(&next_active[node_id], false, true);
+    };
+    active_nodes = parlay::flatten(parlay::map(
+        moved_nodes,
+        [&](uintE node_id) {
+          parlay::sequence<uintE> activated;
+          if (activate(node_id)) activated.push_back(node_id);
+          graph.Graph()->get_vertex(node_id).out_neighbors().map(
+              [&](uintE, uintE neighbor_id, float) {
+                if (activate(neighbor_id)) activated.push_back(neighbor_id);
+              },
+              /*parallel=*/false);
+          return activated;
+        },
+        /*granularity=*/1));
+    parlay::parallel_for(0, active_nodes.size(), [&](std::size_t j) {
+      next_active[active_nodes[j]] = false;
+    });
+    ABSL_VLOG(1) << "MinLA iteration " << i << ": " << moved_nodes.size()
+                 << " nodes moved, " << active_nodes.size()
+                 << " nodes active";
+
+    // 3) Rescale the node locations to [0,n-1] range.
+    num_recomputed += new_locations.size();
+    if (num_recomputed >= num_nodes) {
+      RescaleLocations(node_locations, i);
+      num_recomputed = 0;
+    }
+  }
+}
+
 }  // namespace
 
 MinimumLinearArrangement::MinimumLinearArrangement(
@@ -51,9 +162,19 @@ MinimumLinearArrangement::MinimumLinearArrangement(
   config_ = MinimumLinearArrangementConfigWithDefaults(config);
 }
 
-std::vector<uintE>
-MinimumLinearArrangement::Compute(const GbbsGraph& graph) const {
-  
+std::vector<uintE> MinimumLinearArrangement::Compute(
+    const GbbsGraph& graph) const {
+  absl::StatusOr<std::vector<uintE>> minla = TryCompute(graph);
+  ABSL_CHECK_OK(minla.status());
+  return *std::move(minla);
+}
+
+absl::StatusOr<std::vector<uintE>> MinimumLinearArrangement::TryCompute(
+    const GbbsGraph& graph) const {
+  if (config_.initialization() ==
+      MinimumLinearArrangementConfig::AFFINITY_HIERARCHY) {
+    return ComputeCoarseToFine(graph);
+  }
   std::size_t num_nodes = graph.Graph()->n;
   // Entry i is the node id at location i. This is the minla ordering we are
   // interested in computing.
@@ -64,6 +185,30 @@ MinimumLinearArrangement::Compute(const GbbsGraph& graph) const {
   return minla;
 }
 
+absl::StatusOr<std::vector<uintE>>
+MinimumLinearArrangement::ComputeCoarseToFine(const GbbsGraph& graph) const {
+  MultilevelConfig coarsening_config;
+  coarsening_config.set_coarsening_method(MultilevelConfig::AFFINITY);
+  coarsening_config.set_coarsest_nodes_per_cluster(
+      config_.coarsest_num_nodes());
+  ASSIGN_OR_RETURN(
+      std::vector<CoarseningLevel> levels,
+      CoarsenGraph(graph, /*num_clusters=*/1, coarsening_config));
+
+  MinimumLinearArrangementConfig node_id_order_config = config_;
+  node_id_order_config.set_initialization(
+      MinimumLinearArrangementConfig::NODE_ID_ORDER);
+  const MinimumLinearArrangement coarsest_minla(node_id_order_config);
+  std::vector<uintE> minla =
+      coarsest_minla.Compute(levels.empty() ? graph : *levels.back().graph);
+  for (int level = levels.size() - 1; level >= 0; --level) {
+    minla = ProjectArrangement(minla, levels[level].fine_to_coarse);
+    Improve(level > 0 ? *levels[level - 1].graph : graph, minla);
+    ABSL_VLOG(1) << "Done with MinLA at level " << level;
+  }
+  return minla;
+}
+
 // Implements a modified version of the iterative median (or mean) algorithm
 // described in:
 //    https://www.wisdom.weizmann.ac.il/~harel/papers/min_la.pdf
@@ -73,46 +218,40 @@ MinimumLinearArrangement::Compute(const GbbsGraph& graph) const {
 //   - Node's own location is also included in improved location computations
 void MinimumLinearArrangement::Improve(const GbbsGraph& graph,
                                        std::vector<uintE>& minla) const {
-  
   std::size_t num_nodes = graph.Graph()->n;
   // Node id to location array for fast lookup.
   std::vector<double> node_locations(num_nodes);
   parlay::parallel_for(0, num_nodes,
                        [&](std::size_t i) { node_locations[minla[i]] = i; });
-  // Entry i is the new computed node location (as double) of node with id i.
-  std::vector<double> new_node_locations(num_nodes);
   auto minla_cost_metric = CreateMinlaCostMetric(config_);
+  if (config_.active_set_threshold() > 0) {
+    ImproveActiveNodes(graph, *minla_cost_metric, config_, node_locations);
+  } else {
+    // Entry i is the new computed node location (as double) of node with id
+    // i.
+    std::vector<double> new_node_locations(num_nodes);
+    double cost_diff = std::numeric_limits<double>::max();
+    double prev_cost = minla_cost_metric->ComputeCostFromNodeLocations(
+        node_locations, graph);
+    for (int i = 0; i < config_.max_iterations() &&
+                    cost_diff > config_.placement_convergence_delta();
+         ++i) {
+      // 1) Iterate through all the nodes and compute their new locations.
+      parlay::parallel_for(0, num_nodes, [&](std::size_t j) {
+        new_node_locations[j] =
+            minla_cost_metric->ImproveNodeLocation(j, node_locations, graph);
+      });
 
-  double cost_diff = std::numeric_limits<double>::max();
-  double prev_cost =
-      minla_cost_metric->ComputeCostFromNodeLocations(node_locations, graph);
-  for (int i = 0; i < config_.max_iterations() &&
-                  cost_diff > config_.placement_convergence_delta();
-       ++i) {
-    // 1) Iterate through all the nodes and compute their new locations.
-    parlay::parallel_for(0, num_nodes, [&](std::size_t i) {
-      new_node_locations[i] =
-          minla_cost_metric->ImproveNodeLocation(i, node_locations, graph);
-    });
-
-    // 2) Rescale the node locations to [0,n-1] range.
-    auto min_max = parlay::minmax_element(new_node_locations);
-    double min_value = *min_max.first;
-    double max_value = *min_max.second;
-    ABSL_CHECK_GT(max_value, min_value)
-        << "All new locations collapsed to a single point at iteration " << i;
-    const double scaling_factor = (num_nodes - 1) / (max_value - min_value);
-    parlay::parallel_for(0, num_nodes, [&](std::size_t j) {
-      new_node_locations[j] =
-          (new_node_locations[j] - min_value) * scaling_factor;
-    });
+      // 2) Rescale the node locations to [0,n-1] range.
+      RescaleLocations(new_node_locations, i);
 
-    // 3) Compute cost difference.
-    double cost = minla_cost_metric->ComputeCostFromNodeLocations(
-        new_node_locations, graph);
-    cost_diff = std::abs(cost - prev_cost);
-    prev_cost = cost;
-    node_locations.swap(new_node_locations);
+      // 3) Compute cost difference.
+      double cost = minla_cost_metric->ComputeCostFromNodeLocations(
+          new_node_locations, graph);
+      cost_diff = std::abs(cost - prev_cost);
+      prev_cost = cost;
+      node_locations.swap(new_node_locations);
+    }
   }
   // Generate improved minla using the final node locations.
   parlay::sort_inplace(minla, [&node_locations](std::size_t i, std::size_t j) {
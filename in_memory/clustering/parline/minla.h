@@ -17,6 +17,7 @@
 
 #include <vector>
 
+#include "absl/status/statusor.h"
 #include "in_memory/clustering/gbbs_graph.h"
 #include "in_memory/clustering/parline/minla.pb.h"
 
@@ -35,7 +36,14 @@ class MinimumLinearArrangement {
 
   // Computes and returns a minimum linear arrangement of an input graph. The
   // returned vector is a permutation of the node ids in the input graph
-  // computed to minimize the configured cost metric.
+  // computed to minimize the configured cost metric. The initial arrangement
+  // is given by the configured initialization method. Returns an error if the
+  // AFFINITY_HIERARCHY initialization fails (the NODE_ID_ORDER initialization
+  // never fails).
+  absl::StatusOr<std::vector<gbbs::uintE>> TryCompute(
+      const GbbsGraph& graph) const;
+
+  // Same as above, but check-fails on error.
   std::vector<gbbs::uintE> Compute(const GbbsGraph& graph) const;
 
   // Improves an existing minimum linear arrangement by minimizing the cost
@@ -44,6 +52,10 @@ class MinimumLinearArrangement {
   void Improve(const GbbsGraph& graph, std::vector<gbbs::uintE>& minla) const;
 
  private:
+  // Implements the AFFINITY_HIERARCHY initialization of Compute.
+  absl::StatusOr<std::vector<gbbs::uintE>> ComputeCoarseToFine(
+      const GbbsGraph& graph) const;
+
   MinimumLinearArrangementConfig config_;
 };
 
@@ -0,0 +1,59 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/clustering/parline/minla_embedder.h"
+
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "gbbs/macros.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/parline/affinity_hierarchy_embedder.h"
+#include "in_memory/clustering/parline/linear_embedder.h"
+#include "in_memory/clustering/parline/minla.h"
+#include "in_memory/clustering/parline/parline.pb.h"
+#include "in_memory/status_macros.h"
+
+namespace graph_mining::in_memory {
+
+MinlaEmbedder::MinlaEmbedder(const MinlaEmbedderConfig& config)
+    : config_(config) {}
+
+absl::StatusOr<std::vector<gbbs::uintE>> MinlaEmbedder::EmbedGraph(
+    const GbbsGraph& graph) {
+  AffinityHierarchyEmbedder affinity_embedder(config_.affinity_config());
+  std::vector<gbbs::uintE> embedding;
+  ASSIGN_OR_RETURN(embedding, affinity_embedder.EmbedGraph(graph));
+  // Node locations are rescaled to [0, n-1] in each MinLA iteration which is
+  // not possible for fewer than two nodes.
+  if (embedding.size() < 2) return embedding;
+  MinimumLinearArrangement(config_.minla_config()).Improve(graph, embedding);
+  return embedding;
+}
+
+absl::StatusOr<std::vector<std::pair<gbbs::uintE, double>>>
+MinlaEmbedder::EmbedGraphWeighted(const GbbsGraph& graph) {
+  if (graph.Graph()->vertex_weights == nullptr) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Input graph does not have any node weights."));
+  }
+  std::vector<gbbs::uintE> embedding;
+  ASSIGN_OR_RETURN(embedding, EmbedGraph(graph));
+  return ComputeWeightedEmbedding(graph, embedding);
+}
+
+}  // namespace graph_mining::in_memory
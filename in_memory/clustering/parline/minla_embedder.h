@@ -0,0 +1,52 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_PARLINE_MINLA_EMBEDDER_H_
+#define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_PARLINE_MINLA_EMBEDDER_H_
+
+#include <utility>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "gbbs/macros.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/parline/linear_embedder.h"
+#include "in_memory/clustering/parline/parline.pb.h"
+
+namespace graph_mining::in_memory {
+
+// Embeds the nodes of an input graph into a line by computing an affinity
+// hierarchy embedding (see AffinityHierarchyEmbedder) and then improving it
+// with the iterative Minimum Linear Arrangement heuristic (see
+// MinimumLinearArrangement in minla.h). This is more expensive than the
+// affinity hierarchy embedding alone but neighboring nodes typically end up
+// closer to each other, which reduces the cut of the sliced clusters.
+class MinlaEmbedder : public LinearEmbedder {
+ public:
+  explicit MinlaEmbedder(const MinlaEmbedderConfig& config);
+  ~MinlaEmbedder() override {}
+
+  absl::StatusOr<std::vector<gbbs::uintE>> EmbedGraph(
+      const GbbsGraph& graph) override;
+
+  absl::StatusOr<std::vector<std::pair<gbbs::uintE, double>>>
+  EmbedGraphWeighted(const GbbsGraph& graph) override;
+
+ private:
+  MinlaEmbedderConfig config_;
+};
+
+}  // namespace graph_mining::in_memory
+
+#endif  // THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_PARLINE_MINLA_EMBEDDER_H_
@@ -0,0 +1,86 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/clustering/parline/minla.h"
+
+#include <numeric>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/graph.h"
+#include "in_memory/clustering/parline/minla.pb.h"
+#include "in_memory/clustering/parline/minla_cost_metric.h"
+#include "in_memory/status_macros.h"  // IWYU pragma: keep
+
+namespace graph_mining::in_memory {
+namespace {
+
+using ::gbbs::uintE;
+using ::testing::UnorderedElementsAreArray;
+
+constexpr int kNumNodes = 64;
+
+// A path whose i-th node has id (i * 37) % kNumNodes, so that neighboring
+// nodes are far apart in node id order.
+absl::Status MakeScrambledPath(GbbsGraph& graph) {
+  SimpleUndirectedGraph path;
+  for (int i = 0; i + 1 < kNumNodes; ++i) {
+    RETURN_IF_ERROR(path.AddEdge((i * 37) % kNumNodes,
+                                 ((i + 1) * 37) % kNumNodes, 1.0));
+  }
+  return CopyGraph(path, &graph);
+}
+
+std::vector<uintE> AllNodes() {
+  std::vector<uintE> nodes(kNumNodes);
+  std::iota(nodes.begin(), nodes.end(), 0);
+  return nodes;
+}
+
+TEST(MinimumLinearArrangementTest, ActiveSetImprovesArrangement) {
+  GbbsGraph graph;
+  ASSERT_OK(MakeScrambledPath(graph));
+  MinimumLinearArrangementConfig config;
+  config.set_max_iterations(100);
+  config.set_active_set_threshold(0.5);
+  ASSERT_OK_AND_ASSIGN(std::vector<uintE> minla,
+                       MinimumLinearArrangement(config).TryCompute(graph));
+
+  EXPECT_THAT(minla, UnorderedElementsAreArray(AllNodes()));
+  auto cost_metric = CreateMinlaCostMetric(config);
+  EXPECT_LT(cost_metric->ComputeCost(minla, graph),
+            cost_metric->ComputeCost(AllNodes(), graph));
+}
+
+TEST(MinimumLinearArrangementTest, AffinityHierarchyReturnsPermutation) {
+  GbbsGraph graph;
+  ASSERT_OK(MakeScrambledPath(graph));
+  MinimumLinearArrangementConfig config;
+  config.set_initialization(MinimumLinearArrangementConfig::AFFINITY_HIERARCHY);
+  config.set_coarsest_num_nodes(4);
+  config.set_active_set_threshold(0.5);
+  ASSERT_OK_AND_ASSIGN(std::vector<uintE> minla,
+                       MinimumLinearArrangement(config).TryCompute(graph));
+
+  EXPECT_THAT(minla, UnorderedElementsAreArray(AllNodes()));
+  auto cost_metric = CreateMinlaCostMetric(config);
+  EXPECT_LT(cost_metric->ComputeCost(minla, graph),
+            cost_metric->ComputeCost(AllNodes(), graph));
+}
+
+}  // namespace
+}  // namespace graph_mining::in_memory
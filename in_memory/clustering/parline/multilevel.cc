@@ -0,0 +1,271 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/clustering/parline/multilevel.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/log/absl_log.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "gbbs/graph.h"
+#include "gbbs/macros.h"
+#include "in_memory/clustering/affinity/affinity.pb.h"
+#include "in_memory/clustering/affinity/parallel_affinity_internal.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/clustering/parline/parline.pb.h"
+#include "in_memory/parallel/parallel_graph_utils.h"
+#include "in_memory/status_macros.h"
+#include "parlay/delayed_sequence.h"
+#include "parlay/parallel.h"
+#include "parlay/primitives.h"
+#include "parlay/sequence.h"
+#include "utils/status/thread_safe_status.h"
+
+namespace graph_mining::in_memory {
+namespace {
+
+using WeightedUndirectedGraph =
+    gbbs::symmetric_ptr_graph<gbbs::symmetric_vertex, float>;
+
+// Number of proposal rounds in heavy-edge matching.
+constexpr int kMatchingRounds = 3;
+
+// A coarse node is at most this factor times the average node weight of the
+// targeted coarsest graph.
+constexpr double kMaxNodeWeightFactor = 1.5;
+
+std::vector<double> GetNodeWeights(const WeightedUndirectedGraph& graph) {
+  std::vector<double> node_weights(graph.n, 1.0);
+  if (graph.vertex_weights != nullptr) {
+    parlay::parallel_for(0, graph.n, [&](std::size_t i) {
+      node_weights[i] = graph.vertex_weights[i];
+    });
+  }
+  return node_weights;
+}
+
+// Computes a heavy-edge matching of the graph where two nodes are matched
+// only if their total weight is at most max_node_weight. Returns the matched
+// node for each node (itself if unmatched).
+std::vector<gbbs::uintE> HeavyEdgeMatching(
+    WeightedUndirectedGraph& graph,
+    const std::vector<double>& node_weights, double max_node_weight) {
+  const std::size_t num_nodes = graph.n;
+  std::vector<gbbs::uintE> matching(num_nodes, UINT_E_MAX);
+  std::vector<gbbs::uintE> proposals(num_nodes, UINT_E_MAX);
+  for (int round = 0; round < kMatchingRounds; ++round) {
+    // Each unmatched node proposes to its heaviest-edge unmatched neighbor. Ties
+    // are broken by the neighbor id.
+    parlay::parallel_for(0, num_nodes, [&](std::size_t i) {
+      proposals[i] = UINT_E_MAX;
+      if (matching[i] != UINT_E_MAX) return;
+      float best_weight = 0;
+      auto neighbors = graph.get_vertex(i).out_neighbors();
+      for (std::size_t j = 0; j < neighbors.get_degree(); ++j) {
+        const gbbs::uintE neighbor = neighbors.get_neighbor(j);
+        const float weight = neighbors.get_weight(j);
+        if (neighbor == i || matching[neighbor] != UINT_E_MAX ||
+            node_weights[i] + node_weights[neighbor] > max_node_weight) {
+          continue;
+        }
+        if (proposals[i] == UINT_E_MAX || weight > best_weight ||
+            (weight == best_weight && neighbor < proposals[i])) {
+          proposals[i] = neighbor;
+          best_weight = weight;
+        }
+      }
+    });
+    // Mutual proposals are matched.
+    parlay::parallel_for(0, num_nodes, [&](std::size_t i) {
+      const gbbs::uintE proposal = proposals[i];
+      if (proposal != UINT_E_MAX && proposals[proposal] == i) {
+        matching[i] = proposal;
+      }
+    });
+  }
+  parlay::parallel_for(0, num_nodes, [&](std::size_t i) {
+    if (matching[i] == UINT_E_MAX) matching[i] = i;
+  });
+  return matching;
+}
+
+// Converts a matching into consecutive coarse node ids.
+std::vector<gbbs::uintE> MatchingToClusterIds(
+    const std::vector<gbbs::uintE>& matching) {
+  const std::size_t num_nodes = matching.size();
+  // The smaller id of each matched pair is the leader of that pair.
+  auto leader_flags = parlay::sequence<gbbs::uintE>::from_function(
+      num_nodes,
+      [&](std::size_t i) -> gbbs::uintE { return matching[i] >= i ? 1 : 0; });
+  parlay::scan_inplace(leader_flags);
+  std::vector<gbbs::uintE> cluster_ids(num_nodes);
+  parlay::parallel_for(0, num_nodes, [&](std::size_t i) {
+    cluster_ids[i] = leader_flags[std::min<gbbs::uintE>(i, matching[i])];
+  });
+  return cluster_ids;
+}
+
+// Converts a compressed graph into a GbbsGraph with node weights.
+absl::StatusOr<std::unique_ptr<GbbsGraph>> MakeCoarseGraph(
+    const GraphWithWeights& compressed_graph) {
+  WeightedUndirectedGraph& graph = *compressed_graph.graph;
+  auto coarse_graph = std::make_unique<GbbsGraph>();
+  RETURN_IF_ERROR(coarse_graph->PrepareImport(graph.n));
+  ThreadSafeStatus import_status;
+  parlay::parallel_for(0, graph.n, [&](std::size_t i) {
+    InMemoryClusterer::AdjacencyList adjacency_list;
+    adjacency_list.id = i;
+    adjacency_list.weight = compressed_graph.node_weights[i];
+    auto neighbors = graph.get_vertex(i).out_neighbors();
+    adjacency_list.outgoing_edges.reserve(neighbors.get_degree());
+    for (std::size_t j = 0; j < neighbors.get_degree(); ++j) {
+      adjacency_list.outgoing_edges.emplace_back(neighbors.get_neighbor(j),
+                                                 neighbors.get_weight(j));
+    }
+    import_status.Update(coarse_graph->Import(std::move(adjacency_list)));
+  });
+  RETURN_IF_ERROR(import_status.status());
+  RETURN_IF_ERROR(coarse_graph->FinishImport());
+  return coarse_graph;
+}
+
+// Computes the coarse node ids of the next level.
+absl::StatusOr<std::vector<gbbs::uintE>> ComputeCoarseNodeIds(
+    WeightedUndirectedGraph& graph, const std::vector<double>& node_weights,
+    double max_node_weight, const MultilevelConfig& config) {
+  switch (config.coarsening_method()) {
+    case MultilevelConfig::HEAVY_EDGE_MATCHING:
+      return MatchingToClusterIds(
+          HeavyEdgeMatching(graph, node_weights, max_node_weight));
+    case MultilevelConfig::AFFINITY: {
+      AffinityClustererConfig::SizeConstraint size_constraint;
+      size_constraint.set_max_cluster_size(max_node_weight);
+      return NearestNeighborLinkage(
+          graph, /*weight_threshold=*/0.0,
+          std::make_optional(
+              internal::SizeConstraintConfig{size_constraint, node_weights}));
+    }
+  }
+  return absl::InvalidArgumentError(
+      absl::StrCat("Unsupported coarsening method: ",
+                   config.coarsening_method()));
+}
+
+}  // namespace
+
+absl::StatusOr<std::vector<CoarseningLevel>> CoarsenGraph(
+    const GbbsGraph& graph, int num_clusters,
+    const MultilevelConfig& multilevel_config) {
+  const std::size_t coarsest_num_nodes =
+      static_cast<std::size_t>(num_clusters) *
+      std::max(1, multilevel_config.coarsest_nodes_per_cluster());
+  std::vector<double> node_weights = GetNodeWeights(*graph.Graph());
+  const double total_node_weight =
+      parlay::reduce(node_weights, parlay::addm<double>());
+  const double max_node_weight =
+      kMaxNodeWeightFactor * total_node_weight / coarsest_num_nodes;
+
+  // Edge weights are summed up when nodes are contracted.
+  AffinityClustererConfig compression_config;
+  compression_config.set_edge_aggregation_function(
+      AffinityClustererConfig::SUM);
+
+  std::vector<CoarseningLevel> levels;
+  WeightedUndirectedGraph* current_graph = graph.Graph();
+  while (levels.size() <
+             static_cast<std::size_t>(multilevel_config.max_levels()) &&
+         current_graph->n > coarsest_num_nodes) {
+    ASSIGN_OR_RETURN(std::vector<gbbs::uintE> cluster_ids,
+                     ComputeCoarseNodeIds(*current_graph, node_weights,
+                                          max_node_weight, multilevel_config));
+    ASSIGN_OR_RETURN(GraphWithWeights compressed_graph,
+                     CompressGraph(*current_graph, node_weights, cluster_ids,
+                                   compression_config));
+    const std::size_t num_nodes = current_graph->n;
+    const std::size_t num_coarse_nodes = compressed_graph.graph->n;
+    ABSL_VLOG(1) << "Coarsening level " << levels.size() + 1 << ": "
+                 << num_nodes << " -> " << num_coarse_nodes << " nodes";
+    if (num_coarse_nodes == num_nodes) break;
+
+    node_weights = compressed_graph.node_weights;
+    ASSIGN_OR_RETURN(std::unique_ptr<GbbsGraph> coarse_graph,
+                     MakeCoarseGraph(compressed_graph));
+    current_graph = coarse_graph->Graph();
+    levels.push_back({std::move(coarse_graph), std::move(cluster_ids)});
+    if (num_coarse_nodes >
+        (1 - multilevel_config.min_node_reduction()) * num_nodes) {
+      break;
+    }
+  }
+  return levels;
+}
+
+InMemoryClusterer::Clustering ProjectClustering(
+    const InMemoryClusterer::Clustering& coarse_clustering,
+    const std::vector<gbbs::uintE>& fine_to_coarse) {
+  const std::size_t num_coarse_nodes = parlay::reduce(
+      parlay::delayed_seq<std::size_t>(
+          coarse_clustering.size(),
+          [&](std::size_t i) { return coarse_clustering[i].size(); }),
+      parlay::addm<std::size_t>());
+  std::vector<gbbs::uintE> coarse_cluster_ids(num_coarse_nodes);
+  parlay::parallel_for(
+      0, coarse_clustering.size(),
+      [&](std::size_t i) {
+        for (const auto node_id : coarse_clustering[i]) {
+          coarse_cluster_ids[node_id] = i;
+        }
+      },
+      /*granularity=*/1);
+  const std::size_t num_fine_nodes = fine_to_coarse.size();
+  std::vector<gbbs::uintE> fine_cluster_ids(num_fine_nodes);
+  parlay::parallel_for(0, num_fine_nodes, [&](std::size_t i) {
+    fine_cluster_ids[i] = coarse_cluster_ids[fine_to_coarse[i]];
+  });
+  // Cluster i of the result is the projection of coarse cluster i (empty
+  // clusters are kept), so the clusters keep the order of the coarse clusters,
+  // which matters for pairing nearby clusters during refinement.
+  auto fine_node_ids =
+      parlay::tabulate(num_fine_nodes, [](std::size_t i) {
+        return static_cast<InMemoryClusterer::NodeId>(i);
+      });
+  parlay::integer_sort_inplace(fine_node_ids,
+                               [&](InMemoryClusterer::NodeId node_id) {
+                                 return fine_cluster_ids[node_id];
+                               });
+  auto group_starts = parlay::pack_index<std::size_t>(
+      parlay::delayed_seq<bool>(num_fine_nodes, [&](std::size_t i) {
+        return i == 0 || fine_cluster_ids[fine_node_ids[i]] !=
+                             fine_cluster_ids[fine_node_ids[i - 1]];
+      }));
+  InMemoryClusterer::Clustering fine_clustering(coarse_clustering.size());
+  parlay::parallel_for(0, group_starts.size(), [&](std::size_t i) {
+    const std::size_t begin = group_starts[i];
+    const std::size_t end =
+        i + 1 < group_starts.size() ? group_starts[i + 1] : num_fine_nodes;
+    fine_clustering[fine_cluster_ids[fine_node_ids[begin]]].assign(
+        fine_node_ids.begin() + begin, fine_node_ids.begin() + end);
+  });
+  return fine_clustering;
+}
+
+}  // namespace graph_mining::in_memory
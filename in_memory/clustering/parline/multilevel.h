@@ -0,0 +1,61 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Utilities for the multilevel mode of the parallel line partitioner (see
+// MultilevelConfig in parline.proto).
+
+#ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_PARLINE_MULTILEVEL_H_
+#define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_PARLINE_MULTILEVEL_H_
+
+#include <memory>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "gbbs/macros.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/clustering/parline/parline.pb.h"
+
+namespace graph_mining::in_memory {
+
+// A single level of a coarsening hierarchy.
+struct CoarseningLevel {
+  // The coarse graph. Its node weights are the sums of the weights of the
+  // corresponding nodes of the finer graph.
+  std::unique_ptr<GbbsGraph> graph;
+  // Entry i is the id of the node of the coarse graph that node i of the finer
+  // graph (the graph of the previous level, or the input graph for the first
+  // level) is contracted into.
+  std::vector<gbbs::uintE> fine_to_coarse;
+};
+
+// Coarsens the input graph level by level as configured by config and returns
+// the levels from finest to coarsest.
+// The returned vector is empty if the input graph is already small enough.
+// Coarse nodes are never heavier than a small fraction of the average cluster
+// weight (as given by num_clusters) so that the clusters of coarse graphs can
+// still be balanced. Node weights of the input graph are used if present.
+absl::StatusOr<std::vector<CoarseningLevel>> CoarsenGraph(
+    const GbbsGraph& graph, int num_clusters, const MultilevelConfig& config);
+
+// Projects a clustering of a coarse graph onto the finer graph using the
+// fine_to_coarse mapping (see CoarseningLevel). Cluster i of the result
+// consists of the fine nodes of coarse cluster i; empty clusters are kept.
+InMemoryClusterer::Clustering ProjectClustering(
+    const InMemoryClusterer::Clustering& coarse_clustering,
+    const std::vector<gbbs::uintE>& fine_to_coarse);
+
+}  // namespace graph_mining::in_memory
+
+#endif  // THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_PARLINE_MULTILEVEL_H_
@@ -14,20 +14,24 @@
 
 #include "in_memory/clustering/parline/pairwise_improver.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
-#include "absl/container/flat_hash_set.h"
 #include "absl/log/absl_log.h"
 #include "in_memory/clustering/gbbs_graph.h"
 #include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/clustering/parline/bucket_fm.h"
+#include "in_memory/clustering/parline/cluster_pair_improver.h"
+#include "in_memory/clustering/parline/cut_size.h"
 #include "in_memory/clustering/parline/fm_base.h"
 #include "in_memory/clustering/parline/pairing_scheme.h"
 #include "in_memory/clustering/parline/parline.pb.h"
+#include "in_memory/clustering/parline/parline_util.h"
 #include "in_memory/clustering/types.h"
-#include "parlay/delayed_sequence.h"
 #include "parlay/parallel.h"
 #include "parlay/primitives.h"
 
@@ -35,6 +39,8 @@ namespace graph_mining::in_memory {
 namespace {
 
 using ClusterPairingMethod = PairwiseImproverConfig::ClusterPairingMethod;
+using ClusterPairImproverMethod =
+    PairwiseImproverConfig::ClusterPairImproverMethod;
 
 std::unique_ptr<PairingScheme> ConstructPairingScheme(
     int num_ids, const ClusterPairingMethod& pairing_method, int num_clusters) {
@@ -49,34 +55,95 @@ std::unique_ptr<PairingScheme> ConstructPairingScheme(
                   << pairing_method.name();
 }
 
-void UpdateClusters(const absl::flat_hash_set<NodeId>& cluster1_to_cluster2,
-                    const absl::flat_hash_set<NodeId>& cluster2_to_cluster1,
-                    absl::flat_hash_set<NodeId>& cluster1,
-                    absl::flat_hash_set<NodeId>& cluster2) {
+std::unique_ptr<ClusterPairImprover> ConstructClusterPairImprover(
+    const ClusterPairImproverMethod& improver_method) {
+  switch (improver_method.name()) {
+    case ClusterPairImproverMethod::DEFAULT_FM:
+      return std::make_unique<FMBase>();
+    case ClusterPairImproverMethod::BUCKET_FM:
+      return std::make_unique<BucketFM>(
+          improver_method.has_num_gain_buckets()
+              ? improver_method.num_gain_buckets()
+              : BucketFM::kDefaultNumGainBuckets);
+  }
+  ABSL_LOG(FATAL) << "Unsupported cluster pair improver method: "
+                  << improver_method.name();
+}
+
+// Applies the moves between two clusters. Only touches the entries of the
+// nodes in those two clusters, so that disjoint pairs can be updated in
+// parallel.
+void UpdateClusters(int cluster1_id, int cluster2_id,
+                    const std::vector<NodeId>& cluster1_to_cluster2,
+                    const std::vector<NodeId>& cluster2_to_cluster1,
+                    DenseClusters& dense_clusters) {
+  if (cluster1_to_cluster2.empty() && cluster2_to_cluster1.empty()) return;
+  auto& node_cluster_ids = dense_clusters.node_cluster_ids;
   for (const auto& node : cluster1_to_cluster2) {
-    cluster1.erase(node);
-    cluster2.insert(node);
+    node_cluster_ids[node] = cluster2_id;
   }
   for (const auto& node : cluster2_to_cluster1) {
-    cluster2.erase(node);
-    cluster1.insert(node);
+    node_cluster_ids[node] = cluster1_id;
   }
+  auto update_cluster = [&](int cluster_id,
+                            const std::vector<NodeId>& moved_in) {
+    auto& cluster = dense_clusters.clusters[cluster_id];
+    cluster.erase(std::remove_if(cluster.begin(), cluster.end(),
+                                 [&](NodeId node) {
+                                   return node_cluster_ids[node] != cluster_id;
+                                 }),
+                  cluster.end());
+    cluster.insert(cluster.end(), moved_in.begin(), moved_in.end());
+    dense_clusters.UpdatePositions(cluster_id);
+  };
+  update_cluster(cluster1_id, cluster2_to_cluster1);
+  update_cluster(cluster2_id, cluster1_to_cluster2);
 }
 
-// TODO: Move it to a util.
-double ComputeTotalNodeWeight(const LinePartitionerConfig& config,
-                              const GbbsGraph& gbbs_graph) {
-  auto graph = gbbs_graph.Graph();
-  if (!config.use_node_weights() || graph->vertex_weights == nullptr) {
-    return graph->num_vertices();
+// Improves the given disjoint pairs of clusters in parallel. The moves are
+// applied only after all the pairs are processed since the improvers read the
+// node-indexed arrays of dense_clusters for all the nodes. If edge_weights is
+// not null then it is updated with the moves.
+void ImprovePairs(const GbbsGraph& graph,
+                  const std::vector<std::pair<int, int>>& cluster_id_pairs,
+                  double max_cluster_weight, ClusterPairImprover& improver,
+                  DenseClusters& dense_clusters,
+                  ClusterEdgeWeights* edge_weights = nullptr) {
+  std::vector<std::vector<NodeId>> cluster1_to_cluster2(
+      cluster_id_pairs.size());
+  std::vector<std::vector<NodeId>> cluster2_to_cluster1(
+      cluster_id_pairs.size());
+  parlay::parallel_for(0, cluster_id_pairs.size(), [&](size_t idx) {
+    improver.Improve(graph,
+                     dense_clusters.View(cluster_id_pairs[idx].first,
+                                         cluster_id_pairs[idx].second),
+                     max_cluster_weight, cluster1_to_cluster2[idx],
+                     cluster2_to_cluster1[idx]);
+  });
+  parlay::parallel_for(0, cluster_id_pairs.size(), [&](size_t idx) {
+    UpdateClusters(cluster_id_pairs[idx].first, cluster_id_pairs[idx].second,
+                   cluster1_to_cluster2[idx], cluster2_to_cluster1[idx],
+                   dense_clusters);
+  });
+  if (edge_weights != nullptr) {
+    edge_weights->MoveNodes(graph, cluster_id_pairs, cluster1_to_cluster2,
+                            cluster2_to_cluster1,
+                            dense_clusters.node_cluster_ids);
   }
-  auto weight_seq = parlay::delayed_seq<double>(
-      graph->n, [&](size_t i) { return graph->vertex_weights[i]; });
-  return parlay::reduce(weight_seq, parlay::addm<double>());
 }
 
 }  // namespace
 
+DenseClusters CreateDenseClusters(
+    const InMemoryClusterer::Clustering& clustering, std::size_t num_nodes) {
+  DenseClusters dense_clusters{clustering, std::vector<int>(num_nodes, -1),
+                               std::vector<NodeId>(num_nodes, -1)};
+  parlay::parallel_for(0, clustering.size(), [&](std::size_t i) {
+    dense_clusters.UpdatePositions(i);
+  });
+  return dense_clusters;
+}
+
 InMemoryClusterer::Clustering ImproveClustersPairwise(
     const GbbsGraph& graph,
     const InMemoryClusterer::Clustering& initial_clustering,
@@ -93,42 +160,70 @@ InMemoryClusterer::Clustering ImproveClustersPairwise(
       num_clusters, pairwise_improver_config.cluster_pairing_method(),
       num_clusters);
 
-  const double max_cluster_weight = (1 + line_config.imbalance()) *
-                                    ComputeTotalNodeWeight(line_config, graph) /
-                                    initial_clustering.size();
+  const double max_cluster_weight =
+      (1 + line_config.imbalance()) *
+      ComputeTotalNodeWeight(graph, line_config.use_node_weights()) /
+      initial_clustering.size();
+  // The improvers keep no state between calls, so a single instance is shared
+  // by all the pairs.
+  auto improver = ConstructClusterPairImprover(
+      pairwise_improver_config.cluster_pair_improver_method());
   // Create individual clusters that will be improved pairwise in parallel.
-  std::vector<absl::flat_hash_set<NodeId>> clusters(num_clusters);
-  parlay::parallel_for(0, num_clusters, [&](size_t i) {
-    clusters[i].insert(initial_clustering[i].begin(),
-                       initial_clustering[i].end());
-  });
+  DenseClusters dense_clusters =
+      CreateDenseClusters(initial_clustering, graph.Graph()->n);
 
-  int total_iterations = pairwise_improver_config.num_improvement_iterations() *
-                         pairing_scheme->CycleSize();
-  // Each iteration improves clusters pairwise in parallel.
-  for (int i = 0; i < total_iterations; ++i) {
-    std::vector<std::pair<int, int>> cluster_id_pairs = pairing_scheme->Next();
-    parlay::parallel_for(0, cluster_id_pairs.size(), [&](size_t idx) {
-      auto& cluster1 = clusters[cluster_id_pairs[idx].first];
-      auto& cluster2 = clusters[cluster_id_pairs[idx].second];
-      absl::flat_hash_set<NodeId> cluster1_to_cluster2;
-      absl::flat_hash_set<NodeId> cluster2_to_cluster1;
-      FMBase fm;
-      fm.Improve(graph, cluster1, cluster2, max_cluster_weight,
-                 cluster1_to_cluster2, cluster2_to_cluster1);
-      UpdateClusters(cluster1_to_cluster2, cluster2_to_cluster1, cluster1,
-                     cluster2);
-    });
+  // The cut weight is tracked only if it is needed for early termination.
+  std::optional<ClusterEdgeWeights> edge_weights;
+  if (pairwise_improver_config.has_min_relative_cut_improvement()) {
+    edge_weights.emplace(graph, dense_clusters.clusters,
+                         dense_clusters.node_cluster_ids);
   }
 
-  // Convert the final clusters to the in-memory format.
-  InMemoryClusterer::Clustering improved_clustering;
-  improved_clustering.reserve(num_clusters);
-  for (const auto& cluster : clusters) {
-    improved_clustering.push_back(
-        std::vector<NodeId>(cluster.begin(), cluster.end()));
+  // Each improvement iteration goes through a full cycle of the pairing scheme
+  // and each step of it improves clusters pairwise in parallel.
+  for (int iteration = 0;
+       iteration < pairwise_improver_config.num_improvement_iterations();
+       ++iteration) {
+    const double cut_weight = edge_weights ? edge_weights->CutWeight() : 0;
+    for (int i = 0; i < pairing_scheme->CycleSize(); ++i) {
+      ImprovePairs(graph, pairing_scheme->Next(), max_cluster_weight,
+                   *improver, dense_clusters,
+                   edge_weights ? &*edge_weights : nullptr);
+    }
+    if (!edge_weights) continue;
+    ABSL_VLOG(1) << "Cut ratio after improvement iteration " << iteration + 1
+                 << ": " << edge_weights->CutRatio();
+    if (cut_weight == 0 ||
+        (cut_weight - edge_weights->CutWeight()) / cut_weight <
+            pairwise_improver_config.min_relative_cut_improvement()) {
+      ABSL_VLOG(1) << "Stopping improvement after iteration " << iteration + 1;
+      break;
+    }
   }
-  return improved_clustering;
+
+  return std::move(dense_clusters.clusters);
+}
+
+InMemoryClusterer::Clustering ImproveClusterPairs(
+    const GbbsGraph& graph, const InMemoryClusterer::Clustering& clustering,
+    const std::vector<std::pair<int, int>>& cluster_id_pairs,
+    double max_cluster_weight,
+    const ClusterPairImproverMethod& improver_method) {
+  DenseClusters dense_clusters =
+      CreateDenseClusters(clustering, graph.Graph()->n);
+  ImproveClusterPairs(graph, cluster_id_pairs, max_cluster_weight,
+                      improver_method, dense_clusters);
+  return std::move(dense_clusters.clusters);
+}
+
+void ImproveClusterPairs(
+    const GbbsGraph& graph,
+    const std::vector<std::pair<int, int>>& cluster_id_pairs,
+    double max_cluster_weight, const ClusterPairImproverMethod& improver_method,
+    DenseClusters& dense_clusters) {
+  auto improver = ConstructClusterPairImprover(improver_method);
+  ImprovePairs(graph, cluster_id_pairs, max_cluster_weight, *improver,
+               dense_clusters);
 }
 
 }  // namespace graph_mining::in_memory
@@ -15,12 +15,45 @@
 #ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_PARLINE_PAIRWISE_IMPROVER_H_
 #define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_PARLINE_PAIRWISE_IMPROVER_H_
 
+#include <cstddef>
+#include <utility>
+#include <vector>
+
 #include "in_memory/clustering/gbbs_graph.h"
 #include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/clustering/parline/cluster_pair_improver.h"
 #include "in_memory/clustering/parline/parline.pb.h"
 
 namespace graph_mining::in_memory {
 
+// Clusters stored as node id vectors together with node-indexed cluster ids
+// and positions so that ClusterPairView objects can be created for any pair.
+// Nodes without a cluster have a negative cluster id.
+struct DenseClusters {
+  std::vector<std::vector<InMemoryClusterer::NodeId>> clusters;
+  std::vector<int> node_cluster_ids;
+  std::vector<InMemoryClusterer::NodeId> node_positions;
+
+  ClusterPairView View(int cluster1_id, int cluster2_id) const {
+    return ClusterPairView{clusters[cluster1_id], clusters[cluster2_id],
+                           cluster1_id,           cluster2_id,
+                           node_cluster_ids,      node_positions};
+  }
+
+  // Sets the node-indexed entries of the nodes of the given cluster.
+  void UpdatePositions(int cluster_id) {
+    const auto& cluster = clusters[cluster_id];
+    for (std::size_t i = 0; i < cluster.size(); ++i) {
+      node_cluster_ids[cluster[i]] = cluster_id;
+      node_positions[cluster[i]] = i;
+    }
+  }
+};
+
+// Returns the DenseClusters of a clustering of a graph with num_nodes nodes.
+DenseClusters CreateDenseClusters(
+    const InMemoryClusterer::Clustering& clustering, std::size_t num_nodes);
+
 // Given an input graph and an input clustering it improves the clusters by
 // first pairing them (see PairwiseImproverConfig.cluster_pairing_method) and
 // then running an in-memory pairwise partition improving algorithm (for
@@ -35,6 +68,28 @@ InMemoryClusterer::Clustering ImproveClustersPairwise(
     const InMemoryClusterer::Clustering& initial_clustering,
     const LinePartitionerConfig& line_config);
 
+// Improves the given pairs of clusters of an input clustering in parallel using
+// a single run of the given cluster pair improver for each pair, subject to
+// max_cluster_weight. The pairs must be disjoint, i.e. each cluster index
+// appears in at most one pair. The clusters keep their indices in the returned
+// clustering.
+InMemoryClusterer::Clustering ImproveClusterPairs(
+    const GbbsGraph& graph, const InMemoryClusterer::Clustering& clustering,
+    const std::vector<std::pair<int, int>>& cluster_id_pairs,
+    double max_cluster_weight,
+    const PairwiseImproverConfig::ClusterPairImproverMethod& improver_method);
+
+// Same as above, but improves the pairs of dense_clusters in place. Only the
+// clusters of the pairs and the entries of their nodes are touched, so the
+// cost is independent of the total number of nodes and clusters. The
+// node-indexed vectors must cover all the nodes of the graph.
+void ImproveClusterPairs(
+    const GbbsGraph& graph,
+    const std::vector<std::pair<int, int>>& cluster_id_pairs,
+    double max_cluster_weight,
+    const PairwiseImproverConfig::ClusterPairImproverMethod& improver_method,
+    DenseClusters& dense_clusters);
+
 }  // namespace graph_mining::in_memory
 
 #endif  // THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_PARLINE_PAIRWISE_IMPROVER_H_
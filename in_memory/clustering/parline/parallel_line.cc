@@ -24,6 +24,7 @@
 
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
+#include "absl/log/vlog_is_on.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "gbbs/macros.h"
@@ -31,9 +32,15 @@
 #include "in_memory/clustering/gbbs_graph.h"
 #include "in_memory/clustering/in_memory_clusterer.h"
 #include "in_memory/clustering/parline/affinity_hierarchy_embedder.h"
+#include "in_memory/clustering/parline/bfs_embedder.h"
+#include "in_memory/clustering/parline/kway_refiner.h"
 #include "in_memory/clustering/parline/linear_embedder.h"
+#include "in_memory/clustering/parline/minla_embedder.h"
+#include "in_memory/clustering/parline/multilevel.h"
 #include "in_memory/clustering/parline/pairwise_improver.h"
 #include "in_memory/clustering/parline/parline.pb.h"
+#include "in_memory/clustering/parline/parline_util.h"
+#include "in_memory/clustering/parline/partition_quality.h"
 #include "in_memory/parallel/scheduler.h"
 #include "in_memory/status_macros.h"
 #include "parlay/parallel.h"
@@ -49,13 +56,18 @@ namespace {
 // TODO: This function should be in a util.
 std::unique_ptr<LinearEmbedder> CreateEmbedder(
     const LinePartitionerConfig& line_config) {
-  // Currently we support only one embedding method.
   const EmbedderConfig& embedder_config = line_config.embedder_config();
   switch (embedder_config.embedder_config_case()) {
     case EmbedderConfig::kAffinityConfig: {
       return std::make_unique<AffinityHierarchyEmbedder>(
           embedder_config.affinity_config());
     }
+    case EmbedderConfig::kBfsConfig: {
+      return std::make_unique<BfsEmbedder>(embedder_config.bfs_config());
+    }
+    case EmbedderConfig::kMinlaConfig: {
+      return std::make_unique<MinlaEmbedder>(embedder_config.minla_config());
+    }
     default: {
       ABSL_LOG(INFO)
           << "No embedder_config is specified. Using affinity_config "
@@ -108,24 +120,14 @@ absl::StatusOr<InMemoryClusterer::Clustering> SliceEmbedding(
   return clustering;
 }
 
-double ComputeTotalNodeWeight(const LinePartitionerConfig& config,
-                              const GbbsGraph& gbbs_graph) {
-  auto graph = gbbs_graph.Graph();
-  if (!config.use_node_weights() || graph->vertex_weights == nullptr) {
-    return graph->num_vertices();
-  }
-  auto weight_seq = parlay::delayed_tabulate<double>(
-      graph->n, [&](size_t i) { return graph->vertex_weights[i]; });
-  return parlay::reduce(weight_seq, parlay::addm<double>());
-}
-
 // Divides a weighted linear embedding of nodes where a cluster size is the sum
 // of node weights in it.
 absl::StatusOr<InMemoryClusterer::Clustering> SliceEmbeddingWeighted(
     const GbbsGraph& graph, int num_clusters,
     const LinePartitionerConfig& line_config) {
   const double cluster_weight =
-      ComputeTotalNodeWeight(line_config, graph) / num_clusters;
+      ComputeTotalNodeWeight(graph, line_config.use_node_weights()) /
+      num_clusters;
   std::unique_ptr<LinearEmbedder> embedder = CreateEmbedder(line_config);
   std::vector<std::pair<gbbs::uintE, double>> embedding;
   ASSIGN_OR_RETURN(embedding, embedder->EmbedGraphWeighted(graph));
@@ -169,7 +171,8 @@ absl::StatusOr<int> GetNumberOfClusters(const LinePartitionerConfig& config,
       return absl::InvalidArgumentError(
           "line_config.cluster_size must be a positive non-zero value");
     }
-    double total_node_weight = ComputeTotalNodeWeight(config, gbbs_graph);
+    double total_node_weight =
+        ComputeTotalNodeWeight(gbbs_graph, config.use_node_weights());
     if (total_node_weight <= cluster_size) {
       return absl::InvalidArgumentError(
           "line_config.cluster_size must be less than total node weight");
@@ -185,10 +188,18 @@ InMemoryClusterer::Clustering ImproveClusters(
   if (initial_clusters.empty()) return initial_clusters;
   if (!line_config.has_local_search_config()) {
     ABSL_LOG(INFO) << "No local_search_config set, ignoring post processing.";
-  } else if (line_config.local_search_config().has_pairwise_improver_config()) {
-    return ImproveClustersPairwise(graph, initial_clusters, line_config);
+    return initial_clusters;
   }
-  return initial_clusters;
+  const LocalSearchConfig& local_search_config =
+      line_config.local_search_config();
+  InMemoryClusterer::Clustering clusters = initial_clusters;
+  if (local_search_config.has_kway_refiner_config()) {
+    clusters = ImproveClustersKWay(graph, clusters, line_config);
+  }
+  if (local_search_config.has_pairwise_improver_config()) {
+    clusters = ImproveClustersPairwise(graph, clusters, line_config);
+  }
+  return clusters;
 }
 
 absl::StatusOr<InMemoryClusterer::Clustering> ComputeInitialClusters(
@@ -200,6 +211,50 @@ absl::StatusOr<InMemoryClusterer::Clustering> ComputeInitialClusters(
              : SliceEmbedding(graph, num_clusters, line_config);
 }
 
+// Coarsens the graph, embeds and slices the coarsest graph and then projects
+// and refines the clusters level by level.
+absl::StatusOr<InMemoryClusterer::Clustering> ComputeMultilevelClusters(
+    const GbbsGraph& graph, const LinePartitionerConfig& line_config) {
+  ASSIGN_OR_RETURN(const int num_clusters,
+                   GetNumberOfClusters(line_config, graph));
+  ASSIGN_OR_RETURN(std::vector<CoarseningLevel> levels,
+                   CoarsenGraph(graph, num_clusters,
+                                line_config.multilevel_config()));
+  ABSL_VLOG(1) << "Done with coarsening into " << levels.size() << " levels";
+  if (levels.empty()) {
+    ASSIGN_OR_RETURN(InMemoryClusterer::Clustering clusters,
+                     ComputeInitialClusters(graph, line_config));
+    return ImproveClusters(graph, clusters, line_config);
+  }
+
+  // Coarse graphs always have node weights (the number of contracted nodes if
+  // the input graph has none), and the number of clusters is fixed to the one
+  // computed for the input graph.
+  LinePartitionerConfig coarse_config = line_config;
+  coarse_config.set_use_node_weights(true);
+  coarse_config.set_num_clusters(num_clusters);
+  const GbbsGraph& coarsest_graph = *levels.back().graph;
+  // GbbsGraph drops node weights if they are all equal to one.
+  ASSIGN_OR_RETURN(
+      InMemoryClusterer::Clustering clusters,
+      coarsest_graph.Graph()->vertex_weights == nullptr
+          ? SliceEmbedding(coarsest_graph, num_clusters, coarse_config)
+          : SliceEmbeddingWeighted(coarsest_graph, num_clusters,
+                                   coarse_config));
+  clusters = ImproveClusters(coarsest_graph, clusters, coarse_config);
+  for (int level = levels.size() - 1; level >= 0; --level) {
+    clusters = ProjectClustering(clusters, levels[level].fine_to_coarse);
+    if (level > 0) {
+      clusters =
+          ImproveClusters(*levels[level - 1].graph, clusters, coarse_config);
+    } else {
+      clusters = ImproveClusters(graph, clusters, line_config);
+    }
+    ABSL_VLOG(1) << "Done with refinement at level " << level;
+  }
+  return clusters;
+}
+
 }  // namespace
 
 absl::StatusOr<InMemoryClusterer::Clustering> ParallelLinePartitioner::Cluster(
@@ -211,11 +266,28 @@ absl::StatusOr<InMemoryClusterer::Clustering> ParallelLinePartitioner::Cluster(
   if (!line_config.use_node_weights()) {
     std::swap(node_weights, graph_.Graph()->vertex_weights);
   }
-  ASSIGN_OR_RETURN(InMemoryClusterer::Clustering initial_clusters,
-                   ComputeInitialClusters(graph_, line_config));
-  InMemoryClusterer::Clustering improved_clusters =
-      ImproveClusters(graph_, initial_clusters, line_config);
+  InMemoryClusterer::Clustering improved_clusters;
+  if (line_config.has_multilevel_config()) {
+    ASSIGN_OR_RETURN(improved_clusters,
+                     ComputeMultilevelClusters(graph_, line_config));
+  } else {
+    ASSIGN_OR_RETURN(InMemoryClusterer::Clustering initial_clusters,
+                     ComputeInitialClusters(graph_, line_config));
+    improved_clusters = ImproveClusters(graph_, initial_clusters, line_config);
+  }
   ABSL_VLOG(1) << "Done with post processing to improve clusters";
+  if (ABSL_VLOG_IS_ON(1)) {
+    // Node weights are still the ones the partitioner balanced.
+    absl::StatusOr<PartitionQuality> quality =
+        ComputePartitionQuality(improved_clusters, graph_);
+    if (quality.ok()) {
+      ABSL_LOG(INFO) << "Partition quality: "
+                     << PartitionQualitySummary(*quality);
+    } else {
+      ABSL_LOG(WARNING) << "Partition quality not available: "
+                        << quality.status();
+    }
+  }
   if (!line_config.use_node_weights()) {
     graph_.Graph()->vertex_weights = node_weights;
   }
@@ -0,0 +1,36 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "in_memory/clustering/parline/parline_util.h"
+
+#include <cstddef>
+
+#include "in_memory/clustering/gbbs_graph.h"
+#include "parlay/delayed_sequence.h"
+#include "parlay/monoid.h"
+#include "parlay/primitives.h"
+
+namespace graph_mining::in_memory {
+
+double ComputeTotalNodeWeight(const GbbsGraph& gbbs_graph,
+                              bool use_node_weights) {
+  auto* graph = gbbs_graph.Graph();
+  if (!use_node_weights || graph->vertex_weights == nullptr) {
+    return graph->num_vertices();
+  }
+  auto weight_seq = parlay::delayed_seq<double>(
+      graph->n, [&](std::size_t i) { return graph->vertex_weights[i]; });
+  return parlay::reduce(weight_seq, parlay::addm<double>());
+}
+
+}  // namespace graph_mining::in_memory
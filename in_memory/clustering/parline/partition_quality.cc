@@ -0,0 +1,222 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/clustering/parline/partition_quality.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "gbbs/bridge.h"
+#include "gbbs/macros.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/parallel/per_worker.h"
+#include "in_memory/status_macros.h"
+#include "parlay/monoid.h"
+#include "parlay/parallel.h"
+#include "parlay/primitives.h"
+#include "parlay/sequence.h"
+#include "utils/status/thread_safe_status.h"
+
+namespace graph_mining::in_memory {
+namespace {
+
+using uintE = gbbs::uintE;
+using Part = PartitionQuality::Part;
+
+// Per-part measures plus the total weight of the edges incident to the part.
+struct PartStats {
+  Part part;
+  double edge_weight = 0;
+};
+
+PartStats AddPartStats(const PartStats& a, const PartStats& b) {
+  PartStats sum;
+  sum.part.num_nodes = a.part.num_nodes + b.part.num_nodes;
+  sum.part.node_weight = a.part.node_weight + b.part.node_weight;
+  sum.part.cut_weight = a.part.cut_weight + b.part.cut_weight;
+  sum.part.num_boundary_nodes =
+      a.part.num_boundary_nodes + b.part.num_boundary_nodes;
+  sum.part.communication_volume =
+      a.part.communication_volume + b.part.communication_volume;
+  sum.edge_weight = a.edge_weight + b.edge_weight;
+  return sum;
+}
+
+// Returns the part id of each node, or an error if the clustering is not a
+// partition of the nodes.
+absl::StatusOr<std::vector<uintE>> ComputePartIds(
+    const InMemoryClusterer::Clustering& clustering, std::size_t num_nodes) {
+  const std::size_t num_clustered_nodes = parlay::reduce(
+      parlay::delayed_seq<std::size_t>(
+          clustering.size(), [&](std::size_t i) { return clustering[i].size(); }),
+      parlay::addm<std::size_t>());
+  if (num_clustered_nodes != num_nodes) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("The clustering contains ", num_clustered_nodes,
+                     " nodes but the graph has ", num_nodes, " nodes"));
+  }
+  std::vector<uintE> part_ids(num_nodes, UINT_E_MAX);
+  ThreadSafeStatus status;
+  parlay::parallel_for(
+      0, clustering.size(),
+      [&](std::size_t part_id) {
+        const auto& cluster = clustering[part_id];
+        parlay::parallel_for(0, cluster.size(), [&](std::size_t i) {
+          const InMemoryClusterer::NodeId node_id = cluster[i];
+          if (node_id < 0 || static_cast<std::size_t>(node_id) >= num_nodes) {
+            status.Update(absl::InvalidArgumentError(
+                absl::StrCat("Invalid node id in clustering: ", node_id)));
+          } else if (!gbbs::atomic_compare_and_swap(
+                         &part_ids[node_id], UINT_E_MAX,
+                         static_cast<uintE>(part_id))) {
+            status.Update(absl::InvalidArgumentError(absl::StrCat(
+                "Node ", node_id, " is in more than one cluster")));
+          }
+        });
+      },
+      /*granularity=*/1);
+  if (!status.status().ok()) return status.status();
+  return part_ids;
+}
+
+}  // namespace
+
+absl::StatusOr<PartitionQuality> ComputePartitionQuality(
+    const InMemoryClusterer::Clustering& clustering, const GbbsGraph& graph) {
+  auto* gbbs_graph = graph.Graph();
+  const std::size_t num_parts = clustering.size();
+  ASSIGN_OR_RETURN(std::vector<uintE> part_ids,
+                   ComputePartIds(clustering, gbbs_graph->n));
+
+  // Entry p of the vector of a worker is the last node processed by the worker
+  // that has a neighbor in part p. This way the distinct neighboring parts of
+  // a node are counted in time proportional to its degree.
+  PerWorker<std::vector<uintE>> last_node_with_neighbor_in_part;
+  auto node_stats = [&](uintE node_id, uintE part_id) {
+    PartStats stats;
+    stats.part.num_nodes = 1;
+    stats.part.node_weight = gbbs_graph->vertex_weights == nullptr
+                                 ? 1.0
+                                 : gbbs_graph->vertex_weights[node_id];
+    std::vector<uintE>& last_node = last_node_with_neighbor_in_part.Get();
+    if (last_node.size() != num_parts) last_node.assign(num_parts, UINT_E_MAX);
+    auto add_edge = [&](uintE, uintE neighbor_id, float weight) {
+      stats.edge_weight += weight;
+      const uintE neighbor_part_id = part_ids[neighbor_id];
+      if (neighbor_part_id == part_id) return;
+      stats.part.cut_weight += weight;
+      if (last_node[neighbor_part_id] != node_id) {
+        last_node[neighbor_part_id] = node_id;
+        ++stats.part.communication_volume;
+      }
+    };
+    gbbs_graph->get_vertex(node_id).out_neighbors().map(add_edge,
+                                                         /*parallel=*/false);
+    stats.part.num_boundary_nodes = stats.part.communication_volume > 0 ? 1 : 0;
+    return stats;
+  };
+
+  std::vector<double> part_edge_weights(num_parts);
+  PartitionQuality quality;
+  quality.parts.resize(num_parts);
+  parlay::parallel_for(
+      0, num_parts,
+      [&](std::size_t part_id) {
+        const auto& cluster = clustering[part_id];
+        PartStats stats = parlay::reduce(
+            parlay::delayed_seq<PartStats>(
+                cluster.size(),
+                [&](std::size_t i) { return node_stats(cluster[i], part_id); }),
+            parlay::make_monoid(AddPartStats, PartStats()));
+        quality.parts[part_id] = stats.part;
+        part_edge_weights[part_id] = stats.edge_weight;
+      },
+      /*granularity=*/1);
+
+  PartStats totals = parlay::reduce(
+      parlay::delayed_seq<PartStats>(num_parts,
+                                     [&](std::size_t i) {
+                                       return PartStats{quality.parts[i],
+                                                        part_edge_weights[i]};
+                                     }),
+      parlay::make_monoid(AddPartStats, PartStats()));
+  quality.total_edge_weight = totals.edge_weight;
+  quality.cut_weight = totals.part.cut_weight;
+  quality.cut_ratio = totals.edge_weight == 0
+                          ? 0
+                          : totals.part.cut_weight / totals.edge_weight;
+  quality.total_node_weight = totals.part.node_weight;
+  quality.num_boundary_nodes = totals.part.num_boundary_nodes;
+  quality.communication_volume = totals.part.communication_volume;
+  if (num_parts > 0) {
+    quality.max_part_node_weight =
+        parlay::reduce(parlay::delayed_seq<double>(
+                           num_parts,
+                           [&](std::size_t i) {
+                             return quality.parts[i].node_weight;
+                           }),
+                       parlay::maxm<double>());
+    quality.max_part_communication_volume = parlay::reduce(
+        parlay::delayed_seq<std::size_t>(
+            num_parts,
+            [&](std::size_t i) {
+              return quality.parts[i].communication_volume;
+            }),
+        parlay::maxm<std::size_t>());
+    if (quality.total_node_weight > 0) {
+      quality.imbalance = quality.max_part_node_weight * num_parts /
+                              quality.total_node_weight -
+                          1;
+    }
+  }
+  return quality;
+}
+
+std::string PartitionQualitySummary(const PartitionQuality& quality,
+                                    int max_listed_parts) {
+  std::string summary = absl::StrCat(
+      "parts: ", quality.parts.size(), ", cut weight: ", quality.cut_weight,
+      " of ", quality.total_edge_weight, " (ratio ", quality.cut_ratio,
+      "), imbalance: ", quality.imbalance,
+      ", boundary nodes: ", quality.num_boundary_nodes,
+      ", communication volume: ", quality.communication_volume, " (max ",
+      quality.max_part_communication_volume, " per part)");
+  std::vector<std::size_t> part_ids(quality.parts.size());
+  for (std::size_t i = 0; i < part_ids.size(); ++i) part_ids[i] = i;
+  const std::size_t num_listed_parts =
+      std::min<std::size_t>(std::max(max_listed_parts, 0), part_ids.size());
+  std::partial_sort(part_ids.begin(), part_ids.begin() + num_listed_parts,
+                    part_ids.end(), [&](std::size_t a, std::size_t b) {
+                      return quality.parts[a].cut_weight >
+                             quality.parts[b].cut_weight;
+                    });
+  for (std::size_t i = 0; i < num_listed_parts; ++i) {
+    const Part& part = quality.parts[part_ids[i]];
+    absl::StrAppend(&summary, "\n  part ", part_ids[i],
+                    ": nodes: ", part.num_nodes,
+                    ", weight: ", part.node_weight,
+                    ", cut weight: ", part.cut_weight,
+                    ", boundary nodes: ", part.num_boundary_nodes,
+                    ", communication volume: ", part.communication_volume);
+  }
+  return summary;
+}
+
+}  // namespace graph_mining::in_memory
@@ -0,0 +1,79 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_PARLINE_PARTITION_QUALITY_H_
+#define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_PARLINE_PARTITION_QUALITY_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+
+namespace graph_mining::in_memory {
+
+// Quality measures of a partition (clustering) of a graph. As in
+// ComputeCutRatio, both directions of each edge are counted in edge weights.
+// Node weights are the vertex weights of the graph if present, and 1
+// otherwise.
+struct PartitionQuality {
+  struct Part {
+    std::size_t num_nodes = 0;
+    double node_weight = 0;
+    // Total weight of the edges from nodes of this part to other parts.
+    double cut_weight = 0;
+    // Number of nodes of this part with at least one neighbor in another part.
+    std::size_t num_boundary_nodes = 0;
+    // Sum over the nodes of this part of the number of distinct other parts
+    // containing a neighbor of the node, i.e., the number of node copies this
+    // part has to send out in a distributed computation.
+    std::size_t communication_volume = 0;
+  };
+  // Indexed the same way as the input clustering.
+  std::vector<Part> parts;
+
+  double total_edge_weight = 0;
+  // Sum of the cut weights of all parts.
+  double cut_weight = 0;
+  // cut_weight / total_edge_weight, or 0 if the graph has no edges.
+  double cut_ratio = 0;
+
+  double total_node_weight = 0;
+  double max_part_node_weight = 0;
+  // max_part_node_weight divided by the average part node weight, minus 1.
+  double imbalance = 0;
+
+  std::size_t num_boundary_nodes = 0;
+  std::size_t communication_volume = 0;
+  std::size_t max_part_communication_volume = 0;
+};
+
+// Computes the quality measures of the clustering in a single parallel pass
+// over the edges of the graph. Uses O(num_nodes + num_workers * num_parts)
+// additional memory. Returns an error if the clustering is not a partition of
+// the nodes of the graph.
+absl::StatusOr<PartitionQuality> ComputePartitionQuality(
+    const InMemoryClusterer::Clustering& clustering, const GbbsGraph& graph);
+
+// Returns a human-readable summary of the quality measures, including the
+// per-part measures of at most max_listed_parts parts with the largest cut
+// weights.
+std::string PartitionQualitySummary(const PartitionQuality& quality,
+                                    int max_listed_parts = 10);
+
+}  // namespace graph_mining::in_memory
+
+#endif  // THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_PARLINE_PARTITION_QUALITY_H_
@@ -0,0 +1,112 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/clustering/parline/partition_quality.h"
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/graph.h"
+#include "in_memory/status_macros.h"  // IWYU pragma: keep
+
+namespace graph_mining::in_memory {
+namespace {
+
+using ::testing::DoubleEq;
+using ::testing::ElementsAre;
+using ::testing::FieldsAre;
+using ::testing::HasSubstr;
+using ::testing::Not;
+
+// Returns the graph with the edges {0, 1}: 1, {1, 2}: 2, {2, 3}: 1,
+// {1, 3}: 3 and {3, 4}: 0.5, where node 4 has weight 4 and the other nodes
+// have weight 1.
+absl::Status MakeGraph(GbbsGraph& graph) {
+  SimpleUndirectedGraph simple_graph;
+  for (const auto& [node_a, node_b, weight] :
+       std::vector<std::tuple<int, int, double>>{
+           {0, 1, 1}, {1, 2, 2}, {2, 3, 1}, {1, 3, 3}, {3, 4, 0.5}}) {
+    RETURN_IF_ERROR(simple_graph.AddEdge(node_a, node_b, weight));
+  }
+  simple_graph.SetNodeWeight(4, 4.0);
+  return CopyGraph(simple_graph, &graph);
+}
+
+TEST(PartitionQualityTest, ComputesPartAndTotalMeasures) {
+  GbbsGraph graph;
+  ASSERT_OK(MakeGraph(graph));
+  ASSERT_OK_AND_ASSIGN(const PartitionQuality quality,
+                       ComputePartitionQuality({{0, 1}, {2, 3}, {4}}, graph));
+  // Node 1 is the only boundary node of part 0. Node 3 has neighbors in parts
+  // 0 and 2, so it contributes 2 to the communication volume of part 1.
+  EXPECT_THAT(quality.parts,
+              ElementsAre(FieldsAre(2, 2, 5, 1, 1), FieldsAre(2, 2, 5.5, 2, 3),
+                          FieldsAre(1, 4, 0.5, 1, 1)));
+  EXPECT_EQ(quality.total_edge_weight, 15);
+  EXPECT_EQ(quality.cut_weight, 11);
+  EXPECT_THAT(quality.cut_ratio, DoubleEq(11.0 / 15));
+  EXPECT_EQ(quality.total_node_weight, 8);
+  EXPECT_EQ(quality.max_part_node_weight, 4);
+  EXPECT_THAT(quality.imbalance, DoubleEq(0.5));
+  EXPECT_EQ(quality.num_boundary_nodes, 4);
+  EXPECT_EQ(quality.communication_volume, 5);
+  EXPECT_EQ(quality.max_part_communication_volume, 3);
+}
+
+TEST(PartitionQualityTest, SinglePartHasNoCut) {
+  GbbsGraph graph;
+  ASSERT_OK(MakeGraph(graph));
+  ASSERT_OK_AND_ASSIGN(const PartitionQuality quality,
+                       ComputePartitionQuality({{0, 1, 2, 3, 4}}, graph));
+  EXPECT_THAT(quality.parts, ElementsAre(FieldsAre(5, 8, 0, 0, 0)));
+  EXPECT_EQ(quality.cut_weight, 0);
+  EXPECT_EQ(quality.cut_ratio, 0);
+  EXPECT_EQ(quality.imbalance, 0);
+}
+
+TEST(PartitionQualityTest, SummaryListsPartsWithLargestCutWeight) {
+  GbbsGraph graph;
+  ASSERT_OK(MakeGraph(graph));
+  ASSERT_OK_AND_ASSIGN(const PartitionQuality quality,
+                       ComputePartitionQuality({{0, 1}, {2, 3}, {4}}, graph));
+  const std::string summary =
+      PartitionQualitySummary(quality, /*max_listed_parts=*/1);
+  EXPECT_THAT(summary, HasSubstr("parts: 3, cut weight: 11 of 15"));
+  EXPECT_THAT(summary, HasSubstr("\n  part 1: nodes: 2, weight: 2, "
+                                 "cut weight: 5.5"));
+  EXPECT_THAT(summary, Not(HasSubstr("part 0:")));
+  EXPECT_THAT(summary, Not(HasSubstr("part 2:")));
+}
+
+TEST(PartitionQualityTest, ClusteringThatIsNotAPartitionIsAnError) {
+  GbbsGraph graph;
+  ASSERT_OK(MakeGraph(graph));
+  // Node 4 is missing.
+  EXPECT_THAT(ComputePartitionQuality({{0, 1}, {2, 3}}, graph),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  // Node 1 is in two clusters.
+  EXPECT_THAT(ComputePartitionQuality({{0, 1}, {1, 2, 3}}, graph),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  // Node 5 is not in the graph.
+  EXPECT_THAT(ComputePartitionQuality({{0, 1}, {2, 3}, {5}}, graph),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace graph_mining::in_memory
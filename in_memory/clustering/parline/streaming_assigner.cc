@@ -0,0 +1,394 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/clustering/parline/streaming_assigner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/clustering/parline/pairwise_improver.h"
+#include "in_memory/clustering/parline/parline.pb.h"
+#include "parlay/delayed_sequence.h"
+#include "parlay/parallel.h"
+#include "parlay/primitives.h"
+#include "parlay/sequence.h"
+
+namespace graph_mining::in_memory {
+namespace {
+
+using NodeId = InMemoryClusterer::NodeId;
+
+// Cluster indices of nodes without a cluster.
+constexpr int kUnassigned = -1;
+// Nodes of the batch being assigned.
+constexpr int kPending = -2;
+
+// Computes the FENNEL alpha parameter from the total edge weight estimated
+// from the weighted degrees of the given nodes.
+double EstimateFennelAlpha(
+    absl::Span<const InMemoryClusterer::AdjacencyList> nodes,
+    double nodes_weight, double total_node_weight, int num_clusters,
+    double gamma) {
+  if (nodes_weight <= 0 || total_node_weight <= 0) return 0;
+  const double nodes_edge_weight = parlay::reduce(
+      parlay::delayed_seq<double>(nodes.size(),
+                                  [&](std::size_t i) {
+                                    double weight = 0;
+                                    for (const auto& [neighbor, edge_weight] :
+                                         nodes[i].outgoing_edges) {
+                                      weight += edge_weight;
+                                    }
+                                    return weight;
+                                  }),
+      parlay::addm<double>());
+  // Each edge is counted from both of its ends.
+  const double total_edge_weight =
+      nodes_edge_weight / nodes_weight * total_node_weight / 2;
+  return total_edge_weight * std::pow(num_clusters, gamma - 1) /
+         std::pow(total_node_weight, gamma);
+}
+
+}  // namespace
+
+StreamingAssigner::StreamingAssigner(const StreamingAssignmentConfig& config)
+    : config_(config) {}
+
+absl::Status StreamingAssigner::SetPartition(
+    const InMemoryClusterer::Clustering& clustering,
+    absl::Span<const double> node_weights) {
+  if (clustering.empty()) {
+    return absl::InvalidArgumentError("Clustering must not be empty.");
+  }
+  NodeId num_nodes = node_weights.size();
+  for (const auto& cluster : clustering) {
+    for (const NodeId node_id : cluster) {
+      if (node_id < 0) {
+        return absl::InvalidArgumentError(
+            absl::StrCat("Invalid node id: ", node_id));
+      }
+      num_nodes = std::max(num_nodes, node_id + 1);
+    }
+  }
+  if (!node_weights.empty() && node_weights.size() != num_nodes) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Node id out of range of node_weights: ", num_nodes - 1));
+  }
+  std::vector<int> node_cluster_ids(num_nodes, kUnassigned);
+  node_weights_.assign(num_nodes, 0);
+  cluster_weights_.assign(clustering.size(), 0);
+  for (int i = 0; i < clustering.size(); ++i) {
+    for (const NodeId node_id : clustering[i]) {
+      if (node_cluster_ids[node_id] != kUnassigned) {
+        return absl::InvalidArgumentError(
+            absl::StrCat("Node ", node_id, " is in multiple clusters."));
+      }
+      node_cluster_ids[node_id] = i;
+      node_weights_[node_id] =
+          node_weights.empty() ? 1.0 : node_weights[node_id];
+      cluster_weights_[i] += node_weights_[node_id];
+    }
+  }
+  clusters_ = CreateDenseClusters(clustering, num_nodes);
+  total_node_weight_ =
+      parlay::reduce(cluster_weights_, parlay::addm<double>());
+  max_node_weight_ = parlay::reduce(node_weights_, parlay::maxm<double>());
+  affected_pairs_.clear();
+  return absl::OkStatus();
+}
+
+double StreamingAssigner::MaxClusterWeight(double total_node_weight) const {
+  const double average_cluster_weight = total_node_weight / NumClusters();
+  return std::max((1 + config_.imbalance()) * average_cluster_weight,
+                  average_cluster_weight + max_node_weight_);
+}
+
+absl::StatusOr<std::vector<int>> StreamingAssigner::AssignNodes(
+    absl::Span<const AdjacencyList> nodes) {
+  if (cluster_weights_.empty()) {
+    return absl::FailedPreconditionError("SetPartition must be called first.");
+  }
+  // Validate the batch and mark its nodes as pending.
+  auto node_ids = parlay::sequence<NodeId>::from_function(
+      nodes.size(), [&](std::size_t i) { return nodes[i].id; });
+  parlay::sort_inplace(node_ids);
+  for (std::size_t i = 0; i < node_ids.size(); ++i) {
+    if (node_ids[i] < 0 || (i > 0 && node_ids[i] == node_ids[i - 1]) ||
+        ClusterId(node_ids[i]) != kUnassigned) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Invalid or already assigned node id: ", node_ids[i]));
+    }
+  }
+  for (const auto& node : nodes) {
+    if (node.part.has_value() &&
+        (*node.part < 0 || *node.part >= NumClusters())) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Invalid part ", *node.part, " for node ", node.id));
+    }
+  }
+  if (nodes.empty()) return std::vector<int>();
+  if (node_ids.back() >= clusters_.node_cluster_ids.size()) {
+    clusters_.node_cluster_ids.resize(node_ids.back() + 1, kUnassigned);
+    clusters_.node_positions.resize(node_ids.back() + 1, -1);
+    node_weights_.resize(node_ids.back() + 1, 0);
+  }
+  parlay::parallel_for(0, nodes.size(), [&](std::size_t i) {
+    clusters_.node_cluster_ids[nodes[i].id] = kPending;
+    node_weights_[nodes[i].id] = nodes[i].weight;
+  });
+  const double nodes_weight = parlay::reduce(
+      parlay::delayed_seq<double>(
+          nodes.size(), [&](std::size_t i) { return nodes[i].weight; }),
+      parlay::addm<double>());
+  max_node_weight_ = std::max(
+      max_node_weight_,
+      parlay::reduce(parlay::delayed_seq<double>(
+                         nodes.size(),
+                         [&](std::size_t i) { return nodes[i].weight; }),
+                     parlay::maxm<double>()));
+
+  // Nodes with a given part are assigned first.
+  for (const auto& node : nodes) {
+    if (!node.part.has_value()) continue;
+    AddToCluster(node.id, *node.part);
+    cluster_weights_[*node.part] += node.weight;
+    total_node_weight_ += node.weight;
+  }
+
+  const double fennel_alpha =
+      config_.has_fennel_alpha()
+          ? config_.fennel_alpha()
+          : EstimateFennelAlpha(nodes, nodes_weight,
+                                total_node_weight_ + nodes_weight,
+                                NumClusters(), config_.fennel_gamma());
+  const std::size_t round_size = std::max(1, config_.round_size());
+  std::vector<std::size_t> round;
+  std::size_t next_node = 0;
+  while (true) {
+    while (round.size() < round_size && next_node < nodes.size()) {
+      if (!nodes[next_node].part.has_value()) round.push_back(next_node);
+      ++next_node;
+    }
+    if (round.empty()) break;
+    // The nodes that are not accepted are retried in the next round.
+    round = AssignRound(nodes, round, fennel_alpha);
+  }
+
+  RecordAffectedPairs(nodes);
+  std::vector<int> node_cluster_ids(nodes.size());
+  parlay::parallel_for(0, nodes.size(), [&](std::size_t i) {
+    node_cluster_ids[i] = clusters_.node_cluster_ids[nodes[i].id];
+  });
+  return node_cluster_ids;
+}
+
+std::vector<std::size_t> StreamingAssigner::AssignRound(
+    absl::Span<const AdjacencyList> nodes,
+    const std::vector<std::size_t>& round, double fennel_alpha) {
+  const int num_clusters = NumClusters();
+  const double round_weight = parlay::reduce(
+      parlay::delayed_seq<double>(
+          round.size(), [&](std::size_t i) { return nodes[round[i]].weight; }),
+      parlay::addm<double>());
+  const double max_cluster_weight =
+      MaxClusterWeight(total_node_weight_ + round_weight);
+  const int lightest_cluster =
+      parlay::min_element(cluster_weights_) - cluster_weights_.begin();
+
+  auto score = [&](int cluster_id, double connectivity, double node_weight) {
+    const double cluster_weight = cluster_weights_[cluster_id];
+    switch (config_.objective()) {
+      case StreamingAssignmentConfig::FENNEL:
+        return connectivity -
+               fennel_alpha * config_.fennel_gamma() *
+                   std::pow(cluster_weight, config_.fennel_gamma() - 1) *
+                   node_weight;
+      case StreamingAssignmentConfig::LDG:
+      default:
+        return connectivity * (1 - cluster_weight / max_cluster_weight);
+    }
+  };
+
+  // 1) Compute the best cluster of each node of the round. Only the clusters of
+  // the neighbors and the lightest cluster need to be considered since any
+  // other cluster has no connectivity and a larger weight than the lightest
+  // cluster, so it cannot have a larger score under either objective.
+  std::vector<int> best_clusters(round.size());
+  parlay::parallel_for(0, round.size(), [&](std::size_t i) {
+    const AdjacencyList& node = nodes[round[i]];
+    absl::flat_hash_map<int, double> connectivity;
+    connectivity[lightest_cluster] = 0;
+    for (const auto& [neighbor, edge_weight] : node.outgoing_edges) {
+      const int cluster_id = ClusterId(neighbor);
+      if (cluster_id >= 0) connectivity[cluster_id] += edge_weight;
+    }
+    int best_cluster = -1;
+    double best_score = 0;
+    for (const auto& [cluster_id, cluster_connectivity] : connectivity) {
+      if (cluster_weights_[cluster_id] + node.weight > max_cluster_weight) {
+        continue;
+      }
+      const double cluster_score =
+          score(cluster_id, cluster_connectivity, node.weight);
+      // Ties are broken by lighter cluster weight and then by smaller index.
+      if (best_cluster == -1 ||
+          std::make_tuple(cluster_score, -cluster_weights_[cluster_id],
+                          -cluster_id) >
+              std::make_tuple(best_score, -cluster_weights_[best_cluster],
+                              -best_cluster)) {
+        best_cluster = cluster_id;
+        best_score = cluster_score;
+      }
+    }
+    best_clusters[i] = best_cluster == -1 ? lightest_cluster : best_cluster;
+  });
+
+  // 2) Accept the nodes of each cluster in round order while the cluster stays
+  // within max_cluster_weight. The first node of each cluster is always
+  // accepted since it fits by the choice above (or the cluster is the
+  // lightest one), which guarantees progress.
+  auto order = parlay::sequence<std::pair<int, std::size_t>>::from_function(
+      round.size(),
+      [&](std::size_t i) { return std::make_pair(best_clusters[i], i); });
+  parlay::sort_inplace(order);
+  auto group_starts = parlay::pack_index<std::size_t>(
+      parlay::delayed_seq<bool>(order.size(), [&](std::size_t i) {
+        return i == 0 || order[i - 1].first != order[i].first;
+      }));
+  parlay::sequence<bool> accepted_flags(round.size(), false);
+  std::vector<double> accepted_weights(group_starts.size());
+  parlay::parallel_for(0, group_starts.size(), [&](std::size_t g) {
+    const std::size_t end =
+        g + 1 < group_starts.size() ? group_starts[g + 1] : order.size();
+    const int cluster_id = order[group_starts[g]].first;
+    double cluster_weight = cluster_weights_[cluster_id];
+    for (std::size_t j = group_starts[g]; j < end; ++j) {
+      const std::size_t i = order[j].second;
+      const double node_weight = nodes[round[i]].weight;
+      if (j > group_starts[g] &&
+          cluster_weight + node_weight > max_cluster_weight) {
+        continue;
+      }
+      accepted_flags[i] = true;
+      cluster_weight += node_weight;
+      AddToCluster(nodes[round[i]].id, cluster_id);
+    }
+    accepted_weights[g] = cluster_weight - cluster_weights_[cluster_id];
+    cluster_weights_[cluster_id] = cluster_weight;
+  });
+  total_node_weight_ +=
+      parlay::reduce(accepted_weights, parlay::addm<double>());
+
+  std::vector<std::size_t> rejected;
+  for (std::size_t i = 0; i < round.size(); ++i) {
+    if (!accepted_flags[i]) rejected.push_back(round[i]);
+  }
+  return rejected;
+}
+
+void StreamingAssigner::AddToCluster(NodeId node_id, int cluster_id) {
+  auto& cluster = clusters_.clusters[cluster_id];
+  clusters_.node_cluster_ids[node_id] = cluster_id;
+  clusters_.node_positions[node_id] = cluster.size();
+  cluster.push_back(node_id);
+}
+
+void StreamingAssigner::RecordAffectedPairs(
+    absl::Span<const AdjacencyList> nodes) {
+  using WeightedPair = std::pair<std::pair<int, int>, double>;
+  auto node_pairs = parlay::sequence<parlay::sequence<WeightedPair>>::
+      from_function(nodes.size(), [&](std::size_t i) {
+        parlay::sequence<WeightedPair> pairs;
+        const int cluster_id = clusters_.node_cluster_ids[nodes[i].id];
+        for (const auto& [neighbor, edge_weight] : nodes[i].outgoing_edges) {
+          const int neighbor_cluster_id = ClusterId(neighbor);
+          if (neighbor_cluster_id < 0 || neighbor_cluster_id == cluster_id) {
+            continue;
+          }
+          pairs.push_back({std::minmax(cluster_id, neighbor_cluster_id),
+                           edge_weight});
+        }
+        return pairs;
+      });
+  for (const auto& pairs : node_pairs) {
+    for (const auto& [cluster_pair, weight] : pairs) {
+      affected_pairs_[cluster_pair] += weight;
+    }
+  }
+}
+
+absl::Status StreamingAssigner::ImproveAffectedClusters(
+    const GbbsGraph& graph) {
+  const std::size_t num_nodes = graph.Graph()->n;
+  if (num_nodes < clusters_.node_cluster_ids.size()) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Graph has ", num_nodes, " nodes but node ids up to ",
+        clusters_.node_cluster_ids.size() - 1, " are assigned."));
+  }
+  // The improvers look up the clusters of all the neighbors.
+  clusters_.node_cluster_ids.resize(num_nodes, kUnassigned);
+  clusters_.node_positions.resize(num_nodes, -1);
+  std::vector<std::pair<std::pair<int, int>, double>> affected_pairs(
+      affected_pairs_.begin(), affected_pairs_.end());
+  affected_pairs_.clear();
+  parlay::sort_inplace(affected_pairs, [](const auto& a, const auto& b) {
+    return std::tie(b.second, a.first) < std::tie(a.second, b.first);
+  });
+  const double max_cluster_weight = MaxClusterWeight(total_node_weight_);
+  for (int round = 0;
+       round < config_.num_improvement_rounds() && !affected_pairs.empty();
+       ++round) {
+    // Greedily pick disjoint pairs, heaviest first. The remaining pairs are
+    // left to the next round.
+    std::vector<bool> used(NumClusters());
+    std::vector<std::pair<int, int>> cluster_id_pairs;
+    std::vector<std::pair<std::pair<int, int>, double>> remaining_pairs;
+    for (const auto& affected_pair : affected_pairs) {
+      const auto [cluster1_id, cluster2_id] = affected_pair.first;
+      if (used[cluster1_id] || used[cluster2_id]) {
+        remaining_pairs.push_back(affected_pair);
+        continue;
+      }
+      used[cluster1_id] = used[cluster2_id] = true;
+      cluster_id_pairs.push_back(affected_pair.first);
+    }
+    affected_pairs.swap(remaining_pairs);
+
+    ImproveClusterPairs(graph, cluster_id_pairs, max_cluster_weight,
+                        config_.cluster_pair_improver_method(), clusters_);
+    parlay::parallel_for(0, cluster_id_pairs.size(), [&](std::size_t i) {
+      for (const int cluster_id :
+           {cluster_id_pairs[i].first, cluster_id_pairs[i].second}) {
+        double cluster_weight = 0;
+        for (const NodeId node_id : clusters_.clusters[cluster_id]) {
+          cluster_weight += node_weights_[node_id];
+        }
+        cluster_weights_[cluster_id] = cluster_weight;
+      }
+    });
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace graph_mining::in_memory
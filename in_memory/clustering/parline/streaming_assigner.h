@@ -0,0 +1,140 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_PARLINE_STREAMING_ASSIGNER_H_
+#define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_PARLINE_STREAMING_ASSIGNER_H_
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/clustering/parline/pairwise_improver.h"
+#include "in_memory/clustering/parline/parline.pb.h"
+
+namespace graph_mining::in_memory {
+
+// Assigns new nodes to the clusters of an existing partition (for example one
+// computed by ParallelLinePartitioner) without recomputing the partition.
+//
+// New nodes arrive in batches of adjacency lists. The nodes of a batch are
+// assigned in rounds of StreamingAssignmentConfig.round_size nodes: all the
+// nodes of a round are scored in parallel against the cluster weights at the
+// beginning of the round using a balance-aware greedy objective (LDG or
+// Fennel), and each node is then accepted into its best cluster as long as the
+// cluster stays within the maximum cluster weight. Nodes that are not accepted
+// are retried in the next round. Edges to nodes that have not been assigned
+// yet (including nodes of the same round) are ignored.
+//
+// Optionally, the pairs of clusters connected by the edges of the new nodes can
+// be improved afterwards with a cluster pair improver (see
+// ImproveAffectedClusters).
+//
+// Example usage:
+//   StreamingAssigner assigner(config);
+//   RETURN_IF_ERROR(assigner.SetPartition(clustering, node_weights));
+//   ASSIGN_OR_RETURN(std::vector<int> cluster_ids,
+//                    assigner.AssignNodes(new_nodes));
+//
+// This class is not thread-safe.
+class StreamingAssigner {
+ public:
+  using AdjacencyList = InMemoryClusterer::AdjacencyList;
+  using NodeId = InMemoryClusterer::NodeId;
+
+  explicit StreamingAssigner(const StreamingAssignmentConfig& config);
+
+  // Sets the existing partition. Node ids in clustering must be distinct and
+  // node_weights[i] is the weight of node i (all weights are 1 if
+  // node_weights is empty). The clusters keep their indices in clustering.
+  absl::Status SetPartition(const InMemoryClusterer::Clustering& clustering,
+                            absl::Span<const double> node_weights = {});
+
+  // Assigns a batch of new nodes to the clusters and returns the cluster index
+  // of each node of the batch (in the same order). The node ids must be
+  // distinct and must not have been assigned before. If the part field of an
+  // adjacency list is set then the node is assigned to that cluster. Only the
+  // outgoing edges of the new nodes are used, so an edge between two new nodes
+  // should appear in both of their adjacency lists.
+  absl::StatusOr<std::vector<int>> AssignNodes(
+      absl::Span<const AdjacencyList> nodes);
+
+  // Improves the pairs of clusters connected by the edges of the nodes
+  // assigned since the last call, heaviest connections first, using
+  // config.cluster_pair_improver_method(). The graph must contain all the
+  // nodes assigned so far with the same node ids and node weights. Clusters
+  // are kept within the maximum cluster weight of
+  // StreamingAssignmentConfig.imbalance.
+  absl::Status ImproveAffectedClusters(const GbbsGraph& graph);
+
+  // Returns the current partition. Cluster i contains the nodes whose cluster
+  // index is i, so empty clusters are included.
+  InMemoryClusterer::Clustering Clustering() const {
+    return clusters_.clusters;
+  }
+
+  // Returns the cluster index of a node or -1 if the node is not assigned.
+  int ClusterId(NodeId node_id) const {
+    return node_id >= 0 && node_id < clusters_.node_cluster_ids.size()
+               ? clusters_.node_cluster_ids[node_id]
+               : -1;
+  }
+
+  // Returns the current weight of a cluster.
+  double ClusterWeight(int cluster_id) const {
+    return cluster_weights_[cluster_id];
+  }
+
+  int NumClusters() const { return cluster_weights_.size(); }
+
+ private:
+  // Returns the max cluster weight for the given total node weight.
+  double MaxClusterWeight(double total_node_weight) const;
+
+  // Assigns the nodes with the given indices into nodes in parallel and
+  // returns the indices of the nodes that are not accepted.
+  std::vector<std::size_t> AssignRound(absl::Span<const AdjacencyList> nodes,
+                                       const std::vector<std::size_t>& round,
+                                       double fennel_alpha);
+
+  // Appends a node to a cluster without updating the cluster weight. Nodes
+  // can be added to different clusters in parallel.
+  void AddToCluster(NodeId node_id, int cluster_id);
+
+  // Records the weights of the edges between the clusters of the given nodes
+  // and the clusters of their neighbors.
+  void RecordAffectedPairs(absl::Span<const AdjacencyList> nodes);
+
+  StreamingAssignmentConfig config_;
+  // The current partition. Kept up to date incrementally, so that improving a
+  // pair of clusters only touches the nodes of the two clusters. The cluster
+  // index of a node is negative if the node is not assigned.
+  DenseClusters clusters_;
+  std::vector<double> node_weights_;
+  std::vector<double> cluster_weights_;
+  double total_node_weight_ = 0;
+  double max_node_weight_ = 0;
+  // Total weight of the new edges between pairs of clusters (with the smaller
+  // cluster index first) since the last ImproveAffectedClusters call.
+  absl::flat_hash_map<std::pair<int, int>, double> affected_pairs_;
+};
+
+}  // namespace graph_mining::in_memory
+
+#endif  // THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_PARLINE_STREAMING_ASSIGNER_H_
@@ -0,0 +1,164 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/clustering/parline/streaming_assigner.h"
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/graph.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/clustering/parline/parline.pb.h"
+#include "in_memory/status_macros.h"  // IWYU pragma: keep
+
+namespace graph_mining::in_memory {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::UnorderedElementsAre;
+using AdjacencyList = StreamingAssigner::AdjacencyList;
+using NodeId = StreamingAssigner::NodeId;
+
+AdjacencyList Node(NodeId id, const std::vector<NodeId>& neighbors,
+                   std::optional<int32_t> part = std::nullopt) {
+  AdjacencyList node;
+  node.id = id;
+  for (const NodeId neighbor : neighbors) {
+    node.outgoing_edges.emplace_back(neighbor, 1.0);
+  }
+  node.part = part;
+  return node;
+}
+
+StreamingAssignmentConfig ConfigWithRoundSize(int32_t round_size) {
+  StreamingAssignmentConfig config;
+  config.set_round_size(round_size);
+  return config;
+}
+
+TEST(StreamingAssignerTest, AssignsToConnectedCluster) {
+  StreamingAssigner assigner{StreamingAssignmentConfig()};
+  ASSERT_OK(assigner.SetPartition({{0, 1}, {2, 3}}));
+  EXPECT_THAT(assigner.AssignNodes({Node(4, {2, 3})}),
+              IsOkAndHolds(ElementsAre(1)));
+  EXPECT_EQ(assigner.ClusterId(4), 1);
+  EXPECT_EQ(assigner.ClusterWeight(0), 2);
+  EXPECT_EQ(assigner.ClusterWeight(1), 3);
+  EXPECT_THAT(assigner.Clustering(),
+              ElementsAre(UnorderedElementsAre(0, 1),
+                          UnorderedElementsAre(2, 3, 4)));
+}
+
+TEST(StreamingAssignerTest, RespectsMaxClusterWeight) {
+  StreamingAssigner assigner{StreamingAssignmentConfig()};
+  ASSERT_OK(assigner.SetPartition({{0, 1}, {2, 3}}));
+  // With all 7 nodes the max cluster weight is max(1.05 * 3.5, 3.5 + 1) = 4.5,
+  // so only two of the new nodes fit into cluster 1 and the last one goes to
+  // the lightest cluster.
+  EXPECT_THAT(assigner.AssignNodes(
+                  {Node(4, {2, 3}), Node(5, {2, 3}), Node(6, {2, 3})}),
+              IsOkAndHolds(ElementsAre(1, 1, 0)));
+  EXPECT_EQ(assigner.ClusterWeight(0), 3);
+  EXPECT_EQ(assigner.ClusterWeight(1), 4);
+}
+
+TEST(StreamingAssignerTest, AssignsGivenPart) {
+  StreamingAssigner assigner{StreamingAssignmentConfig()};
+  ASSERT_OK(assigner.SetPartition({{0, 1}, {2, 3}}));
+  EXPECT_THAT(assigner.AssignNodes({Node(4, {2, 3}, /*part=*/0)}),
+              IsOkAndHolds(ElementsAre(0)));
+  EXPECT_EQ(assigner.ClusterWeight(0), 3);
+}
+
+TEST(StreamingAssignerTest, UsesNodesOfEarlierRounds) {
+  // Node 5 is only connected to node 4, which is assigned to cluster 1 in the
+  // first round when each round has a single node.
+  StreamingAssigner assigner(ConfigWithRoundSize(1));
+  ASSERT_OK(assigner.SetPartition({{0, 1}, {2, 3}}));
+  EXPECT_THAT(assigner.AssignNodes({Node(4, {2, 5}), Node(5, {4})}),
+              IsOkAndHolds(ElementsAre(1, 1)));
+}
+
+TEST(StreamingAssignerTest, IgnoresNodesOfTheSameRound) {
+  // Node 4 is still unassigned when node 5 is assigned, so node 5 has no
+  // connectivity and goes to the lightest cluster.
+  StreamingAssigner assigner(ConfigWithRoundSize(2));
+  ASSERT_OK(assigner.SetPartition({{0, 1}, {2, 3}}));
+  EXPECT_THAT(assigner.AssignNodes({Node(4, {2, 5}), Node(5, {4})}),
+              IsOkAndHolds(ElementsAre(1, 0)));
+}
+
+TEST(StreamingAssignerTest, ImprovesAffectedClusters) {
+  // The triangles {0, 1, 2} and {3, 4, 5} joined by the edge {2, 3}. Nodes 2
+  // and 5 are forced into the wrong clusters.
+  StreamingAssigner assigner{StreamingAssignmentConfig()};
+  ASSERT_OK(assigner.SetPartition({{0, 1}, {3, 4}}));
+  ASSERT_OK(assigner
+                .AssignNodes({Node(2, {0, 1, 3}, /*part=*/1),
+                              Node(5, {3, 4}, /*part=*/0)})
+                .status());
+  SimpleUndirectedGraph simple_graph;
+  for (const auto& [node_a, node_b] : std::vector<std::pair<int, int>>{
+           {0, 1}, {0, 2}, {1, 2}, {3, 4}, {3, 5}, {4, 5}, {2, 3}}) {
+    ASSERT_OK(simple_graph.AddEdge(node_a, node_b, 1.0));
+  }
+  GbbsGraph graph;
+  ASSERT_OK(CopyGraph(simple_graph, &graph));
+  ASSERT_OK(assigner.ImproveAffectedClusters(graph));
+  EXPECT_THAT(assigner.Clustering(),
+              ElementsAre(UnorderedElementsAre(0, 1, 2),
+                          UnorderedElementsAre(3, 4, 5)));
+  EXPECT_EQ(assigner.ClusterWeight(0), 3);
+  EXPECT_EQ(assigner.ClusterWeight(1), 3);
+}
+
+TEST(StreamingAssignerTest, AssignNodesBeforeSetPartitionIsAnError) {
+  StreamingAssigner assigner{StreamingAssignmentConfig()};
+  EXPECT_THAT(assigner.AssignNodes({Node(0, {})}),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+}
+
+TEST(StreamingAssignerTest, InvalidPartitionIsAnError) {
+  StreamingAssigner assigner{StreamingAssignmentConfig()};
+  EXPECT_THAT(assigner.SetPartition({}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(assigner.SetPartition({{0, 1}, {1, 2}}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(assigner.SetPartition({{0, -1}}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(StreamingAssignerTest, InvalidNodesAreAnError) {
+  StreamingAssigner assigner{StreamingAssignmentConfig()};
+  ASSERT_OK(assigner.SetPartition({{0, 1}, {2, 3}}));
+  // Already assigned.
+  EXPECT_THAT(assigner.AssignNodes({Node(3, {})}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  // Duplicate.
+  EXPECT_THAT(assigner.AssignNodes({Node(4, {}), Node(4, {})}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  // Invalid part.
+  EXPECT_THAT(assigner.AssignNodes({Node(4, {}, /*part=*/2)}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_EQ(assigner.ClusterId(4), -1);
+}
+
+}  // namespace
+}  // namespace graph_mining::in_memory
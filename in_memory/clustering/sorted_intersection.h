@@ -0,0 +1,80 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_SORTED_INTERSECTION_H_
+#define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_SORTED_INTERSECTION_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "absl/types/span.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace graph_mining::in_memory {
+
+// Returns the number of common elements of two sorted arrays without
+// duplicates.
+//
+// With SSE2, blocks of 4 elements of both arrays are compared all-to-all with
+// 4 vector comparisons, and the block with the smaller maximum is advanced.
+// The remaining elements are merged one by one.
+inline std::size_t SortedIntersectionSize(absl::Span<const uint32_t> a,
+                                          absl::Span<const uint32_t> b) {
+  std::size_t i = 0;
+  std::size_t j = 0;
+  std::size_t count = 0;
+#if defined(__SSE2__)
+  while (i + 4 <= a.size() && j + 4 <= b.size()) {
+    const __m128i a_block =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(a.data() + i));
+    const __m128i b_block =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(b.data() + j));
+    // Compares every element of a_block with every rotation of b_block.
+    __m128i matches = _mm_cmpeq_epi32(a_block, b_block);
+    matches = _mm_or_si128(
+        matches, _mm_cmpeq_epi32(a_block, _mm_shuffle_epi32(
+                                              b_block, _MM_SHUFFLE(0, 3, 2, 1))));
+    matches = _mm_or_si128(
+        matches, _mm_cmpeq_epi32(a_block, _mm_shuffle_epi32(
+                                              b_block, _MM_SHUFFLE(1, 0, 3, 2))));
+    matches = _mm_or_si128(
+        matches, _mm_cmpeq_epi32(a_block, _mm_shuffle_epi32(
+                                              b_block, _MM_SHUFFLE(2, 1, 0, 3))));
+    count += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(matches)));
+    const uint32_t a_max = a[i + 3];
+    const uint32_t b_max = b[j + 3];
+    if (a_max <= b_max) i += 4;
+    if (b_max <= a_max) j += 4;
+  }
+#endif
+  while (i < a.size() && j < b.size()) {
+    if (a[i] < b[j]) {
+      ++i;
+    } else if (b[j] < a[i]) {
+      ++j;
+    } else {
+      ++count;
+      ++i;
+      ++j;
+    }
+  }
+  return count;
+}
+
+}  // namespace graph_mining::in_memory
+
+#endif  // THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CLUSTERING_SORTED_INTERSECTION_H_
@@ -0,0 +1,84 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/clustering/sorted_intersection.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace graph_mining::in_memory {
+namespace {
+
+std::size_t ScalarIntersectionSize(const std::vector<uint32_t>& a,
+                                   const std::vector<uint32_t>& b) {
+  std::vector<uint32_t> intersection;
+  std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                        std::back_inserter(intersection));
+  return intersection.size();
+}
+
+// Returns `size` distinct sorted values in [0, max_value).
+std::vector<uint32_t> RandomSortedSet(std::size_t size, uint32_t max_value,
+                                      std::mt19937& rng) {
+  std::vector<uint32_t> values(max_value);
+  for (uint32_t i = 0; i < max_value; ++i) values[i] = i;
+  std::shuffle(values.begin(), values.end(), rng);
+  values.resize(size);
+  std::sort(values.begin(), values.end());
+  return values;
+}
+
+TEST(SortedIntersectionSizeTest, EmptyInputs) {
+  const std::vector<uint32_t> empty;
+  const std::vector<uint32_t> values = {1, 2, 3, 4, 5};
+  EXPECT_EQ(SortedIntersectionSize(empty, empty), 0);
+  EXPECT_EQ(SortedIntersectionSize(empty, values), 0);
+  EXPECT_EQ(SortedIntersectionSize(values, empty), 0);
+}
+
+TEST(SortedIntersectionSizeTest, MatchesInTails) {
+  // The common elements follow the first full blocks of 4 elements.
+  const std::vector<uint32_t> a = {0, 2, 4, 6, 8, 10, 11};
+  const std::vector<uint32_t> b = {1, 3, 5, 7, 10, 11};
+  EXPECT_EQ(SortedIntersectionSize(a, b), 2);
+  EXPECT_EQ(SortedIntersectionSize(b, a), 2);
+}
+
+TEST(SortedIntersectionSizeTest, IdenticalInputs) {
+  const std::vector<uint32_t> values = {3, 5, 8, 13, 21, 34, 55, 89, 144};
+  EXPECT_EQ(SortedIntersectionSize(values, values), values.size());
+}
+
+TEST(SortedIntersectionSizeTest, MatchesScalarIntersection) {
+  std::mt19937 rng(42);
+  for (std::size_t a_size = 0; a_size <= 20; ++a_size) {
+    for (std::size_t b_size = 0; b_size <= 20; ++b_size) {
+      for (uint32_t max_value : {24u, 64u}) {
+        const std::vector<uint32_t> a = RandomSortedSet(a_size, max_value, rng);
+        const std::vector<uint32_t> b = RandomSortedSet(b_size, max_value, rng);
+        EXPECT_EQ(SortedIntersectionSize(a, b), ScalarIntersectionSize(a, b))
+            << "sizes " << a_size << " and " << b_size;
+      }
+    }
+  }
+}
+
+}  // namespace
+}  // namespace graph_mining::in_memory
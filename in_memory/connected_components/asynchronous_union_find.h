@@ -53,8 +53,8 @@ namespace graph_mining::in_memory {
 // case, for maximum performance one should ensure that the Parlay scheduler
 // has been initialized.
 //
-// Both Unite and Find are thread-safe and can be called concurrently with each
-// other. Any other function cannot be called concurrently with any other
+// Unite, Find and IsRoot are thread-safe and can be called concurrently with
+// each other. Any other function cannot be called concurrently with any other
 // function; e.g., ComponentIds() should not be used in parallel with calling
 // any other function.
 template <class IntT, class ParentArray = parlay::sequence<IntT>>
@@ -92,6 +92,12 @@ class AsynchronousUnionFind {
                                                          parents_.data());
   }
 
+  // Returns true if node_u is currently the root of its tree. This function is
+  // thread-safe. Once a node is not a root, it never becomes a root again.
+  bool IsRoot(IntT node_u) const {
+    return __atomic_load_n(&parents_[node_u], __ATOMIC_ACQUIRE) == node_u;
+  }
+
   // Calls find() for every node to compress the parents sequence, and returns
   // a ParentArray (without a copy); this object is no longer usable after
   // calling ComponentSequence().
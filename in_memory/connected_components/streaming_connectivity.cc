@@ -0,0 +1,100 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/connected_components/streaming_connectivity.h"
+
+#include <cstddef>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "gbbs/macros.h"
+#include "parlay/parallel.h"
+#include "parlay/primitives.h"
+#include "parlay/sequence.h"
+
+namespace graph_mining::in_memory {
+
+absl::Status StreamingConnectivity::AddEdges(absl::Span<const Edge> edges) {
+  const gbbs::uintE num_nodes = NumNodes();
+  const std::size_t num_invalid_edges =
+      parlay::count_if(edges, [&](const Edge& edge) {
+        return edge.first >= num_nodes || edge.second >= num_nodes;
+      });
+  if (num_invalid_edges > 0) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        num_invalid_edges, " edges have endpoints outside of [0, ",
+        num_nodes, ")"));
+  }
+  absl::ReaderMutexLock lock(&add_edges_mutex_);
+  parlay::parallel_for(0, edges.size(), [&](std::size_t i) {
+    union_find_.Unite(edges[i].first, edges[i].second);
+  });
+  return absl::OkStatus();
+}
+
+bool StreamingConnectivity::SameComponent(gbbs::uintE node_u,
+                                          gbbs::uintE node_v) {
+  // If the roots differ and root_u is still a root afterwards, the nodes were
+  // in different components when root_v was found.
+  while (true) {
+    const gbbs::uintE root_u = union_find_.Find(node_u);
+    const gbbs::uintE root_v = union_find_.Find(node_v);
+    if (root_u == root_v) return true;
+    if (union_find_.IsRoot(root_u)) return false;
+  }
+}
+
+std::size_t StreamingConnectivity::UpdateStaleRoots(
+    parlay::sequence<gbbs::uintE>& roots) {
+  auto is_stale = parlay::sequence<bool>::from_function(
+      roots.size(),
+      [&](std::size_t i) { return !union_find_.IsRoot(roots[i]); });
+  auto stale_nodes = parlay::pack_index<gbbs::uintE>(is_stale);
+  parlay::parallel_for(0, stale_nodes.size(), [&](std::size_t i) {
+    roots[stale_nodes[i]] = union_find_.Find(roots[stale_nodes[i]]);
+  });
+  return stale_nodes.size();
+}
+
+ComponentSnapshot StreamingConnectivity::Snapshot() {
+  const std::size_t num_nodes = NumNodes();
+  auto roots = parlay::sequence<gbbs::uintE>::from_function(
+      num_nodes, [&](std::size_t i) { return union_find_.Find(i); });
+  // Two nodes connected before the snapshot may have been given different
+  // roots if their component was merged while the roots were found. The
+  // earlier of these roots is then no longer a root, which the check below
+  // detects, as all checks happen after all roots were found. Such nodes are
+  // assigned their current root and all roots are checked again.
+  for (int pass = 1; UpdateStaleRoots(roots) > 0; ++pass) {
+    if (pass == kMaxSnapshotPasses) {
+      // Without concurrent merges, the roots found by one more pass are final.
+      absl::WriterMutexLock lock(&add_edges_mutex_);
+      UpdateStaleRoots(roots);
+      break;
+    }
+  }
+
+  // Every root is its own root, so the roots are numbered consecutively.
+  ComponentSnapshot snapshot;
+  auto root_ids = parlay::sequence<gbbs::uintE>::from_function(
+      num_nodes, [&](std::size_t i) -> gbbs::uintE { return roots[i] == i; });
+  snapshot.num_components = parlay::scan_inplace(root_ids);
+  snapshot.component_ids = parlay::sequence<gbbs::uintE>::from_function(
+      num_nodes, [&](std::size_t i) { return root_ids[roots[i]]; });
+  return snapshot;
+}
+
+}  // namespace graph_mining::in_memory
@@ -0,0 +1,90 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CONNECTED_COMPONENTS_STREAMING_CONNECTIVITY_H_
+#define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CONNECTED_COMPONENTS_STREAMING_CONNECTIVITY_H_
+
+#include <cstddef>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "gbbs/macros.h"
+#include "in_memory/connected_components/asynchronous_union_find.h"
+#include "parlay/sequence.h"
+
+namespace graph_mining::in_memory {
+
+// Compact component ids of all nodes at some point in time.
+struct ComponentSnapshot {
+  // Component id of each node, between 0 and num_components - 1. Components
+  // are numbered in the order of their minimum node id.
+  parlay::sequence<gbbs::uintE> component_ids;
+  std::size_t num_components = 0;
+};
+
+// Incremental connectivity over a fixed set of nodes 0, ..., num_nodes - 1,
+// on top of AsynchronousUnionFind. Edges can be added at any time, and all
+// functions are thread-safe and may be called concurrently with each other.
+// Queries never stop the ingestion of edges, and snapshots only do so if
+// concurrent merges keep interfering with them, see Snapshot.
+class StreamingConnectivity {
+ public:
+  using Edge = std::pair<gbbs::uintE, gbbs::uintE>;
+
+  explicit StreamingConnectivity(gbbs::uintE num_nodes)
+      : union_find_(num_nodes) {}
+
+  gbbs::uintE NumNodes() const { return union_find_.NumberOfNodes(); }
+
+  // Links the endpoints of the edges in parallel. Returns an error without
+  // adding any edge if an endpoint is not a valid node id.
+  absl::Status AddEdges(absl::Span<const Edge> edges);
+
+  // Returns the representative of the component of the node. Representatives
+  // change as components are merged, so only compare representatives obtained
+  // without concurrent AddEdges calls; use SameComponent otherwise. The node
+  // must be valid.
+  gbbs::uintE Find(gbbs::uintE node) { return union_find_.Find(node); }
+
+  // Returns true if the nodes are in the same component. Linearizable with
+  // respect to concurrent AddEdges calls. The nodes must be valid.
+  bool SameComponent(gbbs::uintE node_u, gbbs::uintE node_v);
+
+  // Returns the components of all nodes. Every edge added before the call
+  // started is reflected in the snapshot, while edges added concurrently may
+  // be reflected or not. Costs O(num_nodes) work per pass, with an additional
+  // pass for each batch of concurrent merges that interferes with the
+  // snapshot. After kMaxSnapshotPasses passes, AddEdges calls are blocked
+  // until the in-flight ones have finished and the snapshot is complete, so
+  // that a steady stream of merges cannot delay it indefinitely.
+  ComponentSnapshot Snapshot();
+
+  static constexpr int kMaxSnapshotPasses = 4;
+
+ private:
+  // Replaces every root in `roots` that is no longer a root by its current
+  // root. Returns the number of replaced roots.
+  std::size_t UpdateStaleRoots(parlay::sequence<gbbs::uintE>& roots);
+
+  AsynchronousUnionFind<gbbs::uintE> union_find_;
+  // Held in shared mode by AddEdges and in exclusive mode by a Snapshot that
+  // exceeded kMaxSnapshotPasses.
+  absl::Mutex add_edges_mutex_;
+};
+
+}  // namespace graph_mining::in_memory
+
+#endif  // THIRD_PARTY_GRAPH_MINING_IN_MEMORY_CONNECTED_COMPONENTS_STREAMING_CONNECTIVITY_H_
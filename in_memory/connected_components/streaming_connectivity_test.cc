@@ -0,0 +1,88 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/connected_components/streaming_connectivity.h"
+
+#include <cstddef>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "in_memory/parallel/scheduler_test_util.h"
+#include "in_memory/status_macros.h"  // IWYU pragma: keep
+#include "parlay/parallel.h"
+
+namespace graph_mining::in_memory {
+namespace {
+
+using ::testing::ElementsAre;
+using Edge = StreamingConnectivity::Edge;
+
+class StreamingConnectivityTest : public ParallelSchedulerReferenceTest {};
+
+TEST_F(StreamingConnectivityTest, SnapshotNumbersComponentsByMinimumNode) {
+  StreamingConnectivity connectivity(5);
+  ASSERT_OK(connectivity.AddEdges({{3, 1}, {4, 2}}));
+  const ComponentSnapshot snapshot = connectivity.Snapshot();
+  EXPECT_EQ(snapshot.num_components, 3);
+  EXPECT_THAT(snapshot.component_ids, ElementsAre(0, 1, 2, 1, 2));
+  EXPECT_TRUE(connectivity.SameComponent(1, 3));
+  EXPECT_FALSE(connectivity.SameComponent(0, 1));
+}
+
+TEST_F(StreamingConnectivityTest, InvalidEdgeIsAnError) {
+  StreamingConnectivity connectivity(2);
+  EXPECT_EQ(connectivity.AddEdges({{0, 1}, {1, 2}}).code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_FALSE(connectivity.SameComponent(0, 1));
+}
+
+TEST_F(StreamingConnectivityTest, SnapshotsDuringConcurrentUnites) {
+  // Even nodes are linked into one path and odd nodes into another, one edge
+  // per batch, while snapshots are taken concurrently.
+  constexpr int kNumNodes = 1000;
+  StreamingConnectivity connectivity(kNumNodes);
+  std::vector<ComponentSnapshot> snapshots(20);
+  parlay::par_do(
+      [&] {
+        for (int i = 0; i + 2 < kNumNodes; ++i) {
+          const Edge edge(i, i + 2);
+          ASSERT_OK(connectivity.AddEdges({&edge, 1}));
+        }
+      },
+      [&] {
+        for (auto& snapshot : snapshots) snapshot = connectivity.Snapshot();
+      });
+
+  for (const ComponentSnapshot& snapshot : snapshots) {
+    ASSERT_EQ(snapshot.component_ids.size(), kNumNodes);
+    EXPECT_GE(snapshot.num_components, 2);
+    // The first two nodes are the minimum nodes of their components, and
+    // nodes of different parities are never in the same component.
+    EXPECT_EQ(snapshot.component_ids[0], 0);
+    EXPECT_EQ(snapshot.component_ids[1], 1);
+    for (std::size_t i = 0; i < kNumNodes; ++i) {
+      EXPECT_NE(snapshot.component_ids[i], 1 - i % 2) << "node " << i;
+    }
+  }
+  const ComponentSnapshot final_snapshot = connectivity.Snapshot();
+  EXPECT_EQ(final_snapshot.num_components, 2);
+  for (std::size_t i = 0; i < kNumNodes; ++i) {
+    EXPECT_EQ(final_snapshot.component_ids[i], i % 2);
+  }
+}
+
+}  // namespace
+}  // namespace graph_mining::in_memory
@@ -14,26 +14,39 @@
 
 #include "in_memory/generation/add_edge_weights.h"
 
+#include <cstddef>
+#include <cstdint>
+
 #include "absl/random/distributions.h"
 #include "absl/random/random.h"
 #include "absl/status/status.h"
 #include "in_memory/clustering/graph.h"
-#include "in_memory/status_macros.h"
+#include "in_memory/generation/generator_utils.h"
+#include "parlay/parallel.h"
+#include "utils/status/thread_safe_status.h"
 
 namespace graph_mining::in_memory {
 
 absl::Status AddUniformWeights(SimpleUndirectedGraph& graph, double low,
                                double high) {
   absl::BitGen gen;
-  for (size_t i = 0; i < graph.NumNodes(); ++i) {
+  return AddUniformWeights(graph, low, high, absl::Uniform<uint64_t>(gen));
+}
+
+absl::Status AddUniformWeights(SimpleUndirectedGraph& graph, double low,
+                               double high, uint64_t seed) {
+  ThreadSafeStatus status;
+  parlay::parallel_for(0, graph.NumNodes(), [&](std::size_t i) {
     for (const auto& [neighbor_id, weight] : graph.Neighbors(i)) {
-      if (i < neighbor_id) {
-        RETURN_IF_ERROR(
-            graph.SetEdgeWeight(i, neighbor_id, absl::Uniform(gen, low, high)));
-      }
+      // Only sets the weight of the edge from i, since the weight of the edge
+      // from neighbor_id is set when processing neighbor_id. The entry already
+      // exists, so the adjacency list of i is not rehashed while iterating.
+      status.Update(graph.SimpleDirectedGraph::SetEdgeWeight(
+          i, neighbor_id,
+          UniformEdgeWeight(seed, i, neighbor_id, low, high)));
     }
-  }
-  return absl::OkStatus();
+  });
+  return status.status();
 }
 
 }  // namespace graph_mining::in_memory
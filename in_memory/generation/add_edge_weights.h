@@ -15,6 +15,9 @@
 #ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_GENERATION_ADD_EDGE_WEIGHTS_H_
 #define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_GENERATION_ADD_EDGE_WEIGHTS_H_
 
+#include <cstdint>
+
+#include "absl/status/status.h"
 #include "in_memory/clustering/graph.h"
 
 namespace graph_mining::in_memory {
@@ -24,6 +27,13 @@ namespace graph_mining::in_memory {
 absl::Status AddUniformWeights(SimpleUndirectedGraph& graph, double low,
                                double high);
 
+// Same as above, but deterministic given seed: edge {u, v} gets the weight
+// UniformEdgeWeight(seed, u, v, low, high) (see generator_utils.h). The nodes
+// are processed in parallel; each node only updates its own adjacency list,
+// which is safe because the weight does not depend on the edge direction.
+absl::Status AddUniformWeights(SimpleUndirectedGraph& graph, double low,
+                               double high, uint64_t seed);
+
 }  // namespace graph_mining::in_memory
 
 #endif  // THIRD_PARTY_GRAPH_MINING_IN_MEMORY_GENERATION_ADD_EDGE_WEIGHTS_H_
@@ -22,8 +22,14 @@
 #include "absl/log/absl_check.h"
 #include "absl/random/distributions.h"
 #include "absl/random/random.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "in_memory/clustering/graph.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/clustering/types.h"
+#include "in_memory/generation/generator_utils.h"
 #include "in_memory/status_macros.h"
+#include "parlay/sequence.h"
 
 namespace graph_mining::in_memory {
 
@@ -82,4 +88,30 @@ absl::StatusOr<std::unique_ptr<SimpleUndirectedGraph>> UnweightedBarabasiAlbert(
   return result;
 }
 
+absl::Status ParallelBarabasiAlbert(NodeId num_nodes, int edges_per_node,
+                                    const GeneratorOptions& options,
+                                    InMemoryClusterer::Graph& graph) {
+  if (num_nodes < 0 || edges_per_node < 1) {
+    return absl::InvalidArgumentError(
+        "num_nodes must be non-negative and edges_per_node must be positive");
+  }
+  const uint64_t num_edges = static_cast<uint64_t>(num_nodes) * edges_per_node;
+  auto edge_keys =
+      parlay::sequence<uint64_t>::from_function(num_edges, [&](uint64_t edge) {
+        // Resolve the target of edge by following copied target entries until
+        // a source entry (with an even index) is reached.
+        uint64_t entry;
+        uint64_t copying_edge = edge;
+        while (true) {
+          entry = RandomBelow(options.seed, copying_edge, 2 * copying_edge + 1);
+          if (entry % 2 == 0) break;
+          copying_edge = entry / 2;
+        }
+        return internal::EdgeKey(edge / edges_per_node,
+                                 entry / 2 / edges_per_node);
+      });
+  internal::SortUniqueEdgeKeys(edge_keys);
+  return internal::ImportSortedEdgeKeys(edge_keys, num_nodes, options, graph);
+}
+
 }  // namespace graph_mining::in_memory
@@ -15,7 +15,15 @@
 #ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_GENERATION_BARABASI_ALBERT_H_
 #define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_GENERATION_BARABASI_ALBERT_H_
 
+#include <cstddef>
+#include <memory>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "in_memory/clustering/graph.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/clustering/types.h"
+#include "in_memory/generation/generator_utils.h"
 
 namespace graph_mining::in_memory {
 
@@ -38,6 +46,24 @@ namespace graph_mining::in_memory {
 absl::StatusOr<std::unique_ptr<SimpleUndirectedGraph>> UnweightedBarabasiAlbert(
     size_t num_nodes, size_t num_initial_nodes, size_t edges_per_node);
 
+// Imports a preferential attachment graph into graph, which must be empty (see
+// ImportUndirectedEdges). Unlike UnweightedBarabasiAlbert, all edges are
+// sampled in parallel, using the edge-copy formulation of the model (Batagelj
+// and Brandes, Phys. Rev. E'05; Sanders and Schulz, arXiv:1602.07106): node i
+// adds edges_per_node edges, and edge e = i * edges_per_node + j is represented
+// by the two entries 2e (its source i) and 2e + 1 of a virtual array. The
+// target of edge e copies an entry chosen uniformly at random among the entries
+// 0, ..., 2e, which selects a node with probability proportional to its current
+// degree. Since the random choice of every entry is a fixed function of its
+// index, each target is resolved independently by following the chain of copied
+// entries, which has expected constant length.
+//
+// Self-loops and multi-edges of the model are dropped, so nodes may have fewer
+// than edges_per_node edges to older nodes. Requires edges_per_node >= 1.
+absl::Status ParallelBarabasiAlbert(NodeId num_nodes, int edges_per_node,
+                                    const GeneratorOptions& options,
+                                    InMemoryClusterer::Graph& graph);
+
 }  // namespace graph_mining::in_memory
 
 #endif  // THIRD_PARTY_GRAPH_MINING_IN_MEMORY_GENERATION_BARABASI_ALBERT_H_
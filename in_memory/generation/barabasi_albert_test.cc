@@ -0,0 +1,68 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/generation/barabasi_albert.h"
+
+#include <vector>
+
+#include "absl/status/status.h"
+#include "gtest/gtest.h"
+#include "in_memory/clustering/graph.h"
+#include "in_memory/clustering/types.h"
+#include "in_memory/generation/generation_test_util.h"
+#include "in_memory/generation/generator_utils.h"
+#include "in_memory/status_macros.h"  // IWYU pragma: keep
+
+namespace graph_mining::in_memory {
+namespace {
+
+TEST(ParallelBarabasiAlbertTest, NodesLinkToAtMostEdgesPerNodeOlderNodes) {
+  constexpr int kEdgesPerNode = 3;
+  SimpleUndirectedGraph graph;
+  ASSERT_OK(
+      ParallelBarabasiAlbert(500, kEdgesPerNode, GeneratorOptions(), graph));
+  EXPECT_EQ(graph.NumNodes(), 500);
+  std::vector<int> num_older_neighbors(500, 0);
+  for (const auto& [u, v] : SortedEdges(graph)) ++num_older_neighbors[v];
+  for (NodeId u = 0; u < 500; ++u) {
+    EXPECT_LE(num_older_neighbors[u], kEdgesPerNode) << "node " << u;
+    EXPECT_FALSE(graph.EdgeWeight(u, u).has_value());
+  }
+  // Preferential attachment makes the oldest nodes the hubs.
+  EXPECT_GT(graph.Neighbors(0).size(), 3 * kEdgesPerNode);
+}
+
+TEST(ParallelBarabasiAlbertTest, IsDeterministicGivenSeed) {
+  GeneratorOptions options;
+  options.seed = 9;
+  SimpleUndirectedGraph graph_a;
+  ASSERT_OK(ParallelBarabasiAlbert(300, 2, options, graph_a));
+  for (const int num_workers : {1, 2, 4}) {
+    SimpleUndirectedGraph graph_b;
+    RunWithNumWorkers(num_workers, [&] {
+      ASSERT_OK(ParallelBarabasiAlbert(300, 2, options, graph_b));
+    });
+    EXPECT_EQ(SortedEdges(graph_a), SortedEdges(graph_b))
+        << num_workers << " workers";
+  }
+}
+
+TEST(ParallelBarabasiAlbertTest, NonPositiveEdgesPerNodeIsAnError) {
+  SimpleUndirectedGraph graph;
+  EXPECT_EQ(ParallelBarabasiAlbert(10, 0, GeneratorOptions(), graph).code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+}  // namespace
+}  // namespace graph_mining::in_memory
@@ -15,14 +15,23 @@
 #include "in_memory/generation/erdos_renyi.h"
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <utility>
 
 #include "absl/log/absl_check.h"
 #include "absl/random/distributions.h"
 #include "absl/random/random.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "in_memory/clustering/graph.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/clustering/types.h"
+#include "in_memory/generation/generator_utils.h"
 #include "in_memory/status_macros.h"
+#include "parlay/primitives.h"
+#include "parlay/sequence.h"
 
 namespace graph_mining::in_memory {
 
@@ -46,4 +55,62 @@ absl::StatusOr<std::unique_ptr<SimpleUndirectedGraph>> UnweightedErdosRenyi(
   return result;
 }
 
+absl::Status ErdosRenyiGnm(NodeId num_nodes, int64_t num_edges,
+                           const GeneratorOptions& options,
+                           InMemoryClusterer::Graph& graph) {
+  if (num_nodes < 0 || num_edges < 0) {
+    return absl::InvalidArgumentError(
+        "num_nodes and num_edges must be non-negative");
+  }
+  const unsigned __int128 max_num_edges =
+      num_nodes == 0 ? 0
+                     : static_cast<unsigned __int128>(num_nodes) *
+                           (num_nodes - 1) / 2;
+  if (num_edges > max_num_edges) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("A simple graph with ", num_nodes,
+                     " nodes has fewer than ", num_edges, " edges"));
+  }
+
+  const std::size_t num_target_edges = num_edges;
+  parlay::sequence<uint64_t> edge_keys;
+  // Number of candidate edges sampled so far. Candidate i uses the random
+  // numbers with indices 2 * i and 2 * i + 1.
+  uint64_t num_candidates = 0;
+  while (edge_keys.size() < num_target_edges) {
+    const uint64_t num_missing = num_target_edges - edge_keys.size();
+    // Slightly oversample so that a single round usually suffices.
+    const uint64_t num_new_candidates = num_missing + num_missing / 16 + 16;
+    auto candidates = parlay::sequence<uint64_t>::from_function(
+        num_new_candidates, [&](std::size_t i) {
+          const uint64_t index = 2 * (num_candidates + i);
+          const NodeId u = RandomBelow(options.seed, index, num_nodes);
+          NodeId v = RandomBelow(options.seed, index + 1, num_nodes - 1);
+          if (v >= u) ++v;
+          return internal::EdgeKey(u, v);
+        });
+    num_candidates += num_new_candidates;
+    candidates.append(edge_keys);
+    internal::SortUniqueEdgeKeys(candidates);
+    edge_keys = std::move(candidates);
+  }
+
+  if (edge_keys.size() > num_target_edges) {
+    // Keep the num_target_edges edges of smallest random priority. Priorities
+    // of distinct edges are distinct because RandomBits is a bijection of the
+    // index for a fixed seed.
+    const uint64_t priority_seed = ~options.seed;
+    auto priorities = parlay::map(edge_keys, [&](uint64_t key) {
+      return RandomBits(priority_seed, key);
+    });
+    parlay::integer_sort_inplace(priorities,
+                                 [](uint64_t priority) { return priority; });
+    const uint64_t max_priority = priorities[num_target_edges - 1];
+    edge_keys = parlay::filter(edge_keys, [&](uint64_t key) {
+      return RandomBits(priority_seed, key) <= max_priority;
+    });
+  }
+  return internal::ImportSortedEdgeKeys(edge_keys, num_nodes, options, graph);
+}
+
 }  // namespace graph_mining::in_memory
@@ -15,20 +15,39 @@
 #ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_GENERATION_ERDOS_RENYI_H_
 #define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_GENERATION_ERDOS_RENYI_H_
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "in_memory/clustering/graph.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/clustering/types.h"
+#include "in_memory/generation/generator_utils.h"
 
 namespace graph_mining::in_memory {
 
 // Construct a G(n,p) graph for n >=1 and 0 <= p <= 1 (see:
 // https://en.wikipedia.org/wiki/Erd%C5%91s%E2%80%93R%C3%A9nyi_model) with given
 // values of n and p. Note that this method spends O(n^2) time to consider each
-// possible edge.
-// TODO: For larger graphs, the (sparse) G(n,M) model would be more
-// appropriate, but is not yet implemented. If higher performance is necessary
-// for implementing G(n,p), this piece of code is useful:
+// possible edge. For larger graphs, use ErdosRenyiGnm below.
 absl::StatusOr<std::unique_ptr<SimpleUndirectedGraph>> UnweightedErdosRenyi(
     size_t n, double p);
 
+// Imports a G(n,M) graph, i.e., a graph chosen uniformly at random among all
+// simple undirected graphs with num_nodes nodes and exactly num_edges edges,
+// into graph, which must be empty (see ImportUndirectedEdges). Requires
+// num_edges <= num_nodes * (num_nodes - 1) / 2.
+//
+// Candidate edges are sampled in parallel with replacement and deduplicated by
+// sorting; the missing edges are resampled until num_edges distinct edges are
+// found and surplus edges are dropped uniformly at random. The expected work is
+// O(num_edges) as long as the graph is not close to complete.
+absl::Status ErdosRenyiGnm(NodeId num_nodes, int64_t num_edges,
+                           const GeneratorOptions& options,
+                           InMemoryClusterer::Graph& graph);
+
 }  // namespace graph_mining::in_memory
 
 #endif  // THIRD_PARTY_GRAPH_MINING_IN_MEMORY_GENERATION_ERDOS_RENYI_H_
@@ -0,0 +1,71 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/generation/erdos_renyi.h"
+
+#include "absl/status/status.h"
+#include "gtest/gtest.h"
+#include "in_memory/clustering/graph.h"
+#include "in_memory/clustering/types.h"
+#include "in_memory/generation/generation_test_util.h"
+#include "in_memory/generation/generator_utils.h"
+#include "in_memory/status_macros.h"  // IWYU pragma: keep
+
+namespace graph_mining::in_memory {
+namespace {
+
+TEST(ErdosRenyiGnmTest, HasExactlyNumEdgesSimpleEdges) {
+  SimpleUndirectedGraph graph;
+  ASSERT_OK(ErdosRenyiGnm(100, 500, GeneratorOptions(), graph));
+  EXPECT_EQ(graph.NumNodes(), 100);
+  EXPECT_EQ(SortedEdges(graph).size(), 500);
+  EXPECT_EQ(graph.NumDirectedEdges(), 1000);
+  for (NodeId u = 0; u < graph.NumNodes(); ++u) {
+    EXPECT_FALSE(graph.EdgeWeight(u, u).has_value());
+  }
+}
+
+TEST(ErdosRenyiGnmTest, CompleteGraph) {
+  SimpleUndirectedGraph graph;
+  ASSERT_OK(ErdosRenyiGnm(10, 45, GeneratorOptions(), graph));
+  EXPECT_EQ(SortedEdges(graph).size(), 45);
+}
+
+TEST(ErdosRenyiGnmTest, IsDeterministicGivenSeed) {
+  GeneratorOptions options;
+  options.seed = 12;
+  SimpleUndirectedGraph graph_a;
+  ASSERT_OK(ErdosRenyiGnm(200, 1000, options, graph_a));
+  for (const int num_workers : {1, 2, 4}) {
+    SimpleUndirectedGraph graph_b;
+    RunWithNumWorkers(num_workers, [&] {
+      ASSERT_OK(ErdosRenyiGnm(200, 1000, options, graph_b));
+    });
+    EXPECT_EQ(SortedEdges(graph_a), SortedEdges(graph_b))
+        << num_workers << " workers";
+  }
+  SimpleUndirectedGraph graph_c;
+  options.seed = 13;
+  ASSERT_OK(ErdosRenyiGnm(200, 1000, options, graph_c));
+  EXPECT_NE(SortedEdges(graph_a), SortedEdges(graph_c));
+}
+
+TEST(ErdosRenyiGnmTest, TooManyEdgesIsAnError) {
+  SimpleUndirectedGraph graph;
+  EXPECT_EQ(ErdosRenyiGnm(10, 46, GeneratorOptions(), graph).code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+}  // namespace
+}  // namespace graph_mining::in_memory
@@ -0,0 +1,57 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/generation/generation_test_util.h"
+
+#include <algorithm>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "absl/functional/function_ref.h"
+#include "in_memory/clustering/graph.h"
+#include "in_memory/clustering/types.h"
+#include "parlay/parallel.h"
+
+namespace graph_mining::in_memory {
+
+std::vector<std::pair<NodeId, NodeId>> SortedEdges(
+    const SimpleUndirectedGraph& graph) {
+  std::vector<std::pair<NodeId, NodeId>> edges;
+  for (NodeId u = 0; u < graph.NumNodes(); ++u) {
+    for (const auto& [v, weight] : graph.Neighbors(u)) {
+      if (u < v) edges.emplace_back(u, v);
+    }
+  }
+  std::sort(edges.begin(), edges.end());
+  return edges;
+}
+
+std::vector<std::tuple<NodeId, NodeId, double>> SortedWeightedEdges(
+    const SimpleUndirectedGraph& graph) {
+  std::vector<std::tuple<NodeId, NodeId, double>> edges;
+  for (NodeId u = 0; u < graph.NumNodes(); ++u) {
+    for (const auto& [v, weight] : graph.Neighbors(u)) {
+      if (u < v) edges.emplace_back(u, v, weight);
+    }
+  }
+  std::sort(edges.begin(), edges.end());
+  return edges;
+}
+
+void RunWithNumWorkers(int num_workers, absl::FunctionRef<void()> f) {
+  parlay::execute_with_scheduler(num_workers, [&] { f(); });
+}
+
+}  // namespace graph_mining::in_memory
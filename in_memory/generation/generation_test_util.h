@@ -0,0 +1,44 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Helpers shared by the tests of the graph generators.
+
+#ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_GENERATION_GENERATION_TEST_UTIL_H_
+#define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_GENERATION_GENERATION_TEST_UTIL_H_
+
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "absl/functional/function_ref.h"
+#include "in_memory/clustering/graph.h"
+#include "in_memory/clustering/types.h"
+
+namespace graph_mining::in_memory {
+
+// Returns the edges {u, v} with u < v of the graph, sorted.
+std::vector<std::pair<NodeId, NodeId>> SortedEdges(
+    const SimpleUndirectedGraph& graph);
+
+// Returns the edges (u, v, weight) with u < v of the graph, sorted.
+std::vector<std::tuple<NodeId, NodeId, double>> SortedWeightedEdges(
+    const SimpleUndirectedGraph& graph);
+
+// Runs f on a parlay scheduler with the given number of worker threads, so
+// that tests can check that a generator does not depend on the scheduling.
+void RunWithNumWorkers(int num_workers, absl::FunctionRef<void()> f);
+
+}  // namespace graph_mining::in_memory
+
+#endif  // THIRD_PARTY_GRAPH_MINING_IN_MEMORY_GENERATION_GENERATION_TEST_UTIL_H_
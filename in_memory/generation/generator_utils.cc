@@ -0,0 +1,211 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/generation/generator_utils.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/clustering/types.h"
+#include "in_memory/status_macros.h"
+#include "parlay/parallel.h"
+#include "parlay/primitives.h"
+#include "parlay/sequence.h"
+#include "utils/status/thread_safe_status.h"
+
+namespace graph_mining::in_memory {
+namespace {
+
+constexpr uint64_t kLowerBits = (uint64_t{1} << 32) - 1;
+
+// Node ids are stored in the 32-bit halves of the edge keys, so the number of
+// nodes is bounded by the largest NodeId and by 2^32 - 1, whichever is smaller.
+constexpr uint64_t kMaxNumNodes = std::min<uint64_t>(
+    std::numeric_limits<NodeId>::max(), kLowerBits);
+
+absl::Status CheckNumNodes(NodeId num_nodes) {
+  if (num_nodes < 0 || static_cast<uint64_t>(num_nodes) > kMaxNumNodes) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "num_nodes must be in [0, ", kMaxNumNodes, "], got ", num_nodes));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::Status ImportUndirectedEdges(
+    const parlay::sequence<std::pair<NodeId, NodeId>>& edges,
+    NodeId num_nodes, const GeneratorOptions& options,
+    InMemoryClusterer::Graph& graph) {
+  RETURN_IF_ERROR(CheckNumNodes(num_nodes));
+  const std::size_t num_invalid_edges =
+      parlay::count_if(edges, [&](const std::pair<NodeId, NodeId>& edge) {
+        return edge.first < 0 || edge.first >= num_nodes || edge.second < 0 ||
+               edge.second >= num_nodes;
+      });
+  if (num_invalid_edges > 0) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        num_invalid_edges, " edges have endpoints outside of [0, ", num_nodes,
+        ")"));
+  }
+  auto edge_keys =
+      parlay::map(edges, [](const std::pair<NodeId, NodeId>& edge) {
+        return internal::EdgeKey(edge.first, edge.second);
+      });
+  internal::SortUniqueEdgeKeys(edge_keys);
+  return internal::ImportSortedEdgeKeys(edge_keys, num_nodes, options, graph);
+}
+
+namespace internal {
+
+void SortUniqueEdgeKeys(parlay::sequence<uint64_t>& edge_keys) {
+  edge_keys = parlay::filter(edge_keys, [](uint64_t key) {
+    return (key >> 32) != (key & kLowerBits);
+  });
+  parlay::integer_sort_inplace(edge_keys, [](uint64_t key) { return key; });
+  edge_keys = parlay::unique(edge_keys);
+}
+
+absl::Status ImportSortedEdgeKeys(
+    const parlay::sequence<uint64_t>& edge_keys, NodeId num_nodes,
+    const GeneratorOptions& options, InMemoryClusterer::Graph& graph) {
+  if (options.min_weight == options.max_weight) {
+    return ImportSortedEdgeKeys(
+        edge_keys, num_nodes,
+        [&](NodeId, NodeId) { return options.min_weight; }, graph);
+  }
+  return ImportSortedEdgeKeys(
+      edge_keys, num_nodes,
+      [&](NodeId u, NodeId v) {
+        return UniformEdgeWeight(options.seed, u, v, options.min_weight,
+                                 options.max_weight);
+      },
+      graph);
+}
+
+absl::Status ImportSortedEdgeKeys(
+    const parlay::sequence<uint64_t>& edge_keys, NodeId num_nodes,
+    absl::FunctionRef<double(NodeId, NodeId)> edge_weight,
+    InMemoryClusterer::Graph& graph) {
+  RETURN_IF_ERROR(CheckNumNodes(num_nodes));
+  // Both directions of each edge, sorted by the source node (upper 32 bits).
+  const std::size_t num_entries = 2 * edge_keys.size();
+  auto entries = parlay::sequence<uint64_t>::uninitialized(num_entries);
+  parlay::parallel_for(0, edge_keys.size(), [&](std::size_t i) {
+    const uint64_t key = edge_keys[i];
+    entries[2 * i] = key;
+    entries[2 * i + 1] = (key << 32) | (key >> 32);
+  });
+  parlay::integer_sort_inplace(entries, [](uint64_t key) { return key; });
+
+  // offsets[u] is the index of the first entry with source u (or larger).
+  parlay::sequence<std::size_t> offsets(num_nodes + 1);
+  parlay::parallel_for(0, num_entries + 1, [&](std::size_t i) {
+    const int64_t source =
+        i == num_entries ? num_nodes : static_cast<int64_t>(entries[i] >> 32);
+    const int64_t previous_source =
+        i == 0 ? -1 : static_cast<int64_t>(entries[i - 1] >> 32);
+    for (int64_t node = previous_source + 1; node <= source; ++node) {
+      offsets[node] = i;
+    }
+  });
+
+  RETURN_IF_ERROR(graph.PrepareImport(num_nodes));
+  ThreadSafeStatus import_status;
+  parlay::parallel_for(0, num_nodes, [&](std::size_t node) {
+    InMemoryClusterer::AdjacencyList adjacency_list;
+    adjacency_list.id = node;
+    adjacency_list.outgoing_edges.reserve(offsets[node + 1] - offsets[node]);
+    for (std::size_t i = offsets[node]; i < offsets[node + 1]; ++i) {
+      const NodeId neighbor = static_cast<NodeId>(entries[i] & kLowerBits);
+      adjacency_list.outgoing_edges.emplace_back(neighbor,
+                                                 edge_weight(node, neighbor));
+    }
+    import_status.Update(graph.Import(std::move(adjacency_list)));
+  });
+  RETURN_IF_ERROR(import_status.status());
+  return graph.FinishImport();
+}
+
+parlay::sequence<NodeId> RandomPermutation(NodeId num_nodes, uint64_t seed) {
+  auto order = parlay::sequence<uint64_t>::from_function(
+      num_nodes, [&](std::size_t i) -> uint64_t {
+        return (RandomBits(seed, i) & ~kLowerBits) | i;
+      });
+  parlay::integer_sort_inplace(order, [](uint64_t key) { return key; });
+  auto permutation = parlay::sequence<NodeId>::uninitialized(num_nodes);
+  parlay::parallel_for(0, num_nodes, [&](std::size_t i) {
+    permutation[order[i] & kLowerBits] = i;
+  });
+  return permutation;
+}
+
+absl::StatusOr<Clustering> ImportCommunityGraph(
+    parlay::sequence<uint64_t> edge_keys, bool sorted_edge_keys,
+    const parlay::sequence<NodeId>& community_offsets, bool permute_node_ids,
+    double inter_weight_factor, const GeneratorOptions& options,
+    InMemoryClusterer::Graph& graph) {
+  const NodeId num_nodes =
+      community_offsets.empty() ? 0 : community_offsets.back();
+  RETURN_IF_ERROR(CheckNumNodes(num_nodes));
+  const std::size_t num_communities =
+      community_offsets.empty() ? 0 : community_offsets.size() - 1;
+
+  parlay::sequence<NodeId> new_ids;
+  if (permute_node_ids) {
+    new_ids = RandomPermutation(num_nodes, RandomBits(options.seed, 0));
+    parlay::parallel_for(0, edge_keys.size(), [&](std::size_t i) {
+      edge_keys[i] = EdgeKey(new_ids[edge_keys[i] >> 32],
+                             new_ids[edge_keys[i] & kLowerBits]);
+    });
+  }
+  if (permute_node_ids || !sorted_edge_keys) SortUniqueEdgeKeys(edge_keys);
+
+  Clustering clustering(num_communities);
+  parlay::sequence<NodeId> community_ids(num_nodes);
+  parlay::parallel_for(
+      0, num_communities,
+      [&](std::size_t i) {
+        clustering[i].reserve(community_offsets[i + 1] - community_offsets[i]);
+        for (NodeId node = community_offsets[i];
+             node < community_offsets[i + 1]; ++node) {
+          const NodeId id = permute_node_ids ? new_ids[node] : node;
+          clustering[i].push_back(id);
+          community_ids[id] = i;
+        }
+      },
+      /*granularity=*/1);
+
+  RETURN_IF_ERROR(ImportSortedEdgeKeys(
+      edge_keys, num_nodes,
+      [&](NodeId u, NodeId v) {
+        const double weight = UniformEdgeWeight(
+            options.seed, u, v, options.min_weight, options.max_weight);
+        return community_ids[u] == community_ids[v]
+                   ? weight
+                   : weight * inter_weight_factor;
+      },
+      graph));
+  return clustering;
+}
+
+}  // namespace internal
+
+}  // namespace graph_mining::in_memory
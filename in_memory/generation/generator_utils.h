@@ -0,0 +1,157 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Shared pieces of the parallel graph generators: deterministic per-index
+// random numbers and a parallel import of an undirected edge list into any
+// InMemoryClusterer::Graph.
+
+#ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_GENERATION_GENERATOR_UTILS_H_
+#define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_GENERATION_GENERATOR_UTILS_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/clustering/types.h"
+#include "parlay/sequence.h"
+#include "parlay/utilities.h"
+
+namespace graph_mining::in_memory {
+
+namespace internal {
+
+// Returns the key of the undirected edge {u, v}: the smaller endpoint in the
+// upper and the larger endpoint in the lower 32 bits.
+inline uint64_t EdgeKey(NodeId u, NodeId v) {
+  return (static_cast<uint64_t>(std::min(u, v)) << 32) |
+         static_cast<uint32_t>(std::max(u, v));
+}
+
+}  // namespace internal
+
+// Options shared by the parallel generators. The generated graph is a
+// deterministic function of the generator parameters and these options; in
+// particular it does not depend on the number of workers.
+struct GeneratorOptions {
+  // Seed of all random choices.
+  uint64_t seed = 0;
+  // Edge {u, v} gets the weight UniformEdgeWeight(seed, u, v, min_weight,
+  // max_weight). With the default values, the graph is unweighted (all weights
+  // are 1).
+  double min_weight = 1.0;
+  double max_weight = 1.0;
+};
+
+// Returns 64 pseudo-random bits that are a deterministic function of seed and
+// index. Different indices give (practically) independent values.
+inline uint64_t RandomBits(uint64_t seed, uint64_t index) {
+  return parlay::hash64(parlay::hash64(seed) + index);
+}
+
+// Returns a pseudo-random double in [0, 1), see RandomBits.
+inline double RandomUnit(uint64_t seed, uint64_t index) {
+  return (RandomBits(seed, index) >> 11) * 0x1.0p-53;
+}
+
+// Returns a pseudo-random integer in [0, bound), see RandomBits. bound must be
+// positive.
+inline uint64_t RandomBelow(uint64_t seed, uint64_t index, uint64_t bound) {
+  return static_cast<uint64_t>(
+      (static_cast<unsigned __int128>(RandomBits(seed, index)) * bound) >> 64);
+}
+
+// Returns a pseudo-random integer in [min_value, max_value] whose probability
+// is roughly proportional to x^(-exponent) (a discretized continuous power
+// law), see RandomBits. Requires 1 <= min_value <= max_value.
+inline int64_t RandomPowerLaw(uint64_t seed, uint64_t index, int64_t min_value,
+                              int64_t max_value, double exponent) {
+  const double r = RandomUnit(seed, index);
+  const double low = min_value;
+  const double high = max_value + 1.0;
+  double value;
+  if (std::abs(exponent - 1) < 1e-9) {
+    value = low * std::pow(high / low, r);
+  } else {
+    const double e = 1 - exponent;
+    value = std::pow(
+        std::pow(low, e) + r * (std::pow(high, e) - std::pow(low, e)), 1 / e);
+  }
+  return std::clamp<int64_t>(static_cast<int64_t>(value), min_value,
+                             max_value);
+}
+
+// Returns a pseudo-random weight in [low, high) of the undirected edge {u, v}.
+// The weight does not depend on the order of u and v, so both directions of an
+// edge can be assigned independently.
+inline double UniformEdgeWeight(uint64_t seed, NodeId u, NodeId v, double low,
+                                double high) {
+  return low + (high - low) * RandomUnit(seed, internal::EdgeKey(u, v));
+}
+
+// Imports the undirected graph on nodes [0, num_nodes) given by edges into
+// graph, which must be empty: calls graph.PrepareImport(num_nodes), imports the
+// adjacency lists of all nodes in parallel (each adjacency list contains both
+// directions of every edge) and calls graph.FinishImport(). Self-loops and
+// duplicate edges (in either orientation) are dropped. Edge weights are set as
+// described in GeneratorOptions. num_nodes must be less than 2^32.
+absl::Status ImportUndirectedEdges(
+    const parlay::sequence<std::pair<NodeId, NodeId>>& edges,
+    NodeId num_nodes, const GeneratorOptions& options,
+    InMemoryClusterer::Graph& graph);
+
+namespace internal {
+
+// Sorts the edge keys and removes duplicates and self-loops.
+void SortUniqueEdgeKeys(parlay::sequence<uint64_t>& edge_keys);
+
+// Same as ImportUndirectedEdges, but takes the output of SortUniqueEdgeKeys.
+absl::Status ImportSortedEdgeKeys(
+    const parlay::sequence<uint64_t>& edge_keys, NodeId num_nodes,
+    const GeneratorOptions& options, InMemoryClusterer::Graph& graph);
+
+// Same as above, but the weight of edge {u, v} is edge_weight(u, v), which
+// must be thread-safe and symmetric.
+absl::Status ImportSortedEdgeKeys(
+    const parlay::sequence<uint64_t>& edge_keys, NodeId num_nodes,
+    absl::FunctionRef<double(NodeId, NodeId)> edge_weight,
+    InMemoryClusterer::Graph& graph);
+
+// Returns a uniformly random permutation of [0, num_nodes) (up to ties among
+// 32-bit random priorities, which are broken by node id). num_nodes must be
+// less than 2^32.
+parlay::sequence<NodeId> RandomPermutation(NodeId num_nodes, uint64_t seed);
+
+// Imports a graph with planted communities and returns the communities as a
+// clustering. Community i consists of the nodes [community_offsets[i],
+// community_offsets[i + 1]) before node ids are (optionally) permuted. The edge
+// keys are sorted and deduplicated unless sorted_edge_keys is true and node ids
+// are not permuted. Edge weights are drawn as described in GeneratorOptions,
+// and the weights of edges between different communities are then multiplied
+// by inter_weight_factor.
+absl::StatusOr<Clustering> ImportCommunityGraph(
+    parlay::sequence<uint64_t> edge_keys, bool sorted_edge_keys,
+    const parlay::sequence<NodeId>& community_offsets, bool permute_node_ids,
+    double inter_weight_factor, const GeneratorOptions& options,
+    InMemoryClusterer::Graph& graph);
+
+}  // namespace internal
+
+}  // namespace graph_mining::in_memory
+
+#endif  // THIRD_PARTY_GRAPH_MINING_IN_MEMORY_GENERATION_GENERATOR_UTILS_H_
@@ -0,0 +1,95 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/generation/generator_utils.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "in_memory/clustering/graph.h"
+#include "in_memory/clustering/types.h"
+#include "in_memory/generation/generation_test_util.h"
+#include "in_memory/status_macros.h"  // IWYU pragma: keep
+#include "parlay/sequence.h"
+
+namespace graph_mining::in_memory {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::FieldsAre;
+
+TEST(ImportUndirectedEdgesTest, DropsSelfLoopsAndDuplicates) {
+  const parlay::sequence<std::pair<NodeId, NodeId>> edges = {
+      {0, 1}, {1, 0}, {2, 2}, {3, 1}, {0, 1}};
+  SimpleUndirectedGraph graph;
+  ASSERT_OK(ImportUndirectedEdges(edges, 4, GeneratorOptions(), graph));
+  EXPECT_EQ(graph.NumNodes(), 4);
+  EXPECT_THAT(SortedWeightedEdges(graph),
+              ElementsAre(FieldsAre(0, 1, 1.0), FieldsAre(1, 3, 1.0)));
+}
+
+TEST(ImportUndirectedEdgesTest, SymmetricWeightsInRange) {
+  const parlay::sequence<std::pair<NodeId, NodeId>> edges = {
+      {0, 1}, {2, 1}, {3, 0}};
+  GeneratorOptions options;
+  options.seed = 7;
+  options.min_weight = 2.0;
+  options.max_weight = 3.0;
+  SimpleUndirectedGraph graph;
+  ASSERT_OK(ImportUndirectedEdges(edges, 4, options, graph));
+  for (const auto& [u, v, weight] : SortedWeightedEdges(graph)) {
+    EXPECT_GE(weight, 2.0);
+    EXPECT_LT(weight, 3.0);
+    EXPECT_EQ(graph.EdgeWeight(v, u), weight);
+    EXPECT_DOUBLE_EQ(weight, UniformEdgeWeight(7, v, u, 2.0, 3.0));
+  }
+}
+
+TEST(ImportUndirectedEdgesTest, InvalidEndpointIsAnError) {
+  SimpleUndirectedGraph graph;
+  EXPECT_EQ(
+      ImportUndirectedEdges({{0, 4}}, 4, GeneratorOptions(), graph).code(),
+      absl::StatusCode::kInvalidArgument);
+}
+
+TEST(ImportUndirectedEdgesTest, NegativeNumNodesIsAnError) {
+  SimpleUndirectedGraph graph;
+  EXPECT_EQ(ImportUndirectedEdges({}, -1, GeneratorOptions(), graph).code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+TEST(RandomPowerLawTest, StaysInRange) {
+  for (uint64_t i = 0; i < 1000; ++i) {
+    const int64_t value = RandomPowerLaw(/*seed=*/3, i, 5, 50, 2.5);
+    EXPECT_GE(value, 5);
+    EXPECT_LE(value, 50);
+  }
+}
+
+TEST(RandomPermutationTest, IsPermutation) {
+  parlay::sequence<NodeId> permutation =
+      internal::RandomPermutation(100, /*seed=*/1);
+  std::vector<NodeId> sorted(permutation.begin(), permutation.end());
+  std::sort(sorted.begin(), sorted.end());
+  for (NodeId i = 0; i < 100; ++i) EXPECT_EQ(sorted[i], i);
+}
+
+}  // namespace
+}  // namespace graph_mining::in_memory
@@ -0,0 +1,195 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/generation/lfr.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/clustering/types.h"
+#include "in_memory/generation/generator_utils.h"
+#include "in_memory/status_macros.h"
+#include "parlay/parallel.h"
+#include "parlay/primitives.h"
+#include "parlay/sequence.h"
+
+namespace graph_mining::in_memory {
+namespace {
+
+// A stub (half-edge) of a node, together with its sort key.
+using Stub = std::pair<uint64_t, NodeId>;
+
+absl::Status CheckConfig(const LfrConfig& config) {
+  if (config.num_nodes < 0) {
+    return absl::InvalidArgumentError("num_nodes must be non-negative");
+  }
+  if (config.min_degree < 1 || config.min_degree > config.max_degree) {
+    return absl::InvalidArgumentError(
+        "Degrees must satisfy 1 <= min_degree <= max_degree");
+  }
+  if (config.min_community_size < 1 ||
+      config.min_community_size > config.max_community_size) {
+    return absl::InvalidArgumentError(
+        "Community sizes must satisfy 1 <= min_community_size <= "
+        "max_community_size");
+  }
+  if (!(config.mixing_parameter >= 0 && config.mixing_parameter <= 1)) {
+    return absl::InvalidArgumentError("mixing_parameter must be in [0, 1]");
+  }
+  return absl::OkStatus();
+}
+
+// Returns the start of each community and num_nodes at the end.
+parlay::sequence<NodeId> CommunityOffsets(const LfrConfig& config,
+                                          uint64_t seed) {
+  // This many communities always cover all nodes.
+  const std::size_t max_num_communities =
+      config.num_nodes / config.min_community_size + 1;
+  auto offsets = parlay::sequence<int64_t>::from_function(
+      max_num_communities, [&](std::size_t i) {
+        return RandomPowerLaw(seed, i, config.min_community_size,
+                              config.max_community_size,
+                              config.community_size_exponent);
+      });
+  parlay::scan_inplace(offsets);
+  std::size_t num_communities = parlay::count_if(
+      offsets, [&](int64_t offset) { return offset < config.num_nodes; });
+  const int64_t last_size =
+      num_communities == 0 ? 0
+                           : config.num_nodes - offsets[num_communities - 1];
+  if (num_communities > 1 && last_size < config.min_community_size) {
+    --num_communities;
+  }
+  return parlay::sequence<NodeId>::from_function(
+      num_communities + 1, [&](std::size_t i) -> NodeId {
+        return i == num_communities ? config.num_nodes : offsets[i];
+      });
+}
+
+// Matches consecutive stubs (positions 2j and 2j + 1 counted from the start of
+// the group of each stub) and returns the edge keys. group_start(i) returns the
+// position of the first stub of the group of the stub at position i, and
+// keep(u, v) returns whether the edge {u, v} is kept. Unmatched stubs and
+// dropped edges give self-loops, which are removed by SortUniqueEdgeKeys.
+template <typename GroupStart, typename Keep>
+parlay::sequence<uint64_t> MatchStubs(const parlay::sequence<Stub>& stubs,
+                                      GroupStart group_start, Keep keep) {
+  return parlay::sequence<uint64_t>::from_function(
+      stubs.size(), [&](std::size_t i) -> uint64_t {
+        const NodeId u = stubs[i].second;
+        if ((i - group_start(i)) % 2 == 1 || i + 1 == stubs.size() ||
+            group_start(i + 1) != group_start(i)) {
+          return internal::EdgeKey(u, u);
+        }
+        const NodeId v = stubs[i + 1].second;
+        return keep(u, v) ? internal::EdgeKey(u, v) : internal::EdgeKey(u, u);
+      });
+}
+
+}  // namespace
+
+absl::StatusOr<Clustering> LfrGraph(const LfrConfig& config,
+                                    const GeneratorOptions& options,
+                                    InMemoryClusterer::Graph& graph) {
+  RETURN_IF_ERROR(CheckConfig(config));
+  const uint64_t seed = options.seed;
+  const NodeId num_nodes = config.num_nodes;
+  const parlay::sequence<NodeId> community_offsets =
+      CommunityOffsets(config, RandomBits(seed, 1));
+  const std::size_t num_communities = community_offsets.size() - 1;
+  parlay::sequence<NodeId> community_ids(num_nodes);
+  parlay::parallel_for(
+      0, num_communities,
+      [&](std::size_t i) {
+        parlay::parallel_for(
+            community_offsets[i], community_offsets[i + 1],
+            [&](NodeId node) { community_ids[node] = i; });
+      },
+      /*granularity=*/1);
+
+  // Internal and external degree of each node.
+  const uint64_t degree_seed = RandomBits(seed, 2);
+  auto internal_degrees = parlay::sequence<std::size_t>::uninitialized(
+      num_nodes + 1);
+  auto external_degrees = parlay::sequence<std::size_t>::uninitialized(
+      num_nodes + 1);
+  parlay::parallel_for(0, num_nodes + 1, [&](NodeId node) {
+    if (node == num_nodes) {
+      internal_degrees[node] = external_degrees[node] = 0;
+      return;
+    }
+    const int64_t degree =
+        RandomPowerLaw(degree_seed, node, config.min_degree, config.max_degree,
+                       config.degree_exponent);
+    const NodeId community = community_ids[node];
+    const int64_t internal_degree = std::min<int64_t>(
+        std::llround((1 - config.mixing_parameter) * degree),
+        community_offsets[community + 1] - community_offsets[community] - 1);
+    internal_degrees[node] = internal_degree;
+    external_degrees[node] = degree - internal_degree;
+  });
+  const std::size_t num_internal_stubs = parlay::scan_inplace(internal_degrees);
+  const std::size_t num_external_stubs = parlay::scan_inplace(external_degrees);
+
+  // Internal stubs are shuffled within each community: the community is in the
+  // upper and a random priority in the lower 32 bits of the sort key. The stubs
+  // of a community stay where they were before sorting.
+  const uint64_t internal_seed = RandomBits(seed, 3);
+  auto internal_stubs = parlay::sequence<Stub>::uninitialized(
+      num_internal_stubs);
+  auto external_stubs = parlay::sequence<Stub>::uninitialized(
+      num_external_stubs);
+  const uint64_t external_seed = RandomBits(seed, 4);
+  parlay::parallel_for(0, num_nodes, [&](NodeId node) {
+    const uint64_t community = community_ids[node];
+    for (std::size_t i = internal_degrees[node];
+         i < internal_degrees[node + 1]; ++i) {
+      internal_stubs[i] = {
+          (community << 32) | (RandomBits(internal_seed, i) >> 32), node};
+    }
+    for (std::size_t i = external_degrees[node];
+         i < external_degrees[node + 1]; ++i) {
+      external_stubs[i] = {RandomBits(external_seed, i), node};
+    }
+  });
+  auto stub_key = [](const Stub& stub) { return stub.first; };
+  parlay::integer_sort_inplace(internal_stubs, stub_key);
+  parlay::integer_sort_inplace(external_stubs, stub_key);
+
+  auto internal_edges = MatchStubs(
+      internal_stubs,
+      [&](std::size_t i) {
+        return internal_degrees[community_offsets[
+            community_ids[internal_stubs[i].second]]];
+      },
+      [](NodeId, NodeId) { return true; });
+  auto external_edges = MatchStubs(
+      external_stubs, [](std::size_t) { return std::size_t{0}; },
+      [&](NodeId u, NodeId v) {
+        return community_ids[u] != community_ids[v];
+      });
+  internal_edges.append(external_edges);
+  return internal::ImportCommunityGraph(
+      std::move(internal_edges), /*sorted_edge_keys=*/false, community_offsets,
+      config.permute_node_ids, config.inter_community_weight_factor, options,
+      graph);
+}
+
+}  // namespace graph_mining::in_memory
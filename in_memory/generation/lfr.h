@@ -0,0 +1,72 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_GENERATION_LFR_H_
+#define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_GENERATION_LFR_H_
+
+#include <cstdint>
+
+#include "absl/status/statusor.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/clustering/types.h"
+#include "in_memory/generation/generator_utils.h"
+
+namespace graph_mining::in_memory {
+
+struct LfrConfig {
+  NodeId num_nodes = 0;
+  // Node degrees follow a power law with this exponent on
+  // [min_degree, max_degree].
+  double degree_exponent = 2.5;
+  int64_t min_degree = 5;
+  int64_t max_degree = 50;
+  // Community sizes follow a power law with this exponent on
+  // [min_community_size, max_community_size].
+  double community_size_exponent = 1.5;
+  int64_t min_community_size = 20;
+  int64_t max_community_size = 100;
+  // Fraction of the degree of each node that goes to other communities.
+  double mixing_parameter = 0.2;
+  // The weights of the edges between different communities are multiplied by
+  // this factor (see GeneratorOptions for how weights are drawn).
+  double inter_community_weight_factor = 1.0;
+  // If false, the communities consist of consecutive node ids. Otherwise, node
+  // ids are randomly permuted.
+  bool permute_node_ids = true;
+};
+
+// Imports an LFR-style benchmark graph (Lancichinetti, Fortunato and
+// Radicchi, Phys. Rev. E'08) into graph, which must be empty (see
+// ImportUndirectedEdges), and returns its communities as the ground-truth
+// clustering.
+//
+// Degrees and community sizes are drawn from power laws. Each node u with
+// degree d splits it into round((1 - mixing_parameter) * d) internal stubs,
+// capped at the size of its community minus one, and external stubs for the
+// rest. Internal stubs are matched uniformly at random within each community
+// and external stubs across the whole graph (a configuration model), both by
+// sorting the stubs by random priorities. Unlike the original sequential
+// generator, the communities are consecutive ranges of node ids (before the
+// optional permutation of node ids), regardless of the node degrees, and stubs
+// are not rewired, so self-loops, multi-edges and external stubs matched within
+// a community are dropped; the degrees and the mixing of the result thus
+// deviate slightly from the requested values. The last community is merged
+// into the previous one if it is smaller than min_community_size.
+absl::StatusOr<Clustering> LfrGraph(const LfrConfig& config,
+                                    const GeneratorOptions& options,
+                                    InMemoryClusterer::Graph& graph);
+
+}  // namespace graph_mining::in_memory
+
+#endif  // THIRD_PARTY_GRAPH_MINING_IN_MEMORY_GENERATION_LFR_H_
@@ -0,0 +1,146 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "in_memory/generation/lfr.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "gtest/gtest.h"
+#include "in_memory/clustering/graph.h"
+#include "in_memory/clustering/types.h"
+#include "in_memory/generation/generation_test_util.h"
+#include "in_memory/generation/generator_utils.h"
+#include "in_memory/status_macros.h"  // IWYU pragma: keep
+
+namespace graph_mining::in_memory {
+namespace {
+
+// Returns the community of each node and checks that clustering is a
+// partition of the nodes of graph.
+std::vector<int> CommunityIds(const Clustering& clustering,
+                              const SimpleUndirectedGraph& graph) {
+  std::vector<int> community_ids(graph.NumNodes(), -1);
+  for (std::size_t i = 0; i < clustering.size(); ++i) {
+    for (const NodeId node : clustering[i]) {
+      EXPECT_EQ(community_ids[node], -1) << "node " << node;
+      community_ids[node] = i;
+    }
+  }
+  EXPECT_EQ(std::count(community_ids.begin(), community_ids.end(), -1), 0);
+  return community_ids;
+}
+
+TEST(LfrGraphTest, CommunitiesAndDegreesRespectConfig) {
+  LfrConfig config;
+  config.num_nodes = 2000;
+  SimpleUndirectedGraph graph;
+  ASSERT_OK_AND_ASSIGN(Clustering clustering,
+                       LfrGraph(config, GeneratorOptions(), graph));
+  ASSERT_EQ(graph.NumNodes(), 2000);
+  const std::vector<int> community_ids = CommunityIds(clustering, graph);
+  for (const auto& community : clustering) {
+    const int64_t size = community.size();
+    EXPECT_GE(size, config.min_community_size);
+    // The last community may be merged into the previous one.
+    EXPECT_LT(size, config.max_community_size + config.min_community_size);
+  }
+  for (NodeId u = 0; u < graph.NumNodes(); ++u) {
+    const int64_t degree = graph.Neighbors(u).size();
+    EXPECT_LE(degree, config.max_degree) << "node " << u;
+    EXPECT_FALSE(graph.EdgeWeight(u, u).has_value());
+  }
+  // Roughly a 1 - mixing_parameter fraction of the edges are intra-community.
+  int64_t num_edges = 0;
+  int64_t num_intra_edges = 0;
+  for (const auto& [u, v] : SortedEdges(graph)) {
+    ++num_edges;
+    if (community_ids[u] == community_ids[v]) ++num_intra_edges;
+  }
+  EXPECT_GT(num_edges, 2000 * config.min_degree / 2 / 2);
+  EXPECT_GT(num_intra_edges, 0.6 * num_edges);
+  EXPECT_LT(num_intra_edges, 0.95 * num_edges);
+}
+
+TEST(LfrGraphTest, NoMixingGivesDisconnectedCommunities) {
+  LfrConfig config;
+  config.num_nodes = 500;
+  config.max_degree = 10;
+  config.mixing_parameter = 0.0;
+  config.permute_node_ids = false;
+  SimpleUndirectedGraph graph;
+  ASSERT_OK_AND_ASSIGN(Clustering clustering,
+                       LfrGraph(config, GeneratorOptions(), graph));
+  const std::vector<int> community_ids = CommunityIds(clustering, graph);
+  // Without permutation, communities are consecutive ranges of node ids.
+  NodeId next_node = 0;
+  for (const auto& community : clustering) {
+    for (const NodeId node : community) EXPECT_EQ(node, next_node++);
+  }
+  for (const auto& [u, v] : SortedEdges(graph)) {
+    EXPECT_EQ(community_ids[u], community_ids[v]);
+  }
+}
+
+TEST(LfrGraphTest, InterCommunityWeightFactor) {
+  LfrConfig config;
+  config.num_nodes = 500;
+  config.inter_community_weight_factor = 0.5;
+  GeneratorOptions options;
+  options.min_weight = 4.0;
+  options.max_weight = 4.0;
+  SimpleUndirectedGraph graph;
+  ASSERT_OK_AND_ASSIGN(Clustering clustering,
+                       LfrGraph(config, options, graph));
+  const std::vector<int> community_ids = CommunityIds(clustering, graph);
+  for (const auto& [u, v] : SortedEdges(graph)) {
+    EXPECT_EQ(graph.EdgeWeight(u, v),
+              community_ids[u] == community_ids[v] ? 4.0 : 2.0);
+  }
+}
+
+TEST(LfrGraphTest, IsDeterministicGivenSeed) {
+  LfrConfig config;
+  config.num_nodes = 1000;
+  GeneratorOptions options;
+  options.seed = 8;
+  SimpleUndirectedGraph graph_a;
+  ASSERT_OK_AND_ASSIGN(Clustering clustering_a,
+                       LfrGraph(config, options, graph_a));
+  for (const int num_workers : {1, 2, 4}) {
+    SimpleUndirectedGraph graph_b;
+    Clustering clustering_b;
+    RunWithNumWorkers(num_workers, [&] {
+      ASSERT_OK_AND_ASSIGN(clustering_b, LfrGraph(config, options, graph_b));
+    });
+    EXPECT_EQ(clustering_a, clustering_b) << num_workers << " workers";
+    EXPECT_EQ(SortedEdges(graph_a), SortedEdges(graph_b))
+        << num_workers << " workers";
+  }
+}
+
+TEST(LfrGraphTest, InvalidConfigIsAnError) {
+  LfrConfig config;
+  config.num_nodes = 100;
+  config.min_degree = 10;
+  config.max_degree = 5;
+  SimpleUndirectedGraph graph;
+  EXPECT_EQ(LfrGraph(config, GeneratorOptions(), graph).status().code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+}  // namespace
+}  // namespace graph_mining::in_memory
@@ -0,0 +1,71 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/generation/rmat.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/clustering/types.h"
+#include "in_memory/generation/generator_utils.h"
+#include "parlay/sequence.h"
+
+namespace graph_mining::in_memory {
+namespace {
+
+// The number of nodes must be representable as a NodeId and less than 2^32.
+constexpr int kMaxScale = sizeof(NodeId) == 4 ? 30 : 31;
+
+}  // namespace
+
+absl::Status Rmat(int scale, int64_t num_edges,
+                  const RmatParameters& parameters,
+                  const GeneratorOptions& options,
+                  InMemoryClusterer::Graph& graph) {
+  if (scale < 1 || scale > kMaxScale) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "scale must be in [1, ", kMaxScale, "], got ", scale));
+  }
+  if (num_edges < 0) {
+    return absl::InvalidArgumentError("num_edges must be non-negative");
+  }
+  const double a = parameters.a;
+  const double ab = a + parameters.b;
+  const double abc = ab + parameters.c;
+  if (a < 0 || parameters.b < 0 || parameters.c < 0 || abc > 1) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Invalid R-MAT probabilities a=", a, " b=", parameters.b,
+        " c=", parameters.c));
+  }
+
+  auto edge_keys = parlay::sequence<uint64_t>::from_function(
+      num_edges, [&](std::size_t edge) {
+        NodeId u = 0;
+        NodeId v = 0;
+        for (int level = 0; level < scale; ++level) {
+          const double r = RandomUnit(options.seed, edge * scale + level);
+          u = 2 * u + (r >= ab ? 1 : 0);
+          v = 2 * v + ((r >= a && r < ab) || r >= abc ? 1 : 0);
+        }
+        return internal::EdgeKey(u, v);
+      });
+  internal::SortUniqueEdgeKeys(edge_keys);
+  return internal::ImportSortedEdgeKeys(edge_keys, NodeId{1} << scale, options,
+                                        graph);
+}
+
+}  // namespace graph_mining::in_memory
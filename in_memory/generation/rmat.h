@@ -0,0 +1,54 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_GENERATION_RMAT_H_
+#define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_GENERATION_RMAT_H_
+
+#include <cstdint>
+
+#include "absl/status/status.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/generation/generator_utils.h"
+
+namespace graph_mining::in_memory {
+
+// Probabilities of the four quadrants of the R-MAT recursion. The probability
+// of the bottom-right quadrant is 1 - a - b - c. The defaults are the Graph500
+// parameters.
+struct RmatParameters {
+  // Top-left quadrant (both endpoints in the lower half of the id range).
+  double a = 0.57;
+  // Top-right quadrant.
+  double b = 0.19;
+  // Bottom-left quadrant.
+  double c = 0.19;
+};
+
+// Imports an R-MAT graph (Chakrabarti et al., SDM'04) with 2^scale nodes into
+// graph, which must be empty (see ImportUndirectedEdges). This is the same as
+// a stochastic Kronecker graph with the 2x2 initiator matrix [[a, b], [c, d]].
+//
+// num_edges candidate edges are sampled independently and in parallel: each
+// candidate chooses one quadrant per bit of the endpoint ids, starting from the
+// most significant bit. Self-loops and duplicate candidates are dropped, so the
+// graph has at most num_edges edges. Node ids with few set bits have the
+// largest degrees. Requires 1 <= scale <= 30 (31 with 64-bit node ids).
+absl::Status Rmat(int scale, int64_t num_edges,
+                  const RmatParameters& parameters,
+                  const GeneratorOptions& options,
+                  InMemoryClusterer::Graph& graph);
+
+}  // namespace graph_mining::in_memory
+
+#endif  // THIRD_PARTY_GRAPH_MINING_IN_MEMORY_GENERATION_RMAT_H_
@@ -0,0 +1,78 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/generation/rmat.h"
+
+#include <cstddef>
+
+#include "absl/status/status.h"
+#include "gtest/gtest.h"
+#include "in_memory/clustering/graph.h"
+#include "in_memory/clustering/types.h"
+#include "in_memory/generation/generation_test_util.h"
+#include "in_memory/generation/generator_utils.h"
+#include "in_memory/status_macros.h"  // IWYU pragma: keep
+
+namespace graph_mining::in_memory {
+namespace {
+
+TEST(RmatTest, HasPowerOfTwoNodesAndAtMostNumEdges) {
+  SimpleUndirectedGraph graph;
+  ASSERT_OK(Rmat(/*scale=*/8, /*num_edges=*/2000, RmatParameters(),
+                 GeneratorOptions(), graph));
+  EXPECT_EQ(graph.NumNodes(), 256);
+  const std::size_t num_edges = SortedEdges(graph).size();
+  EXPECT_GT(num_edges, 0);
+  EXPECT_LE(num_edges, 2000);
+  for (NodeId u = 0; u < graph.NumNodes(); ++u) {
+    EXPECT_FALSE(graph.EdgeWeight(u, u).has_value());
+  }
+}
+
+TEST(RmatTest, SkewedTowardsLowIds) {
+  SimpleUndirectedGraph graph;
+  ASSERT_OK(Rmat(/*scale=*/10, /*num_edges=*/20000, RmatParameters(),
+                 GeneratorOptions(), graph));
+  // Node 0 has no set bits and hence the largest expected degree.
+  EXPECT_GT(graph.Neighbors(0).size(), graph.Neighbors(1023).size());
+}
+
+TEST(RmatTest, IsDeterministicGivenSeed) {
+  GeneratorOptions options;
+  options.seed = 5;
+  SimpleUndirectedGraph graph_a;
+  ASSERT_OK(Rmat(8, 1000, RmatParameters(), options, graph_a));
+  for (const int num_workers : {1, 2, 4}) {
+    SimpleUndirectedGraph graph_b;
+    RunWithNumWorkers(num_workers, [&] {
+      ASSERT_OK(Rmat(8, 1000, RmatParameters(), options, graph_b));
+    });
+    EXPECT_EQ(SortedEdges(graph_a), SortedEdges(graph_b))
+        << num_workers << " workers";
+  }
+}
+
+TEST(RmatTest, InvalidParametersAreAnError) {
+  SimpleUndirectedGraph graph;
+  EXPECT_EQ(
+      Rmat(0, 10, RmatParameters(), GeneratorOptions(), graph).code(),
+      absl::StatusCode::kInvalidArgument);
+  RmatParameters parameters;
+  parameters.a = 0.9;
+  EXPECT_EQ(Rmat(4, 10, parameters, GeneratorOptions(), graph).code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+}  // namespace
+}  // namespace graph_mining::in_memory
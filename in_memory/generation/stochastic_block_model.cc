@@ -0,0 +1,119 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/generation/stochastic_block_model.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/clustering/types.h"
+#include "in_memory/generation/generator_utils.h"
+#include "in_memory/status_macros.h"
+#include "parlay/parallel.h"
+#include "parlay/primitives.h"
+#include "parlay/sequence.h"
+
+namespace graph_mining::in_memory {
+namespace {
+
+// Calls f(v) for every v in [begin, end) independently with the given
+// probability. Uses the random numbers (seed, counter), (seed, counter + 1),
+// ... and advances counter accordingly.
+template <typename F>
+void SampleRange(NodeId begin, NodeId end, double probability, uint64_t seed,
+                 uint64_t& counter, F f) {
+  if (begin >= end || probability <= 0) return;
+  if (probability >= 1) {
+    for (NodeId v = begin; v < end; ++v) f(v);
+    return;
+  }
+  const double log_q = std::log1p(-probability);
+  NodeId v = begin - 1;
+  while (true) {
+    // The gap to the next sampled candidate is geometrically distributed.
+    const double gap =
+        std::floor(std::log1p(-RandomUnit(seed, counter++)) / log_q);
+    if (gap >= static_cast<double>(end - v - 1)) return;
+    v += 1 + static_cast<NodeId>(gap);
+    f(v);
+  }
+}
+
+absl::Status CheckProbability(double probability) {
+  if (!(probability >= 0 && probability <= 1)) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Invalid edge probability: ", probability));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::StatusOr<Clustering> StochasticBlockModel(
+    const StochasticBlockModelConfig& config, const GeneratorOptions& options,
+    InMemoryClusterer::Graph& graph) {
+  RETURN_IF_ERROR(CheckProbability(config.intra_block_probability));
+  RETURN_IF_ERROR(CheckProbability(config.inter_block_probability));
+  const std::size_t num_blocks = config.block_sizes.size();
+  auto block_offsets = parlay::sequence<NodeId>::from_function(
+      num_blocks + 1, [&](std::size_t i) -> NodeId {
+        return i == num_blocks ? 0 : config.block_sizes[i];
+      });
+  if (parlay::count_if(block_offsets,
+                       [](NodeId block_size) { return block_size < 0; }) > 0) {
+    return absl::InvalidArgumentError("Block sizes must be non-negative");
+  }
+  const NodeId num_nodes = parlay::scan_inplace(block_offsets);
+
+  // End of the block of each node.
+  parlay::sequence<NodeId> block_ends(num_nodes);
+  parlay::parallel_for(
+      0, num_blocks,
+      [&](std::size_t i) {
+        parlay::parallel_for(block_offsets[i], block_offsets[i + 1],
+                             [&](NodeId node) {
+                               block_ends[node] = block_offsets[i + 1];
+                             });
+      },
+      /*granularity=*/1);
+
+  // Neighbors v > u of each node u in increasing order. The candidates inside
+  // of the block of u come first.
+  const uint64_t edge_seed = RandomBits(options.seed, 1);
+  auto neighbor_keys = parlay::map(
+      parlay::iota<NodeId>(num_nodes), [&](NodeId u) {
+        parlay::sequence<uint64_t> keys;
+        uint64_t counter = 0;
+        const uint64_t node_seed = RandomBits(edge_seed, u);
+        auto add_edge = [&](NodeId v) {
+          keys.push_back(internal::EdgeKey(u, v));
+        };
+        SampleRange(u + 1, block_ends[u], config.intra_block_probability,
+                    node_seed, counter, add_edge);
+        SampleRange(block_ends[u], num_nodes, config.inter_block_probability,
+                    node_seed, counter, add_edge);
+        return keys;
+      });
+  return internal::ImportCommunityGraph(
+      parlay::flatten(neighbor_keys), /*sorted_edge_keys=*/true, block_offsets,
+      config.permute_node_ids, config.inter_block_weight_factor, options,
+      graph);
+}
+
+}  // namespace graph_mining::in_memory
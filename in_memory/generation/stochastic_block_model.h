@@ -0,0 +1,58 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_GENERATION_STOCHASTIC_BLOCK_MODEL_H_
+#define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_GENERATION_STOCHASTIC_BLOCK_MODEL_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/clustering/types.h"
+#include "in_memory/generation/generator_utils.h"
+
+namespace graph_mining::in_memory {
+
+struct StochasticBlockModelConfig {
+  // Number of nodes of each block. The blocks are the ground-truth clusters.
+  std::vector<NodeId> block_sizes;
+  // Probability of each edge between two nodes of the same block.
+  double intra_block_probability = 0.0;
+  // Probability of each edge between two nodes of different blocks.
+  double inter_block_probability = 0.0;
+  // The weights of the edges between different blocks are multiplied by this
+  // factor (see GeneratorOptions for how weights are drawn).
+  double inter_block_weight_factor = 1.0;
+  // If false, block i consists of consecutive node ids following the nodes of
+  // block i - 1. Otherwise, node ids are randomly permuted.
+  bool permute_node_ids = true;
+};
+
+// Imports a planted-partition stochastic block model graph into graph, which
+// must be empty (see ImportUndirectedEdges), and returns its blocks as the
+// ground-truth clustering. Each pair of nodes is connected independently with
+// the intra- or inter-block probability.
+//
+// The nodes are processed in parallel. Each node u samples its neighbors v > u
+// by skipping over the candidates with geometrically distributed gaps, so the
+// work is O(num_nodes + num_edges) and edges come out sorted without any
+// deduplication pass (unless node ids are permuted).
+absl::StatusOr<Clustering> StochasticBlockModel(
+    const StochasticBlockModelConfig& config, const GeneratorOptions& options,
+    InMemoryClusterer::Graph& graph);
+
+}  // namespace graph_mining::in_memory
+
+#endif  // THIRD_PARTY_GRAPH_MINING_IN_MEMORY_GENERATION_STOCHASTIC_BLOCK_MODEL_H_
@@ -0,0 +1,128 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "in_memory/generation/stochastic_block_model.h"
+
+#include <cstddef>
+#include <tuple>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "in_memory/clustering/graph.h"
+#include "in_memory/clustering/types.h"
+#include "in_memory/generation/generation_test_util.h"
+#include "in_memory/generation/generator_utils.h"
+#include "in_memory/status_macros.h"  // IWYU pragma: keep
+
+namespace graph_mining::in_memory {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::SizeIs;
+using ::testing::UnorderedElementsAre;
+
+TEST(StochasticBlockModelTest, DisjointCliques) {
+  StochasticBlockModelConfig config;
+  config.block_sizes = {3, 4, 5};
+  config.intra_block_probability = 1.0;
+  config.permute_node_ids = false;
+  SimpleUndirectedGraph graph;
+  ASSERT_OK_AND_ASSIGN(
+      Clustering clustering,
+      StochasticBlockModel(config, GeneratorOptions(), graph));
+  EXPECT_THAT(clustering,
+              ElementsAre(ElementsAre(0, 1, 2), ElementsAre(3, 4, 5, 6),
+                          ElementsAre(7, 8, 9, 10, 11)));
+  EXPECT_EQ(graph.NumNodes(), 12);
+  EXPECT_THAT(SortedWeightedEdges(graph), SizeIs(3 + 6 + 10));
+}
+
+TEST(StochasticBlockModelTest, PermutedBlocksAreCliques) {
+  StochasticBlockModelConfig config;
+  config.block_sizes = {3, 4, 5};
+  config.intra_block_probability = 1.0;
+  SimpleUndirectedGraph graph;
+  ASSERT_OK_AND_ASSIGN(
+      Clustering clustering,
+      StochasticBlockModel(config, GeneratorOptions(), graph));
+  ASSERT_THAT(clustering, ElementsAre(SizeIs(3), SizeIs(4), SizeIs(5)));
+  std::vector<int> block_ids(12, -1);
+  for (std::size_t i = 0; i < clustering.size(); ++i) {
+    for (const NodeId node : clustering[i]) {
+      ASSERT_EQ(block_ids[node], -1);
+      block_ids[node] = i;
+    }
+  }
+  for (const auto& [u, v, weight] : SortedWeightedEdges(graph)) {
+    EXPECT_EQ(block_ids[u], block_ids[v]);
+  }
+  EXPECT_THAT(SortedWeightedEdges(graph), SizeIs(3 + 6 + 10));
+}
+
+TEST(StochasticBlockModelTest, InterBlockWeightFactor) {
+  StochasticBlockModelConfig config;
+  config.block_sizes = {2, 1};
+  config.intra_block_probability = 1.0;
+  config.inter_block_probability = 1.0;
+  config.inter_block_weight_factor = 0.25;
+  config.permute_node_ids = false;
+  GeneratorOptions options;
+  options.min_weight = 2.0;
+  options.max_weight = 2.0;
+  SimpleUndirectedGraph graph;
+  ASSERT_OK(StochasticBlockModel(config, options, graph).status());
+  EXPECT_THAT(SortedWeightedEdges(graph),
+              UnorderedElementsAre(std::make_tuple(0, 1, 2.0),
+                                   std::make_tuple(0, 2, 0.5),
+                                   std::make_tuple(1, 2, 0.5)));
+}
+
+TEST(StochasticBlockModelTest, IsDeterministicGivenSeed) {
+  StochasticBlockModelConfig config;
+  config.block_sizes = {50, 70, 30};
+  config.intra_block_probability = 0.3;
+  config.inter_block_probability = 0.02;
+  GeneratorOptions options;
+  options.seed = 4;
+  options.min_weight = 0.5;
+  options.max_weight = 1.0;
+  SimpleUndirectedGraph graph_a;
+  ASSERT_OK_AND_ASSIGN(Clustering clustering_a,
+                       StochasticBlockModel(config, options, graph_a));
+  for (const int num_workers : {1, 2, 4}) {
+    SimpleUndirectedGraph graph_b;
+    Clustering clustering_b;
+    RunWithNumWorkers(num_workers, [&] {
+      ASSERT_OK_AND_ASSIGN(clustering_b,
+                           StochasticBlockModel(config, options, graph_b));
+    });
+    EXPECT_EQ(clustering_a, clustering_b) << num_workers << " workers";
+    EXPECT_EQ(SortedWeightedEdges(graph_a), SortedWeightedEdges(graph_b))
+        << num_workers << " workers";
+  }
+}
+
+TEST(StochasticBlockModelTest, InvalidProbabilityIsAnError) {
+  StochasticBlockModelConfig config;
+  config.block_sizes = {3};
+  config.intra_block_probability = 1.5;
+  SimpleUndirectedGraph graph;
+  EXPECT_EQ(
+      StochasticBlockModel(config, GeneratorOptions(), graph).status().code(),
+      absl::StatusCode::kInvalidArgument);
+}
+
+}  // namespace
+}  // namespace graph_mining::in_memory
@@ -0,0 +1,165 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/kcore/parallel_kcore.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
+#include "gbbs/bridge.h"
+#include "gbbs/graph.h"
+#include "gbbs/macros.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/parallel/peeling_buckets.h"
+#include "in_memory/parallel/scheduler.h"
+#include "in_memory/status_macros.h"
+#include "parlay/parallel.h"
+#include "parlay/primitives.h"
+#include "parlay/sequence.h"
+#include "utils/status/thread_safe_status.h"
+
+namespace graph_mining::in_memory {
+
+using ::gbbs::uintE;
+
+absl::StatusOr<std::vector<uint32_t>> ParallelKCore::Run() const {
+  if (graph_.Graph() == nullptr) {
+    return absl::FailedPreconditionError(
+        "graph_ must be initialized before computing the k-core "
+        "decomposition.");
+  }
+  auto& graph = *graph_.Graph();
+  const std::size_t num_nodes = graph.n;
+  auto degrees = parlay::sequence<uintE>::from_function(
+      num_nodes, [&](std::size_t i) -> uintE {
+        auto neighbors = graph.get_vertex(i).out_neighbors();
+        uintE degree = 0;
+        for (std::size_t j = 0; j < neighbors.get_degree(); ++j) {
+          if (neighbors.get_neighbor(j) != i) ++degree;
+        }
+        return degree;
+      });
+  parlay::sequence<bool> is_removed(num_nodes, false);
+  std::vector<uint32_t> coreness(num_nodes);
+
+  // Each bucket k is peeled in rounds: the nodes of degree k are removed in
+  // parallel, and their neighbors whose degree drops to k form the next round.
+  // The neighbors whose degree drops to a larger value move to its bucket.
+  PeelingBuckets<uintE> buckets(degrees);
+  parlay::sequence<std::uint8_t> is_moved(num_nodes, 0);
+  while (true) {
+    auto bucket = buckets.NextBucket([&](uintE node, uintE key) {
+      return !is_removed[node] && degrees[node] == key;
+    });
+    const uintE k = bucket.first;
+    parlay::sequence<uintE> frontier = std::move(bucket.second);
+    if (frontier.empty()) break;
+    while (!frontier.empty()) {
+      parlay::parallel_for(0, frontier.size(), [&](std::size_t i) {
+        is_removed[frontier[i]] = true;
+        coreness[frontier[i]] = k;
+      });
+      // Every node whose degree drops to k is added by exactly one of its
+      // removed neighbors, and every other node whose degree drops is
+      // collected once.
+      parlay::sequence<parlay::sequence<uintE>> next_frontiers(
+          frontier.size());
+      parlay::sequence<parlay::sequence<uintE>> moved_nodes(frontier.size());
+      parlay::parallel_for(0, frontier.size(), [&](std::size_t i) {
+        auto neighbors = graph.get_vertex(frontier[i]).out_neighbors();
+        for (std::size_t j = 0; j < neighbors.get_degree(); ++j) {
+          const uintE neighbor = neighbors.get_neighbor(j);
+          if (is_removed[neighbor]) continue;
+          if (DecrementToFloor(&degrees[neighbor], k)) {
+            next_frontiers[i].push_back(neighbor);
+          } else if (gbbs::atomic_compare_and_swap(
+                         &is_moved[neighbor], std::uint8_t{0},
+                         std::uint8_t{1})) {
+            moved_nodes[i].push_back(neighbor);
+          }
+        }
+      });
+      frontier = parlay::flatten(next_frontiers);
+      auto moved = parlay::flatten(moved_nodes);
+      parlay::parallel_for(0, moved.size(),
+                           [&](std::size_t i) { is_moved[moved[i]] = 0; });
+      buckets.Insert(
+          parlay::filter(moved, [&](uintE node) { return degrees[node] > k; }),
+          [&](uintE node) { return degrees[node]; });
+    }
+  }
+  return coreness;
+}
+
+absl::StatusOr<std::vector<InMemoryClusterer::NodeId>>
+ParallelKCore::ImportKCore(uint32_t k, InMemoryClusterer::Graph* subgraph,
+                           absl::Span<const uint32_t> coreness) const {
+  if (graph_.Graph() == nullptr) {
+    return absl::FailedPreconditionError(
+        "graph_ must be initialized before computing the k-core "
+        "decomposition.");
+  }
+  std::vector<uint32_t> computed_coreness;
+  if (coreness.empty()) {
+    ASSIGN_OR_RETURN(computed_coreness, Run());
+    coreness = computed_coreness;
+  }
+  auto& graph = *graph_.Graph();
+  const std::size_t num_nodes = graph.n;
+  if (coreness.size() != num_nodes) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Got coreness of ", coreness.size(), " nodes for ", num_nodes,
+        " nodes"));
+  }
+  // new_ids[i] is the id of node i in the subgraph if it is in the k-core.
+  auto new_ids = parlay::sequence<InMemoryClusterer::NodeId>::from_function(
+      num_nodes, [&](std::size_t i) -> InMemoryClusterer::NodeId {
+        return coreness[i] >= k ? 1 : 0;
+      });
+  const std::size_t num_subgraph_nodes = parlay::scan_inplace(new_ids);
+  std::vector<InMemoryClusterer::NodeId> original_ids(num_subgraph_nodes);
+  parlay::parallel_for(0, num_nodes, [&](std::size_t i) {
+    if (coreness[i] >= k) original_ids[new_ids[i]] = i;
+  });
+
+  RETURN_IF_ERROR(subgraph->PrepareImport(num_subgraph_nodes));
+  ThreadSafeStatus import_status;
+  parlay::parallel_for(0, num_subgraph_nodes, [&](std::size_t i) {
+    const InMemoryClusterer::NodeId node = original_ids[i];
+    InMemoryClusterer::AdjacencyList adjacency_list;
+    adjacency_list.id = i;
+    adjacency_list.weight =
+        graph.vertex_weights == nullptr ? 1.0 : graph.vertex_weights[node];
+    auto neighbors = graph.get_vertex(node).out_neighbors();
+    for (std::size_t j = 0; j < neighbors.get_degree(); ++j) {
+      const uintE neighbor = neighbors.get_neighbor(j);
+      if (coreness[neighbor] >= k) {
+        adjacency_list.outgoing_edges.emplace_back(new_ids[neighbor],
+                                                   neighbors.get_weight(j));
+      }
+    }
+    import_status.Update(subgraph->Import(std::move(adjacency_list)));
+  });
+  RETURN_IF_ERROR(import_status.status());
+  RETURN_IF_ERROR(subgraph->FinishImport());
+  return original_ids;
+}
+
+}  // namespace graph_mining::in_memory
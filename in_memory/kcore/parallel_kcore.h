@@ -0,0 +1,62 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_KCORE_PARALLEL_KCORE_H_
+#define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_KCORE_PARALLEL_KCORE_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+
+namespace graph_mining::in_memory {
+
+// Parallel k-core decomposition. The k-core of an undirected graph is its
+// largest induced subgraph in which every node has degree at least k, and the
+// coreness of a node is the largest k such that the node is in the k-core.
+class ParallelKCore {
+ public:
+  ::graph_mining::in_memory::InMemoryClusterer::Graph* MutableGraph() {
+    return &graph_;
+  }
+
+  // Returns the coreness of each node of `graph_`, which must be symmetric and
+  // must not have parallel edges. Self-loops and edge weights are ignored.
+  //
+  // Nodes are bucketed by their remaining degree and the buckets are peeled in
+  // increasing order of k in rounds: the nodes of degree k are removed in
+  // parallel, which may lower the degrees of their neighbors to k and so add
+  // them to the next round of the same k.
+  absl::StatusOr<std::vector<uint32_t>> Run() const;
+
+  // Imports the subgraph of `graph_` induced by the nodes with coreness at
+  // least k into `subgraph`, calling PrepareImport, Import and FinishImport.
+  // Edge and node weights are kept. The nodes of the subgraph are numbered
+  // consecutively in the order of their ids in `graph_`, and the result maps
+  // each of them to its id in `graph_`. If coreness is empty, it is computed
+  // by Run().
+  absl::StatusOr<std::vector<InMemoryClusterer::NodeId>> ImportKCore(
+      uint32_t k, InMemoryClusterer::Graph* subgraph,
+      absl::Span<const uint32_t> coreness = {}) const;
+
+ private:
+  ::graph_mining::in_memory::GbbsGraph graph_;
+};
+
+}  // namespace graph_mining::in_memory
+
+#endif  // THIRD_PARTY_GRAPH_MINING_IN_MEMORY_KCORE_PARALLEL_KCORE_H_
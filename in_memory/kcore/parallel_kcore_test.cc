@@ -0,0 +1,75 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/kcore/parallel_kcore.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/graph.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/status_macros.h"  // IWYU pragma: keep
+
+namespace graph_mining::in_memory {
+namespace {
+
+using ::testing::ElementsAre;
+
+// Returns the path 0 - 1 - 2 - 3 whose last node is part of a clique on the
+// nodes 3, 4, 5 and 6.
+absl::Status MakePathWithClique(InMemoryClusterer::Graph* graph) {
+  SimpleUndirectedGraph path_with_clique;
+  for (int i = 0; i < 3; ++i) {
+    RETURN_IF_ERROR(path_with_clique.AddEdge(i, i + 1, 1.0));
+  }
+  for (int i = 3; i < 7; ++i) {
+    for (int j = i + 1; j < 7; ++j) {
+      RETURN_IF_ERROR(path_with_clique.AddEdge(i, j, 1.0));
+    }
+  }
+  return CopyGraph(path_with_clique, graph);
+}
+
+TEST(ParallelKCoreTest, CorenessOfPathAndClique) {
+  ParallelKCore kcore;
+  ASSERT_OK(MakePathWithClique(kcore.MutableGraph()));
+  ASSERT_OK_AND_ASSIGN(std::vector<uint32_t> coreness, kcore.Run());
+  EXPECT_THAT(coreness, ElementsAre(1, 1, 1, 3, 3, 3, 3));
+}
+
+TEST(ParallelKCoreTest, ImportsKCore) {
+  ParallelKCore kcore;
+  ASSERT_OK(MakePathWithClique(kcore.MutableGraph()));
+  GbbsGraph subgraph;
+  ASSERT_OK_AND_ASSIGN(std::vector<InMemoryClusterer::NodeId> original_ids,
+                       kcore.ImportKCore(3, &subgraph));
+  EXPECT_THAT(original_ids, ElementsAre(3, 4, 5, 6));
+  ASSERT_EQ(subgraph.Graph()->n, 4);
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(subgraph.Graph()->get_vertex(i).out_degree(), 3);
+  }
+}
+
+TEST(ParallelKCoreTest, UninitializedGraphIsAnError) {
+  ParallelKCore kcore;
+  EXPECT_EQ(kcore.Run().status().code(),
+            absl::StatusCode::kFailedPrecondition);
+}
+
+}  // namespace
+}  // namespace graph_mining::in_memory
@@ -0,0 +1,216 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/ktruss/parallel_ktruss.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "gbbs/bridge.h"
+#include "gbbs/graph.h"
+#include "gbbs/macros.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/parallel/peeling_buckets.h"
+#include "in_memory/parallel/scheduler.h"
+#include "in_memory/triangle_counting/oriented_graph.h"
+#include "parlay/parallel.h"
+#include "parlay/primitives.h"
+#include "parlay/sequence.h"
+
+namespace graph_mining::in_memory {
+namespace {
+
+using ::gbbs::uintE;
+
+enum EdgeState : uint8_t { kAlive, kInFrontier, kRemoved };
+
+// Returns the position of node in the sorted neighbors, or their degree if node
+// is not a neighbor.
+template <typename Neighbors>
+std::size_t FindNeighbor(Neighbors& neighbors, uintE node) {
+  std::size_t begin = 0;
+  std::size_t end = neighbors.get_degree();
+  while (begin < end) {
+    const std::size_t middle = begin + (end - begin) / 2;
+    if (neighbors.get_neighbor(middle) < node) {
+      begin = middle + 1;
+    } else {
+      end = middle;
+    }
+  }
+  return begin < neighbors.get_degree() && neighbors.get_neighbor(begin) == node
+             ? begin
+             : neighbors.get_degree();
+}
+
+}  // namespace
+
+absl::StatusOr<std::vector<EdgeTrussness>> ParallelKTruss::Run() const {
+  if (graph_.Graph() == nullptr) {
+    return absl::FailedPreconditionError(
+        "graph_ must be initialized before computing the k-truss "
+        "decomposition.");
+  }
+  auto& graph = *graph_.Graph();
+  const std::size_t num_nodes = graph.n;
+  const auto oriented_graph = DegreeOrientedGraph::Create(graph);
+  const std::size_t num_edges = oriented_graph.NumEdges();
+  const auto& offsets = oriented_graph.offsets();
+  const auto& targets = oriented_graph.targets();
+  auto sources = parlay::sequence<uintE>::uninitialized(num_edges);
+  parlay::parallel_for(0, num_nodes, [&](std::size_t i) {
+    for (std::size_t e = offsets[i]; e < offsets[i + 1]; ++e) sources[e] = i;
+  });
+  parlay::sequence<uintE> supports = oriented_graph.CountTrianglesPerEdge();
+
+  // adjacency_edges[adjacency_offsets[i] + j] is the index of the edge to the
+  // j-th neighbor of node i in oriented_graph, so that triangles found in the
+  // neighbor lists need no further edge lookups. Self-loops are unused.
+  auto adjacency_offsets = parlay::sequence<std::size_t>::from_function(
+      num_nodes + 1, [&](std::size_t i) -> std::size_t {
+        return i == num_nodes ? 0 : graph.get_vertex(i).out_degree();
+      });
+  const std::size_t num_adjacency_entries =
+      parlay::scan_inplace(adjacency_offsets);
+  auto adjacency_edges =
+      parlay::sequence<std::size_t>::uninitialized(num_adjacency_entries);
+  parlay::parallel_for(0, num_nodes, [&](std::size_t i) {
+    auto neighbors = graph.get_vertex(i).out_neighbors();
+    for (std::size_t j = 0; j < neighbors.get_degree(); ++j) {
+      const uintE neighbor = neighbors.get_neighbor(j);
+      adjacency_edges[adjacency_offsets[i] + j] =
+          neighbor == i ? num_edges : oriented_graph.EdgeIndex(i, neighbor);
+    }
+  });
+
+  parlay::sequence<EdgeState> states(num_edges, kAlive);
+  parlay::sequence<uint32_t> trussness(num_edges);
+
+  // Same bucketed peeling as in ParallelKCore, with edges instead of nodes and
+  // triangle counts instead of degrees.
+  PeelingBuckets<std::size_t> buckets(supports);
+  parlay::sequence<std::uint8_t> is_moved(num_edges, 0);
+  while (true) {
+    auto bucket = buckets.NextBucket([&](std::size_t edge, uintE key) {
+      return states[edge] == kAlive && supports[edge] == key;
+    });
+    const uintE s = bucket.first;
+    parlay::sequence<std::size_t> frontier = std::move(bucket.second);
+    if (frontier.empty()) break;
+    while (!frontier.empty()) {
+      parlay::parallel_for(0, frontier.size(), [&](std::size_t i) {
+        states[frontier[i]] = kInFrontier;
+      });
+      // A triangle loses its other two edges if they are alive. If one of them
+      // is also in the frontier, only the frontier edge with the smaller index
+      // decrements the third edge.
+      parlay::sequence<parlay::sequence<std::size_t>> next_frontiers(
+          frontier.size());
+      parlay::sequence<parlay::sequence<std::size_t>> moved_edges(
+          frontier.size());
+      parlay::parallel_for(0, frontier.size(), [&](std::size_t i) {
+        const std::size_t edge = frontier[i];
+        const uintE u = sources[edge];
+        const uintE v = targets[edge];
+        auto decrement = [&](std::size_t other_edge) {
+          if (DecrementToFloor(&supports[other_edge], s)) {
+            next_frontiers[i].push_back(other_edge);
+          } else if (gbbs::atomic_compare_and_swap(&is_moved[other_edge],
+                                                   std::uint8_t{0},
+                                                   std::uint8_t{1})) {
+            moved_edges[i].push_back(other_edge);
+          }
+        };
+        // The triangles of the edge are found by scanning the neighbors of its
+        // endpoint x with the lower degree and searching each of them among
+        // the sorted neighbors of the other endpoint y, so that removing all
+        // edges costs O(sum of min(d(u), d(v)) log(max degree)) instead of
+        // O(sum of d(u) + d(v)).
+        uintE x = u;
+        uintE y = v;
+        if (graph.get_vertex(x).out_degree() >
+            graph.get_vertex(y).out_degree()) {
+          std::swap(x, y);
+        }
+        auto x_neighbors = graph.get_vertex(x).out_neighbors();
+        auto y_neighbors = graph.get_vertex(y).out_neighbors();
+        for (std::size_t j = 0; j < x_neighbors.get_degree(); ++j) {
+          const uintE w = x_neighbors.get_neighbor(j);
+          if (w == x || w == y) continue;
+          const std::size_t k = FindNeighbor(y_neighbors, w);
+          if (k == y_neighbors.get_degree()) continue;
+          const std::size_t xw = adjacency_edges[adjacency_offsets[x] + j];
+          const std::size_t yw = adjacency_edges[adjacency_offsets[y] + k];
+          const EdgeState xw_state = states[xw];
+          const EdgeState yw_state = states[yw];
+          if (xw_state == kRemoved || yw_state == kRemoved) continue;
+          if (xw_state == kAlive && yw_state == kAlive) {
+            decrement(xw);
+            decrement(yw);
+          } else if (xw_state == kAlive && edge < yw) {
+            decrement(xw);
+          } else if (yw_state == kAlive && edge < xw) {
+            decrement(yw);
+          }
+        }
+      });
+      parlay::parallel_for(0, frontier.size(), [&](std::size_t i) {
+        states[frontier[i]] = kRemoved;
+        trussness[frontier[i]] = s + 2;
+      });
+      frontier = parlay::flatten(next_frontiers);
+      auto moved = parlay::flatten(moved_edges);
+      parlay::parallel_for(0, moved.size(),
+                           [&](std::size_t i) { is_moved[moved[i]] = 0; });
+      buckets.Insert(parlay::filter(moved,
+                                    [&](std::size_t edge) {
+                                      return supports[edge] > s;
+                                    }),
+                     [&](std::size_t edge) { return supports[edge]; });
+    }
+  }
+
+  // Every edge is listed by its endpoint with the smaller id. As the
+  // neighbors are sorted, these are the last neighbors of each node.
+  auto output_offsets = parlay::sequence<std::size_t>::from_function(
+      num_nodes, [&](std::size_t i) -> std::size_t {
+        auto neighbors = graph.get_vertex(i).out_neighbors();
+        std::size_t num_larger_neighbors = 0;
+        for (std::size_t j = 0; j < neighbors.get_degree(); ++j) {
+          if (neighbors.get_neighbor(j) > i) ++num_larger_neighbors;
+        }
+        return num_larger_neighbors;
+      });
+  parlay::scan_inplace(output_offsets);
+  std::vector<EdgeTrussness> result(num_edges);
+  parlay::parallel_for(0, num_nodes, [&](std::size_t i) {
+    auto neighbors = graph.get_vertex(i).out_neighbors();
+    std::size_t position = output_offsets[i];
+    for (std::size_t j = 0; j < neighbors.get_degree(); ++j) {
+      const uintE neighbor = neighbors.get_neighbor(j);
+      if (neighbor <= i) continue;
+      result[position++] = {
+          static_cast<InMemoryClusterer::NodeId>(i),
+          static_cast<InMemoryClusterer::NodeId>(neighbor),
+          trussness[adjacency_edges[adjacency_offsets[i] + j]]};
+    }
+  });
+  return result;
+}
+
+}  // namespace graph_mining::in_memory
@@ -0,0 +1,63 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_KTRUSS_PARALLEL_KTRUSS_H_
+#define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_KTRUSS_PARALLEL_KTRUSS_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+
+namespace graph_mining::in_memory {
+
+// Trussness of the edge {node_a, node_b}.
+struct EdgeTrussness {
+  InMemoryClusterer::NodeId node_a;
+  InMemoryClusterer::NodeId node_b;
+  uint32_t trussness;
+};
+
+// Parallel k-truss decomposition. The k-truss of an undirected graph is its
+// largest subgraph in which every edge is contained in at least k - 2
+// triangles, and the trussness of an edge is the largest k such that the edge
+// is in the k-truss. Every edge has trussness at least 2.
+class ParallelKTruss {
+ public:
+  ::graph_mining::in_memory::InMemoryClusterer::Graph* MutableGraph() {
+    return &graph_;
+  }
+
+  // Returns the trussness of each edge of `graph_`, which must be symmetric and
+  // must not have parallel edges. Self-loops are ignored. Every edge is listed
+  // once with node_a < node_b, and the result is sorted by (node_a, node_b).
+  //
+  // Edges are bucketed by their remaining triangle count and the buckets are
+  // peeled in increasing order of s in rounds: the edges of triangle count s
+  // are removed in parallel, which may lower the triangle counts of the other
+  // edges of their triangles to s and so add them to the next round of the
+  // same s.
+  absl::StatusOr<std::vector<EdgeTrussness>> Run() const;
+
+ private:
+  // Neighbor lists are sorted so that the triangles of an edge can be found by
+  // binary search.
+  ::graph_mining::in_memory::UnweightedSortedNeighborGbbsGraph graph_;
+};
+
+}  // namespace graph_mining::in_memory
+
+#endif  // THIRD_PARTY_GRAPH_MINING_IN_MEMORY_KTRUSS_PARALLEL_KTRUSS_H_
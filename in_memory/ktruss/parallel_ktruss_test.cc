@@ -0,0 +1,70 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/ktruss/parallel_ktruss.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "in_memory/clustering/graph.h"
+#include "in_memory/status_macros.h"  // IWYU pragma: keep
+
+namespace graph_mining::in_memory {
+namespace {
+
+using ::testing::AllOf;
+using ::testing::ElementsAre;
+using ::testing::Field;
+
+testing::Matcher<EdgeTrussness> Trussness(int node_a, int node_b,
+                                          uint32_t trussness) {
+  return AllOf(Field(&EdgeTrussness::node_a, node_a),
+               Field(&EdgeTrussness::node_b, node_b),
+               Field(&EdgeTrussness::trussness, trussness));
+}
+
+TEST(ParallelKTrussTest, TrussnessOfCliqueTriangleAndPendant) {
+  // A clique on the nodes 0, 1, 2 and 3, the triangle 3, 4, 5 and the pendant
+  // edge {5, 6}.
+  SimpleUndirectedGraph graph;
+  for (int i = 0; i < 4; ++i) {
+    for (int j = i + 1; j < 4; ++j) ASSERT_OK(graph.AddEdge(i, j, 1.0));
+  }
+  ASSERT_OK(graph.AddEdge(3, 4, 1.0));
+  ASSERT_OK(graph.AddEdge(3, 5, 1.0));
+  ASSERT_OK(graph.AddEdge(4, 5, 1.0));
+  ASSERT_OK(graph.AddEdge(5, 6, 1.0));
+  ParallelKTruss ktruss;
+  ASSERT_OK(CopyGraph(graph, ktruss.MutableGraph()));
+
+  ASSERT_OK_AND_ASSIGN(std::vector<EdgeTrussness> result, ktruss.Run());
+  EXPECT_THAT(result,
+              ElementsAre(Trussness(0, 1, 4), Trussness(0, 2, 4),
+                          Trussness(0, 3, 4), Trussness(1, 2, 4),
+                          Trussness(1, 3, 4), Trussness(2, 3, 4),
+                          Trussness(3, 4, 3), Trussness(3, 5, 3),
+                          Trussness(4, 5, 3), Trussness(5, 6, 2)));
+}
+
+TEST(ParallelKTrussTest, UninitializedGraphIsAnError) {
+  ParallelKTruss ktruss;
+  EXPECT_EQ(ktruss.Run().status().code(),
+            absl::StatusCode::kFailedPrecondition);
+}
+
+}  // namespace
+}  // namespace graph_mining::in_memory
@@ -0,0 +1,212 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/pagerank/local_pagerank.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/pagerank/pagerank.pb.h"
+#include "in_memory/parallel/per_worker.h"
+#include "parlay/parallel.h"
+#include "parlay/sequence.h"
+#include "utils/status/thread_safe_status.h"
+
+namespace graph_mining::in_memory {
+namespace {
+
+using NodeId = InMemoryClusterer::NodeId;
+
+// Residual and score of a node in a single query.
+struct NodeMass {
+  double residual = 0;
+  double score = 0;
+};
+
+// Sparse state of a single query. Each worker reuses its state across queries;
+// see ResetPushState for how the map keeps its capacity.
+struct PushState {
+  absl::flat_hash_map<NodeId, NodeMass> masses;
+  // Keys of masses in insertion order, so that the scores are collected and
+  // the map is reset in time proportional to the work of the query rather
+  // than to the capacity of the map, which grows to fit the largest query.
+  std::vector<NodeId> touched;
+  // Nodes whose residual reached the threshold, in the order of pushes.
+  std::vector<NodeId> queue;
+
+  // Returns the mass of node_id, inserting it if needed.
+  NodeMass& Touch(NodeId node_id) {
+    auto [it, inserted] = masses.try_emplace(node_id);
+    if (inserted) touched.push_back(node_id);
+    return it->second;
+  }
+};
+
+absl::Status ValidateSeeds(const WeightedNodes& seeds, std::size_t num_nodes) {
+  if (seeds.empty()) {
+    return absl::InvalidArgumentError("Seed sets must not be empty");
+  }
+  for (const auto& [node_id, weight] : seeds) {
+    if (node_id < 0 || static_cast<std::size_t>(node_id) >= num_nodes) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Invalid seed node id: ", node_id));
+    }
+    if (!(weight > 0)) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Seed weights must be positive, got ", weight, " for ", node_id));
+    }
+  }
+  return absl::OkStatus();
+}
+
+// Empties `state` without releasing its storage. flat_hash_map::clear frees the
+// backing array of maps with a capacity above 127, whereas erasing the entries
+// keeps it, so that a worker does not reallocate the map for every query.
+void ResetPushState(PushState& state) {
+  for (const NodeId node_id : state.touched) state.masses.erase(node_id);
+  state.touched.clear();
+  state.queue.clear();
+}
+
+// Runs the push procedure for a single seed set and returns its top-k scores.
+WeightedNodes PushFromSeeds(const GbbsGraph& graph,
+                            const parlay::sequence<double>& weighted_degrees,
+                            const WeightedNodes& seeds,
+                            const LocalPageRankConfig& config,
+                            PushState& state) {
+  ResetPushState(state);
+  const double damping = config.damping_factor();
+  const double epsilon = config.epsilon();
+  // Nodes without edges use a threshold of epsilon.
+  auto is_above_threshold = [&](NodeId node_id, double residual) {
+    const double weighted_degree = weighted_degrees[node_id];
+    return residual >= epsilon * (weighted_degree > 0 ? weighted_degree : 1);
+  };
+
+  double total_seed_weight = 0;
+  for (const auto& [node_id, weight] : seeds) total_seed_weight += weight;
+  for (const auto& [node_id, weight] : seeds) {
+    state.Touch(node_id).residual += weight / total_seed_weight;
+  }
+  for (const NodeId node_id : state.touched) {
+    if (is_above_threshold(node_id, state.masses[node_id].residual)) {
+      state.queue.push_back(node_id);
+    }
+  }
+
+  for (std::size_t head = 0; head < state.queue.size(); ++head) {
+    const NodeId node_id = state.queue[head];
+    NodeMass& node_mass = state.masses[node_id];
+    const double residual = node_mass.residual;
+    node_mass.residual = 0;
+    const double weighted_degree = weighted_degrees[node_id];
+    if (weighted_degree == 0) {
+      node_mass.score += residual;
+      continue;
+    }
+    node_mass.score += (1 - damping) * residual;
+    const double residual_per_weight = damping * residual / weighted_degree;
+    auto neighbors = graph.Graph()->get_vertex(node_id).out_neighbors();
+    for (std::size_t i = 0; i < neighbors.get_degree(); ++i) {
+      const NodeId neighbor_id = neighbors.get_neighbor(i);
+      double& neighbor_residual = state.Touch(neighbor_id).residual;
+      const bool was_above_threshold =
+          is_above_threshold(neighbor_id, neighbor_residual);
+      neighbor_residual += residual_per_weight * neighbors.get_weight(i);
+      if (!was_above_threshold &&
+          is_above_threshold(neighbor_id, neighbor_residual)) {
+        state.queue.push_back(neighbor_id);
+      }
+    }
+  }
+
+  // Only pushed nodes have a score, which is then positive.
+  WeightedNodes result;
+  for (const NodeId node_id : state.touched) {
+    const double score = state.masses[node_id].score;
+    if (score > 0) result.emplace_back(node_id, score);
+  }
+  auto higher_score = [](const std::pair<NodeId, double>& a,
+                         const std::pair<NodeId, double>& b) {
+    return a.second > b.second || (a.second == b.second && a.first < b.first);
+  };
+  if (config.top_k() > 0 &&
+      result.size() > static_cast<std::size_t>(config.top_k())) {
+    std::partial_sort(result.begin(), result.begin() + config.top_k(),
+                      result.end(), higher_score);
+    result.resize(config.top_k());
+  } else {
+    std::sort(result.begin(), result.end(), higher_score);
+  }
+  return result;
+}
+
+}  // namespace
+
+absl::StatusOr<std::vector<WeightedNodes>> ComputeLocalPageRank(
+    const GbbsGraph& graph, absl::Span<const WeightedNodes> seed_sets,
+    const LocalPageRankConfig& config) {
+  if (graph.Graph() == nullptr) {
+    return absl::FailedPreconditionError(
+        "graph must be initialized before running local PageRank.");
+  }
+  if (!(config.damping_factor() >= 0 && config.damping_factor() < 1)) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "damping_factor must be in [0, 1), got ", config.damping_factor()));
+  }
+  if (!(config.epsilon() > 0)) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("epsilon must be positive, got ", config.epsilon()));
+  }
+  const std::size_t num_nodes = graph.Graph()->n;
+  auto weighted_degrees = parlay::sequence<double>::from_function(
+      num_nodes, [&](std::size_t i) {
+        auto neighbors = graph.Graph()->get_vertex(i).out_neighbors();
+        double weighted_degree = 0;
+        for (std::size_t j = 0; j < neighbors.get_degree(); ++j) {
+          weighted_degree += neighbors.get_weight(j);
+        }
+        return weighted_degree;
+      });
+
+  std::vector<WeightedNodes> results(seed_sets.size());
+  PerWorker<PushState> push_states;
+  ThreadSafeStatus status;
+  parlay::parallel_for(
+      0, seed_sets.size(),
+      [&](std::size_t i) {
+        const absl::Status seeds_status =
+            ValidateSeeds(seed_sets[i], num_nodes);
+        if (!seeds_status.ok()) {
+          status.Update(seeds_status);
+          return;
+        }
+        results[i] = PushFromSeeds(graph, weighted_degrees, seed_sets[i],
+                                   config, push_states.Get());
+      },
+      /*granularity=*/1);
+  if (!status.status().ok()) return status.status();
+  return results;
+}
+
+}  // namespace graph_mining::in_memory
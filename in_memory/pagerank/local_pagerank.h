@@ -0,0 +1,53 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_PAGERANK_LOCAL_PAGERANK_H_
+#define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_PAGERANK_LOCAL_PAGERANK_H_
+
+#include <utility>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/pagerank/pagerank.pb.h"
+
+namespace graph_mining::in_memory {
+
+// Nodes with weights, e.g., seed nodes or PageRank scores.
+using WeightedNodes = std::vector<std::pair<InMemoryClusterer::NodeId, double>>;
+
+// Approximates personalized PageRank for each of the given seed sets with the
+// forward push algorithm of Andersen, Chung and Lang ("Local graph
+// partitioning using PageRank vectors", FOCS 2006) on an undirected weighted
+// graph. The walk restarts at a seed node with probability proportional to its
+// weight in the seed set and moves to a neighbor with probability
+// proportional to the edge weight. A node without edges keeps its mass.
+//
+// Queries are processed in parallel, each by a single worker using that
+// worker's sparse map of residuals and scores, so the work of a query depends
+// only on config.epsilon() and not on the size of the graph (except for a
+// single pass to compute weighted degrees per call). For each query, returns
+// the config.top_k() nodes with the highest scores in decreasing order of
+// score (ties are broken by node id). Returns an error if a seed set is empty,
+// has an invalid node id or a non-positive weight, or if the config is
+// invalid.
+absl::StatusOr<std::vector<WeightedNodes>> ComputeLocalPageRank(
+    const GbbsGraph& graph, absl::Span<const WeightedNodes> seed_sets,
+    const LocalPageRankConfig& config);
+
+}  // namespace graph_mining::in_memory
+
+#endif  // THIRD_PARTY_GRAPH_MINING_IN_MEMORY_PAGERANK_LOCAL_PAGERANK_H_
@@ -0,0 +1,255 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/pagerank/local_pagerank.h"
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/pagerank/pagerank.pb.h"
+#include "in_memory/status_macros.h"  // IWYU pragma: keep
+
+namespace graph_mining::in_memory {
+namespace {
+
+using ::absl::StatusCode;
+using ::testing::DoubleNear;
+using ::testing::ElementsAre;
+using ::testing::Pair;
+
+using Edge = std::tuple<int, int, float>;
+
+// Undirected weighted graph with an isolated node 6.
+constexpr int kNumNodes = 7;
+const std::vector<Edge>& TestEdges() {
+  static const auto* const kEdges = new std::vector<Edge>{
+      {0, 1, 1}, {0, 2, 2}, {1, 2, 1}, {2, 3, 1},
+      {3, 4, 3}, {4, 5, 1}, {3, 5, 1}};
+  return *kEdges;
+}
+
+// Imports both directions of each edge into graph.
+absl::Status ImportEdges(int num_nodes, const std::vector<Edge>& edges,
+                         GbbsGraph& graph) {
+  std::vector<InMemoryClusterer::AdjacencyList> adjacency_lists(num_nodes);
+  for (int i = 0; i < num_nodes; ++i) adjacency_lists[i].id = i;
+  for (const auto& [node_a, node_b, weight] : edges) {
+    adjacency_lists[node_a].outgoing_edges.emplace_back(node_b, weight);
+    adjacency_lists[node_b].outgoing_edges.emplace_back(node_a, weight);
+  }
+  RETURN_IF_ERROR(graph.PrepareImport(num_nodes));
+  for (auto& adjacency_list : adjacency_lists) {
+    RETURN_IF_ERROR(graph.Import(std::move(adjacency_list)));
+  }
+  return graph.FinishImport();
+}
+
+std::vector<double> WeightedDegrees(int num_nodes,
+                                    const std::vector<Edge>& edges) {
+  std::vector<double> weighted_degrees(num_nodes, 0);
+  for (const auto& [node_a, node_b, weight] : edges) {
+    weighted_degrees[node_a] += weight;
+    weighted_degrees[node_b] += weight;
+  }
+  return weighted_degrees;
+}
+
+// Personalized PageRank by dense power iterations, for graphs without isolated
+// nodes.
+std::vector<double> BruteForcePersonalizedPageRank(
+    int num_nodes, const std::vector<Edge>& edges, const WeightedNodes& seeds,
+    double damping) {
+  const std::vector<double> weighted_degrees =
+      WeightedDegrees(num_nodes, edges);
+  std::vector<double> restart(num_nodes, 0);
+  double total_seed_weight = 0;
+  for (const auto& [node_id, weight] : seeds) total_seed_weight += weight;
+  for (const auto& [node_id, weight] : seeds) {
+    restart[node_id] += weight / total_seed_weight;
+  }
+  std::vector<double> scores = restart;
+  for (int iteration = 0; iteration < 500; ++iteration) {
+    std::vector<double> next_scores(num_nodes);
+    for (int i = 0; i < num_nodes; ++i) {
+      next_scores[i] = (1 - damping) * restart[i];
+    }
+    for (const auto& [node_a, node_b, weight] : edges) {
+      next_scores[node_b] +=
+          damping * scores[node_a] * weight / weighted_degrees[node_a];
+      next_scores[node_a] +=
+          damping * scores[node_b] * weight / weighted_degrees[node_b];
+    }
+    scores = std::move(next_scores);
+  }
+  return scores;
+}
+
+// Returns the dense scores of the given result.
+std::vector<double> DenseScores(int num_nodes, const WeightedNodes& result) {
+  std::vector<double> scores(num_nodes, 0);
+  for (const auto& [node_id, score] : result) scores[node_id] = score;
+  return scores;
+}
+
+LocalPageRankConfig Config(double epsilon, int top_k) {
+  LocalPageRankConfig config;
+  config.set_epsilon(epsilon);
+  config.set_top_k(top_k);
+  return config;
+}
+
+// Checks the guarantee of the push procedure: the scores underestimate
+// personalized PageRank by less than epsilon times the weighted degree.
+void ExpectWithinPushBound(const WeightedNodes& result,
+                           const WeightedNodes& seeds, double epsilon) {
+  // The isolated node is never reached from the other nodes.
+  const int num_nodes = kNumNodes - 1;
+  const std::vector<double> expected = BruteForcePersonalizedPageRank(
+      num_nodes, TestEdges(), seeds, /*damping=*/0.85);
+  const std::vector<double> weighted_degrees =
+      WeightedDegrees(num_nodes, TestEdges());
+  const std::vector<double> scores = DenseScores(num_nodes, result);
+  for (int i = 0; i < num_nodes; ++i) {
+    EXPECT_GE(expected[i] - scores[i], -1e-12) << "node " << i;
+    EXPECT_LT(expected[i] - scores[i], epsilon * weighted_degrees[i])
+        << "node " << i;
+  }
+}
+
+TEST(LocalPageRankTest, SatisfiesPushInvariant) {
+  GbbsGraph graph;
+  ASSERT_OK(ImportEdges(kNumNodes, TestEdges(), graph));
+  for (const double epsilon : {1e-2, 1e-4, 1e-8}) {
+    const WeightedNodes seeds = {{0, 1}};
+    ASSERT_OK_AND_ASSIGN(
+        std::vector<WeightedNodes> results,
+        ComputeLocalPageRank(graph, {seeds}, Config(epsilon, /*top_k=*/0)));
+    ASSERT_EQ(results.size(), 1);
+    ExpectWithinPushBound(results[0], seeds, epsilon);
+    // The mass that was not pushed yet is below the threshold everywhere.
+    double total_score = 0;
+    for (const auto& [node_id, score] : results[0]) total_score += score;
+    double total_weighted_degree = 0;
+    for (const double weighted_degree :
+         WeightedDegrees(kNumNodes, TestEdges())) {
+      total_weighted_degree += weighted_degree;
+    }
+    EXPECT_LE(total_score, 1 + 1e-12);
+    EXPECT_GT(total_score, 1 - epsilon * total_weighted_degree);
+  }
+}
+
+TEST(LocalPageRankTest, StopsWhenResidualsAreBelowEpsilon) {
+  GbbsGraph graph;
+  ASSERT_OK(ImportEdges(kNumNodes, TestEdges(), graph));
+  // Node 0 has weighted degree 3, so its initial residual of 1 is pushed only
+  // if epsilon is at most 1 / 3.
+  ASSERT_OK_AND_ASSIGN(std::vector<WeightedNodes> results,
+                       ComputeLocalPageRank(graph, {{{0, 1}}},
+                                            Config(0.34, /*top_k=*/0)));
+  EXPECT_THAT(results, ElementsAre(ElementsAre()));
+  // After pushing node 0, nodes 1 and 2 have residuals 0.85 / 3 and
+  // 0.85 * 2 / 3, below their thresholds of 0.33 * 2 and 0.33 * 4.
+  ASSERT_OK_AND_ASSIGN(results, ComputeLocalPageRank(graph, {{{0, 1}}},
+                                                     Config(0.33, 0)));
+  EXPECT_THAT(results,
+              ElementsAre(ElementsAre(Pair(0, DoubleNear(0.15, 1e-12)))));
+}
+
+TEST(LocalPageRankTest, IsolatedSeedKeepsItsMass) {
+  GbbsGraph graph;
+  ASSERT_OK(ImportEdges(kNumNodes, TestEdges(), graph));
+  ASSERT_OK_AND_ASSIGN(std::vector<WeightedNodes> results,
+                       ComputeLocalPageRank(graph, {{{6, 2}}},
+                                            Config(1e-6, /*top_k=*/0)));
+  EXPECT_THAT(results, ElementsAre(ElementsAre(Pair(6, 1.0))));
+}
+
+TEST(LocalPageRankTest, MultipleSeeds) {
+  GbbsGraph graph;
+  ASSERT_OK(ImportEdges(kNumNodes, TestEdges(), graph));
+  constexpr double kEpsilon = 1e-6;
+  const WeightedNodes seeds = {{0, 1}, {4, 3}};
+  ASSERT_OK_AND_ASSIGN(
+      std::vector<WeightedNodes> results,
+      ComputeLocalPageRank(graph, {seeds}, Config(kEpsilon, /*top_k=*/0)));
+  ASSERT_EQ(results.size(), 1);
+  ExpectWithinPushBound(results[0], seeds, kEpsilon);
+}
+
+TEST(LocalPageRankTest, QueriesAreIndependent) {
+  GbbsGraph graph;
+  ASSERT_OK(ImportEdges(kNumNodes, TestEdges(), graph));
+  const LocalPageRankConfig config = Config(1e-6, /*top_k=*/0);
+  const std::vector<WeightedNodes> seed_sets = {
+      {{0, 1}}, {{0, 1}, {4, 3}}, {{6, 1}}, {{5, 1}}, {{0, 1}}};
+  ASSERT_OK_AND_ASSIGN(std::vector<WeightedNodes> results,
+                       ComputeLocalPageRank(graph, seed_sets, config));
+  ASSERT_EQ(results.size(), seed_sets.size());
+  for (std::size_t i = 0; i < seed_sets.size(); ++i) {
+    ASSERT_OK_AND_ASSIGN(std::vector<WeightedNodes> single_result,
+                         ComputeLocalPageRank(graph, {seed_sets[i]}, config));
+    EXPECT_EQ(results[i], single_result[0]) << "query " << i;
+  }
+}
+
+TEST(LocalPageRankTest, ReturnsTopKInDecreasingOrder) {
+  GbbsGraph graph;
+  ASSERT_OK(ImportEdges(kNumNodes, TestEdges(), graph));
+  ASSERT_OK_AND_ASSIGN(std::vector<WeightedNodes> all_results,
+                       ComputeLocalPageRank(graph, {{{3, 1}}},
+                                            Config(1e-6, /*top_k=*/0)));
+  ASSERT_OK_AND_ASSIGN(std::vector<WeightedNodes> top_results,
+                       ComputeLocalPageRank(graph, {{{3, 1}}},
+                                            Config(1e-6, /*top_k=*/2)));
+  const WeightedNodes& all_scores = all_results[0];
+  ASSERT_EQ(all_scores.size(), kNumNodes - 1);
+  for (std::size_t i = 1; i < all_scores.size(); ++i) {
+    EXPECT_GE(all_scores[i - 1].second, all_scores[i].second);
+  }
+  EXPECT_EQ(top_results[0], WeightedNodes(all_scores.begin(),
+                                          all_scores.begin() + 2));
+}
+
+TEST(LocalPageRankTest, InvalidInputIsAnError) {
+  GbbsGraph graph;
+  EXPECT_THAT(ComputeLocalPageRank(graph, {{{0, 1}}}, LocalPageRankConfig()),
+              StatusIs(StatusCode::kFailedPrecondition));
+  ASSERT_OK(ImportEdges(kNumNodes, TestEdges(), graph));
+  EXPECT_THAT(ComputeLocalPageRank(graph, {{{0, 1}}, {}},
+                                   LocalPageRankConfig()),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_THAT(ComputeLocalPageRank(graph, {{{kNumNodes, 1}}},
+                                   LocalPageRankConfig()),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_THAT(ComputeLocalPageRank(graph, {{{0, 1}, {1, 0}}},
+                                   LocalPageRankConfig()),
+              StatusIs(StatusCode::kInvalidArgument));
+  LocalPageRankConfig config;
+  config.set_damping_factor(1);
+  EXPECT_THAT(ComputeLocalPageRank(graph, {{{0, 1}}}, config),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_THAT(ComputeLocalPageRank(graph, {{{0, 1}}}, Config(0, 10)),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace graph_mining::in_memory
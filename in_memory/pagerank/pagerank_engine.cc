@@ -0,0 +1,431 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/pagerank/pagerank_engine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
+#include "gbbs/bridge.h"
+#include "gbbs/macros.h"
+#include "in_memory/clustering/types.h"
+#include "in_memory/pagerank/pagerank.pb.h"
+#include "in_memory/status_macros.h"
+#include "parlay/monoid.h"
+#include "parlay/parallel.h"
+#include "parlay/primitives.h"
+#include "parlay/sequence.h"
+
+namespace graph_mining::in_memory {
+namespace {
+
+// Target number of nodes plus in-edges of a cache block. A block has at most
+// kBlockSize nodes, so the partial scores of its nodes (128 KiB) stay in the L2
+// cache while its in-edges are processed in source order, and the relative
+// targets of the in-edges fit into 16 bits. The blocks also balance the work
+// of the tasks of an iteration.
+constexpr std::size_t kBlockSize = 1 << 14;
+static_assert(kBlockSize <= 1 << 16);
+
+// Returns the first node of each block of consecutive nodes, plus n at the end,
+// such that the blocks have roughly kBlockSize nodes plus in-edges each. Node v
+// is in the block containing v + offsets[v], so a block has at most kBlockSize
+// nodes.
+parlay::sequence<std::size_t> ComputeBlockStarts(
+    const parlay::sequence<std::size_t>& offsets) {
+  const std::size_t num_nodes = offsets.size() - 1;
+  const std::size_t total_size = num_nodes + offsets[num_nodes];
+  const std::size_t num_blocks =
+      std::max<std::size_t>(1, (total_size + kBlockSize - 1) / kBlockSize);
+  auto block_starts =
+      parlay::sequence<std::size_t>::from_function(
+          num_blocks + 1, [&](std::size_t block) -> std::size_t {
+            if (block == num_blocks) return num_nodes;
+            const std::size_t target_size = block * total_size / num_blocks;
+            // The first node v with v + offsets[v] >= target_size.
+            std::size_t low = 0, high = num_nodes;
+            while (low < high) {
+              const std::size_t middle = low + (high - low) / 2;
+              if (middle + offsets[middle] < target_size) {
+                low = middle + 1;
+              } else {
+                high = middle;
+              }
+            }
+            return low;
+          });
+  return block_starts;
+}
+
+// Computes next_scores[v] = base_score + damping * sum of
+// contributions[u] * w(u, v) over the in-edges of the nodes v of the given
+// block, and returns the L1 difference to scores on these nodes. The sums are
+// accumulated in next_scores in the source order of the blocked in-edges.
+template <bool kIsWeighted>
+double PullScores(const PageRankGraph& graph, std::size_t block,
+                  double damping, double base_score,
+                  const parlay::sequence<double>& contributions,
+                  const parlay::sequence<double>& scores,
+                  parlay::sequence<double>& next_scores) {
+  const std::size_t begin = graph.block_starts()[block];
+  const std::size_t end = graph.block_starts()[block + 1];
+  const std::size_t edge_begin = graph.offsets()[begin];
+  const std::size_t edge_end = graph.offsets()[end];
+  const auto& sources = graph.blocked_sources();
+  const auto& targets = graph.blocked_targets();
+  const auto& weights = graph.blocked_weights();
+  double* sums = next_scores.data() + begin;
+  std::fill(sums, sums + (end - begin), 0.0);
+  for (std::size_t i = edge_begin; i < edge_end; ++i) {
+    if constexpr (kIsWeighted) {
+      sums[targets[i]] += contributions[sources[i]] * weights[i];
+    } else {
+      sums[targets[i]] += contributions[sources[i]];
+    }
+  }
+  double l1_difference = 0;
+  for (std::size_t v = begin; v < end; ++v) {
+    next_scores[v] = base_score + damping * next_scores[v];
+    l1_difference += std::abs(next_scores[v] - scores[v]);
+  }
+  return l1_difference;
+}
+
+absl::Status ValidateDampingFactor(double damping) {
+  if (!(damping >= 0 && damping <= 1)) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("damping_factor must be in [0, 1], got ", damping));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+PageRankGraph::PageRankGraph(parlay::sequence<std::size_t> out_offsets,
+                             parlay::sequence<gbbs::uintE> out_targets,
+                             parlay::sequence<float> edge_weights,
+                             parlay::sequence<double> out_weights,
+                             bool is_symmetric)
+    : is_symmetric_(is_symmetric) {
+  const std::size_t num_nodes = out_weights.size();
+  const std::size_t num_edges = out_targets.size();
+  if (is_symmetric_) {
+    // w(u, v) = w(v, u), so the out-edges of v are also its in-edges.
+    offsets_ = std::move(out_offsets);
+    sources_ = std::move(out_targets);
+    weights_ = std::move(edge_weights);
+  } else {
+    const bool is_weighted = !edge_weights.empty();
+    parlay::sequence<Edge> edges(num_edges);
+    parlay::parallel_for(0, num_nodes, [&](std::size_t u) {
+      for (std::size_t i = out_offsets[u]; i < out_offsets[u + 1]; ++i) {
+        edges[i] = {out_targets[i], u, is_weighted ? edge_weights[i] : 1.0f};
+      }
+    });
+    // The sort is stable, so the sources of each node remain sorted.
+    parlay::integer_sort_inplace(
+        edges, [](const Edge& edge) { return std::get<0>(edge); });
+    offsets_ = parlay::sequence<std::size_t>(num_nodes + 1);
+    parlay::parallel_for(0, num_edges + 1, [&](std::size_t i) {
+      // Sets the offsets of the nodes after the target of the previous edge,
+      // up to the target of edge i.
+      const int64_t previous_target =
+          i == 0 ? -1 : static_cast<int64_t>(std::get<0>(edges[i - 1]));
+      const int64_t target =
+          i == num_edges ? num_nodes : std::get<0>(edges[i]);
+      for (int64_t v = previous_target + 1; v <= target; ++v) {
+        offsets_[v] = i;
+      }
+    });
+    sources_ = parlay::sequence<gbbs::uintE>::from_function(
+        num_edges, [&](std::size_t i) { return std::get<1>(edges[i]); });
+    if (is_weighted) {
+      weights_ = parlay::sequence<float>::from_function(
+          num_edges, [&](std::size_t i) { return std::get<2>(edges[i]); });
+    }
+    out_offsets_ = std::move(out_offsets);
+    out_targets_ = std::move(out_targets);
+  }
+  inverse_out_weights_ = parlay::sequence<double>::from_function(
+      num_nodes, [&](std::size_t i) {
+        return out_weights[i] > 0 ? 1 / out_weights[i] : 0.0;
+      });
+  dangling_nodes_ = parlay::pack_index<gbbs::uintE>(parlay::delayed_seq<bool>(
+      num_nodes, [&](std::size_t i) { return !(out_weights[i] > 0); }));
+
+  // Sorts the in-edges of each block by (block, source) with a stable integer
+  // sort, so the edges stay grouped by block.
+  block_starts_ = ComputeBlockStarts(offsets_);
+  const std::size_t num_blocks = block_starts_.size() - 1;
+  parlay::sequence<BlockedEdge> blocked_edges(num_edges);
+  parlay::parallel_for(
+      0, num_blocks,
+      [&](std::size_t block) {
+        const std::size_t begin = block_starts_[block];
+        for (std::size_t v = begin; v < block_starts_[block + 1]; ++v) {
+          for (std::size_t i = offsets_[v]; i < offsets_[v + 1]; ++i) {
+            blocked_edges[i] = {block * num_nodes + sources_[i],
+                                static_cast<std::uint16_t>(v - begin),
+                                weights_.empty() ? 1.0f : weights_[i]};
+          }
+        }
+      },
+      /*granularity=*/1);
+  parlay::integer_sort_inplace(
+      blocked_edges, [](const BlockedEdge& edge) { return edge.key; });
+  blocked_sources_ = parlay::sequence<gbbs::uintE>::from_function(
+      num_edges, [&](std::size_t i) -> gbbs::uintE {
+        return blocked_edges[i].key % num_nodes;
+      });
+  blocked_targets_ = parlay::sequence<std::uint16_t>::from_function(
+      num_edges, [&](std::size_t i) { return blocked_edges[i].target; });
+  if (!weights_.empty()) {
+    blocked_weights_ = parlay::sequence<float>::from_function(
+        num_edges, [&](std::size_t i) { return blocked_edges[i].weight; });
+  }
+}
+
+absl::StatusOr<PageRankResult> ComputePageRank(const PageRankGraph& graph,
+                                               const PageRankConfig& config) {
+  const double damping = config.damping_factor();
+  RETURN_IF_ERROR(ValidateDampingFactor(damping));
+  const std::size_t num_nodes = graph.NumNodes();
+  PageRankResult result;
+  if (num_nodes == 0) return result;
+
+  const std::size_t num_blocks = graph.block_starts().size() - 1;
+  const auto& dangling_nodes = graph.dangling_nodes();
+  const auto& inverse_out_weights = graph.inverse_out_weights();
+  const bool is_weighted = !graph.weights().empty();
+
+  // Scores of the current and the next iteration, swapped after each
+  // iteration.
+  parlay::sequence<double> scores(num_nodes, 1.0 / num_nodes);
+  parlay::sequence<double> next_scores(num_nodes);
+  // scores[u] / W(u) for each node u.
+  parlay::sequence<double> contributions(num_nodes);
+  parlay::sequence<double> block_l1_differences(num_blocks);
+  for (int iteration = 0; iteration < config.num_iterations(); ++iteration) {
+    const double dangling_score = parlay::reduce(
+        parlay::delayed_seq<double>(
+            dangling_nodes.size(),
+            [&](std::size_t i) { return scores[dangling_nodes[i]]; }),
+        parlay::addm<double>());
+    parlay::parallel_for(0, num_nodes, [&](std::size_t i) {
+      contributions[i] = scores[i] * inverse_out_weights[i];
+    });
+    const double base_score =
+        ((1 - damping) + damping * dangling_score) / num_nodes;
+    parlay::parallel_for(
+        0, num_blocks,
+        [&](std::size_t block) {
+          block_l1_differences[block] =
+              is_weighted
+                  ? PullScores</*kIsWeighted=*/true>(graph, block, damping,
+                                                     base_score, contributions,
+                                                     scores, next_scores)
+                  : PullScores</*kIsWeighted=*/false>(
+                        graph, block, damping, base_score, contributions,
+                        scores, next_scores);
+        },
+        /*granularity=*/1);
+    std::swap(scores, next_scores);
+    ++result.num_iterations;
+    result.residual =
+        parlay::reduce(block_l1_differences, parlay::addm<double>());
+    if (result.residual < config.approx_precision()) break;
+  }
+  result.scores = std::move(scores);
+  return result;
+}
+
+absl::StatusOr<PageRankResult> ComputeIncrementalPageRank(
+    const PageRankGraph& graph, const PageRankConfig& config,
+    absl::Span<const double> initial_scores,
+    absl::Span<const NodeId> changed_nodes) {
+  const double damping = config.damping_factor();
+  RETURN_IF_ERROR(ValidateDampingFactor(damping));
+  const std::size_t num_nodes = graph.NumNodes();
+  if (initial_scores.size() > num_nodes) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Got ", initial_scores.size(), " initial scores for ", num_nodes,
+        " nodes"));
+  }
+  const std::size_t num_invalid_scores =
+      parlay::count_if(initial_scores, [](double score) {
+        return !(score >= 0) || !std::isfinite(score);
+      });
+  if (num_invalid_scores > 0) {
+    return absl::InvalidArgumentError(
+        "Initial scores must be finite and non-negative");
+  }
+  const std::size_t num_invalid_nodes =
+      parlay::count_if(changed_nodes, [&](NodeId node_id) {
+        return node_id < 0 || static_cast<std::size_t>(node_id) >= num_nodes;
+      });
+  if (num_invalid_nodes > 0) {
+    return absl::InvalidArgumentError("Invalid id in changed_nodes");
+  }
+  PageRankResult result;
+  if (num_nodes == 0) return result;
+
+  parlay::sequence<double> scores = parlay::sequence<double>::from_function(
+      num_nodes, [&](std::size_t i) {
+        return i < initial_scores.size() ? initial_scores[i] : 1.0 / num_nodes;
+      });
+  const double total_score = parlay::reduce(scores, parlay::addm<double>());
+  if (!(total_score > 0)) {
+    return absl::InvalidArgumentError("Initial scores must not all be 0");
+  }
+  parlay::parallel_for(0, num_nodes,
+                       [&](std::size_t i) { scores[i] /= total_score; });
+
+  const auto& offsets = graph.offsets();
+  const auto& sources = graph.sources();
+  const auto& weights = graph.weights();
+  const auto& inverse_out_weights = graph.inverse_out_weights();
+  const auto& dangling_nodes = graph.dangling_nodes();
+  // Changes below this threshold are not propagated.
+  const double min_score_change = config.approx_precision() / num_nodes;
+
+  // Returns the given nodes and their out-neighbors without duplicates.
+  parlay::sequence<std::uint8_t> is_marked(num_nodes, 0);
+  auto close_under_out_neighbors =
+      [&](const parlay::sequence<gbbs::uintE>& nodes) {
+        const auto& out_offsets = graph.out_offsets();
+        const auto& out_targets = graph.out_targets();
+        auto candidate_offsets = parlay::sequence<std::size_t>::from_function(
+            nodes.size(), [&](std::size_t i) {
+              return 1 + out_offsets[nodes[i] + 1] - out_offsets[nodes[i]];
+            });
+        const std::size_t num_candidates =
+            parlay::scan_inplace(candidate_offsets);
+        parlay::sequence<gbbs::uintE> candidates(num_candidates);
+        parlay::parallel_for(0, nodes.size(), [&](std::size_t i) {
+          const gbbs::uintE node_id = nodes[i];
+          std::size_t position = candidate_offsets[i];
+          candidates[position++] = node_id;
+          for (std::size_t j = out_offsets[node_id];
+               j < out_offsets[node_id + 1]; ++j) {
+            candidates[position++] = out_targets[j];
+          }
+        });
+        auto is_first = parlay::sequence<bool>::from_function(
+            num_candidates, [&](std::size_t i) {
+              return gbbs::atomic_compare_and_swap(
+                  &is_marked[candidates[i]], std::uint8_t{0}, std::uint8_t{1});
+            });
+        auto result = parlay::pack(candidates, is_first);
+        parlay::parallel_for(0, result.size(),
+                             [&](std::size_t i) { is_marked[result[i]] = 0; });
+        // Sorting improves the locality of the score updates.
+        parlay::integer_sort_inplace(
+            result, [](gbbs::uintE node_id) { return node_id; });
+        return result;
+      };
+
+  parlay::sequence<gbbs::uintE> active_nodes = close_under_out_neighbors(
+      parlay::sequence<gbbs::uintE>::from_function(
+          changed_nodes.size() + num_nodes - initial_scores.size(),
+          [&](std::size_t i) -> gbbs::uintE {
+            return i < changed_nodes.size()
+                       ? changed_nodes[i]
+                       : initial_scores.size() + i - changed_nodes.size();
+          }));
+
+  // Weighted sum of the contributions of the in-neighbors of node_id.
+  auto pull_score = [&](gbbs::uintE node_id) {
+    double sum = 0;
+    for (std::size_t j = offsets[node_id]; j < offsets[node_id + 1]; ++j) {
+      const double contribution =
+          scores[sources[j]] * inverse_out_weights[sources[j]];
+      sum += weights.empty() ? contribution : contribution * weights[j];
+    }
+    return sum;
+  };
+
+  // The PageRank vector is the solution of x = b * 1 + damping * P * x where
+  // the base score b is spread uniformly over all nodes and depends on x only
+  // through the dangling mass. Hence the solution for any fixed b is
+  // proportional to the PageRank vector, so b is kept fixed and the scores are
+  // normalized at the end, and changes of the dangling mass do not activate
+  // any nodes. b must match the scale of the initial scores of the nodes that
+  // are not recomputed, so it is solved from their equations.
+  parlay::sequence<bool> is_initially_active(num_nodes, false);
+  parlay::parallel_for(0, active_nodes.size(), [&](std::size_t i) {
+    is_initially_active[active_nodes[i]] = true;
+  });
+  const std::size_t num_unaffected_nodes = num_nodes - active_nodes.size();
+  double base_score;
+  if (num_unaffected_nodes > 0) {
+    base_score =
+        parlay::reduce(parlay::delayed_seq<double>(
+                           num_nodes,
+                           [&](std::size_t i) {
+                             return is_initially_active[i]
+                                        ? 0.0
+                                        : scores[i] - damping * pull_score(i);
+                           }),
+                       parlay::addm<double>()) /
+        num_unaffected_nodes;
+  } else {
+    const double dangling_score = parlay::reduce(
+        parlay::delayed_seq<double>(
+            dangling_nodes.size(),
+            [&](std::size_t i) { return scores[dangling_nodes[i]]; }),
+        parlay::addm<double>());
+    base_score = ((1 - damping) + damping * dangling_score) / num_nodes;
+  }
+  for (int iteration = 0; iteration < config.num_iterations(); ++iteration) {
+    if (active_nodes.empty()) break;
+
+    // Jacobi update of the scores of the active nodes.
+    auto new_scores = parlay::sequence<double>::from_function(
+        active_nodes.size(), [&](std::size_t i) {
+          return base_score + damping * pull_score(active_nodes[i]);
+        });
+    auto score_changes = parlay::sequence<double>::from_function(
+        active_nodes.size(), [&](std::size_t i) {
+          return std::abs(new_scores[i] - scores[active_nodes[i]]);
+        });
+    parlay::parallel_for(0, active_nodes.size(), [&](std::size_t i) {
+      scores[active_nodes[i]] = new_scores[i];
+    });
+    ++result.num_iterations;
+    result.residual = parlay::reduce(score_changes, parlay::addm<double>());
+    if (result.residual < config.approx_precision()) break;
+
+    active_nodes = close_under_out_neighbors(parlay::pack(
+        active_nodes,
+        parlay::delayed_seq<bool>(active_nodes.size(), [&](std::size_t i) {
+          return score_changes[i] >= min_score_change;
+        })));
+  }
+  const double final_total_score =
+      parlay::reduce(scores, parlay::addm<double>());
+  parlay::parallel_for(0, num_nodes,
+                       [&](std::size_t i) { scores[i] /= final_total_score; });
+  result.scores = std::move(scores);
+  return result;
+}
+
+}  // namespace graph_mining::in_memory
@@ -0,0 +1,250 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_PAGERANK_PAGERANK_ENGINE_H_
+#define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_PAGERANK_PAGERANK_ENGINE_H_
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
+#include "gbbs/graph.h"
+#include "gbbs/macros.h"
+#include "in_memory/clustering/types.h"
+#include "in_memory/pagerank/pagerank.pb.h"
+#include "parlay/parallel.h"
+#include "parlay/primitives.h"
+#include "parlay/sequence.h"
+
+namespace graph_mining::in_memory {
+
+// The transposed adjacency matrix of a directed graph with non-negative edge
+// weights in CSR format, as used by pull-based PageRank iterations. A random
+// walk at node u moves to out-neighbor v with probability w(u, v) / W(u) where
+// W(u) is the total out-weight of u. Nodes with W(u) = 0 are dangling.
+//
+// The matrix is also stored in cache blocks for the power iterations: the
+// nodes are split into ranges of consecutive nodes with roughly the same number
+// of nodes plus in-edges, and the in-edges of each range are sorted by source.
+// The partial scores of a block stay in the cache while its in-edges are
+// processed, and the scores of the sources are read in increasing order.
+//
+// Building the matrix copies every edge twice (and transposes the matrix for
+// asymmetric graphs), so it should be built once per graph and reused across
+// PageRank computations.
+class PageRankGraph {
+ public:
+  // Builds the matrix from the out-neighbors of a GBBS graph, which may be
+  // symmetric or asymmetric, weighted or unweighted (gbbs::empty weights count
+  // as 1). The matrix of a symmetric graph is its own transpose, so its
+  // out-edge arrays are used as in-edge arrays without sorting. Returns an
+  // error if there is a negative or non-finite edge weight.
+  template <typename Graph>
+  static absl::StatusOr<PageRankGraph> Create(Graph& graph);
+
+  std::size_t NumNodes() const { return inverse_out_weights_.size(); }
+
+  // In-edges of node v are edges offsets()[v], ..., offsets()[v + 1] - 1.
+  const parlay::sequence<std::size_t>& offsets() const { return offsets_; }
+
+  // Source node of each in-edge. For asymmetric graphs, the sources of each
+  // node are sorted by id.
+  const parlay::sequence<gbbs::uintE>& sources() const { return sources_; }
+
+  // Weight of each in-edge. Empty if all edge weights are 1.
+  const parlay::sequence<float>& weights() const { return weights_; }
+
+  // 1 / W(u) for each node u, or 0 for dangling nodes.
+  const parlay::sequence<double>& inverse_out_weights() const {
+    return inverse_out_weights_;
+  }
+
+  const parlay::sequence<gbbs::uintE>& dangling_nodes() const {
+    return dangling_nodes_;
+  }
+
+  // Block b consists of the nodes block_starts()[b], ...,
+  // block_starts()[b + 1] - 1 and their in-edges, i.e., the edges
+  // offsets()[block_starts()[b]], ..., offsets()[block_starts()[b + 1]] - 1.
+  // blocked_sources(), blocked_targets() and blocked_weights() hold these edges
+  // sorted by source, with targets relative to the first node of the block.
+  // blocked_weights() is empty if all edge weights are 1.
+  const parlay::sequence<std::size_t>& block_starts() const {
+    return block_starts_;
+  }
+  const parlay::sequence<gbbs::uintE>& blocked_sources() const {
+    return blocked_sources_;
+  }
+  const parlay::sequence<std::uint16_t>& blocked_targets() const {
+    return blocked_targets_;
+  }
+  const parlay::sequence<float>& blocked_weights() const {
+    return blocked_weights_;
+  }
+
+  // Out-edges of node u are out_targets()[out_offsets()[u]], ...,
+  // out_targets()[out_offsets()[u + 1] - 1]. Used to find the nodes affected
+  // by a score change in incremental computations.
+  const parlay::sequence<std::size_t>& out_offsets() const {
+    return is_symmetric_ ? offsets_ : out_offsets_;
+  }
+  const parlay::sequence<gbbs::uintE>& out_targets() const {
+    return is_symmetric_ ? sources_ : out_targets_;
+  }
+
+ private:
+  // A weighted edge as (target, source, weight).
+  using Edge = std::tuple<gbbs::uintE, gbbs::uintE, float>;
+
+  // An in-edge of a block, where key is block * NumNodes() + source and target
+  // is relative to the first node of the block.
+  struct BlockedEdge {
+    std::uint64_t key;
+    std::uint16_t target;
+    float weight;
+  };
+
+  // Takes the out-edge arrays, where edge_weights is empty if all edge weights
+  // are 1. Unless is_symmetric, sorts the edges by target to build the in-edge
+  // arrays.
+  PageRankGraph(parlay::sequence<std::size_t> out_offsets,
+                parlay::sequence<gbbs::uintE> out_targets,
+                parlay::sequence<float> edge_weights,
+                parlay::sequence<double> out_weights, bool is_symmetric);
+
+  bool is_symmetric_ = false;
+  // Empty for symmetric graphs.
+  parlay::sequence<std::size_t> out_offsets_;
+  parlay::sequence<gbbs::uintE> out_targets_;
+  parlay::sequence<std::size_t> offsets_;
+  parlay::sequence<gbbs::uintE> sources_;
+  parlay::sequence<float> weights_;
+  parlay::sequence<double> inverse_out_weights_;
+  parlay::sequence<gbbs::uintE> dangling_nodes_;
+  parlay::sequence<std::size_t> block_starts_;
+  parlay::sequence<gbbs::uintE> blocked_sources_;
+  parlay::sequence<std::uint16_t> blocked_targets_;
+  parlay::sequence<float> blocked_weights_;
+};
+
+struct PageRankResult {
+  // PageRank score of each node.
+  parlay::sequence<double> scores;
+  int num_iterations = 0;
+  // L1 norm of the score changes in the last iteration.
+  double residual = 0;
+};
+
+// Computes PageRank with config.damping_factor() by pull-based power
+// iterations, starting from the uniform distribution. The probability mass of
+// dangling nodes is spread uniformly over all nodes, so the scores always sum
+// up to 1. Stops after config.num_iterations() iterations or when the L1
+// difference between two consecutive iterations is smaller than
+// config.approx_precision(). Returns an error if the damping factor is not in
+// [0, 1].
+absl::StatusOr<PageRankResult> ComputePageRank(const PageRankGraph& graph,
+                                               const PageRankConfig& config);
+
+// Same as above but warm-started from initial_scores, typically the converged
+// scores of a previous version of the graph. changed_nodes must contain every
+// node whose in- or out-edges changed since then; nodes with ids of at least
+// initial_scores.size() are new and count as changed (their initial score is
+// 1 / n). The initial scores are normalized to sum up to 1.
+//
+// Each iteration recomputes only the scores of the nodes that may be affected
+// by the changes of the previous iteration (initially the changed nodes and
+// their out-neighbors), and only changes of at least
+// config.approx_precision() / n are propagated. The uniformly spread teleport
+// and dangling mass only scales the solution, so it is fixed to match the
+// initial scores of the unaffected nodes (one pass over their in-edges) and
+// the scores are normalized at the end; changes of the dangling mass
+// therefore do not activate any nodes. The result reports the number of
+// iterations and the L1 norm of the (unnormalized) score changes in the last
+// iteration.
+absl::StatusOr<PageRankResult> ComputeIncrementalPageRank(
+    const PageRankGraph& graph, const PageRankConfig& config,
+    absl::Span<const double> initial_scores,
+    absl::Span<const NodeId> changed_nodes);
+
+//////////////////////////////////////////////////////////////////////////////
+/// IMPLEMENTATION ONLY BELOW
+//////////////////////////////////////////////////////////////////////////////
+
+namespace internal {
+
+template <typename Graph>
+struct IsSymmetricGraph : std::false_type {};
+
+template <template <class> class Vertex, class Weight>
+struct IsSymmetricGraph<gbbs::symmetric_ptr_graph<Vertex, Weight>>
+    : std::true_type {};
+
+}  // namespace internal
+
+template <typename Graph>
+absl::StatusOr<PageRankGraph> PageRankGraph::Create(Graph& graph) {
+  using WeightType = typename Graph::weight_type;
+  constexpr bool kIsWeighted = !std::is_same_v<WeightType, gbbs::empty>;
+  const std::size_t num_nodes = graph.n;
+  auto out_offsets = parlay::sequence<std::size_t>::from_function(
+      num_nodes + 1, [&](std::size_t i) -> std::size_t {
+        return i < num_nodes ? graph.get_vertex(i).out_degree() : 0;
+      });
+  // The exclusive scan sets out_offsets[num_nodes] to the number of edges.
+  const std::size_t num_edges = parlay::scan_inplace(out_offsets);
+  parlay::sequence<gbbs::uintE> out_targets(num_edges);
+  parlay::sequence<float> edge_weights(kIsWeighted ? num_edges : 0);
+  parlay::sequence<double> out_weights(num_nodes);
+  parlay::parallel_for(0, num_nodes, [&](std::size_t i) {
+    auto neighbors = graph.get_vertex(i).out_neighbors();
+    const std::size_t offset = out_offsets[i];
+    double out_weight = 0;
+    for (std::size_t j = 0; j < neighbors.get_degree(); ++j) {
+      out_targets[offset + j] = neighbors.get_neighbor(j);
+      if constexpr (kIsWeighted) {
+        const float weight = neighbors.get_weight(j);
+        edge_weights[offset + j] = weight;
+        out_weight += weight;
+      } else {
+        out_weight += 1;
+      }
+    }
+    out_weights[i] = out_weight;
+  });
+  if constexpr (kIsWeighted) {
+    const std::size_t num_invalid_weights =
+        parlay::count_if(edge_weights, [](float weight) {
+          return !(weight >= 0) || !std::isfinite(weight);
+        });
+    if (num_invalid_weights > 0) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "PageRank requires finite non-negative edge weights, found ",
+          num_invalid_weights, " invalid weights"));
+    }
+  }
+  return PageRankGraph(std::move(out_offsets), std::move(out_targets),
+                       std::move(edge_weights), std::move(out_weights),
+                       internal::IsSymmetricGraph<Graph>::value);
+}
+
+}  // namespace graph_mining::in_memory
+
+#endif  // THIRD_PARTY_GRAPH_MINING_IN_MEMORY_PAGERANK_PAGERANK_ENGINE_H_
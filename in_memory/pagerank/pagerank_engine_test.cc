@@ -0,0 +1,248 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/pagerank/pagerank_engine.h"
+
+#include <cstddef>
+#include <random>
+#include <set>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/pagerank/pagerank.pb.h"
+#include "in_memory/status_macros.h"  // IWYU pragma: keep
+
+namespace graph_mining::in_memory {
+namespace {
+
+using Edge = std::tuple<int, int, float>;
+
+// Imports the given directed edges into a graph with num_nodes nodes.
+template <typename Graph>
+absl::Status ImportEdges(int num_nodes, const std::vector<Edge>& edges,
+                         Graph& graph) {
+  std::vector<InMemoryClusterer::AdjacencyList> adjacency_lists(num_nodes);
+  for (int i = 0; i < num_nodes; ++i) adjacency_lists[i].id = i;
+  for (const auto& [source, target, weight] : edges) {
+    adjacency_lists[source].outgoing_edges.emplace_back(target, weight);
+  }
+  RETURN_IF_ERROR(graph.PrepareImport(num_nodes));
+  for (auto& adjacency_list : adjacency_lists) {
+    RETURN_IF_ERROR(graph.Import(std::move(adjacency_list)));
+  }
+  return graph.FinishImport();
+}
+
+// Returns both directions of each edge.
+std::vector<Edge> Symmetrize(const std::vector<Edge>& edges) {
+  std::vector<Edge> result;
+  for (const auto& [source, target, weight] : edges) {
+    result.emplace_back(source, target, weight);
+    result.emplace_back(target, source, weight);
+  }
+  return result;
+}
+
+// Dense power iterations following the definition of ComputePageRank.
+std::vector<double> BruteForcePageRank(int num_nodes,
+                                       const std::vector<Edge>& edges,
+                                       double damping, int num_iterations) {
+  std::vector<double> out_weights(num_nodes, 0);
+  for (const auto& [source, target, weight] : edges) {
+    out_weights[source] += weight;
+  }
+  std::vector<double> scores(num_nodes, 1.0 / num_nodes);
+  for (int iteration = 0; iteration < num_iterations; ++iteration) {
+    double dangling_score = 0;
+    for (int i = 0; i < num_nodes; ++i) {
+      if (out_weights[i] == 0) dangling_score += scores[i];
+    }
+    std::vector<double> next_scores(
+        num_nodes, ((1 - damping) + damping * dangling_score) / num_nodes);
+    for (const auto& [source, target, weight] : edges) {
+      next_scores[target] +=
+          damping * scores[source] * weight / out_weights[source];
+    }
+    scores = std::move(next_scores);
+  }
+  return scores;
+}
+
+PageRankConfig FixedIterationsConfig(int num_iterations) {
+  PageRankConfig config;
+  config.set_num_iterations(num_iterations);
+  config.set_approx_precision(0);
+  return config;
+}
+
+TEST(PageRankEngineTest, CycleHasUniformScores) {
+  UnweightedGbbsGraph graph;
+  ASSERT_OK(ImportEdges(
+      4, Symmetrize({{0, 1, 1}, {1, 2, 1}, {2, 3, 1}, {3, 0, 1}}), graph));
+  ASSERT_OK_AND_ASSIGN(PageRankGraph pagerank_graph,
+                       PageRankGraph::Create(*graph.Graph()));
+  ASSERT_OK_AND_ASSIGN(PageRankResult result,
+                       ComputePageRank(pagerank_graph, PageRankConfig()));
+  ASSERT_EQ(result.scores.size(), 4);
+  for (const double score : result.scores) EXPECT_NEAR(score, 0.25, 1e-9);
+}
+
+TEST(PageRankEngineTest, DirectedWeightedMatchesBruteForce) {
+  // Node 4 is dangling.
+  const std::vector<Edge> edges = {{0, 1, 2},   {0, 2, 1}, {1, 2, 1},
+                                   {2, 0, 0.5}, {2, 3, 3}, {3, 4, 1},
+                                   {1, 4, 1}};
+  DirectedGbbsGraph graph;
+  ASSERT_OK(ImportEdges(5, edges, graph));
+  ASSERT_OK_AND_ASSIGN(PageRankGraph pagerank_graph,
+                       PageRankGraph::Create(*graph.Graph()));
+  EXPECT_THAT(pagerank_graph.dangling_nodes(), testing::ElementsAre(4));
+  ASSERT_OK_AND_ASSIGN(PageRankResult result,
+                       ComputePageRank(pagerank_graph,
+                                       FixedIterationsConfig(30)));
+  EXPECT_EQ(result.num_iterations, 30);
+  const std::vector<double> expected =
+      BruteForcePageRank(5, edges, /*damping=*/0.85, /*num_iterations=*/30);
+  ASSERT_EQ(result.scores.size(), expected.size());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_NEAR(result.scores[i], expected[i], 1e-9) << "node " << i;
+  }
+}
+
+TEST(PageRankEngineTest, CacheBlocksMatchBruteForce) {
+  // Enough nodes and edges for several cache blocks, and a node with a large
+  // in-degree.
+  constexpr int kNumNodes = 20000;
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<int> random_node(0, kNumNodes - 1);
+  std::uniform_real_distribution<float> random_weight(0.1, 2);
+  std::set<std::pair<int, int>> node_pairs;
+  for (int i = 1; i < kNumNodes; i += 2) node_pairs.emplace(i, 0);
+  for (int i = 0; i < 5 * kNumNodes; ++i) {
+    const int source = random_node(rng);
+    const int target = random_node(rng);
+    if (source != target) node_pairs.emplace(source, target);
+  }
+  std::vector<Edge> edges;
+  for (const auto& [source, target] : node_pairs) {
+    edges.emplace_back(source, target, random_weight(rng));
+  }
+  DirectedGbbsGraph graph;
+  ASSERT_OK(ImportEdges(kNumNodes, edges, graph));
+  ASSERT_OK_AND_ASSIGN(PageRankGraph pagerank_graph,
+                       PageRankGraph::Create(*graph.Graph()));
+
+  const auto& block_starts = pagerank_graph.block_starts();
+  ASSERT_GT(block_starts.size(), 2);
+  EXPECT_EQ(block_starts.back(), kNumNodes);
+  for (std::size_t block = 0; block + 1 < block_starts.size(); ++block) {
+    const std::size_t begin = block_starts[block];
+    const std::size_t end = block_starts[block + 1];
+    for (std::size_t i = pagerank_graph.offsets()[begin];
+         i < pagerank_graph.offsets()[end]; ++i) {
+      EXPECT_LT(pagerank_graph.blocked_targets()[i], end - begin);
+      if (i > pagerank_graph.offsets()[begin]) {
+        EXPECT_LE(pagerank_graph.blocked_sources()[i - 1],
+                  pagerank_graph.blocked_sources()[i]);
+      }
+    }
+  }
+
+  ASSERT_OK_AND_ASSIGN(PageRankResult result,
+                       ComputePageRank(pagerank_graph,
+                                       FixedIterationsConfig(10)));
+  const std::vector<double> expected = BruteForcePageRank(
+      kNumNodes, edges, /*damping=*/0.85, /*num_iterations=*/10);
+  ASSERT_EQ(result.scores.size(), expected.size());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_NEAR(result.scores[i], expected[i], 1e-12) << "node " << i;
+  }
+}
+
+TEST(PageRankEngineTest, SymmetricGraphMatchesItsDirectedVersion) {
+  const std::vector<Edge> edges = Symmetrize(
+      {{0, 1, 1}, {0, 2, 1}, {1, 2, 1}, {2, 3, 1}, {3, 4, 1}, {4, 5, 1}});
+  UnweightedGbbsGraph symmetric_graph;
+  ASSERT_OK(ImportEdges(6, edges, symmetric_graph));
+  DirectedGbbsGraph directed_graph;
+  ASSERT_OK(ImportEdges(6, edges, directed_graph));
+  ASSERT_OK_AND_ASSIGN(PageRankGraph symmetric_pagerank_graph,
+                       PageRankGraph::Create(*symmetric_graph.Graph()));
+  ASSERT_OK_AND_ASSIGN(PageRankGraph directed_pagerank_graph,
+                       PageRankGraph::Create(*directed_graph.Graph()));
+  // The out-edges of the symmetric graph are reused as its in-edges.
+  EXPECT_EQ(&symmetric_pagerank_graph.out_targets(),
+            &symmetric_pagerank_graph.sources());
+
+  const PageRankConfig config = FixedIterationsConfig(20);
+  ASSERT_OK_AND_ASSIGN(PageRankResult symmetric_result,
+                       ComputePageRank(symmetric_pagerank_graph, config));
+  ASSERT_OK_AND_ASSIGN(PageRankResult directed_result,
+                       ComputePageRank(directed_pagerank_graph, config));
+  ASSERT_EQ(symmetric_result.scores.size(), directed_result.scores.size());
+  for (std::size_t i = 0; i < symmetric_result.scores.size(); ++i) {
+    EXPECT_NEAR(symmetric_result.scores[i], directed_result.scores[i], 1e-12);
+  }
+}
+
+TEST(PageRankEngineTest, IncrementalMatchesFromScratch) {
+  // Node 4 is dangling before the update.
+  std::vector<Edge> edges = {{0, 1, 2}, {0, 2, 1}, {1, 2, 1}, {2, 0, 0.5},
+                             {2, 3, 3}, {3, 4, 1}, {1, 4, 1}};
+  PageRankConfig config;
+  config.set_num_iterations(1000);
+  config.set_approx_precision(1e-12);
+  DirectedGbbsGraph old_graph;
+  ASSERT_OK(ImportEdges(5, edges, old_graph));
+  ASSERT_OK_AND_ASSIGN(PageRankGraph old_pagerank_graph,
+                       PageRankGraph::Create(*old_graph.Graph()));
+  ASSERT_OK_AND_ASSIGN(PageRankResult old_result,
+                       ComputePageRank(old_pagerank_graph, config));
+
+  // Node 4 stops being dangling, which changes the dangling mass, and the new
+  // node 5 is added.
+  edges.emplace_back(4, 3, 1);
+  edges.emplace_back(3, 5, 2);
+  DirectedGbbsGraph new_graph;
+  ASSERT_OK(ImportEdges(6, edges, new_graph));
+  ASSERT_OK_AND_ASSIGN(PageRankGraph new_pagerank_graph,
+                       PageRankGraph::Create(*new_graph.Graph()));
+  ASSERT_OK_AND_ASSIGN(PageRankResult expected,
+                       ComputePageRank(new_pagerank_graph, config));
+  const std::vector<InMemoryClusterer::NodeId> changed_nodes = {3, 4};
+  ASSERT_OK_AND_ASSIGN(
+      PageRankResult result,
+      ComputeIncrementalPageRank(new_pagerank_graph, config, old_result.scores,
+                                 changed_nodes));
+
+  ASSERT_EQ(result.scores.size(), expected.scores.size());
+  for (std::size_t i = 0; i < expected.scores.size(); ++i) {
+    EXPECT_NEAR(result.scores[i], expected.scores[i], 1e-9) << "node " << i;
+  }
+}
+
+TEST(PageRankEngineTest, NegativeWeightIsAnError) {
+  DirectedGbbsGraph graph;
+  ASSERT_OK(ImportEdges(2, {{0, 1, -1}}, graph));
+  EXPECT_FALSE(PageRankGraph::Create(*graph.Graph()).ok());
+}
+
+}  // namespace
+}  // namespace graph_mining::in_memory
@@ -14,22 +14,101 @@
 
 #include "in_memory/pagerank/parallel_pagerank.h"
 
+#include <optional>
+#include <utility>
+
+#include "absl/log/absl_log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
-#include "benchmarks/PageRank/PageRank.h"
+#include "absl/types/span.h"
+#include "in_memory/clustering/types.h"
+#include "in_memory/pagerank/pagerank_engine.h"
 #include "in_memory/parallel/scheduler.h"
+#include "in_memory/status_macros.h"
 
 namespace graph_mining::in_memory {
 
-  absl::StatusOr<parlay::sequence<double>> ParallelPageRank::Run() const {
-    if (graph_.Graph() == nullptr) {
+namespace {
+
+// Returns the PageRankGraph of graph.
+template <typename Graph>
+absl::StatusOr<PageRankGraph> CreatePageRankGraph(const Graph& graph) {
+  if (graph.Graph() == nullptr) {
     return absl::FailedPreconditionError(
-        "graph_ must be initialized before triangle counting.");
+        "graph_ must be initialized before running PageRank.");
   }
+  return PageRankGraph::Create(*graph.Graph());
+}
 
-  
-  return ::gbbs::PageRank(*(graph_.Graph()), config_.approx_precision(),
-                          config_.num_iterations());
-  }
+// Returns the prepared PageRankGraph if there is one, and otherwise builds the
+// PageRankGraph of graph into temporary_graph.
+template <typename Graph>
+absl::StatusOr<const PageRankGraph*> GetPageRankGraph(
+    const Graph& graph, const std::optional<PageRankGraph>& prepared_graph,
+    std::optional<PageRankGraph>& temporary_graph) {
+  if (prepared_graph.has_value()) return &*prepared_graph;
+  ASSIGN_OR_RETURN(temporary_graph, CreatePageRankGraph(graph));
+  return &*temporary_graph;
+}
+
+}  // namespace
+
+absl::Status ParallelPageRank::Prepare() {
+  pagerank_graph_.reset();
+  ASSIGN_OR_RETURN(pagerank_graph_, CreatePageRankGraph(graph_));
+  return absl::OkStatus();
+}
+
+absl::StatusOr<parlay::sequence<double>> ParallelPageRank::Run() const {
+  std::optional<PageRankGraph> temporary_graph;
+  ASSIGN_OR_RETURN(
+      const PageRankGraph* pagerank_graph,
+      GetPageRankGraph(graph_, pagerank_graph_, temporary_graph));
+  ASSIGN_OR_RETURN(PageRankResult result,
+                   ComputePageRank(*pagerank_graph, config_));
+  ABSL_VLOG(1) << "PageRank done after " << result.num_iterations
+               << " iterations with residual " << result.residual;
+  return std::move(result.scores);
+}
+
+absl::StatusOr<PageRankResult> ParallelPageRank::RunIncremental(
+    absl::Span<const double> initial_scores,
+    absl::Span<const NodeId> changed_nodes) const {
+  std::optional<PageRankGraph> temporary_graph;
+  ASSIGN_OR_RETURN(
+      const PageRankGraph* pagerank_graph,
+      GetPageRankGraph(graph_, pagerank_graph_, temporary_graph));
+  return ComputeIncrementalPageRank(*pagerank_graph, config_, initial_scores,
+                                    changed_nodes);
+}
+
+absl::Status DirectedPageRank::Prepare() {
+  pagerank_graph_.reset();
+  ASSIGN_OR_RETURN(pagerank_graph_, CreatePageRankGraph(graph_));
+  return absl::OkStatus();
+}
+
+absl::StatusOr<parlay::sequence<double>> DirectedPageRank::Run() const {
+  std::optional<PageRankGraph> temporary_graph;
+  ASSIGN_OR_RETURN(
+      const PageRankGraph* pagerank_graph,
+      GetPageRankGraph(graph_, pagerank_graph_, temporary_graph));
+  ASSIGN_OR_RETURN(PageRankResult result,
+                   ComputePageRank(*pagerank_graph, config_));
+  ABSL_VLOG(1) << "PageRank done after " << result.num_iterations
+               << " iterations with residual " << result.residual;
+  return std::move(result.scores);
+}
+
+absl::StatusOr<PageRankResult> DirectedPageRank::RunIncremental(
+    absl::Span<const double> initial_scores,
+    absl::Span<const NodeId> changed_nodes) const {
+  std::optional<PageRankGraph> temporary_graph;
+  ASSIGN_OR_RETURN(
+      const PageRankGraph* pagerank_graph,
+      GetPageRankGraph(graph_, pagerank_graph_, temporary_graph));
+  return ComputeIncrementalPageRank(*pagerank_graph, config_, initial_scores,
+                                    changed_nodes);
+}
 
 }  // namespace graph_mining::in_memory
@@ -15,30 +15,98 @@
 #ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_PAGERANK_PARALLEL_PAGERANK_H_
 #define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_PAGERANK_PARALLEL_PAGERANK_H_
 
+#include <optional>
+
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
 #include "parlay/sequence.h"
 #include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/types.h"
 #include "in_memory/pagerank/pagerank.pb.h"
+#include "in_memory/pagerank/pagerank_engine.h"
 
 namespace graph_mining::in_memory {
 
+// PageRank on an undirected unweighted graph. See ComputePageRank for details.
+//
+// Prepare() builds the PageRankGraph once so that later runs reuse it. Runs
+// without a prepared PageRankGraph build a temporary one instead. Runs do not
+// modify the object and may be concurrent.
 class ParallelPageRank {
  public:
   explicit ParallelPageRank(
       const ::graph_mining::in_memory::PageRankConfig& config)
       : config_(config) {}
 
+  // Drops the PageRankGraph built by Prepare(), since the graph may be
+  // modified through the returned pointer.
   ::graph_mining::in_memory::UnweightedGbbsGraph* MutableGraph() {
+    pagerank_graph_.reset();
     return &graph_;
   }
 
+  // Builds the PageRankGraph used by the following runs. Must be called after
+  // FinishImport, and again after the graph is modified.
+  absl::Status Prepare();
+
   // Returns a sequence where the i-th element contains the pagerank value for
   // the i-th node.
   absl::StatusOr<::parlay::sequence<double>> Run() const;
 
+  // Warm-starts the computation from the scores of a previous version of the
+  // graph. See ComputeIncrementalPageRank for the requirements on the
+  // arguments.
+  absl::StatusOr<PageRankResult> RunIncremental(
+      absl::Span<const double> initial_scores,
+      absl::Span<const NodeId> changed_nodes) const;
+
  private:
   ::graph_mining::in_memory::UnweightedGbbsGraph graph_;
   ::graph_mining::in_memory::PageRankConfig config_;
+  // Built from graph_ by the last Prepare() call, if any, after the last
+  // MutableGraph() call.
+  std::optional<PageRankGraph> pagerank_graph_;
+};
+
+// PageRank on a directed graph with non-negative edge weights, where a random
+// walk follows an out-edge with probability proportional to its weight. See
+// ComputePageRank for details. The PageRankGraph is prepared and reused as in
+// ParallelPageRank.
+class DirectedPageRank {
+ public:
+  explicit DirectedPageRank(
+      const ::graph_mining::in_memory::PageRankConfig& config)
+      : config_(config) {}
+
+  // Drops the PageRankGraph built by Prepare(), since the graph may be
+  // modified through the returned pointer.
+  ::graph_mining::in_memory::DirectedGbbsGraph* MutableGraph() {
+    pagerank_graph_.reset();
+    return &graph_;
+  }
+
+  // Builds the PageRankGraph used by the following runs. Must be called after
+  // FinishImport, and again after the graph is modified.
+  absl::Status Prepare();
+
+  // Returns a sequence where the i-th element contains the pagerank value for
+  // the i-th node.
+  absl::StatusOr<::parlay::sequence<double>> Run() const;
+
+  // Warm-starts the computation from the scores of a previous version of the
+  // graph. See ComputeIncrementalPageRank for the requirements on the
+  // arguments.
+  absl::StatusOr<PageRankResult> RunIncremental(
+      absl::Span<const double> initial_scores,
+      absl::Span<const NodeId> changed_nodes) const;
+
+ private:
+  ::graph_mining::in_memory::DirectedGbbsGraph graph_;
+  ::graph_mining::in_memory::PageRankConfig config_;
+  // Built from graph_ by the last Prepare() call, if any, after the last
+  // MutableGraph() call.
+  std::optional<PageRankGraph> pagerank_graph_;
 };
 
 }  // namespace graph_mining::in_memory
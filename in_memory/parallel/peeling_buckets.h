@@ -0,0 +1,125 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_PARALLEL_PEELING_BUCKETS_H_
+#define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_PARALLEL_PEELING_BUCKETS_H_
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "gbbs/bridge.h"
+#include "gbbs/macros.h"
+#include "parlay/parallel.h"
+#include "parlay/primitives.h"
+#include "parlay/sequence.h"
+
+namespace graph_mining::in_memory {
+
+// Decrements *value unless it is at most `floor`. Returns true if this call
+// lowered *value to `floor`. Thread-safe.
+inline bool DecrementToFloor(gbbs::uintE* value, gbbs::uintE floor) {
+  while (true) {
+    const gbbs::uintE current = *value;
+    if (current <= floor) return false;
+    if (gbbs::atomic_compare_and_swap(value, current, current - 1)) {
+      return current - 1 == floor;
+    }
+  }
+}
+
+// Buckets of the elements of a peeling algorithm (e.g., k-core or k-truss
+// decomposition) by their keys, which only decrease, and never below the key
+// of the bucket being peeled. Buckets are extracted in increasing order of
+// keys. An element whose key decreases is inserted again into the bucket of
+// its new key and its stale entries are skipped on extraction, so the total
+// work is linear in the number of elements, key changes and the maximum key,
+// instead of scanning all remaining elements for each key.
+template <typename Id>
+class PeelingBuckets {
+ public:
+  // Creates the buckets of the elements 0, ..., keys.size() - 1, where element
+  // i has key keys[i].
+  explicit PeelingBuckets(const parlay::sequence<gbbs::uintE>& keys);
+
+  // Returns the smallest key k of a non-extracted bucket that has an element e
+  // with is_current(e, k), together with these elements, and marks all
+  // buckets up to k as extracted. Returns an empty sequence if there is no
+  // such bucket. is_current must be thread-safe.
+  template <typename IsCurrent>
+  std::pair<gbbs::uintE, parlay::sequence<Id>> NextBucket(
+      IsCurrent is_current);
+
+  // Inserts each element e into the bucket of key(e), which must not have
+  // been extracted.
+  template <typename Key>
+  void Insert(parlay::sequence<Id> elements, Key key);
+
+ private:
+  std::vector<parlay::sequence<Id>> buckets_;
+  // Key of the first non-extracted bucket.
+  std::size_t next_key_ = 0;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+/// IMPLEMENTATION ONLY BELOW
+//////////////////////////////////////////////////////////////////////////////
+
+template <typename Id>
+PeelingBuckets<Id>::PeelingBuckets(const parlay::sequence<gbbs::uintE>& keys) {
+  const gbbs::uintE max_key =
+      keys.empty() ? 0 : parlay::reduce(keys, parlay::maxm<gbbs::uintE>());
+  buckets_.resize(static_cast<std::size_t>(max_key) + 1);
+  Insert(parlay::tabulate(keys.size(), [](std::size_t i) -> Id { return i; }),
+         [&](Id element) { return keys[element]; });
+}
+
+template <typename Id>
+template <typename IsCurrent>
+std::pair<gbbs::uintE, parlay::sequence<Id>> PeelingBuckets<Id>::NextBucket(
+    IsCurrent is_current) {
+  while (next_key_ < buckets_.size()) {
+    const gbbs::uintE key = next_key_++;
+    parlay::sequence<Id> bucket = std::move(buckets_[key]);
+    if (bucket.empty()) continue;
+    auto elements = parlay::filter(
+        bucket, [&](Id element) { return is_current(element, key); });
+    if (!elements.empty()) return {key, std::move(elements)};
+  }
+  return {0, parlay::sequence<Id>()};
+}
+
+template <typename Id>
+template <typename Key>
+void PeelingBuckets<Id>::Insert(parlay::sequence<Id> elements, Key key) {
+  if (elements.empty()) return;
+  parlay::integer_sort_inplace(elements, key);
+  const auto group_starts =
+      parlay::pack_index<std::size_t>(parlay::delayed_seq<bool>(
+          elements.size(), [&](std::size_t i) {
+            return i == 0 || key(elements[i]) != key(elements[i - 1]);
+          }));
+  // Every group goes to a different bucket.
+  parlay::parallel_for(0, group_starts.size(), [&](std::size_t i) {
+    const std::size_t begin = group_starts[i];
+    const std::size_t end = i + 1 < group_starts.size() ? group_starts[i + 1]
+                                                        : elements.size();
+    buckets_[key(elements[begin])].append(elements.begin() + begin,
+                                          elements.begin() + end);
+  });
+}
+
+}  // namespace graph_mining::in_memory
+
+#endif  // THIRD_PARTY_GRAPH_MINING_IN_MEMORY_PARALLEL_PEELING_BUCKETS_H_
@@ -0,0 +1,250 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/parallel/perf_counters.h"
+
+#ifdef __linux__
+#include <dirent.h>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "parlay/scheduler.h"
+
+namespace graph_mining::in_memory {
+namespace {
+
+internal::PerfEventOpenFunction perf_event_open_for_testing = nullptr;
+
+int64_t Difference(int64_t end, int64_t start) {
+  return end < 0 || start < 0 ? -1 : end - start;
+}
+
+#ifdef __linux__
+
+constexpr uint64_t HardwareCacheConfig(uint64_t cache, uint64_t result) {
+  return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (result << 16);
+}
+
+// The (type, config) pairs of the counted events, in the order of the fields
+// of PerfCounterValues.
+constexpr struct {
+  uint32_t type;
+  uint64_t config;
+} kEvents[] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE, HardwareCacheConfig(PERF_COUNT_HW_CACHE_LL,
+                                             PERF_COUNT_HW_CACHE_RESULT_MISS)},
+    {PERF_TYPE_HW_CACHE, HardwareCacheConfig(PERF_COUNT_HW_CACHE_DTLB,
+                                             PERF_COUNT_HW_CACHE_RESULT_MISS)},
+};
+
+// Returns the ids of all threads of the process.
+std::vector<pid_t> ThreadIds() {
+  std::vector<pid_t> thread_ids;
+  DIR* dir = opendir("/proc/self/task");
+  if (dir == nullptr) return {static_cast<pid_t>(syscall(SYS_gettid))};
+  while (const dirent* entry = readdir(dir)) {
+    int thread_id;
+    if (absl::SimpleAtoi(entry->d_name, &thread_id)) {
+      thread_ids.push_back(thread_id);
+    }
+  }
+  closedir(dir);
+  return thread_ids;
+}
+
+// Returns a file descriptor of a counter of the given event on the given
+// thread in the group of group_fd (or a new group if group_fd is -1), or -1 on
+// failure.
+int OpenCounter(uint32_t type, uint64_t config, pid_t thread_id,
+                int group_fd) {
+  perf_event_attr attr = {};
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                     PERF_FORMAT_TOTAL_TIME_RUNNING;
+  if (perf_event_open_for_testing != nullptr) {
+    return perf_event_open_for_testing(&attr, thread_id, /*cpu=*/-1, group_fd,
+                                       PERF_FLAG_FD_CLOEXEC);
+  }
+  return syscall(SYS_perf_event_open, &attr, thread_id, /*cpu=*/-1, group_fd,
+                 PERF_FLAG_FD_CLOEXEC);
+}
+
+// Reads the counters of the group of leader_fd into values, scaled up by the
+// fraction of time the group was not scheduled. Returns false on failure.
+bool ReadGroup(int leader_fd, std::vector<int64_t>& values) {
+  // The number of counters, the enabled and the running time, and the values.
+  std::vector<uint64_t> buffer(3 + values.size());
+  const ssize_t size = buffer.size() * sizeof(uint64_t);
+  if (read(leader_fd, buffer.data(), size) != size ||
+      buffer[0] != values.size()) {
+    return false;
+  }
+  const uint64_t time_enabled = buffer[1];
+  const uint64_t time_running = buffer[2];
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    const uint64_t value = buffer[3 + i];
+    if (time_running == 0) {
+      values[i] = 0;
+    } else if (time_running == time_enabled) {
+      values[i] = value;
+    } else {
+      values[i] = static_cast<int64_t>(static_cast<double>(value) *
+                                       time_enabled / time_running);
+    }
+  }
+  return true;
+}
+
+#endif  // __linux__
+
+// Returns the value in bytes of a "<key>: <value> kB" line of
+// /proc/self/status, or -1 if not found.
+int64_t ParseStatusKilobytes(absl::string_view line, absl::string_view key) {
+  if (!absl::ConsumePrefix(&line, key) || !absl::ConsumePrefix(&line, ":")) {
+    return -1;
+  }
+  std::vector<absl::string_view> parts =
+      absl::StrSplit(line, ' ', absl::SkipWhitespace());
+  int64_t kilobytes;
+  if (parts.size() != 2 || parts[1] != "kB" ||
+      !absl::SimpleAtoi(parts[0], &kilobytes)) {
+    return -1;
+  }
+  return kilobytes * 1024;
+}
+
+}  // namespace
+
+PerfCounterValues PerfCounterDifference(const PerfCounterValues& end,
+                                        const PerfCounterValues& start) {
+  return {Difference(end.cycles, start.cycles),
+          Difference(end.instructions, start.instructions),
+          Difference(end.llc_misses, start.llc_misses),
+          Difference(end.dtlb_misses, start.dtlb_misses)};
+}
+
+ProcessPerfCounters::ProcessPerfCounters() {
+#ifdef __linux__
+  // Make sure the parlay workers exist before enumerating the threads.
+  parlay::num_workers();
+  const pid_t current_thread_id = syscall(SYS_gettid);
+  std::vector<int> fds;
+  for (int event = 0; event < kNumEvents; ++event) {
+    const int fd = OpenCounter(kEvents[event].type, kEvents[event].config,
+                               current_thread_id, fds.empty() ? -1 : fds[0]);
+    if (fd >= 0) {
+      events_.push_back(event);
+      fds.push_back(fd);
+    }
+  }
+  if (events_.empty()) return;
+  group_fds_.push_back(std::move(fds));
+  for (const pid_t thread_id : ThreadIds()) {
+    if (thread_id == current_thread_id) continue;
+    fds.clear();
+    for (const int event : events_) {
+      const int fd = OpenCounter(kEvents[event].type, kEvents[event].config,
+                                 thread_id, fds.empty() ? -1 : fds[0]);
+      if (fd < 0) break;
+      fds.push_back(fd);
+    }
+    if (fds.size() == events_.size()) {
+      group_fds_.push_back(std::move(fds));
+      continue;
+    }
+    const int error = errno;
+    for (const int fd : fds) close(fd);
+    // Threads that exited in the meantime (ESRCH) are skipped.
+    if (error != ESRCH) {
+      CloseAll();
+      return;
+    }
+  }
+#endif
+}
+
+ProcessPerfCounters::~ProcessPerfCounters() { CloseAll(); }
+
+void ProcessPerfCounters::CloseAll() {
+#ifdef __linux__
+  for (const std::vector<int>& fds : group_fds_) {
+    for (const int fd : fds) close(fd);
+  }
+#endif
+  group_fds_.clear();
+  events_.clear();
+}
+
+bool ProcessPerfCounters::Available() const { return !events_.empty(); }
+
+PerfCounterValues ProcessPerfCounters::Read() const {
+  int64_t totals[kNumEvents] = {-1, -1, -1, -1};
+#ifdef __linux__
+  for (const int event : events_) totals[event] = 0;
+  std::vector<int64_t> values(events_.size());
+  for (const std::vector<int>& fds : group_fds_) {
+    if (!ReadGroup(fds[0], values)) {
+      for (const int event : events_) totals[event] = -1;
+      break;
+    }
+    for (std::size_t i = 0; i < events_.size(); ++i) {
+      totals[events_[i]] += values[i];
+    }
+  }
+#endif
+  return {totals[0], totals[1], totals[2], totals[3]};
+}
+
+MemoryUsage CurrentMemoryUsage() {
+  MemoryUsage usage;
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    int64_t bytes = ParseStatusKilobytes(line, "VmRSS");
+    if (bytes >= 0) usage.rss_bytes = bytes;
+    bytes = ParseStatusKilobytes(line, "VmHWM");
+    if (bytes >= 0) usage.peak_rss_bytes = bytes;
+  }
+  return usage;
+}
+
+namespace internal {
+
+void SetPerfEventOpenFunctionForTesting(PerfEventOpenFunction function) {
+  perf_event_open_for_testing = function;
+}
+
+}  // namespace internal
+
+}  // namespace graph_mining::in_memory
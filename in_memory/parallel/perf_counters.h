@@ -0,0 +1,111 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Hardware performance counters and memory usage of the current process.
+//
+// The counters are read with perf_event_open(2), which may be unavailable
+// (e.g., on non-Linux systems, in containers or VMs without a PMU, or when
+// /proc/sys/kernel/perf_event_paranoid forbids user-space counting). In this
+// case the affected values are -1 and no error is reported.
+
+#ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_PARALLEL_PERF_COUNTERS_H_
+#define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_PARALLEL_PERF_COUNTERS_H_
+
+#include <cstdint>
+#include <vector>
+
+namespace graph_mining::in_memory {
+
+// Values of hardware counters. Each value is -1 if the counter is unavailable.
+struct PerfCounterValues {
+  int64_t cycles = -1;
+  int64_t instructions = -1;
+  // Last-level cache read misses.
+  int64_t llc_misses = -1;
+  // Data TLB read misses.
+  int64_t dtlb_misses = -1;
+};
+
+// Returns end - start for every counter available in both.
+PerfCounterValues PerfCounterDifference(const PerfCounterValues& end,
+                                        const PerfCounterValues& start);
+
+// Counts the events of PerfCounterValues (in user space) on all threads of
+// the process that exist when the object is constructed. The constructor
+// starts the parlay scheduler if needed, so all parlay workers are included.
+//
+// The counters of each thread form one event group (see perf_event_open(2)),
+// so they are scheduled onto the PMU together and Read() takes one read(2) per
+// thread. The events are selected on the constructing thread: events that
+// cannot be counted there are left out of all groups. If a group cannot be
+// opened on another thread, no events are counted.
+//
+// This class is thread-compatible.
+class ProcessPerfCounters {
+ public:
+  ProcessPerfCounters();
+  ~ProcessPerfCounters();
+
+  ProcessPerfCounters(const ProcessPerfCounters&) = delete;
+  ProcessPerfCounters& operator=(const ProcessPerfCounters&) = delete;
+
+  // Returns true if at least one of the counters could be opened.
+  bool Available() const;
+
+  // Returns the numbers of events since construction, summed over all threads.
+  // Values are scaled up if the kernel multiplexed the counter groups.
+  PerfCounterValues Read() const;
+
+ private:
+  static constexpr int kNumEvents = 4;
+
+  // Closes all counters; no events are counted afterwards.
+  void CloseAll();
+
+  // The counted events, as indices of the fields of PerfCounterValues, in the
+  // order of the counters of a group.
+  std::vector<int> events_;
+  // File descriptors of the counters of each thread, in the order of events_.
+  // The first one is the group leader.
+  std::vector<std::vector<int>> group_fds_;
+};
+
+// Memory usage of the process. Each value is -1 if unavailable.
+struct MemoryUsage {
+  // Resident set size.
+  int64_t rss_bytes = -1;
+  // High-water mark of the resident set size since the start of the process.
+  int64_t peak_rss_bytes = -1;
+};
+
+// Returns the current memory usage of the process (read from
+// /proc/self/status).
+MemoryUsage CurrentMemoryUsage();
+
+namespace internal {
+
+// The signature of perf_event_open(2), where attr points to a perf_event_attr.
+using PerfEventOpenFunction = int (*)(void* attr, int thread_id, int cpu,
+                                      int group_fd, unsigned long flags);
+
+// Makes ProcessPerfCounters constructed afterwards open their counters with
+// function instead of perf_event_open(2), or with perf_event_open(2) again if
+// function is nullptr. For tests only; not thread-safe.
+void SetPerfEventOpenFunctionForTesting(PerfEventOpenFunction function);
+
+}  // namespace internal
+
+}  // namespace graph_mining::in_memory
+
+#endif  // THIRD_PARTY_GRAPH_MINING_IN_MEMORY_PARALLEL_PERF_COUNTERS_H_
@@ -0,0 +1,192 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/parallel/tracing.h"
+
+#include <time.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "in_memory/parallel/per_worker.h"
+
+namespace graph_mining::in_memory {
+namespace {
+
+int64_t SteadyClockNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Appends `value` as a JSON string literal.
+void AppendJsonString(absl::string_view value, std::string& output) {
+  output.push_back('"');
+  for (const char c : value) {
+    switch (c) {
+      case '"':
+        output.append("\\\"");
+        break;
+      case '\\':
+        output.append("\\\\");
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          absl::StrAppendFormat(&output, "\\u%04x", c);
+        } else {
+          output.push_back(c);
+        }
+    }
+  }
+  output.push_back('"');
+}
+
+}  // namespace
+
+Tracer& Tracer::Get() {
+  static Tracer* const tracer = new Tracer();
+  return *tracer;
+}
+
+void Tracer::Start(std::size_t events_per_worker) {
+  Stop();
+  events_per_worker_ = std::max<std::size_t>(1, events_per_worker);
+  buffers_ = std::make_unique<PerWorker<RingBuffer>>();
+  epoch_ns_ = SteadyClockNanos();
+  recording_.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::Stop() { recording_.store(false, std::memory_order_relaxed); }
+
+int64_t Tracer::NowNanos() const { return SteadyClockNanos() - epoch_ns_; }
+
+int64_t Tracer::ProcessCpuNanos() {
+  timespec time;
+  if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time) != 0) return -1;
+  return int64_t{time.tv_sec} * 1000000000 + time.tv_nsec;
+}
+
+void Tracer::Record(const TraceEvent& event) {
+  if (!IsRecording()) return;
+  RingBuffer& buffer = buffers_->Get();
+  if (buffer.events.size() < events_per_worker_) {
+    buffer.events.push_back(event);
+  } else {
+    buffer.events[buffer.num_recorded % events_per_worker_] = event;
+  }
+  ++buffer.num_recorded;
+}
+
+void Tracer::RecordElapsed(const char* name, double seconds) {
+  if (!IsRecording()) return;
+  const auto duration_ns = static_cast<int64_t>(seconds * 1e9);
+  Record({name, NowNanos() - duration_ns, duration_ns, /*cpu_ns=*/-1});
+}
+
+std::vector<std::vector<TraceEvent>> Tracer::Events() const {
+  std::vector<std::vector<TraceEvent>> events;
+  if (buffers_ == nullptr) return events;
+  events.resize(buffers_->NumWorkers());
+  for (int worker = 0; worker < buffers_->NumWorkers(); ++worker) {
+    const RingBuffer& buffer = buffers_->Get(worker);
+    // The oldest event is at index num_recorded % size once the buffer is full
+    // and at index 0 otherwise.
+    const std::size_t size = buffer.events.size();
+    const std::size_t oldest =
+        size < events_per_worker_ ? 0 : buffer.num_recorded % size;
+    events[worker].reserve(size);
+    for (std::size_t i = 0; i < size; ++i) {
+      events[worker].push_back(buffer.events[(oldest + i) % size]);
+    }
+  }
+  return events;
+}
+
+int64_t Tracer::NumDroppedEvents() const {
+  int64_t num_dropped = 0;
+  if (buffers_ == nullptr) return num_dropped;
+  for (int worker = 0; worker < buffers_->NumWorkers(); ++worker) {
+    const RingBuffer& buffer = buffers_->Get(worker);
+    num_dropped += buffer.num_recorded - buffer.events.size();
+  }
+  return num_dropped;
+}
+
+std::string Tracer::ChromeTraceJson() const {
+  const std::vector<std::vector<TraceEvent>> events = Events();
+  std::string json = "{\"traceEvents\":[";
+  bool first = true;
+  auto start_event = [&]() {
+    if (!first) json.push_back(',');
+    first = false;
+    json.append("\n");
+  };
+  for (std::size_t worker = 0; worker < events.size(); ++worker) {
+    if (events[worker].empty()) continue;
+    start_event();
+    absl::StrAppendFormat(&json,
+                          "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,"
+                          "\"tid\":%d,\"args\":{\"name\":\"worker %d\"}}",
+                          worker, worker);
+    for (const TraceEvent& event : events[worker]) {
+      start_event();
+      json.append("{\"name\":");
+      AppendJsonString(event.name, json);
+      // Timestamps are in microseconds.
+      absl::StrAppendFormat(
+          &json, ",\"ph\":\"X\",\"pid\":0,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f",
+          worker, event.start_ns / 1e3, event.duration_ns / 1e3);
+      if (event.cpu_ns >= 0) {
+        absl::StrAppendFormat(
+            &json, ",\"args\":{\"cpu_ms\":%.3f,\"parallelism\":%.2f}",
+            event.cpu_ns / 1e6,
+            event.duration_ns > 0
+                ? static_cast<double>(event.cpu_ns) / event.duration_ns
+                : 0.0);
+      }
+      json.push_back('}');
+    }
+  }
+  absl::StrAppend(&json, "\n],\"displayTimeUnit\":\"ms\",",
+                  "\"otherData\":{\"dropped_events\":", NumDroppedEvents(),
+                  "}}\n");
+  return json;
+}
+
+absl::Status Tracer::WriteChromeTrace(absl::string_view path) const {
+  std::ofstream file{std::string(path)};
+  if (!file) {
+    return absl::UnavailableError(
+        absl::StrCat("Cannot open trace file ", path));
+  }
+  file << ChromeTraceJson();
+  file.close();
+  if (!file) {
+    return absl::DataLossError(
+        absl::StrCat("Cannot write trace file ", path));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace graph_mining::in_memory
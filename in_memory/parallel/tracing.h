@@ -0,0 +1,185 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Low-overhead tracing of (nested) algorithm phases.
+//
+// Phases are marked with scopes:
+//
+//   {
+//     GRAPH_MINING_TRACE_SCOPE("ParHac/StarMerge");
+//     ...
+//   }
+//
+// The macros expand to nothing unless GRAPH_MINING_ENABLE_TRACING is defined
+// (e.g., with `bazel build --config=tracing`). When compiled in, a scope costs
+// a single relaxed atomic load unless the tracer is recording:
+//
+//   Tracer::Get().Start();
+//   ... run clusterers ...
+//   Tracer::Get().Stop();
+//   RETURN_IF_ERROR(Tracer::Get().WriteChromeTrace("/tmp/trace.json"));
+//
+// The resulting file can be opened in chrome://tracing or
+// https://ui.perfetto.dev. Events are grouped by the parlay worker that
+// recorded them.
+
+#ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_PARALLEL_TRACING_H_
+#define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_PARALLEL_TRACING_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "in_memory/parallel/per_worker.h"
+
+#ifdef GRAPH_MINING_ENABLE_TRACING
+#define GRAPH_MINING_TRACE_INTERNAL_CONCAT_IMPL(a, b) a##b
+#define GRAPH_MINING_TRACE_INTERNAL_CONCAT(a, b) \
+  GRAPH_MINING_TRACE_INTERNAL_CONCAT_IMPL(a, b)
+// Records the enclosing scope as a phase with the given name, which must be a
+// string with static storage duration (e.g., a string literal).
+#define GRAPH_MINING_TRACE_SCOPE(name)                              \
+  ::graph_mining::in_memory::TraceScope                             \
+      GRAPH_MINING_TRACE_INTERNAL_CONCAT(graph_mining_trace_scope_, \
+                                         __LINE__)(name)
+// Records a phase with the given name (see GRAPH_MINING_TRACE_SCOPE) that
+// ended now and took the given number of seconds. This is meant for code that
+// already measures its phases with a WallTimer.
+#define GRAPH_MINING_TRACE_ELAPSED(name, seconds) \
+  ::graph_mining::in_memory::Tracer::Get().RecordElapsed(name, seconds)
+#else
+#define GRAPH_MINING_TRACE_SCOPE(name) static_cast<void>(0)
+#define GRAPH_MINING_TRACE_ELAPSED(name, seconds) static_cast<void>(0)
+#endif
+
+namespace graph_mining::in_memory {
+
+// A completed phase.
+struct TraceEvent {
+  // Not owned, see GRAPH_MINING_TRACE_SCOPE.
+  const char* name;
+  // Nanoseconds since the tracer was started.
+  int64_t start_ns;
+  int64_t duration_ns;
+  // CPU time used by the whole process during the phase, or -1 if unknown.
+  // Together with duration_ns this shows how parallel the phase was (note that
+  // this includes the time spent by idle scheduler workers before they go to
+  // sleep).
+  int64_t cpu_ns;
+};
+
+// Collects TraceEvents in per-worker ring buffers. Once a buffer is full, the
+// oldest events of that worker are overwritten.
+//
+// Record() and RecordElapsed() are thread-safe when called from parlay workers
+// (including the main thread). All other methods must be called from serial
+// code.
+class Tracer {
+ public:
+  static constexpr std::size_t kDefaultEventsPerWorker = 1 << 14;
+
+  // Returns the process-wide tracer.
+  static Tracer& Get();
+
+  // Discards all previously recorded events and starts recording. Each worker
+  // keeps at most events_per_worker most recent events.
+  void Start(std::size_t events_per_worker = kDefaultEventsPerWorker);
+
+  // Stops recording. The recorded events are kept until the next Start().
+  void Stop();
+
+  bool IsRecording() const {
+    return recording_.load(std::memory_order_relaxed);
+  }
+
+  // Nanoseconds since the tracer was started.
+  int64_t NowNanos() const;
+
+  // Process CPU time in nanoseconds, or -1 if unavailable.
+  static int64_t ProcessCpuNanos();
+
+  // Records an event on behalf of the current worker. No-op if the tracer is
+  // not recording.
+  void Record(const TraceEvent& event);
+
+  // Records an event that ended now and took the given number of seconds.
+  void RecordElapsed(const char* name, double seconds);
+
+  // Returns the recorded events, indexed by worker id, in the order in which
+  // they were completed.
+  std::vector<std::vector<TraceEvent>> Events() const;
+
+  // Returns the number of events that were overwritten.
+  int64_t NumDroppedEvents() const;
+
+  // Returns the recorded events in the Chrome trace event format.
+  std::string ChromeTraceJson() const;
+
+  // Writes ChromeTraceJson() to the given file.
+  absl::Status WriteChromeTrace(absl::string_view path) const;
+
+ private:
+  struct RingBuffer {
+    std::vector<TraceEvent> events;
+    // Total number of events recorded, including overwritten ones.
+    int64_t num_recorded = 0;
+  };
+
+  Tracer() = default;
+
+  std::atomic<bool> recording_ = false;
+  std::size_t events_per_worker_ = kDefaultEventsPerWorker;
+  int64_t epoch_ns_ = 0;
+  std::unique_ptr<PerWorker<RingBuffer>> buffers_;
+};
+
+// Records the lifetime of the object as a TraceEvent. Use through
+// GRAPH_MINING_TRACE_SCOPE.
+class TraceScope {
+ public:
+  explicit TraceScope(const char* name) {
+    Tracer& tracer = Tracer::Get();
+    if (!tracer.IsRecording()) return;
+    name_ = name;
+    start_ns_ = tracer.NowNanos();
+    start_cpu_ns_ = Tracer::ProcessCpuNanos();
+  }
+
+  ~TraceScope() {
+    if (name_ == nullptr) return;
+    Tracer& tracer = Tracer::Get();
+    const int64_t end_cpu_ns = Tracer::ProcessCpuNanos();
+    tracer.Record(
+        {name_, start_ns_, tracer.NowNanos() - start_ns_,
+         start_cpu_ns_ < 0 ? -1 : end_cpu_ns - start_cpu_ns_});
+  }
+
+  TraceScope(const TraceScope&) = delete;
+  TraceScope& operator=(const TraceScope&) = delete;
+
+ private:
+  // nullptr if the tracer was not recording when the scope was entered.
+  const char* name_ = nullptr;
+  int64_t start_ns_ = 0;
+  int64_t start_cpu_ns_ = 0;
+};
+
+}  // namespace graph_mining::in_memory
+
+#endif  // THIRD_PARTY_GRAPH_MINING_IN_MEMORY_PARALLEL_TRACING_H_
@@ -0,0 +1,130 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/parallel/tracing.h"
+
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace graph_mining::in_memory {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::Field;
+using ::testing::HasSubstr;
+using ::testing::StrEq;
+
+// Returns the recorded events of all workers.
+std::vector<TraceEvent> AllEvents() {
+  std::vector<TraceEvent> all_events;
+  for (const auto& events : Tracer::Get().Events()) {
+    all_events.insert(all_events.end(), events.begin(), events.end());
+  }
+  return all_events;
+}
+
+testing::Matcher<TraceEvent> EventNamed(const char* name) {
+  return Field(&TraceEvent::name, StrEq(name));
+}
+
+TEST(TracerTest, RecordsNestedScopesInCompletionOrder) {
+  Tracer& tracer = Tracer::Get();
+  tracer.Start();
+  {
+    TraceScope outer("outer");
+    { TraceScope inner("inner"); }
+  }
+  tracer.Stop();
+  { TraceScope ignored("ignored"); }
+
+  const std::vector<TraceEvent> events = AllEvents();
+  ASSERT_THAT(events, ElementsAre(EventNamed("inner"), EventNamed("outer")));
+  EXPECT_LE(events[1].start_ns, events[0].start_ns);
+  EXPECT_GE(events[1].start_ns + events[1].duration_ns,
+            events[0].start_ns + events[0].duration_ns);
+  EXPECT_GE(events[0].duration_ns, 0);
+  EXPECT_EQ(tracer.NumDroppedEvents(), 0);
+}
+
+TEST(TracerTest, StartDiscardsPreviousEvents) {
+  Tracer& tracer = Tracer::Get();
+  tracer.Start();
+  { TraceScope scope("first"); }
+  tracer.Start();
+  { TraceScope scope("second"); }
+  tracer.Stop();
+  EXPECT_THAT(AllEvents(), ElementsAre(EventNamed("second")));
+}
+
+TEST(TracerTest, RingBufferKeepsMostRecentEvents) {
+  Tracer& tracer = Tracer::Get();
+  tracer.Start(/*events_per_worker=*/2);
+  const char* const names[] = {"a", "b", "c", "d", "e"};
+  for (const char* name : names) {
+    tracer.Record({name, /*start_ns=*/0, /*duration_ns=*/1, /*cpu_ns=*/-1});
+  }
+  tracer.Stop();
+  EXPECT_THAT(AllEvents(), ElementsAre(EventNamed("d"), EventNamed("e")));
+  EXPECT_EQ(tracer.NumDroppedEvents(), 3);
+}
+
+TEST(TracerTest, RecordElapsed) {
+  Tracer& tracer = Tracer::Get();
+  tracer.Start();
+  tracer.RecordElapsed("elapsed", 0.25);
+  tracer.Stop();
+  const std::vector<TraceEvent> events = AllEvents();
+  ASSERT_THAT(events, ElementsAre(EventNamed("elapsed")));
+  EXPECT_EQ(events[0].duration_ns, 250000000);
+  EXPECT_EQ(events[0].cpu_ns, -1);
+}
+
+TEST(TracerTest, ChromeTraceJsonEscapesNames) {
+  Tracer& tracer = Tracer::Get();
+  tracer.Start();
+  tracer.Record({"say \"hi\"\\", /*start_ns=*/1000, /*duration_ns=*/2000,
+                 /*cpu_ns=*/4000});
+  tracer.Stop();
+  const std::string json = tracer.ChromeTraceJson();
+  EXPECT_THAT(json, HasSubstr(R"("name":"say \"hi\"\\")"));
+  EXPECT_THAT(json, HasSubstr(R"("ts":1.000,"dur":2.000)"));
+  EXPECT_THAT(json, HasSubstr(R"("parallelism":2.00)"));
+  EXPECT_THAT(json, HasSubstr(R"("dropped_events":0)"));
+}
+
+TEST(TracerTest, WriteChromeTrace) {
+  Tracer& tracer = Tracer::Get();
+  tracer.Start();
+  { TraceScope scope("phase"); }
+  tracer.Stop();
+  const std::string path = testing::TempDir() + "/trace.json";
+  ASSERT_TRUE(tracer.WriteChromeTrace(path).ok());
+  std::ifstream file(path);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  EXPECT_EQ(contents.str(), tracer.ChromeTraceJson());
+
+  EXPECT_FALSE(
+      tracer.WriteChromeTrace(testing::TempDir() + "/missing/trace.json")
+          .ok());
+}
+
+}  // namespace
+}  // namespace graph_mining::in_memory
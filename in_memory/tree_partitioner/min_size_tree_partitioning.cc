@@ -1,6 +1,9 @@
 #include "in_memory/tree_partitioner/min_size_tree_partitioning.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <limits>
 #include <queue>
 #include <stack>
 #include <utility>
@@ -11,8 +14,13 @@
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/types/span.h"
+#include "in_memory/clustering/parallel_dendrogram.h"
 #include "in_memory/clustering/types.h"
 #include "in_memory/status_macros.h"
+#include "parlay/monoid.h"
+#include "parlay/parallel.h"
+#include "parlay/primitives.h"
+#include "parlay/sequence.h"
 
 namespace graph_mining::in_memory {
 
@@ -267,6 +275,262 @@ void PartitionSubtree(const int root, const double min_weight_threshold,
 
 }  // namespace internal
 
+namespace {
+
+// A cluster of the partially computed partition of a subtree.
+struct ClusterCandidate {
+  NodeId cluster_id = -1;
+  double weight = std::numeric_limits<double>::infinity();
+};
+
+ClusterCandidate LighterCluster(const ClusterCandidate& a,
+                                const ClusterCandidate& b) {
+  return (b.weight < a.weight ||
+          (b.weight == a.weight && b.cluster_id < a.cluster_id))
+             ? b
+             : a;
+}
+
+// Nodes with fewer children than this are processed with sequential loops.
+// Most nodes of HAC dendrograms have two children, for which the overhead of
+// the parlay primitives would dominate the work of the node.
+constexpr std::size_t kSequentialNumChildren = 1024;
+
+// Returns the sum of weight(i) for i in [0, n).
+template <typename Weight>
+double SumOfWeights(std::size_t n, Weight weight) {
+  if (n < kSequentialNumChildren) {
+    double sum = 0;
+    for (std::size_t i = 0; i < n; ++i) sum += weight(i);
+    return sum;
+  }
+  return parlay::reduce(parlay::delayed_seq<double>(n, weight),
+                        parlay::addm<double>());
+}
+
+// Returns the lightest of cluster(i) for i in [0, n), or ClusterCandidate() if
+// n is 0.
+template <typename Cluster>
+ClusterCandidate LightestCluster(std::size_t n, Cluster cluster) {
+  if (n < kSequentialNumChildren) {
+    ClusterCandidate lightest_cluster;
+    for (std::size_t i = 0; i < n; ++i) {
+      lightest_cluster = LighterCluster(lightest_cluster, cluster(i));
+    }
+    return lightest_cluster;
+  }
+  return parlay::reduce(
+      parlay::delayed_seq<ClusterCandidate>(n, cluster),
+      parlay::make_monoid(LighterCluster, ClusterCandidate()));
+}
+
+// Returns the values element(i) for i in [0, n) that satisfy keep, in order.
+template <typename T, typename Element, typename Keep>
+parlay::sequence<T> FilterElements(std::size_t n, Element element, Keep keep) {
+  if (n < kSequentialNumChildren) {
+    parlay::sequence<T> result;
+    for (std::size_t i = 0; i < n; ++i) {
+      T value = element(i);
+      if (keep(value)) result.push_back(std::move(value));
+    }
+    return result;
+  }
+  return parlay::filter(parlay::delayed_seq<T>(n, element), keep);
+}
+
+// Greedily packs unassigned subtrees, given by their roots and weights, into
+// clusters of weight at least min_weight_threshold and updates the parent ids
+// of the roots accordingly. As in internal::PartitionClusters, the cluster
+// containing root_id has cluster id root_id. The total weight must be at least
+// min_weight_threshold. Returns the lightest of the created clusters.
+ClusterCandidate PackUnassignedSubtrees(
+    parlay::sequence<std::pair<NodeId, double>>& subtrees,
+    double min_weight_threshold, NodeId root_id,
+    std::vector<NodeId>& result_parent_ids) {
+  auto lighter = [](const std::pair<NodeId, double>& x,
+                    const std::pair<NodeId, double>& y) {
+    return (x.second < y.second) || (x.second == y.second && x.first < y.first);
+  };
+  if (subtrees.size() < kSequentialNumChildren) {
+    std::sort(subtrees.begin(), subtrees.end(), lighter);
+  } else {
+    parlay::sort_inplace(subtrees, lighter);
+  }
+  // End offsets and weights of the clusters.
+  std::vector<std::pair<std::size_t, double>> clusters;
+  double current_cluster_weight = 0;
+  for (std::size_t i = 0; i < subtrees.size(); ++i) {
+    current_cluster_weight += subtrees[i].second;
+    if (current_cluster_weight >= min_weight_threshold) {
+      clusters.push_back({i + 1, current_cluster_weight});
+      current_cluster_weight = 0;
+    }
+  }
+  ABSL_CHECK(!clusters.empty());
+  // If the last cluster is not large enough, merge it with the previous
+  // cluster.
+  if (clusters.back().first != subtrees.size()) {
+    clusters.back().first = subtrees.size();
+    clusters.back().second += current_cluster_weight;
+  }
+  ClusterCandidate lightest_cluster;
+  std::size_t begin = 0;
+  for (const auto& [end, weight] : clusters) {
+    NodeId cluster_id = subtrees[begin].first;
+    for (std::size_t i = begin; i < end; ++i) {
+      if (subtrees[i].first == root_id) cluster_id = root_id;
+    }
+    for (std::size_t i = begin; i < end; ++i) {
+      const NodeId node_id = subtrees[i].first;
+      result_parent_ids[node_id] = node_id == cluster_id ? -1 : cluster_id;
+    }
+    lightest_cluster = LighterCluster(lightest_cluster, {cluster_id, weight});
+    begin = end;
+  }
+  return lightest_cluster;
+}
+
+// Checks the input of the parallel partitioning functions. See
+// MinWeightedSizeTreePartitioning for the conditions.
+absl::Status ValidateForest(absl::Span<const NodeId> parent_ids,
+                            absl::Span<const double> node_weights) {
+  const std::size_t n = parent_ids.size();
+  if (node_weights.size() != n) {
+    return absl::InvalidArgumentError(
+        "The sizes of parent_ids and node_weights are inconsistent.");
+  }
+  const std::size_t num_invalid_parent_ids =
+      parlay::count_if(parent_ids, [&](NodeId parent_id) {
+        return parent_id < -1 || parent_id >= static_cast<NodeId>(n);
+      });
+  if (num_invalid_parent_ids > 0) {
+    return absl::InvalidArgumentError("The parent id is out of range.");
+  }
+  const std::size_t first_negative_weight_node = parlay::reduce(
+      parlay::delayed_seq<std::size_t>(
+          n, [&](std::size_t i) { return node_weights[i] < 0 ? i : n; }),
+      parlay::minm<std::size_t>());
+  if (first_negative_weight_node < n) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "The node weight of node ", first_negative_weight_node,
+        " is negative: ", node_weights[first_negative_weight_node]));
+  }
+  return absl::OkStatus();
+}
+
+// Children lists of a forest in CSR format: the children of node i are
+// children[child_begin[i]], ..., children[child_end[i] - 1] in increasing
+// order of ids.
+struct ChildrenArrays {
+  parlay::sequence<NodeId> children;
+  std::vector<std::size_t> child_begin;
+  std::vector<std::size_t> child_end;
+
+  auto Children(NodeId node_id) const {
+    return parlay::make_slice(children.begin() + child_begin[node_id],
+                              children.begin() + child_end[node_id]);
+  }
+};
+
+// Computes the children arrays with a parallel (stable) integer sort of the
+// non-root nodes by their parents. parent_ids must be in range.
+ChildrenArrays ComputeChildrenArrays(absl::Span<const NodeId> parent_ids) {
+  const std::size_t n = parent_ids.size();
+  ChildrenArrays result{
+      parlay::filter(parlay::iota<NodeId>(n),
+                     [&](NodeId i) { return parent_ids[i] >= 0; }),
+      std::vector<std::size_t>(n, 0), std::vector<std::size_t>(n, 0)};
+  auto& children = result.children;
+  parlay::integer_sort_inplace(children, [&](NodeId i) {
+    return static_cast<std::size_t>(parent_ids[i]);
+  });
+  parlay::parallel_for(0, children.size(), [&](std::size_t i) {
+    const NodeId parent_id = parent_ids[children[i]];
+    if (i == 0 || parent_ids[children[i - 1]] != parent_id) {
+      result.child_begin[parent_id] = i;
+    }
+    if (i + 1 == children.size() || parent_ids[children[i + 1]] != parent_id) {
+      result.child_end[parent_id] = i + 1;
+    }
+  });
+  return result;
+}
+
+// Calls process_node(i) for every node i such that all children of a node are
+// processed before the node itself. Each leaf starts a walk towards its root.
+// The walk of the last processed child of a node continues with that node, so
+// the walks touch every node once. Independent subtrees are processed in
+// parallel and there are no per-level rounds. Returns an error if parent_ids
+// has a cycle.
+template <typename ProcessNode>
+absl::Status ProcessBottomUp(absl::Span<const NodeId> parent_ids,
+                             const ChildrenArrays& children_arrays,
+                             ProcessNode process_node) {
+  const std::size_t n = parent_ids.size();
+  // The number of children of each node that have not been processed.
+  std::vector<std::atomic<std::size_t>> num_unprocessed_children(n);
+  parlay::parallel_for(0, n, [&](std::size_t i) {
+    num_unprocessed_children[i].store(
+        children_arrays.child_end[i] - children_arrays.child_begin[i],
+        std::memory_order_relaxed);
+  });
+  auto leaves = parlay::pack_index<NodeId>(
+      parlay::delayed_seq<bool>(n, [&](std::size_t i) {
+        return children_arrays.child_begin[i] == children_arrays.child_end[i];
+      }));
+  parlay::sequence<std::size_t> num_processed_nodes(leaves.size());
+  parlay::parallel_for(
+      0, leaves.size(),
+      [&](std::size_t i) {
+        NodeId node_id = leaves[i];
+        std::size_t num_processed = 0;
+        while (true) {
+          process_node(node_id);
+          ++num_processed;
+          const NodeId parent_id = parent_ids[node_id];
+          if (parent_id == -1 ||
+              num_unprocessed_children[parent_id].fetch_sub(
+                  1, std::memory_order_acq_rel) != 1) {
+            break;
+          }
+          node_id = parent_id;
+        }
+        num_processed_nodes[i] = num_processed;
+      },
+      /*granularity=*/1);
+  if (parlay::reduce(num_processed_nodes, parlay::addm<std::size_t>()) != n) {
+    return absl::InvalidArgumentError("Invalid parent ids: cycle detected.");
+  }
+  return absl::OkStatus();
+}
+
+// Converts a dendrogram into parent ids and node weights, see
+// ParallelMinWeightedSizeTreePartitioning.
+absl::Status DendrogramToForest(const ParallelDendrogram& dendrogram,
+                                absl::Span<const double> leaf_weights,
+                                std::vector<NodeId>& parent_ids,
+                                std::vector<double>& node_weights) {
+  const std::size_t num_leaves = dendrogram.NumNodes();
+  if (!leaf_weights.empty() && leaf_weights.size() != num_leaves) {
+    return absl::InvalidArgumentError(
+        "The sizes of the dendrogram and leaf_weights are inconsistent.");
+  }
+  const std::size_t num_cluster_ids =
+      num_leaves == 0 ? 0 : dendrogram.MaxClusterId();
+  parent_ids.resize(num_cluster_ids);
+  node_weights.assign(num_cluster_ids, 0);
+  parlay::parallel_for(0, num_cluster_ids, [&](std::size_t i) {
+    parent_ids[i] =
+        dendrogram.HasValidParent(i) ? dendrogram.GetParent(i).parent_id : -1;
+    if (i < num_leaves) {
+      node_weights[i] = leaf_weights.empty() ? 1 : leaf_weights[i];
+    }
+  });
+  return absl::OkStatus();
+}
+
+}  // namespace
+
 absl::StatusOr<std::vector<NodeId>> MinWeightedSizeTreePartitioning(
     const std::vector<NodeId>& parent_ids,
     const std::vector<double>& node_weights,
@@ -294,4 +558,193 @@ absl::StatusOr<std::vector<NodeId>> MinWeightedSizeTreePartitioning(
   return result_parent_ids;
 }
 
+absl::StatusOr<std::vector<NodeId>> ParallelMinWeightedSizeTreePartitioning(
+    absl::Span<const NodeId> parent_ids, absl::Span<const double> node_weights,
+    const double min_weight_threshold) {
+  if (min_weight_threshold < 0) {
+    return absl::InvalidArgumentError("Negative min_weight_threshold.");
+  }
+  RETURN_IF_ERROR(ValidateForest(parent_ids, node_weights));
+  const std::size_t n = parent_ids.size();
+  const ChildrenArrays children_arrays = ComputeChildrenArrays(parent_ids);
+
+  // A processed node is either part of a cluster, or it is the root of an
+  // unassigned subtree of weight unassigned_weights[i] < min_weight_threshold
+  // whose nodes will be added to the cluster of an ancestor. Initially, all
+  // nodes keep their parents.
+  std::vector<NodeId> result_parent_ids(parent_ids.begin(), parent_ids.end());
+  parlay::sequence<bool> is_unassigned(n, false);
+  std::vector<double> unassigned_weights(n, 0);
+  // The lightest cluster in the subtree of each node.
+  std::vector<ClusterCandidate> lightest_clusters(n);
+
+  auto process_node = [&](NodeId node_id) {
+    const auto node_children = children_arrays.Children(node_id);
+    const double unassigned_weight =
+        node_weights[node_id] +
+        SumOfWeights(node_children.size(), [&](std::size_t i) {
+          const NodeId child = node_children[i];
+          return is_unassigned[child] ? unassigned_weights[child] : 0.0;
+        });
+    ClusterCandidate lightest_cluster =
+        LightestCluster(node_children.size(), [&](std::size_t i) {
+          return lightest_clusters[node_children[i]];
+        });
+    if (unassigned_weight < min_weight_threshold) {
+      is_unassigned[node_id] = true;
+      unassigned_weights[node_id] = unassigned_weight;
+      if (parent_ids[node_id] == -1 && lightest_cluster.cluster_id != -1) {
+        // Attach the remaining nodes of the tree to its lightest cluster,
+        // keeping node_id as the root.
+        result_parent_ids[lightest_cluster.cluster_id] = node_id;
+      }
+    } else {
+      // The unassigned subtrees of the children, followed by the node itself.
+      auto subtrees = FilterElements<std::pair<NodeId, double>>(
+          node_children.size() + 1,
+          [&](std::size_t i) {
+            if (i == node_children.size()) {
+              return std::make_pair(node_id, node_weights[node_id]);
+            }
+            const NodeId child = node_children[i];
+            return std::make_pair(is_unassigned[child] ? child : -1,
+                                  unassigned_weights[child]);
+          },
+          [](const std::pair<NodeId, double>& subtree) {
+            return subtree.first != -1;
+          });
+      lightest_cluster = LighterCluster(
+          lightest_cluster,
+          PackUnassignedSubtrees(subtrees, min_weight_threshold, node_id,
+                                 result_parent_ids));
+    }
+    lightest_clusters[node_id] = lightest_cluster;
+  };
+  RETURN_IF_ERROR(ProcessBottomUp(parent_ids, children_arrays, process_node));
+  return result_parent_ids;
+}
+
+absl::StatusOr<std::vector<NodeId>> ParallelMinWeightedSizeTreePartitioning(
+    const ParallelDendrogram& dendrogram, absl::Span<const double> leaf_weights,
+    const double min_weight_threshold) {
+  std::vector<NodeId> parent_ids;
+  std::vector<double> node_weights;
+  RETURN_IF_ERROR(
+      DendrogramToForest(dendrogram, leaf_weights, parent_ids, node_weights));
+  return ParallelMinWeightedSizeTreePartitioning(parent_ids, node_weights,
+                                                 min_weight_threshold);
+}
+
+absl::StatusOr<std::vector<NodeId>> MinMaxWeightedSizeTreePartitioning(
+    absl::Span<const NodeId> parent_ids, absl::Span<const double> node_weights,
+    const double min_weight, const double max_weight) {
+  if (min_weight < 0) {
+    return absl::InvalidArgumentError("Negative min_weight.");
+  }
+  if (max_weight < 2 * min_weight) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("max_weight must be at least 2 * min_weight, got ",
+                     max_weight, " and ", min_weight));
+  }
+  RETURN_IF_ERROR(ValidateForest(parent_ids, node_weights));
+  const std::size_t n = parent_ids.size();
+  const ChildrenArrays children_arrays = ComputeChildrenArrays(parent_ids);
+
+  // Every node is added to exactly one piece when it is processed. A piece is
+  // either a part, whose id is its node with parent id -1, or it is unassigned
+  // and has weight below min_weight. The unassigned piece of the subtree of
+  // node i (if any) is represented by its node unassigned_roots[i] and is
+  // passed on to the parent of node i.
+  std::vector<NodeId> result_parent_ids(n, -1);
+  std::vector<NodeId> unassigned_roots(n, -1);
+  std::vector<double> unassigned_weights(n, 0);
+  // The lightest part in the subtree of each node.
+  std::vector<ClusterCandidate> lightest_parts(n);
+
+  auto process_node = [&](NodeId node_id) {
+    const auto node_children = children_arrays.Children(node_id);
+    ClusterCandidate lightest_part =
+        LightestCluster(node_children.size(), [&](std::size_t i) {
+          return lightest_parts[node_children[i]];
+        });
+    // The pieces to pack: the unassigned pieces of the children, in the order
+    // of the children, preceded by the node itself if it is light.
+    const double node_weight = node_weights[node_id];
+    const bool is_heavy_node = node_weight >= min_weight;
+    auto pieces = FilterElements<std::pair<NodeId, double>>(
+        node_children.size() + 1,
+        [&](std::size_t i) {
+          if (i == 0) {
+            return std::make_pair(is_heavy_node ? -1 : node_id, node_weight);
+          }
+          const NodeId child = node_children[i - 1];
+          return std::make_pair(unassigned_roots[child],
+                                unassigned_weights[child]);
+        },
+        [](const std::pair<NodeId, double>& piece) {
+          return piece.first != -1;
+        });
+
+    // Greedily groups consecutive pieces into parts. As every piece is lighter
+    // than min_weight, every part is lighter than 2 * min_weight <= max_weight.
+    std::size_t begin = 0;
+    double weight = 0;
+    for (std::size_t i = 0; i < pieces.size(); ++i) {
+      weight += pieces[i].second;
+      if (weight >= min_weight) {
+        for (std::size_t j = begin + 1; j <= i; ++j) {
+          result_parent_ids[pieces[j].first] = pieces[begin].first;
+        }
+        lightest_part = LighterCluster(lightest_part,
+                                       {pieces[begin].first, weight});
+        begin = i + 1;
+        weight = 0;
+      }
+    }
+    // The remaining pieces form the unassigned piece of the subtree, unless
+    // they fit into the part of a heavy node.
+    NodeId unassigned_root = -1;
+    double heavy_node_part_weight = node_weight;
+    if (begin < pieces.size()) {
+      if (is_heavy_node && node_weight + weight <= max_weight) {
+        heavy_node_part_weight += weight;
+        weight = 0;
+      } else {
+        unassigned_root = pieces[begin].first;
+      }
+      const NodeId root = unassigned_root == -1 ? node_id : unassigned_root;
+      for (std::size_t j = begin; j < pieces.size(); ++j) {
+        if (pieces[j].first != root) result_parent_ids[pieces[j].first] = root;
+      }
+    }
+    if (is_heavy_node) {
+      lightest_part =
+          LighterCluster(lightest_part, {node_id, heavy_node_part_weight});
+    }
+    if (unassigned_root != -1 && parent_ids[node_id] == -1 &&
+        lightest_part.cluster_id != -1 &&
+        lightest_part.weight + weight <= max_weight) {
+      // Merge the remaining piece of the tree into its lightest part.
+      result_parent_ids[unassigned_root] = lightest_part.cluster_id;
+      unassigned_root = -1;
+    }
+    unassigned_roots[node_id] = unassigned_root;
+    unassigned_weights[node_id] = unassigned_root == -1 ? 0 : weight;
+    lightest_parts[node_id] = lightest_part;
+  };
+  RETURN_IF_ERROR(ProcessBottomUp(parent_ids, children_arrays, process_node));
+  return result_parent_ids;
+}
+
+absl::StatusOr<std::vector<NodeId>> MinMaxWeightedSizeTreePartitioning(
+    const ParallelDendrogram& dendrogram, absl::Span<const double> leaf_weights,
+    const double min_weight, const double max_weight) {
+  std::vector<NodeId> parent_ids;
+  std::vector<double> node_weights;
+  RETURN_IF_ERROR(
+      DendrogramToForest(dendrogram, leaf_weights, parent_ids, node_weights));
+  return MinMaxWeightedSizeTreePartitioning(parent_ids, node_weights,
+                                            min_weight, max_weight);
+}
+
 }  // namespace graph_mining::in_memory
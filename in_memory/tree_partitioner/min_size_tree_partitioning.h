@@ -5,6 +5,8 @@
 #include <vector>
 
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "in_memory/clustering/parallel_dendrogram.h"
 #include "in_memory/clustering/types.h"
 
 namespace graph_mining::in_memory {
@@ -28,6 +30,77 @@ MinWeightedSizeTreePartitioning(
     const std::vector<graph_mining::in_memory::NodeId>& parent_ids,
     const std::vector<double>& node_weights, double min_weight_threshold);
 
+// Parallel version of MinWeightedSizeTreePartitioning for large forests, e.g.,
+// HAC dendrograms with billions of nodes. It has the same input format and
+// error conditions, and also returns a forest represented by parent ids where
+// each tree is a cluster. Every tree of the returned forest is contained in a
+// tree of the input forest and has weight at least min_weight_threshold,
+// except for input trees with total weight below min_weight_threshold, which
+// are returned unchanged. Roots of input trees remain roots.
+//
+// The clusters are computed bottom-up: a node whose own weight plus the
+// unassigned weight of its children reaches min_weight_threshold partitions
+// these into clusters as in internal::PartitionClusters, and otherwise passes
+// the unassigned weight on to its parent. A remaining underweight cluster at
+// the root of an input tree is merged with the lightest cluster in that tree.
+// Hence the result may differ from the one of MinWeightedSizeTreePartitioning.
+// Independent subtrees are processed in parallel; the work is linear in the
+// number of nodes (up to sorting the children of each node) and the depth is
+// proportional to the height of the forest. Since the result of a subtree is a
+// partition rather than a value that can be composed along a path, no tree
+// contraction is used: a path-like forest, such as the dendrogram of a HAC run
+// that keeps growing a single cluster, is processed sequentially in time
+// linear in its height regardless of the number of workers. The children of a
+// node are only processed in parallel if there are many of them.
+absl::StatusOr<std::vector<graph_mining::in_memory::NodeId>>
+ParallelMinWeightedSizeTreePartitioning(
+    absl::Span<const graph_mining::in_memory::NodeId> parent_ids,
+    absl::Span<const double> node_weights, double min_weight_threshold);
+
+// Same as above but the forest is given by a dendrogram with num_nodes leaves.
+// The returned parent ids are indexed by the cluster ids of the dendrogram,
+// i.e., from 0 to 2 * num_nodes - 2. Leaf i has weight leaf_weights[i], or 1 if
+// leaf_weights is empty, and all the other nodes have weight 0.
+absl::StatusOr<std::vector<graph_mining::in_memory::NodeId>>
+ParallelMinWeightedSizeTreePartitioning(
+    const graph_mining::in_memory::ParallelDendrogram& dendrogram,
+    absl::Span<const double> leaf_weights, double min_weight_threshold);
+
+// Partitions a forest, given as for MinWeightedSizeTreePartitioning, into parts
+// with weights between min_weight and max_weight, where max_weight must be at
+// least 2 * min_weight. Returns a forest represented by parent ids where each
+// tree is a part and each part is contained in a tree of the input forest. The
+// bounds may only be violated by
+// 1) a part consisting of a node heavier than max_weight, and
+// 2) a part lighter than min_weight containing the nodes of an input tree that
+//    are left over after packing the rest of the tree, if adding them to the
+//    lightest part of the tree would exceed max_weight (or if the whole tree is
+//    lighter than min_weight).
+//
+// The parts are packed greedily bottom-up: each node groups its own weight (if
+// lighter than min_weight) and the unassigned pieces passed on by its children
+// into parts in the order of the children, and passes on the remaining pieces
+// as one unassigned piece to its parent. A node that is at least as heavy as
+// min_weight forms a part that also takes the remaining pieces if they fit.
+// This uses the same parallel bottom-up processing as
+// ParallelMinWeightedSizeTreePartitioning and no sorting, so it has the same
+// depth proportional to the height of the forest. Returns an error
+// under the same conditions as MinWeightedSizeTreePartitioning or if
+// max_weight < 2 * min_weight.
+absl::StatusOr<std::vector<graph_mining::in_memory::NodeId>>
+MinMaxWeightedSizeTreePartitioning(
+    absl::Span<const graph_mining::in_memory::NodeId> parent_ids,
+    absl::Span<const double> node_weights, double min_weight,
+    double max_weight);
+
+// Same as above but the forest is given by a dendrogram, see
+// ParallelMinWeightedSizeTreePartitioning.
+absl::StatusOr<std::vector<graph_mining::in_memory::NodeId>>
+MinMaxWeightedSizeTreePartitioning(
+    const graph_mining::in_memory::ParallelDendrogram& dendrogram,
+    absl::Span<const double> leaf_weights, double min_weight,
+    double max_weight);
+
 // TODO: add a function doing the same thing as
 // MinWeightedSizeTreePartitioning except rounding the weights to a particular
 // precision at the beginning.
@@ -0,0 +1,375 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/tree_partitioner/min_size_tree_partitioning.h"
+
+#include <cstddef>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "in_memory/clustering/parallel_dendrogram.h"
+#include "in_memory/clustering/types.h"
+#include "in_memory/status_macros.h"  // IWYU pragma: keep
+
+namespace graph_mining::in_memory {
+namespace {
+
+using ::absl::StatusCode;
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+// Returns the root of each node of the forest given by parent_ids, or an empty
+// vector if parent_ids has a cycle.
+std::vector<NodeId> Roots(const std::vector<NodeId>& parent_ids) {
+  const std::size_t n = parent_ids.size();
+  std::vector<NodeId> roots(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    NodeId node_id = i;
+    for (std::size_t steps = 0; parent_ids[node_id] != -1; ++steps) {
+      if (steps == n) return {};
+      node_id = parent_ids[node_id];
+    }
+    roots[i] = node_id;
+  }
+  return roots;
+}
+
+// Returns the total weight of the nodes with each root.
+absl::flat_hash_map<NodeId, double> TreeWeights(
+    const std::vector<NodeId>& roots, const std::vector<double>& node_weights) {
+  absl::flat_hash_map<NodeId, double> tree_weights;
+  for (std::size_t i = 0; i < roots.size(); ++i) {
+    tree_weights[roots[i]] += node_weights[i];
+  }
+  return tree_weights;
+}
+
+// Checks that result is a valid output of
+// ParallelMinWeightedSizeTreePartitioning for the given input.
+void ExpectValidMinSizePartition(const std::vector<NodeId>& parent_ids,
+                                 const std::vector<double>& node_weights,
+                                 double min_weight_threshold,
+                                 const std::vector<NodeId>& result) {
+  ASSERT_EQ(result.size(), parent_ids.size());
+  const std::vector<NodeId> input_roots = Roots(parent_ids);
+  const std::vector<NodeId> cluster_ids = Roots(result);
+  ASSERT_EQ(cluster_ids.size(), parent_ids.size()) << "cycle in the result";
+  const auto tree_weights = TreeWeights(input_roots, node_weights);
+  const auto cluster_weights = TreeWeights(cluster_ids, node_weights);
+  for (std::size_t i = 0; i < parent_ids.size(); ++i) {
+    EXPECT_EQ(input_roots[cluster_ids[i]], input_roots[i])
+        << "node " << i << " is clustered across input trees";
+    if (parent_ids[i] == -1) EXPECT_EQ(result[i], -1) << "root " << i;
+    if (tree_weights.at(input_roots[i]) < min_weight_threshold) {
+      EXPECT_EQ(result[i], parent_ids[i]) << "light tree node " << i;
+    } else {
+      EXPECT_GE(cluster_weights.at(cluster_ids[i]), min_weight_threshold)
+          << "cluster of node " << i;
+    }
+  }
+}
+
+// Checks that result is a valid output of MinMaxWeightedSizeTreePartitioning
+// for the given input: every part is contained in an input tree and has weight
+// in [min_weight, max_weight], except for parts consisting of a single node
+// heavier than max_weight and at most one lighter part per input tree.
+void ExpectValidMinMaxPartition(const std::vector<NodeId>& parent_ids,
+                                const std::vector<double>& node_weights,
+                                double min_weight, double max_weight,
+                                const std::vector<NodeId>& result) {
+  ASSERT_EQ(result.size(), parent_ids.size());
+  const std::vector<NodeId> input_roots = Roots(parent_ids);
+  const std::vector<NodeId> part_ids = Roots(result);
+  ASSERT_EQ(part_ids.size(), parent_ids.size()) << "cycle in the result";
+  const auto part_weights = TreeWeights(part_ids, node_weights);
+  absl::flat_hash_map<NodeId, int> part_sizes;
+  for (std::size_t i = 0; i < parent_ids.size(); ++i) {
+    EXPECT_EQ(input_roots[part_ids[i]], input_roots[i])
+        << "node " << i << " is in a part across input trees";
+    ++part_sizes[part_ids[i]];
+  }
+  absl::flat_hash_map<NodeId, int> num_light_parts;
+  for (const auto& [part_id, weight] : part_weights) {
+    if (weight > max_weight) {
+      EXPECT_EQ(part_sizes[part_id], 1) << "heavy part " << part_id;
+    }
+    if (weight < min_weight) ++num_light_parts[input_roots[part_id]];
+  }
+  for (const auto& [root, num_parts] : num_light_parts) {
+    EXPECT_LE(num_parts, 1) << "light parts in the tree of " << root;
+  }
+}
+
+// Returns a random forest on n nodes where the parent of node i is smaller
+// than i, and node 0 and every node with probability root_probability is a
+// root.
+std::vector<NodeId> RandomForest(std::size_t n, double root_probability,
+                                 std::mt19937& rng) {
+  std::vector<NodeId> parent_ids(n, -1);
+  std::bernoulli_distribution is_root(root_probability);
+  for (std::size_t i = 1; i < n; ++i) {
+    if (!is_root(rng)) {
+      parent_ids[i] = std::uniform_int_distribution<NodeId>(0, i - 1)(rng);
+    }
+  }
+  return parent_ids;
+}
+
+std::vector<double> RandomWeights(std::size_t n, std::mt19937& rng) {
+  std::vector<double> node_weights(n);
+  std::uniform_real_distribution<double> weight(0, 2);
+  for (double& node_weight : node_weights) node_weight = weight(rng);
+  return node_weights;
+}
+
+TEST(ParallelMinWeightedSizeTreePartitioningTest, EmptyForest) {
+  ASSERT_OK_AND_ASSIGN(auto result,
+                       ParallelMinWeightedSizeTreePartitioning({}, {}, 1.0));
+  EXPECT_THAT(result, IsEmpty());
+}
+
+TEST(ParallelMinWeightedSizeTreePartitioningTest, LightTreeIsUnchanged) {
+  const std::vector<NodeId> parent_ids = {-1, 0, 0, 1};
+  const std::vector<double> node_weights = {1, 1, 1, 1};
+  ASSERT_OK_AND_ASSIGN(auto result, ParallelMinWeightedSizeTreePartitioning(
+                                        parent_ids, node_weights, 5.0));
+  EXPECT_EQ(result, parent_ids);
+}
+
+TEST(ParallelMinWeightedSizeTreePartitioningTest, ZeroThresholdSplitsAll) {
+  const std::vector<NodeId> parent_ids = {-1, 0, 0, 1};
+  const std::vector<double> node_weights = {1, 1, 1, 1};
+  ASSERT_OK_AND_ASSIGN(auto result, ParallelMinWeightedSizeTreePartitioning(
+                                        parent_ids, node_weights, 0.0));
+  EXPECT_THAT(result, ElementsAre(-1, -1, -1, -1));
+}
+
+TEST(ParallelMinWeightedSizeTreePartitioningTest, Path) {
+  // 0 <- 1 <- ... <- 9.
+  std::vector<NodeId> parent_ids(10);
+  for (NodeId i = 0; i < 10; ++i) parent_ids[i] = i - 1;
+  const std::vector<double> node_weights(10, 1.0);
+  ASSERT_OK_AND_ASSIGN(auto result, ParallelMinWeightedSizeTreePartitioning(
+                                        parent_ids, node_weights, 3.0));
+  ExpectValidMinSizePartition(parent_ids, node_weights, 3.0, result);
+  // The clusters {7, 8, 9}, {4, 5, 6} and {1, 2, 3} are formed bottom-up, and
+  // the remaining root joins the lightest of them.
+  const std::vector<NodeId> cluster_ids = Roots(result);
+  absl::flat_hash_map<NodeId, int> cluster_sizes;
+  for (NodeId cluster_id : cluster_ids) ++cluster_sizes[cluster_id];
+  EXPECT_EQ(cluster_sizes.size(), 3);
+  EXPECT_EQ(cluster_sizes[0], 4);
+}
+
+TEST(ParallelMinWeightedSizeTreePartitioningTest, WideStar) {
+  // Enough children to use the parallel primitives at the root.
+  constexpr NodeId kNumLeaves = 5000;
+  std::vector<NodeId> parent_ids(kNumLeaves + 1, 0);
+  parent_ids[0] = -1;
+  std::mt19937 rng(7);
+  const std::vector<double> node_weights = RandomWeights(kNumLeaves + 1, rng);
+  ASSERT_OK_AND_ASSIGN(auto result, ParallelMinWeightedSizeTreePartitioning(
+                                        parent_ids, node_weights, 10.0));
+  ExpectValidMinSizePartition(parent_ids, node_weights, 10.0, result);
+}
+
+TEST(ParallelMinWeightedSizeTreePartitioningTest, RandomForests) {
+  std::mt19937 rng(42);
+  for (int trial = 0; trial < 20; ++trial) {
+    const std::size_t n = 1 + trial * 97;
+    const std::vector<NodeId> parent_ids = RandomForest(n, 0.01, rng);
+    const std::vector<double> node_weights = RandomWeights(n, rng);
+    for (double threshold : {0.5, 3.0, 20.0, 1000.0}) {
+      SCOPED_TRACE(testing::Message()
+                   << "n = " << n << ", threshold = " << threshold);
+      ASSERT_OK_AND_ASSIGN(auto result,
+                           ParallelMinWeightedSizeTreePartitioning(
+                               parent_ids, node_weights, threshold));
+      ExpectValidMinSizePartition(parent_ids, node_weights, threshold, result);
+    }
+  }
+}
+
+TEST(ParallelMinWeightedSizeTreePartitioningTest, Dendrogram) {
+  // ((0, 1), (2, 3)) with the merges 4 = {0, 1}, 5 = {2, 3} and 6 = {4, 5}.
+  ParallelDendrogram dendrogram(4);
+  dendrogram.MergeToParent(0, 4, 1.0);
+  dendrogram.MergeToParent(1, 4, 1.0);
+  dendrogram.MergeToParent(2, 5, 1.0);
+  dendrogram.MergeToParent(3, 5, 1.0);
+  dendrogram.MergeToParent(4, 6, 0.5);
+  dendrogram.MergeToParent(5, 6, 0.5);
+  const std::vector<NodeId> parent_ids = {4, 4, 5, 5, 6, 6, -1};
+  const std::vector<double> node_weights = {1, 1, 1, 1, 0, 0, 0};
+  ASSERT_OK_AND_ASSIGN(
+      auto result,
+      ParallelMinWeightedSizeTreePartitioning(dendrogram, {}, 2.0));
+  ExpectValidMinSizePartition(parent_ids, node_weights, 2.0, result);
+  EXPECT_THAT(result, ElementsAre(4, 4, 5, 5, 6, -1, -1));
+
+  const std::vector<double> leaf_weights = {1, 1, 1, 5};
+  ASSERT_OK_AND_ASSIGN(result, ParallelMinWeightedSizeTreePartitioning(
+                                   dendrogram, leaf_weights, 9.0));
+  EXPECT_EQ(result, parent_ids);
+
+  EXPECT_THAT(ParallelMinWeightedSizeTreePartitioning(dendrogram, {1, 1}, 2.0),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST(ParallelMinWeightedSizeTreePartitioningTest, InvalidInput) {
+  EXPECT_THAT(ParallelMinWeightedSizeTreePartitioning({-1, 0}, {1}, 1.0),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParallelMinWeightedSizeTreePartitioning({-1, 2}, {1, 1}, 1.0),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParallelMinWeightedSizeTreePartitioning({-1, -2}, {1, 1}, 1.0),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParallelMinWeightedSizeTreePartitioning({-1, 0}, {1, -1}, 1.0),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParallelMinWeightedSizeTreePartitioning({-1, 0}, {1, 1}, -1.0),
+              StatusIs(StatusCode::kInvalidArgument));
+  // A cycle 1 -> 2 -> 1 next to a valid tree.
+  EXPECT_THAT(
+      ParallelMinWeightedSizeTreePartitioning({-1, 2, 1}, {1, 1, 1}, 1.0),
+      StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST(MinMaxWeightedSizeTreePartitioningTest, EmptyForest) {
+  ASSERT_OK_AND_ASSIGN(auto result,
+                       MinMaxWeightedSizeTreePartitioning({}, {}, 1.0, 2.0));
+  EXPECT_THAT(result, IsEmpty());
+}
+
+TEST(MinMaxWeightedSizeTreePartitioningTest, SingleNodeTree) {
+  for (double node_weight : {0.5, 1.5, 5.0}) {
+    const std::vector<NodeId> parent_ids = {-1};
+    const std::vector<double> node_weights = {node_weight};
+    ASSERT_OK_AND_ASSIGN(auto result,
+                         MinMaxWeightedSizeTreePartitioning(
+                             parent_ids, node_weights, 1.0, 2.0));
+    EXPECT_THAT(result, ElementsAre(-1)) << "node weight " << node_weight;
+  }
+}
+
+TEST(MinMaxWeightedSizeTreePartitioningTest, WeightExceedingMax) {
+  // 0 <- 1 <- 2 where node 1 is heavier than max_weight.
+  const std::vector<NodeId> parent_ids = {-1, 0, 1};
+  const std::vector<double> node_weights = {1, 10, 1};
+  ASSERT_OK_AND_ASSIGN(auto result, MinMaxWeightedSizeTreePartitioning(
+                                        parent_ids, node_weights, 1.0, 2.0));
+  ExpectValidMinMaxPartition(parent_ids, node_weights, 1.0, 2.0, result);
+  EXPECT_THAT(result, ElementsAre(-1, -1, -1));
+}
+
+TEST(MinMaxWeightedSizeTreePartitioningTest, Path) {
+  // 0 <- 1 <- ... <- 9.
+  std::vector<NodeId> parent_ids(10);
+  for (NodeId i = 0; i < 10; ++i) parent_ids[i] = i - 1;
+  const std::vector<double> node_weights(10, 1.0);
+  ASSERT_OK_AND_ASSIGN(auto result, MinMaxWeightedSizeTreePartitioning(
+                                        parent_ids, node_weights, 3.0, 6.0));
+  ExpectValidMinMaxPartition(parent_ids, node_weights, 3.0, 6.0, result);
+  for (const auto& [part_id, weight] :
+       TreeWeights(Roots(result), node_weights)) {
+    EXPECT_GE(weight, 3.0);
+    EXPECT_LE(weight, 6.0);
+  }
+}
+
+TEST(MinMaxWeightedSizeTreePartitioningTest, RandomForests) {
+  std::mt19937 rng(42);
+  for (int trial = 0; trial < 20; ++trial) {
+    const std::size_t n = 1 + trial * 97;
+    const std::vector<NodeId> parent_ids = RandomForest(n, 0.01, rng);
+    const std::vector<double> node_weights = RandomWeights(n, rng);
+    for (const auto& [min_weight, max_weight] :
+         std::vector<std::pair<double, double>>{
+             {0.5, 1.0}, {3.0, 6.0}, {3.0, 10.0}, {20.0, 40.0}}) {
+      SCOPED_TRACE(testing::Message() << "n = " << n << ", bounds = ["
+                                      << min_weight << ", " << max_weight
+                                      << "]");
+      ASSERT_OK_AND_ASSIGN(auto result,
+                           MinMaxWeightedSizeTreePartitioning(
+                               parent_ids, node_weights, min_weight,
+                               max_weight));
+      ExpectValidMinMaxPartition(parent_ids, node_weights, min_weight,
+                                 max_weight, result);
+    }
+  }
+}
+
+TEST(MinMaxWeightedSizeTreePartitioningTest, WideStar) {
+  constexpr NodeId kNumLeaves = 5000;
+  std::vector<NodeId> parent_ids(kNumLeaves + 1, 0);
+  parent_ids[0] = -1;
+  std::mt19937 rng(7);
+  const std::vector<double> node_weights = RandomWeights(kNumLeaves + 1, rng);
+  ASSERT_OK_AND_ASSIGN(auto result, MinMaxWeightedSizeTreePartitioning(
+                                        parent_ids, node_weights, 10.0, 20.0));
+  ExpectValidMinMaxPartition(parent_ids, node_weights, 10.0, 20.0, result);
+}
+
+TEST(MinMaxWeightedSizeTreePartitioningTest, DendrogramWithoutMerges) {
+  // Every cluster id of a dendrogram without merges is a root.
+  ParallelDendrogram dendrogram(3);
+  ASSERT_OK_AND_ASSIGN(auto result, MinMaxWeightedSizeTreePartitioning(
+                                        dendrogram, {}, 1.0, 2.0));
+  EXPECT_THAT(result, ElementsAre(-1, -1, -1, -1, -1));
+}
+
+TEST(MinMaxWeightedSizeTreePartitioningTest, Dendrogram) {
+  // ((0, 1), (2, 3)) with the merges 4 = {0, 1}, 5 = {2, 3} and 6 = {4, 5}.
+  ParallelDendrogram dendrogram(4);
+  dendrogram.MergeToParent(0, 4, 1.0);
+  dendrogram.MergeToParent(1, 4, 1.0);
+  dendrogram.MergeToParent(2, 5, 1.0);
+  dendrogram.MergeToParent(3, 5, 1.0);
+  dendrogram.MergeToParent(4, 6, 0.5);
+  dendrogram.MergeToParent(5, 6, 0.5);
+  const std::vector<NodeId> parent_ids = {4, 4, 5, 5, 6, 6, -1};
+  const std::vector<double> node_weights = {1, 1, 1, 1, 0, 0, 0};
+  ASSERT_OK_AND_ASSIGN(auto result, MinMaxWeightedSizeTreePartitioning(
+                                        dendrogram, {}, 2.0, 4.0));
+  ExpectValidMinMaxPartition(parent_ids, node_weights, 2.0, 4.0, result);
+  for (const auto& [part_id, weight] :
+       TreeWeights(Roots(result), node_weights)) {
+    EXPECT_GE(weight, 2.0);
+    EXPECT_LE(weight, 4.0);
+  }
+
+  EXPECT_THAT(MinMaxWeightedSizeTreePartitioning(dendrogram, {1}, 2.0, 4.0),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST(MinMaxWeightedSizeTreePartitioningTest, InvalidInput) {
+  EXPECT_THAT(MinMaxWeightedSizeTreePartitioning({-1, 0}, {1, 1}, 1.0, 1.5),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_THAT(MinMaxWeightedSizeTreePartitioning({-1, 0}, {1, 1}, -1.0, 1.0),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_THAT(MinMaxWeightedSizeTreePartitioning({-1, 0}, {1}, 1.0, 2.0),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_THAT(MinMaxWeightedSizeTreePartitioning({-1, 5}, {1, 1}, 1.0, 2.0),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_THAT(MinMaxWeightedSizeTreePartitioning({-1, 0}, {1, -1}, 1.0, 2.0),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_THAT(MinMaxWeightedSizeTreePartitioning({1, 0}, {1, 1}, 1.0, 2.0),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace graph_mining::in_memory
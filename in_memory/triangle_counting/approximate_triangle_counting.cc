@@ -0,0 +1,320 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/triangle_counting/approximate_triangle_counting.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "gbbs/graph.h"
+#include "gbbs/macros.h"
+#include "in_memory/triangle_counting/oriented_graph.h"
+#include "in_memory/triangle_counting/triangle_counting.pb.h"
+#include "parlay/monoid.h"
+#include "parlay/parallel.h"
+#include "parlay/primitives.h"
+#include "parlay/sequence.h"
+#include "parlay/utilities.h"
+
+namespace graph_mining::in_memory {
+namespace {
+
+using UnweightedGraph =
+    gbbs::symmetric_ptr_graph<gbbs::symmetric_vertex, gbbs::empty>;
+using ::gbbs::uintE;
+
+// Hashes the arguments into 64 pseudo-random bits. Used instead of random
+// number generators so that the random choices do not depend on the
+// scheduling.
+uint64_t Hash(uint64_t seed, uint64_t a, uint64_t b = 0) {
+  return parlay::hash64(parlay::hash64(parlay::hash64(seed) + a) + b);
+}
+
+// Maps 64 random bits to a uniform double in [0, 1).
+double ToUnitInterval(uint64_t bits) {
+  return static_cast<double>(bits >> 11) * 0x1.0p-53;
+}
+
+// Returns the z such that a standard normal variable lies in [-z, z] with the
+// given probability.
+double NormalQuantile(double confidence_level) {
+  // Bisection on P(|X| > z) = erfc(z / sqrt(2)), which is decreasing in z.
+  double low = 0;
+  double high = 40;
+  for (int i = 0; i < 100; ++i) {
+    const double mid = (low + high) / 2;
+    if (std::erfc(mid / std::sqrt(2.0)) > 1 - confidence_level) {
+      low = mid;
+    } else {
+      high = mid;
+    }
+  }
+  return (low + high) / 2;
+}
+
+// Returns P(|X| < t) for a Student's t-distributed X with the given degrees of
+// freedom, using the finite series for integer degrees of freedom (Abramowitz
+// and Stegun 26.7.3 and 26.7.4).
+double StudentTCentralProbability(double t, int degrees_of_freedom) {
+  const double theta = std::atan(t / std::sqrt(degrees_of_freedom));
+  const double sin_theta = std::sin(theta);
+  const double cos_squared = std::cos(theta) * std::cos(theta);
+  double term = 1;
+  double sum = 1;
+  if (degrees_of_freedom % 2 == 0) {
+    for (int k = 2; k <= degrees_of_freedom - 2; k += 2) {
+      term *= cos_squared * (k - 1) / k;
+      sum += term;
+    }
+    return sin_theta * sum;
+  }
+  if (degrees_of_freedom == 1) return 2 * theta / M_PI;
+  for (int k = 3; k <= degrees_of_freedom - 2; k += 2) {
+    term *= cos_squared * (k - 1) / k;
+    sum += term;
+  }
+  return 2 / M_PI * (theta + sin_theta * std::cos(theta) * sum);
+}
+
+// Same as NormalQuantile for a Student's t-distribution, which accounts for
+// the uncertainty of a sample variance computed from few samples.
+double StudentTQuantile(double confidence_level, int degrees_of_freedom) {
+  double low = 0;
+  double high = 1;
+  while (StudentTCentralProbability(high, degrees_of_freedom) <
+             confidence_level &&
+         high < 1e300) {
+    high *= 2;
+  }
+  for (int i = 0; i < 200; ++i) {
+    const double mid = (low + high) / 2;
+    if (StudentTCentralProbability(mid, degrees_of_freedom) <
+        confidence_level) {
+      low = mid;
+    } else {
+      high = mid;
+    }
+  }
+  return (low + high) / 2;
+}
+
+// Returns the estimate with the confidence interval of estimate +/- quantile
+// standard errors.
+TriangleCountEstimate MakeEstimate(double estimate, double standard_error,
+                                   double quantile) {
+  TriangleCountEstimate result;
+  result.estimate = estimate;
+  result.standard_error = standard_error;
+  result.lower_bound = std::max(0.0, estimate - quantile * standard_error);
+  result.upper_bound = estimate + quantile * standard_error;
+  return result;
+}
+
+// Returns the index of the first neighbor that is not smaller than `node`.
+template <typename Neighbors>
+uintE LowerBound(Neighbors& neighbors, uintE node) {
+  uintE low = 0;
+  uintE high = neighbors.get_degree();
+  while (low < high) {
+    const uintE mid = low + (high - low) / 2;
+    if (neighbors.get_neighbor(mid) < node) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+// Combines the estimates of independent trials.
+TriangleCountEstimate CombineTrials(const std::vector<double>& estimates,
+                                    double confidence_level) {
+  const double num_trials = estimates.size();
+  double mean = 0;
+  for (double estimate : estimates) mean += estimate;
+  mean /= num_trials;
+  if (estimates.size() < 2) {
+    return MakeEstimate(mean, std::numeric_limits<double>::infinity(),
+                        /*quantile=*/1);
+  }
+  double sum_of_squares = 0;
+  for (double estimate : estimates) {
+    sum_of_squares += (estimate - mean) * (estimate - mean);
+  }
+  return MakeEstimate(
+      mean, std::sqrt(sum_of_squares / (num_trials - 1) / num_trials),
+      StudentTQuantile(confidence_level, estimates.size() - 1));
+}
+
+absl::StatusOr<TriangleCountEstimate> EstimateByEdgeSampling(
+    UnweightedGraph& graph,
+    const ApproximateTriangleCountingConfig::EdgeSampling& config,
+    int num_trials, uint64_t seed, double confidence_level) {
+  const double probability = config.edge_probability();
+  if (!(probability > 0 && probability <= 1)) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "edge_probability must be in (0, 1], got ", probability));
+  }
+  std::vector<double> estimates(num_trials);
+  for (int trial = 0; trial < num_trials; ++trial) {
+    const uint64_t trial_seed = Hash(seed, trial);
+    const auto sampled_graph = DegreeOrientedGraph::Create(
+        graph, [&](uintE u, uintE v) {
+          return ToUnitInterval(
+                     Hash(trial_seed, std::min(u, v), std::max(u, v))) <
+                 probability;
+        });
+    estimates[trial] = sampled_graph.CountTriangles() /
+                       (probability * probability * probability);
+  }
+  return CombineTrials(estimates, confidence_level);
+}
+
+absl::StatusOr<TriangleCountEstimate> EstimateByColorfulSampling(
+    UnweightedGraph& graph,
+    const ApproximateTriangleCountingConfig::ColorfulSampling& config,
+    int num_trials, uint64_t seed, double confidence_level) {
+  const int num_colors = config.num_colors();
+  if (num_colors < 1) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("num_colors must be positive, got ", num_colors));
+  }
+  std::vector<double> estimates(num_trials);
+  for (int trial = 0; trial < num_trials; ++trial) {
+    const uint64_t trial_seed = Hash(seed, trial);
+    const auto colors = parlay::sequence<int>::from_function(
+        graph.n, [&](std::size_t i) -> int {
+          return Hash(trial_seed, i) % num_colors;
+        });
+    const auto sampled_graph = DegreeOrientedGraph::Create(
+        graph, [&](uintE u, uintE v) { return colors[u] == colors[v]; });
+    estimates[trial] = static_cast<double>(sampled_graph.CountTriangles()) *
+                       num_colors * num_colors;
+  }
+  return CombineTrials(estimates, confidence_level);
+}
+
+absl::StatusOr<TriangleCountEstimate> EstimateByWedgeSampling(
+    UnweightedGraph& graph,
+    const ApproximateTriangleCountingConfig::WedgeSampling& config,
+    uint64_t seed, double confidence_level) {
+  const int64_t num_samples = config.num_samples();
+  if (num_samples < 1) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("num_samples must be positive, got ", num_samples));
+  }
+  const std::size_t num_nodes = graph.n;
+  // Degree of each node without its self-loop, and the position of the
+  // self-loop in its neighbors (or its degree if there is none). Neighbor
+  // indices from that position on are shifted by one to skip the self-loop.
+  auto degrees = parlay::sequence<uintE>::uninitialized(num_nodes);
+  auto self_loop_positions = parlay::sequence<uintE>::uninitialized(num_nodes);
+  parlay::parallel_for(0, num_nodes, [&](std::size_t i) {
+    auto neighbors = graph.get_vertex(i).out_neighbors();
+    const uintE position = LowerBound(neighbors, i);
+    if (position < neighbors.get_degree() &&
+        neighbors.get_neighbor(position) == i) {
+      degrees[i] = neighbors.get_degree() - 1;
+      self_loop_positions[i] = position;
+    } else {
+      degrees[i] = neighbors.get_degree();
+      self_loop_positions[i] = neighbors.get_degree();
+    }
+  });
+  // wedge_offsets[i] is the number of wedges centered at nodes before i.
+  auto wedge_offsets = parlay::sequence<uint64_t>::from_function(
+      num_nodes, [&](std::size_t i) -> uint64_t {
+        return static_cast<uint64_t>(degrees[i]) * (degrees[i] - 1) / 2;
+      });
+  const uint64_t num_wedges = parlay::scan_inplace(wedge_offsets);
+  if (num_wedges == 0) return MakeEstimate(0, 0, /*quantile=*/1);
+
+  // Returns the j-th neighbor of the node, skipping its self-loop.
+  auto get_neighbor = [&](uintE node, uintE j) {
+    if (j >= self_loop_positions[node]) ++j;
+    return graph.get_vertex(node).out_neighbors().get_neighbor(j);
+  };
+  const uint64_t num_closed_wedges = parlay::reduce(
+      parlay::delayed_seq<uint64_t>(
+          num_samples,
+          [&](std::size_t i) -> uint64_t {
+            // The center is chosen with probability proportional to its number
+            // of wedges, then two distinct neighbors uniformly.
+            const uint64_t wedge = Hash(seed, i, 0) % num_wedges;
+            const uintE center =
+                std::upper_bound(wedge_offsets.begin(), wedge_offsets.end(),
+                                 wedge) -
+                wedge_offsets.begin() - 1;
+            const uintE degree = degrees[center];
+            const uintE first = Hash(seed, i, 1) % degree;
+            uintE second = Hash(seed, i, 2) % (degree - 1);
+            if (second >= first) ++second;
+            const uintE u = get_neighbor(center, first);
+            const uintE v = get_neighbor(center, second);
+            auto u_neighbors = graph.get_vertex(u).out_neighbors();
+            const uintE position = LowerBound(u_neighbors, v);
+            return position < u_neighbors.get_degree() &&
+                           u_neighbors.get_neighbor(position) == v
+                       ? 1
+                       : 0;
+          }),
+      parlay::addm<uint64_t>());
+  const double closed_fraction =
+      static_cast<double>(num_closed_wedges) / num_samples;
+  const double scale = num_wedges / 3.0;
+  return MakeEstimate(
+      closed_fraction * scale,
+      scale * std::sqrt(closed_fraction * (1 - closed_fraction) / num_samples),
+      NormalQuantile(confidence_level));
+}
+
+}  // namespace
+
+absl::StatusOr<TriangleCountEstimate> EstimateTriangleCount(
+    UnweightedGraph& graph, const ApproximateTriangleCountingConfig& config) {
+  const double confidence_level = config.confidence_level();
+  if (!(confidence_level > 0 && confidence_level < 1)) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "confidence_level must be in (0, 1), got ", confidence_level));
+  }
+  const int num_trials = config.num_trials();
+  if (num_trials < 1) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("num_trials must be positive, got ", num_trials));
+  }
+  switch (config.method_case()) {
+    case ApproximateTriangleCountingConfig::kEdgeSampling:
+      return EstimateByEdgeSampling(graph, config.edge_sampling(), num_trials,
+                                    config.seed(), confidence_level);
+    case ApproximateTriangleCountingConfig::kColorfulSampling:
+      return EstimateByColorfulSampling(graph, config.colorful_sampling(),
+                                        num_trials, config.seed(),
+                                        confidence_level);
+    case ApproximateTriangleCountingConfig::kWedgeSampling:
+      return EstimateByWedgeSampling(graph, config.wedge_sampling(),
+                                     config.seed(), confidence_level);
+    case ApproximateTriangleCountingConfig::METHOD_NOT_SET:
+      break;
+  }
+  return absl::InvalidArgumentError("The sampling method must be set");
+}
+
+}  // namespace graph_mining::in_memory
@@ -0,0 +1,45 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_TRIANGLE_COUNTING_APPROXIMATE_TRIANGLE_COUNTING_H_
+#define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_TRIANGLE_COUNTING_APPROXIMATE_TRIANGLE_COUNTING_H_
+
+#include "absl/status/statusor.h"
+#include "gbbs/graph.h"
+#include "gbbs/macros.h"
+#include "in_memory/triangle_counting/triangle_counting.pb.h"
+
+namespace graph_mining::in_memory {
+
+struct TriangleCountEstimate {
+  // Unbiased estimate of the number of triangles.
+  double estimate = 0;
+  double standard_error = 0;
+  // Confidence interval with the configured confidence level. The lower bound
+  // is clamped to 0.
+  double lower_bound = 0;
+  double upper_bound = 0;
+};
+
+// Estimates the number of triangles of `graph` by sampling as configured by
+// `config`. `graph` must be symmetric, must have neighbors sorted by id (as in
+// UnweightedSortedNeighborGbbsGraph) and must not have parallel edges.
+// Self-loops are ignored. Returns an error if the config is invalid.
+absl::StatusOr<TriangleCountEstimate> EstimateTriangleCount(
+    gbbs::symmetric_ptr_graph<gbbs::symmetric_vertex, gbbs::empty>& graph,
+    const ApproximateTriangleCountingConfig& config);
+
+}  // namespace graph_mining::in_memory
+
+#endif  // THIRD_PARTY_GRAPH_MINING_IN_MEMORY_TRIANGLE_COUNTING_APPROXIMATE_TRIANGLE_COUNTING_H_
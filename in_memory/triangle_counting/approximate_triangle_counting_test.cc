@@ -0,0 +1,223 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/triangle_counting/approximate_triangle_counting.h"
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "in_memory/clustering/gbbs_graph.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/status_macros.h"  // IWYU pragma: keep
+#include "in_memory/triangle_counting/triangle_counting.pb.h"
+
+namespace graph_mining::in_memory {
+namespace {
+
+using ::absl::StatusCode;
+
+// Undirected graph as a set of node pairs (a, b) with a < b.
+struct TestGraph {
+  int num_nodes = 0;
+  std::set<std::pair<int, int>> edges;
+};
+
+TestGraph CompleteGraph(int num_nodes) {
+  TestGraph graph{num_nodes, {}};
+  for (int i = 0; i < num_nodes; ++i) {
+    for (int j = i + 1; j < num_nodes; ++j) graph.edges.emplace(i, j);
+  }
+  return graph;
+}
+
+// Erdos-Renyi graph with a self-loop on node 0.
+TestGraph RandomGraph(int num_nodes, double edge_probability) {
+  std::mt19937 rng(0);
+  std::bernoulli_distribution keep_edge(edge_probability);
+  TestGraph graph{num_nodes, {{0, 0}}};
+  for (int i = 0; i < num_nodes; ++i) {
+    for (int j = i + 1; j < num_nodes; ++j) {
+      if (keep_edge(rng)) graph.edges.emplace(i, j);
+    }
+  }
+  return graph;
+}
+
+uint64_t BruteForceTriangleCount(const TestGraph& graph) {
+  uint64_t count = 0;
+  for (const auto& [a, b] : graph.edges) {
+    for (int c = b + 1; c < graph.num_nodes; ++c) {
+      if (a != b && graph.edges.count({a, c}) && graph.edges.count({b, c})) {
+        ++count;
+      }
+    }
+  }
+  return count;
+}
+
+absl::Status ImportGraph(const TestGraph& test_graph,
+                         UnweightedSortedNeighborGbbsGraph& graph) {
+  std::vector<InMemoryClusterer::AdjacencyList> adjacency_lists(
+      test_graph.num_nodes);
+  for (int i = 0; i < test_graph.num_nodes; ++i) adjacency_lists[i].id = i;
+  for (const auto& [a, b] : test_graph.edges) {
+    adjacency_lists[a].outgoing_edges.emplace_back(b, 1);
+    if (a != b) adjacency_lists[b].outgoing_edges.emplace_back(a, 1);
+  }
+  RETURN_IF_ERROR(graph.PrepareImport(test_graph.num_nodes));
+  for (auto& adjacency_list : adjacency_lists) {
+    RETURN_IF_ERROR(graph.Import(std::move(adjacency_list)));
+  }
+  return graph.FinishImport();
+}
+
+ApproximateTriangleCountingConfig EdgeSamplingConfig(double edge_probability) {
+  ApproximateTriangleCountingConfig config;
+  config.mutable_edge_sampling()->set_edge_probability(edge_probability);
+  return config;
+}
+
+ApproximateTriangleCountingConfig ColorfulSamplingConfig(int num_colors) {
+  ApproximateTriangleCountingConfig config;
+  config.mutable_colorful_sampling()->set_num_colors(num_colors);
+  return config;
+}
+
+ApproximateTriangleCountingConfig WedgeSamplingConfig(int64_t num_samples) {
+  ApproximateTriangleCountingConfig config;
+  config.mutable_wedge_sampling()->set_num_samples(num_samples);
+  return config;
+}
+
+TEST(ApproximateTriangleCountingTest, InvalidConfigIsAnError) {
+  UnweightedSortedNeighborGbbsGraph graph;
+  ASSERT_OK(ImportGraph(CompleteGraph(5), graph));
+  const std::vector<ApproximateTriangleCountingConfig> invalid_configs = {
+      ApproximateTriangleCountingConfig(),
+      EdgeSamplingConfig(0),
+      EdgeSamplingConfig(-0.5),
+      EdgeSamplingConfig(1.5),
+      ColorfulSamplingConfig(0),
+      ColorfulSamplingConfig(-1),
+      WedgeSamplingConfig(0),
+      WedgeSamplingConfig(-1)};
+  for (const auto& config : invalid_configs) {
+    EXPECT_THAT(EstimateTriangleCount(*graph.Graph(), config),
+                StatusIs(StatusCode::kInvalidArgument))
+        << config.DebugString();
+  }
+  for (const double confidence_level : {0.0, 1.0, 1.5}) {
+    ApproximateTriangleCountingConfig config = EdgeSamplingConfig(0.5);
+    config.set_confidence_level(confidence_level);
+    EXPECT_THAT(EstimateTriangleCount(*graph.Graph(), config),
+                StatusIs(StatusCode::kInvalidArgument))
+        << config.DebugString();
+  }
+  ApproximateTriangleCountingConfig config = EdgeSamplingConfig(0.5);
+  config.set_num_trials(0);
+  EXPECT_THAT(EstimateTriangleCount(*graph.Graph(), config),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST(ApproximateTriangleCountingTest, ExactWithoutSampling) {
+  const TestGraph test_graph = RandomGraph(100, 0.2);
+  const double num_triangles = BruteForceTriangleCount(test_graph);
+  ASSERT_GT(num_triangles, 0);
+  UnweightedSortedNeighborGbbsGraph graph;
+  ASSERT_OK(ImportGraph(test_graph, graph));
+  // Every edge is kept with probability 1, and every edge has endpoints of the
+  // same color with a single color.
+  for (const auto& config :
+       {EdgeSamplingConfig(1), ColorfulSamplingConfig(1)}) {
+    ASSERT_OK_AND_ASSIGN(TriangleCountEstimate estimate,
+                         EstimateTriangleCount(*graph.Graph(), config));
+    EXPECT_EQ(estimate.estimate, num_triangles) << config.DebugString();
+    EXPECT_EQ(estimate.standard_error, 0) << config.DebugString();
+    EXPECT_EQ(estimate.lower_bound, num_triangles) << config.DebugString();
+    EXPECT_EQ(estimate.upper_bound, num_triangles) << config.DebugString();
+  }
+}
+
+TEST(ApproximateTriangleCountingTest, WedgeSamplingIsExactOnCliques) {
+  // Every wedge of a clique is closed.
+  UnweightedSortedNeighborGbbsGraph graph;
+  ASSERT_OK(ImportGraph(CompleteGraph(10), graph));
+  ASSERT_OK_AND_ASSIGN(
+      TriangleCountEstimate estimate,
+      EstimateTriangleCount(*graph.Graph(), WedgeSamplingConfig(1000)));
+  EXPECT_DOUBLE_EQ(estimate.estimate, 120);
+  EXPECT_EQ(estimate.standard_error, 0);
+}
+
+TEST(ApproximateTriangleCountingTest, DeterministicForFixedSeed) {
+  UnweightedSortedNeighborGbbsGraph graph;
+  ASSERT_OK(ImportGraph(RandomGraph(200, 0.1), graph));
+  for (ApproximateTriangleCountingConfig config :
+       {EdgeSamplingConfig(0.5), ColorfulSamplingConfig(3),
+        WedgeSamplingConfig(10000)}) {
+    config.set_seed(42);
+    ASSERT_OK_AND_ASSIGN(TriangleCountEstimate first,
+                         EstimateTriangleCount(*graph.Graph(), config));
+    ASSERT_OK_AND_ASSIGN(TriangleCountEstimate second,
+                         EstimateTriangleCount(*graph.Graph(), config));
+    EXPECT_EQ(first.estimate, second.estimate) << config.DebugString();
+    EXPECT_EQ(first.standard_error, second.standard_error)
+        << config.DebugString();
+    config.set_seed(43);
+    ASSERT_OK_AND_ASSIGN(TriangleCountEstimate other_seed,
+                         EstimateTriangleCount(*graph.Graph(), config));
+    EXPECT_NE(first.estimate, other_seed.estimate) << config.DebugString();
+  }
+}
+
+TEST(ApproximateTriangleCountingTest, EstimateIsWithinReportedInterval) {
+  const TestGraph test_graph = RandomGraph(200, 0.1);
+  const double num_triangles = BruteForceTriangleCount(test_graph);
+  UnweightedSortedNeighborGbbsGraph graph;
+  ASSERT_OK(ImportGraph(test_graph, graph));
+  for (const auto& config :
+       {EdgeSamplingConfig(0.5), ColorfulSamplingConfig(3),
+        WedgeSamplingConfig(10000)}) {
+    ASSERT_OK_AND_ASSIGN(TriangleCountEstimate estimate,
+                         EstimateTriangleCount(*graph.Graph(), config));
+    EXPECT_GT(estimate.standard_error, 0) << config.DebugString();
+    EXPECT_LT(estimate.lower_bound, estimate.estimate) << config.DebugString();
+    EXPECT_GT(estimate.upper_bound, estimate.estimate) << config.DebugString();
+    // Loose sanity check of the accuracy. The estimate is unbiased and its
+    // relative standard error is below 20% for these parameters.
+    EXPECT_NEAR(estimate.estimate, num_triangles, 0.5 * num_triangles)
+        << config.DebugString();
+  }
+}
+
+TEST(ApproximateTriangleCountingTest, SingleTrialHasUnboundedInterval) {
+  UnweightedSortedNeighborGbbsGraph graph;
+  ASSERT_OK(ImportGraph(RandomGraph(50, 0.3), graph));
+  ApproximateTriangleCountingConfig config = EdgeSamplingConfig(0.5);
+  config.set_num_trials(1);
+  ASSERT_OK_AND_ASSIGN(TriangleCountEstimate estimate,
+                       EstimateTriangleCount(*graph.Graph(), config));
+  EXPECT_EQ(estimate.lower_bound, 0);
+  EXPECT_EQ(estimate.upper_bound, std::numeric_limits<double>::infinity());
+}
+
+}  // namespace
+}  // namespace graph_mining::in_memory
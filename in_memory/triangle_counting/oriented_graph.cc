@@ -0,0 +1,75 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/triangle_counting/oriented_graph.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "gbbs/bridge.h"
+#include "gbbs/macros.h"
+#include "parlay/parallel.h"
+#include "parlay/sequence.h"
+
+namespace graph_mining::in_memory {
+
+std::size_t DegreeOrientedGraph::EdgeIndex(gbbs::uintE u,
+                                           gbbs::uintE v) const {
+  if (!Precedes(u, v)) std::swap(u, v);
+  auto begin = targets_.begin() + offsets_[u];
+  auto end = targets_.begin() + offsets_[u + 1];
+  return std::lower_bound(begin, end, v) - targets_.begin();
+}
+
+parlay::sequence<gbbs::uintE> DegreeOrientedGraph::CountTrianglesPerEdge()
+    const {
+  // The two other edges of a triangle are shared with triangles found by other
+  // tasks, so their counts are incremented atomically. The counts of the
+  // lowest-ranked edges are added once per edge afterwards.
+  parlay::sequence<gbbs::uintE> counts(NumEdges(), 0);
+  const parlay::sequence<gbbs::uintE> lowest_edge_counts =
+      MapTrianglesPerEdge([&](std::size_t, std::size_t uw, std::size_t vw) {
+        gbbs::write_add(&counts[uw], gbbs::uintE{1});
+        gbbs::write_add(&counts[vw], gbbs::uintE{1});
+      });
+  parlay::parallel_for(0, NumEdges(), [&](std::size_t e) {
+    counts[e] += lowest_edge_counts[e];
+  });
+  return counts;
+}
+
+parlay::sequence<uint64_t> DegreeOrientedGraph::CountTrianglesPerNode() const {
+  // The third node w of a triangle is incremented per triangle. The endpoints
+  // u and v of its lowest-ranked edge are incremented once per edge
+  // afterwards, summing the edges of u locally.
+  parlay::sequence<uint64_t> counts(NumNodes(), 0);
+  const parlay::sequence<gbbs::uintE> lowest_edge_counts =
+      MapTrianglesPerEdge([&](std::size_t, std::size_t uw, std::size_t) {
+        gbbs::write_add(&counts[targets_[uw]], uint64_t{1});
+      });
+  parlay::parallel_for(0, NumNodes(), [&](std::size_t u) {
+    uint64_t sum = 0;
+    for (std::size_t e = offsets_[u]; e < offsets_[u + 1]; ++e) {
+      if (lowest_edge_counts[e] == 0) continue;
+      sum += lowest_edge_counts[e];
+      gbbs::write_add(&counts[targets_[e]], uint64_t{lowest_edge_counts[e]});
+    }
+    if (sum > 0) gbbs::write_add(&counts[u], sum);
+  });
+  return counts;
+}
+
+}  // namespace graph_mining::in_memory
@@ -0,0 +1,195 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_TRIANGLE_COUNTING_ORIENTED_GRAPH_H_
+#define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_TRIANGLE_COUNTING_ORIENTED_GRAPH_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "gbbs/macros.h"
+#include "parlay/monoid.h"
+#include "parlay/parallel.h"
+#include "parlay/primitives.h"
+#include "parlay/sequence.h"
+
+namespace graph_mining::in_memory {
+
+// Undirected graph in which every edge is stored once, oriented from the
+// endpoint with the lower (degree, id) rank to the other one. Every triangle is
+// then found exactly once by intersecting the out-neighbors of the endpoints of
+// its lowest-ranked edge, and this orientation bounds the out-degrees by
+// O(sqrt(m)).
+class DegreeOrientedGraph {
+ public:
+  // Keeps the edges {u, v} of `graph` for which keep_edge(u, v) is true.
+  // `graph` must be symmetric, must have neighbors sorted by id and must not
+  // have parallel edges. keep_edge must be symmetric and thread-safe.
+  // Self-loops are dropped.
+  template <typename Graph, typename KeepEdge>
+  static DegreeOrientedGraph Create(Graph& graph, KeepEdge keep_edge);
+
+  // Same as above, but keeps all edges.
+  template <typename Graph>
+  static DegreeOrientedGraph Create(Graph& graph) {
+    return Create(graph, [](gbbs::uintE, gbbs::uintE) { return true; });
+  }
+
+  std::size_t NumNodes() const { return degrees_.size(); }
+  std::size_t NumEdges() const { return targets_.size(); }
+
+  // Number of kept edges incident to the node.
+  gbbs::uintE Degree(gbbs::uintE node) const { return degrees_[node]; }
+
+  // The out-neighbors of u are targets()[offsets()[u]], ...,
+  // targets()[offsets()[u + 1] - 1], sorted by id. Edges are identified by
+  // their index in targets().
+  const parlay::sequence<std::size_t>& offsets() const { return offsets_; }
+  const parlay::sequence<gbbs::uintE>& targets() const { return targets_; }
+
+  // Returns the index of the edge {u, v}, which must exist.
+  std::size_t EdgeIndex(gbbs::uintE u, gbbs::uintE v) const;
+
+  // Calls f(uv, uw, vw) in parallel for every triangle, where uv, uw and vw
+  // are the indices of its edges and uv is its lowest-ranked edge. Returns the
+  // number of triangles found from each edge, i.e., of which it is the
+  // lowest-ranked edge. These counts are accumulated by the task enumerating
+  // the edge, so callers do not need to count uv in f.
+  template <typename F>
+  parlay::sequence<gbbs::uintE> MapTrianglesPerEdge(F f) const;
+
+  // Same as above, but returns the number of triangles.
+  template <typename F>
+  uint64_t MapTriangles(F f) const;
+
+  // Returns the number of triangles.
+  uint64_t CountTriangles() const {
+    return MapTriangles([](std::size_t, std::size_t, std::size_t) {});
+  }
+
+  // Returns the number of triangles containing each edge, indexed by edge.
+  parlay::sequence<gbbs::uintE> CountTrianglesPerEdge() const;
+
+  // Returns the number of triangles containing each node.
+  parlay::sequence<uint64_t> CountTrianglesPerNode() const;
+
+ private:
+  bool Precedes(gbbs::uintE u, gbbs::uintE v) const {
+    return degrees_[u] < degrees_[v] || (degrees_[u] == degrees_[v] && u < v);
+  }
+
+  parlay::sequence<gbbs::uintE> degrees_;
+  parlay::sequence<std::size_t> offsets_;
+  parlay::sequence<gbbs::uintE> targets_;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+/// IMPLEMENTATION ONLY BELOW
+//////////////////////////////////////////////////////////////////////////////
+
+template <typename Graph, typename KeepEdge>
+DegreeOrientedGraph DegreeOrientedGraph::Create(Graph& graph,
+                                                KeepEdge keep_edge) {
+  const std::size_t num_nodes = graph.n;
+  DegreeOrientedGraph result;
+  result.degrees_ = parlay::sequence<gbbs::uintE>::from_function(
+      num_nodes, [&](std::size_t i) -> gbbs::uintE {
+        auto neighbors = graph.get_vertex(i).out_neighbors();
+        gbbs::uintE degree = 0;
+        for (std::size_t j = 0; j < neighbors.get_degree(); ++j) {
+          const gbbs::uintE neighbor = neighbors.get_neighbor(j);
+          if (neighbor != i && keep_edge(i, neighbor)) ++degree;
+        }
+        return degree;
+      });
+  // The out-neighbors are collected in two passes to avoid materializing the
+  // edges. keep_edge is evaluated once more per edge instead.
+  result.offsets_ = parlay::sequence<std::size_t>::from_function(
+      num_nodes + 1, [&](std::size_t i) -> std::size_t {
+        if (i == num_nodes) return 0;
+        auto neighbors = graph.get_vertex(i).out_neighbors();
+        std::size_t out_degree = 0;
+        for (std::size_t j = 0; j < neighbors.get_degree(); ++j) {
+          const gbbs::uintE neighbor = neighbors.get_neighbor(j);
+          if (result.Precedes(i, neighbor) && keep_edge(i, neighbor)) {
+            ++out_degree;
+          }
+        }
+        return out_degree;
+      });
+  const std::size_t num_edges = parlay::scan_inplace(result.offsets_);
+  result.targets_ = parlay::sequence<gbbs::uintE>::uninitialized(num_edges);
+  parlay::parallel_for(0, num_nodes, [&](std::size_t i) {
+    auto neighbors = graph.get_vertex(i).out_neighbors();
+    std::size_t position = result.offsets_[i];
+    for (std::size_t j = 0; j < neighbors.get_degree(); ++j) {
+      const gbbs::uintE neighbor = neighbors.get_neighbor(j);
+      if (result.Precedes(i, neighbor) && keep_edge(i, neighbor)) {
+        result.targets_[position++] = neighbor;
+      }
+    }
+  });
+  return result;
+}
+
+template <typename F>
+parlay::sequence<gbbs::uintE> DegreeOrientedGraph::MapTrianglesPerEdge(
+    F f) const {
+  // Number of triangles found from each oriented edge (u, v) by merging the
+  // out-neighbors of u and v.
+  parlay::sequence<gbbs::uintE> edge_counts(NumEdges());
+  parlay::parallel_for(
+      0, NumNodes(),
+      [&](std::size_t u) {
+        parlay::parallel_for(offsets_[u], offsets_[u + 1], [&](std::size_t e) {
+          const gbbs::uintE v = targets_[e];
+          std::size_t i = offsets_[u];
+          std::size_t j = offsets_[v];
+          const std::size_t u_end = offsets_[u + 1];
+          const std::size_t v_end = offsets_[v + 1];
+          gbbs::uintE count = 0;
+          while (i < u_end && j < v_end) {
+            if (targets_[i] < targets_[j]) {
+              ++i;
+            } else if (targets_[j] < targets_[i]) {
+              ++j;
+            } else {
+              f(e, i, j);
+              ++count;
+              ++i;
+              ++j;
+            }
+          }
+          edge_counts[e] = count;
+        });
+      },
+      /*granularity=*/1);
+  return edge_counts;
+}
+
+template <typename F>
+uint64_t DegreeOrientedGraph::MapTriangles(F f) const {
+  const parlay::sequence<gbbs::uintE> edge_counts = MapTrianglesPerEdge(f);
+  return parlay::reduce(parlay::delayed_seq<uint64_t>(
+                            NumEdges(),
+                            [&](std::size_t e) -> uint64_t {
+                              return edge_counts[e];
+                            }),
+                        parlay::addm<uint64_t>());
+}
+
+}  // namespace graph_mining::in_memory
+
+#endif  // THIRD_PARTY_GRAPH_MINING_IN_MEMORY_TRIANGLE_COUNTING_ORIENTED_GRAPH_H_
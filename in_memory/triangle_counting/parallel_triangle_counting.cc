@@ -14,14 +14,54 @@
 
 #include "in_memory/triangle_counting/parallel_triangle_counting.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "benchmarks/TriangleCounting/ShunTangwongsan15/Triangle.h"
+#include "gbbs/bridge.h"
+#include "gbbs/graph.h"
 #include "gbbs/macros.h"
+#include "in_memory/clustering/in_memory_clusterer.h"
 #include "in_memory/parallel/scheduler.h"
+#include "in_memory/triangle_counting/approximate_triangle_counting.h"
+#include "in_memory/triangle_counting/oriented_graph.h"
+#include "in_memory/triangle_counting/triangle_counting.pb.h"
+#include "parlay/parallel.h"
+#include "parlay/primitives.h"
+#include "parlay/sequence.h"
 
 using ::gbbs::uintE;
 
 namespace graph_mining::in_memory {
+namespace {
+
+using UnweightedGraph =
+    gbbs::symmetric_ptr_graph<gbbs::symmetric_vertex, gbbs::empty>;
+
+// Triangle counts of all edges of an undirected graph.
+class EdgeTriangleCounts {
+ public:
+  explicit EdgeTriangleCounts(UnweightedGraph& graph)
+      : oriented_graph_(DegreeOrientedGraph::Create(graph)),
+        counts_(oriented_graph_.CountTrianglesPerEdge()) {}
+
+  // Returns the number of triangles containing the edge {u, v}, which must
+  // exist.
+  uintE Count(uintE u, uintE v) const {
+    return counts_[oriented_graph_.EdgeIndex(u, v)];
+  }
+
+ private:
+  DegreeOrientedGraph oriented_graph_;
+  // counts_[i] is the number of triangles containing the edge with index i in
+  // oriented_graph_.
+  parlay::sequence<uintE> counts_;
+};
+
+}  // namespace
 
 absl::StatusOr<uint64_t> ParallelTriangleCounting::Count() const {
   if (graph_.Graph() == nullptr) {
@@ -42,4 +82,79 @@ absl::StatusOr<uint64_t> ParallelTriangleCounting::Count() const {
                                           unused_per_triangle_function);
 }
 
+absl::StatusOr<TriangleCountEstimate>
+ParallelTriangleCounting::CountApproximately(
+    const ApproximateTriangleCountingConfig& config) const {
+  if (graph_.Graph() == nullptr) {
+    return absl::FailedPreconditionError(
+        "graph_ must be initialized before triangle counting.");
+  }
+  return EstimateTriangleCount(*graph_.Graph(), config);
+}
+
+absl::StatusOr<std::vector<uint64_t>> ParallelTriangleCounting::CountPerNode()
+    const {
+  if (graph_.Graph() == nullptr) {
+    return absl::FailedPreconditionError(
+        "graph_ must be initialized before triangle counting.");
+  }
+  const parlay::sequence<uint64_t> counts =
+      DegreeOrientedGraph::Create(*graph_.Graph()).CountTrianglesPerNode();
+  return std::vector<uint64_t>(counts.begin(), counts.end());
+}
+
+absl::StatusOr<std::vector<double>>
+ParallelTriangleCounting::LocalClusteringCoefficients() const {
+  if (graph_.Graph() == nullptr) {
+    return absl::FailedPreconditionError(
+        "graph_ must be initialized before triangle counting.");
+  }
+  const auto oriented_graph = DegreeOrientedGraph::Create(*graph_.Graph());
+  const parlay::sequence<uint64_t> node_counts =
+      oriented_graph.CountTrianglesPerNode();
+  std::vector<double> coefficients(oriented_graph.NumNodes());
+  parlay::parallel_for(0, oriented_graph.NumNodes(), [&](std::size_t i) {
+    const double degree = oriented_graph.Degree(i);
+    coefficients[i] =
+        degree < 2 ? 0.0 : 2.0 * node_counts[i] / (degree * (degree - 1));
+  });
+  return coefficients;
+}
+
+absl::StatusOr<std::vector<EdgeTriangleCount>>
+ParallelTriangleCounting::CountPerEdge() const {
+  if (graph_.Graph() == nullptr) {
+    return absl::FailedPreconditionError(
+        "graph_ must be initialized before triangle counting.");
+  }
+  UnweightedGraph& graph = *graph_.Graph();
+  const EdgeTriangleCounts counts(graph);
+  // Every edge is listed by its endpoint with the smaller id. As the
+  // neighbors are sorted, these are the last neighbors of each node.
+  auto offsets = parlay::sequence<std::size_t>::from_function(
+      graph.n, [&](std::size_t i) -> std::size_t {
+        auto neighbors = graph.get_vertex(i).out_neighbors();
+        std::size_t num_larger_neighbors = 0;
+        for (std::size_t j = 0; j < neighbors.get_degree(); ++j) {
+          if (neighbors.get_neighbor(j) > i) ++num_larger_neighbors;
+        }
+        return num_larger_neighbors;
+      });
+  const std::size_t num_edges = parlay::scan_inplace(offsets);
+  std::vector<EdgeTriangleCount> edge_counts(num_edges);
+  parlay::parallel_for(0, graph.n, [&](std::size_t i) {
+    auto neighbors = graph.get_vertex(i).out_neighbors();
+    std::size_t position = offsets[i];
+    for (std::size_t j = 0; j < neighbors.get_degree(); ++j) {
+      const uintE neighbor = neighbors.get_neighbor(j);
+      if (neighbor <= i) continue;
+      edge_counts[position++] = {
+          static_cast<InMemoryClusterer::NodeId>(i),
+          static_cast<InMemoryClusterer::NodeId>(neighbor),
+          counts.Count(i, neighbor)};
+    }
+  });
+  return edge_counts;
+}
+
 }  // namespace graph_mining::in_memory
@@ -15,11 +15,24 @@
 #ifndef THIRD_PARTY_GRAPH_MINING_IN_MEMORY_TRIANGLE_COUNTING_PARALLEL_TRIANGLE_COUNTING_H_
 #define THIRD_PARTY_GRAPH_MINING_IN_MEMORY_TRIANGLE_COUNTING_PARALLEL_TRIANGLE_COUNTING_H_
 
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/statusor.h"
 #include "in_memory/clustering/gbbs_graph.h"
 #include "in_memory/clustering/in_memory_clusterer.h"
+#include "in_memory/triangle_counting/approximate_triangle_counting.h"
+#include "in_memory/triangle_counting/triangle_counting.pb.h"
 
 namespace graph_mining::in_memory {
 
+// Number of triangles containing the edge {node_a, node_b}.
+struct EdgeTriangleCount {
+  InMemoryClusterer::NodeId node_a;
+  InMemoryClusterer::NodeId node_b;
+  uint64_t num_triangles;
+};
+
 // Parallel triangle counting.
 class ParallelTriangleCounting {
  public:
@@ -30,6 +43,27 @@ class ParallelTriangleCounting {
   // Returns the number of triangles in `graph_`.
   absl::StatusOr<uint64_t> Count() const;
 
+  // Returns an estimate of the number of triangles in `graph_` computed by
+  // sampling, see EstimateTriangleCount.
+  absl::StatusOr<TriangleCountEstimate> CountApproximately(
+      const ApproximateTriangleCountingConfig& config) const;
+
+  // The methods below require `graph_` to be symmetric and to have no parallel
+  // edges. Self-loops are ignored.
+
+  // Returns the number of triangles containing each node of `graph_`.
+  absl::StatusOr<std::vector<uint64_t>> CountPerNode() const;
+
+  // Returns the local clustering coefficient of each node of `graph_`, i.e.,
+  // the number of triangles containing the node divided by the number of pairs
+  // of its neighbors. Nodes with fewer than two neighbors have coefficient 0.
+  absl::StatusOr<std::vector<double>> LocalClusteringCoefficients() const;
+
+  // Returns the number of triangles containing each edge of `graph_` (also
+  // known as the support of the edge). Every edge is listed once with
+  // node_a < node_b, and the result is sorted by (node_a, node_b).
+  absl::StatusOr<std::vector<EdgeTriangleCount>> CountPerEdge() const;
+
  private:
   // Must use a graph representation with sorted neighbors due to assumptions in
   // Gbbs library's internal implementation.
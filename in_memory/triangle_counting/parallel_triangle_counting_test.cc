@@ -0,0 +1,88 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "in_memory/triangle_counting/parallel_triangle_counting.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "in_memory/clustering/graph.h"
+#include "in_memory/status_macros.h"  // IWYU pragma: keep
+
+namespace graph_mining::in_memory {
+namespace {
+
+using ::testing::AllOf;
+using ::testing::ElementsAre;
+using ::testing::Field;
+
+// Returns a clique on the nodes 0, 1, 2 and 3 with the pendant node 4
+// attached to node 3.
+absl::Status MakeCliqueWithPendant(ParallelTriangleCounting& counting) {
+  SimpleUndirectedGraph graph;
+  for (int i = 0; i < 4; ++i) {
+    for (int j = i + 1; j < 4; ++j) RETURN_IF_ERROR(graph.AddEdge(i, j, 1.0));
+  }
+  RETURN_IF_ERROR(graph.AddEdge(3, 4, 1.0));
+  return CopyGraph(graph, counting.MutableGraph());
+}
+
+testing::Matcher<EdgeTriangleCount> EdgeCount(int node_a, int node_b,
+                                               uint64_t num_triangles) {
+  return AllOf(Field(&EdgeTriangleCount::node_a, node_a),
+               Field(&EdgeTriangleCount::node_b, node_b),
+               Field(&EdgeTriangleCount::num_triangles, num_triangles));
+}
+
+TEST(ParallelTriangleCountingTest, CountsTrianglesOfK4) {
+  ParallelTriangleCounting counting;
+  ASSERT_OK(MakeCliqueWithPendant(counting));
+  EXPECT_THAT(counting.Count(), IsOkAndHolds(4));
+}
+
+TEST(ParallelTriangleCountingTest, CountsTrianglesPerNodeOfK4) {
+  ParallelTriangleCounting counting;
+  ASSERT_OK(MakeCliqueWithPendant(counting));
+  ASSERT_OK_AND_ASSIGN(std::vector<uint64_t> counts, counting.CountPerNode());
+  EXPECT_THAT(counts, ElementsAre(3, 3, 3, 3, 0));
+}
+
+TEST(ParallelTriangleCountingTest, CountsTrianglesPerEdgeOfK4) {
+  ParallelTriangleCounting counting;
+  ASSERT_OK(MakeCliqueWithPendant(counting));
+  ASSERT_OK_AND_ASSIGN(std::vector<EdgeTriangleCount> counts,
+                       counting.CountPerEdge());
+  EXPECT_THAT(counts, ElementsAre(EdgeCount(0, 1, 2), EdgeCount(0, 2, 2),
+                                  EdgeCount(0, 3, 2), EdgeCount(1, 2, 2),
+                                  EdgeCount(1, 3, 2), EdgeCount(2, 3, 2),
+                                  EdgeCount(3, 4, 0)));
+}
+
+TEST(ParallelTriangleCountingTest, LocalClusteringCoefficientsOfK4) {
+  ParallelTriangleCounting counting;
+  ASSERT_OK(MakeCliqueWithPendant(counting));
+  ASSERT_OK_AND_ASSIGN(std::vector<double> coefficients,
+                       counting.LocalClusteringCoefficients());
+  ASSERT_EQ(coefficients.size(), 5);
+  for (int i = 0; i < 3; ++i) EXPECT_DOUBLE_EQ(coefficients[i], 1.0);
+  // Node 3 has 3 triangles and 4 neighbors.
+  EXPECT_DOUBLE_EQ(coefficients[3], 0.5);
+  EXPECT_DOUBLE_EQ(coefficients[4], 0.0);
+}
+
+}  // namespace
+}  // namespace graph_mining::in_memory